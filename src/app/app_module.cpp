@@ -8,11 +8,16 @@
 
 #include "../base/bnd_utils.h"
 #include "../base/brep_utils.h"
+#include "../base/caf_utils.h"
 #include "../base/cpp_utils.h"
 #include "../base/io_reader.h"
 #include "../base/io_writer.h"
 #include "../base/io_system.h"
+#include "../base/math_utils.h"
+#include "../base/mesh_utils.h"
 #include "../base/settings.h"
+#include "../base/task_progress.h"
+#include "../base/triangulation_annex_data.h"
 #include "../gui/gui_application.h"
 #include "../gui/gui_document.h"
 #include "qtcore_utils.h"
@@ -20,13 +25,24 @@
 #include "qstring_conv.h"
 
 #include <BRepBndLib.hxx>
+#include <BRep_Builder.hxx>
+#include <BRep_Tool.hxx>
+#include <OSD_Parallel.hxx>
+#include <TopExp_Explorer.hxx>
+#include <TopoDS_Compound.hxx>
+#include <TopTools_MapOfShape.hxx>
 
 #include <QtCore/QDir>
 #include <QtCore/QtDebug>
 #include <QtGui/QGuiApplication>
 
 #include <fmt/format.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
 #include <iterator>
+#include <numeric>
+#include <unordered_map>
 
 namespace Mayo {
 
@@ -214,7 +230,8 @@ void AppModule::recordRecentFileThumbnail(GuiDocument* guiDoc)
         return;
 
     RecentFile newRecentFile = *recentFile;
-    const bool okRecord = newRecentFile.recordThumbnail(guiDoc, this->recentFileThumbnailSize());
+    newRecentFile.thumbnailTimestamp = RecentFile::timestampLastModified(newRecentFile.filepath);
+    const bool okRecord = this->startRecentFileThumbnailWrite(newRecentFile, guiDoc);
     if (!okRecord)
         return;
 
@@ -238,7 +255,8 @@ void AppModule::recordRecentFileThumbnails(GuiApplication* guiApp)
             continue; // Skip
 
         RecentFile newRecentFile = *recentFile;
-        if (newRecentFile.recordThumbnail(guiDoc, this->recentFileThumbnailSize())) {
+        newRecentFile.thumbnailTimestamp = RecentFile::timestampLastModified(newRecentFile.filepath);
+        if (this->startRecentFileThumbnailWrite(newRecentFile, guiDoc)) {
             auto indexRecentFile = std::distance(&listRecentFile.front(), recentFile);
             newListRecentFile.at(indexRecentFile) = newRecentFile;
         }
@@ -247,6 +265,43 @@ void AppModule::recordRecentFileThumbnails(GuiApplication* guiApp)
     m_props.recentFiles.setValue(newListRecentFile);
 }
 
+void AppModule::waitForRecentFileThumbnails()
+{
+    std::vector<std::future<void>> vecThumbnailWriter;
+    {
+        [[maybe_unused]] std::lock_guard<std::mutex> lock(m_mutexThumbnailWriter);
+        vecThumbnailWriter.swap(m_vecThumbnailWriter);
+    }
+
+    for (std::future<void>& writer : vecThumbnailWriter)
+        writer.wait();
+
+    pruneRecentFileThumbnails(m_props.recentFiles.value());
+}
+
+bool AppModule::startRecentFileThumbnailWrite(const RecentFile& recentFile, GuiDocument* guiDoc)
+{
+    // Rendering needs the graphics context, so it can't be moved out of the GUI thread
+    Handle_Image_AlienPixMap image = recentFile.renderThumbnail(guiDoc, this->recentFileThumbnailSize());
+    if (!image)
+        return false;
+
+    const FilePath fp = recentFile.filepath;
+    const FilePath fpThumbnail = recentFile.thumbnailFilepath();
+    [[maybe_unused]] std::lock_guard<std::mutex> lock(m_mutexThumbnailWriter);
+    // Forget the writers already done
+    auto itWriterDoneBegin = std::remove_if(
+                m_vecThumbnailWriter.begin(), m_vecThumbnailWriter.end(), [](const std::future<void>& writer) {
+        return writer.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+    });
+    m_vecThumbnailWriter.erase(itWriterDoneBegin, m_vecThumbnailWriter.end());
+    m_vecThumbnailWriter.push_back(std::async(std::launch::async, [=]{
+        if (RecentFile::writeThumbnail(image, fpThumbnail))
+            this->signalRecentFileThumbnailWritten.send(fp);
+    }));
+    return true;
+}
+
 static QuantityLength shapeChordalDeflection(const TopoDS_Shape& shape)
 {
     // Excerpted from Prs3d::GetDeflection(...)
@@ -271,16 +326,69 @@ static QuantityLength shapeChordalDeflection(const TopoDS_Shape& shape)
     return 4 * diagMaxComp * baseDeviation;
 }
 
+// Abort request is only flagged on the root TaskProgress object, so the parents of 'progress' have
+// to be inspected too
+static bool isAbortRequestedInTree(const TaskProgress* progress)
+{
+    for (const TaskProgress* it = progress; it != nullptr; it = it->parent()) {
+        if (it->isAbortRequested())
+            return true;
+    }
+
+    return false;
+}
+
+// Does the active triangulation of 'face' fit the deflection of 'params'?
+// Mirrors BRepMesh_Deflection::IsConsistent() so faces left untouched by BRepMesh can be skipped
+static bool isBRepMeshConsistent(const TopoDS_Face& face, const OccBRepMeshParameters& params)
+{
+    if (params.Relative)
+        return false; // Deflection depends on the edges of the face, let BRepMesh decide
+
+    TopLoc_Location loc;
+    const Handle_Poly_Triangulation& triangulation = BRep_Tool::Triangulation(face, loc);
+    if (triangulation.IsNull())
+        return false;
+
+    constexpr double ratio = 0.1;
+    const double deflection = triangulation->Deflection();
+    return deflection < (1 + ratio) * params.Deflection && deflection > (1 - ratio) * params.Deflection;
+}
+
+// Calls 'fn' on each part of 'shape' to be meshed with its own deflection(see BRepMeshQuality::Adaptive)
+// Parts are solids, free shells and free faces. Instances of the same part are visited once
+template<typename Function>
+static void forEachBRepMeshPart(const TopoDS_Shape& shape, Function fn)
+{
+    TopTools_MapOfShape mapPart;
+    auto fnVisit = [&](const TopoDS_Shape& part) {
+        const TopoDS_Shape partUnlocated = part.Located(TopLoc_Location());
+        if (mapPart.Add(partUnlocated))
+            fn(partUnlocated);
+    };
+    for (TopExp_Explorer expl(shape, TopAbs_SOLID); expl.More(); expl.Next())
+        fnVisit(expl.Current());
+
+    for (TopExp_Explorer expl(shape, TopAbs_SHELL, TopAbs_SOLID); expl.More(); expl.Next())
+        fnVisit(expl.Current());
+
+    for (TopExp_Explorer expl(shape, TopAbs_FACE, TopAbs_SHELL); expl.More(); expl.Next())
+        fnVisit(expl.Current());
+}
+
 OccBRepMeshParameters AppModule::brepMeshParameters(const TopoDS_Shape& shape) const
 {
-    using BRepMeshQuality = AppModuleProperties::BRepMeshQuality;
+    return this->brepMeshParameters(shape, m_props.meshingQuality.value());
+}
 
+OccBRepMeshParameters AppModule::brepMeshParameters(const TopoDS_Shape& shape, BRepMeshQuality quality) const
+{
     OccBRepMeshParameters params;
     params.InParallel = true;
 #if OCC_VERSION_HEX >= OCC_VERSION_CHECK(7, 5, 0)
     params.AllowQualityDecrease = true;
 #endif
-    if (m_props.meshingQuality == BRepMeshQuality::UserDefined) {
+    if (quality == BRepMeshQuality::UserDefined) {
         params.Deflection = UnitSystem::meters(m_props.meshingChordalDeflection.quantity());
         params.Angle = UnitSystem::radians(m_props.meshingAngularDeflection.quantity());
         params.Relative = m_props.meshingRelative;
@@ -297,11 +405,13 @@ OccBRepMeshParameters AppModule::brepMeshParameters(const TopoDS_Shape& shape) c
             case BRepMeshQuality::Normal: return { 1, 1 };
             case BRepMeshQuality::Precise: return { 1/4., 1/2. };
             case BRepMeshQuality::VeryPrecise: return { 1/8., 1/4. };
+            // Normal quality, but 'shape' is expected to be a part(see forEachBRepMeshPart())
+            case BRepMeshQuality::Adaptive: return { 1, 1 };
             case BRepMeshQuality::UserDefined: return { -1, -1 };
             }
             return { 1, 1 };
         };
-        const Coefficients coeffs = fnCoefficients(m_props.meshingQuality);
+        const Coefficients coeffs = fnCoefficients(quality);
         params.Deflection = UnitSystem::meters(coeffs.chordalDeflection * shapeChordalDeflection(shape));
         params.Angle = UnitSystem::radians(coeffs.angularDeflection * (20 * Quantity_Degree));
     }
@@ -309,9 +419,41 @@ OccBRepMeshParameters AppModule::brepMeshParameters(const TopoDS_Shape& shape) c
     return params;
 }
 
+std::vector<OccBRepMeshParameters>
+AppModule::brepMeshLodParameters(const TopoDS_Shape& shape, BRepMeshQuality quality) const
+{
+    // Chordal deflection is multiplied by 4 and angular deflection by 2 from one LOD to the next
+    // one, so a LOD fits an object whose size on screen is 4 times smaller than the previous LOD
+    const OccBRepMeshParameters finestParams = this->brepMeshParameters(shape, quality);
+    const double maxAngle = UnitSystem::radians(60 * Quantity_Degree);
+    std::vector<OccBRepMeshParameters> vecParams;
+    for (int lod = 0; lod < m_props.meshingLodCount.value(); ++lod) {
+        OccBRepMeshParameters params = finestParams;
+        params.Deflection = finestParams.Deflection * std::pow(4., lod);
+        params.Angle = std::min(finestParams.Angle * std::pow(2., lod), std::max(finestParams.Angle, maxAngle));
+        vecParams.push_back(params);
+    }
+
+    return vecParams;
+}
+
 void AppModule::computeBRepMesh(const TopoDS_Shape& shape, TaskProgress* progress)
 {
-    BRepUtils::computeMesh(shape, this->brepMeshParameters(shape), progress);
+    const BRepMeshQuality quality = m_props.meshingQuality.value();
+    if (quality == BRepMeshQuality::Adaptive) {
+        std::vector<TopoDS_Shape> vecPart;
+        forEachBRepMeshPart(shape, [&](const TopoDS_Shape& part) { vecPart.push_back(part); });
+        for (const TopoDS_Shape& part : vecPart) {
+            if (TaskProgress::isAbortRequested(progress))
+                return;
+
+            TaskProgress partProgress(progress, 100. / vecPart.size());
+            BRepUtils::computeMeshLods(part, this->brepMeshLodParameters(part, quality), &partProgress);
+        }
+    }
+    else {
+        BRepUtils::computeMeshLods(shape, this->brepMeshLodParameters(shape, quality), progress);
+    }
 }
 
 void AppModule::computeBRepMesh(const TDF_Label& labelEntity, TaskProgress* progress)
@@ -320,6 +462,386 @@ void AppModule::computeBRepMesh(const TDF_Label& labelEntity, TaskProgress* prog
         this->computeBRepMesh(XCaf::shape(labelEntity), progress);
 }
 
+bool AppModule::isBRepMeshProgressive() const
+{
+    return m_props.meshingProgressive
+            && m_props.meshingQuality.value() != BRepMeshQuality::VeryCoarse;
+}
+
+void AppModule::computeBRepMeshCoarse(const TDF_Label& labelEntity, TaskProgress* progress)
+{
+    if (XCaf::isShape(labelEntity)) {
+        const TopoDS_Shape shape = XCaf::shape(labelEntity);
+        const auto params = this->brepMeshParameters(shape, BRepMeshQuality::VeryCoarse);
+        BRepUtils::computeMesh(shape, params, progress);
+    }
+}
+
+void AppModule::refineBRepMesh(Span<const TDF_Label> spanLabelEntity, TaskProgress* progress)
+{
+    const double msTimeBudget = UnitSystem::milliseconds(m_props.meshingProgressiveTimeBudget.quantity());
+    const auto timeStart = std::chrono::steady_clock::now();
+    auto fnIsRefineStopped = [=]{
+        const auto timeElapsed = std::chrono::steady_clock::now() - timeStart;
+        return isAbortRequestedInTree(progress)
+                || std::chrono::duration<double, std::milli>(timeElapsed).count() > msTimeBudget;
+    };
+
+    // Intermediate passes between the very coarse mesh and the target quality
+    const BRepMeshQuality targetQuality = m_props.meshingQuality.value();
+    std::vector<BRepMeshQuality> vecPassQuality;
+    if (targetQuality == BRepMeshQuality::Adaptive) {
+        vecPassQuality.push_back(BRepMeshQuality::Coarse);
+    }
+    else {
+        for (auto quality : { BRepMeshQuality::Coarse, BRepMeshQuality::Normal, BRepMeshQuality::Precise }) {
+            if (quality < targetQuality)
+                vecPassQuality.push_back(quality);
+        }
+    }
+
+    vecPassQuality.push_back(targetQuality);
+
+    std::vector<TopoDS_Shape> vecShape;
+    for (const TDF_Label& labelEntity : spanLabelEntity)
+        vecShape.push_back(XCaf::isShape(labelEntity) ? XCaf::shape(labelEntity) : TopoDS_Shape{});
+
+    const int passCount = CppUtils::safeStaticCast<int>(vecPassQuality.size() * vecShape.size());
+    int passId = 0;
+    for (BRepMeshQuality quality : vecPassQuality) {
+        for (size_t i = 0; i < vecShape.size(); ++i) {
+            ++passId;
+            const TopoDS_Shape& shape = vecShape.at(i);
+            if (shape.IsNull())
+                continue;
+
+            if (quality != targetQuality && targetQuality != BRepMeshQuality::Adaptive) {
+                // Skip pass that would not be finer than the target quality(possible with UserDefined)
+                const auto params = this->brepMeshParameters(shape, quality);
+                const auto targetParams = this->brepMeshParameters(shape, targetQuality);
+                if (!params.Relative && !targetParams.Relative && params.Deflection <= targetParams.Deflection)
+                    continue;
+            }
+
+            // LODs are computed only by the final pass
+            const bool withLods = quality == targetQuality;
+            std::vector<TopoDS_Face> vecMeshedFace;
+            const bool isRefineDone = this->computeBRepMeshByUnits(
+                        shape, quality, withLods, fnIsRefineStopped, &vecMeshedFace
+            );
+            if (!vecMeshedFace.empty())
+                this->signalBRepMeshChanged.send(spanLabelEntity[i], vecMeshedFace);
+
+            if (progress)
+                progress->setValue(MathUtils::toPercent(passId, 0, passCount));
+
+            if (!isRefineDone)
+                return;
+        }
+    }
+}
+
+int AppModule::updateBRepMesh(Span<const TDF_Label> spanLabelEntity, TaskProgress* progress)
+{
+    auto fnActiveTriangulation = [](const TopoDS_Face& face) {
+        TopLoc_Location loc;
+        return BRep_Tool::Triangulation(face, loc).get();
+    };
+
+    const BRepMeshQuality quality = m_props.meshingQuality.value();
+    int updatedFaceCount = 0;
+    int entityId = 0;
+    for (const TDF_Label& labelEntity : spanLabelEntity) {
+        ++entityId;
+        if (!XCaf::isShape(labelEntity))
+            continue;
+
+        // Record the triangulation of each face to find afterwards the ones replaced by BRepMesh
+        const TopoDS_Shape shape = XCaf::shape(labelEntity);
+        std::unordered_map<const TopoDS_TShape*, const Poly_Triangulation*> mapFaceTriangulation;
+        BRepUtils::forEachSubFace(shape, [&](const TopoDS_Face& face) {
+            mapFaceTriangulation.insert({ face.TShape().get(), fnActiveTriangulation(face) });
+        });
+
+        const bool isDone = this->computeBRepMeshByUnits(
+                    shape, quality, true/*withLods*/, [=]{ return isAbortRequestedInTree(progress); }
+        );
+
+        std::vector<TopoDS_Face> vecUpdatedFace;
+        BRepUtils::forEachSubFace(shape, [&](const TopoDS_Face& face) {
+            auto it = mapFaceTriangulation.find(face.TShape().get());
+            if (it != mapFaceTriangulation.end()) {
+                if (it->second != fnActiveTriangulation(face))
+                    vecUpdatedFace.push_back(face);
+
+                mapFaceTriangulation.erase(it); // Count shared faces once
+            }
+        });
+
+        if (!vecUpdatedFace.empty())
+            this->signalBRepMeshChanged.send(labelEntity, vecUpdatedFace);
+
+        updatedFaceCount += int(vecUpdatedFace.size());
+        if (progress)
+            progress->setValue(MathUtils::toPercent(entityId, 0, spanLabelEntity.size()));
+
+        if (!isDone)
+            break;
+    }
+
+    return updatedFaceCount;
+}
+
+bool AppModule::isPureMeshEntity(const TDF_Label& labelEntity)
+{
+    if (!XCaf::isShape(labelEntity))
+        return false;
+
+    // Mesh readers(STL, OFF, PLY) mark their entities with annex data
+    if (CafUtils::findAttribute<TriangulationAnnexData>(labelEntity))
+        return true;
+
+    bool hasTriangulation = false;
+    bool hasGeometry = false;
+    BRepUtils::forEachSubFace(XCaf::shape(labelEntity), [&](const TopoDS_Face& face) {
+        TopLoc_Location loc;
+        hasTriangulation = hasTriangulation || !BRep_Tool::Triangulation(face, loc).IsNull();
+        hasGeometry = hasGeometry || BRepUtils::isGeometric(face);
+    });
+
+    return hasTriangulation && !hasGeometry;
+}
+
+bool AppModule::isPureMeshPostProcessRequired() const
+{
+    return m_props.pureMeshOptimizeLayout || m_props.pureMeshComputeNormals;
+}
+
+void AppModule::postProcessPureMesh(const TDF_Label& labelEntity, TaskProgress* progress)
+{
+    if (!this->isPureMeshPostProcessRequired() || !AppModule::isPureMeshEntity(labelEntity))
+        return;
+
+    const bool computeNormals = m_props.pureMeshComputeNormals;
+    const double normalCreaseAngle = UnitSystem::radians(m_props.pureMeshNormalCreaseAngle.quantity());
+    const bool optimizeLayout = m_props.pureMeshOptimizeLayout;
+    auto fnProcess = [=](
+            const Handle_Poly_Triangulation& triangulation, int, std::vector<int>* ptrVecSourceNode, TaskProgress*)
+    {
+        Handle_Poly_Triangulation mesh = triangulation;
+        std::vector<int>& vecSourceNode = *ptrVecSourceNode;
+        vecSourceNode.resize(mesh->NbNodes());
+        std::iota(vecSourceNode.begin(), vecSourceNode.end(), 1);
+        // Normals possibly provided by the source file are kept
+        if (computeNormals && !mesh->HasNormals()) {
+            mesh = MeshUtils::computeSmoothNormals(
+                        mesh, normalCreaseAngle, MeshUtils::NormalWeighting::Angle, &vecSourceNode
+            );
+        }
+
+        if (optimizeLayout) {
+            const std::vector<int> vecTriangleOrder = MeshUtils::vertexCacheTriangleOrder(mesh);
+            const std::vector<int> vecNewNodeIndex = MeshUtils::reorderTriangulation(mesh, vecTriangleOrder);
+            std::vector<int> vecReorderedSourceNode(vecSourceNode.size());
+            for (int n = 0; CppUtils::cmpLess(n, vecNewNodeIndex.size()); ++n)
+                vecReorderedSourceNode.at(vecNewNodeIndex.at(n) - 1) = vecSourceNode.at(n);
+
+            vecSourceNode = std::move(vecReorderedSourceNode);
+        }
+
+        return mesh;
+    };
+    this->processPureMeshTriangulations(labelEntity, fnProcess, progress);
+}
+
+void AppModule::decimatePureMesh(
+        const TDF_Label& labelEntity, const MeshDecimation::Parameters& params, TaskProgress* progress
+    )
+{
+    if (!AppModule::isPureMeshEntity(labelEntity))
+        return;
+
+    auto fnProcess = [=](
+            const Handle_Poly_Triangulation& triangulation,
+            int entityTriangleCount,
+            std::vector<int>* ptrVecSourceNode,
+            TaskProgress* meshProgress)
+    {
+        MeshDecimation::Parameters meshParams = params;
+        if (params.targetTriangleCount > 0 && entityTriangleCount > 0) {
+            const double triangleRatio = triangulation->NbTriangles() / double(entityTriangleCount);
+            meshParams.targetTriangleCount = std::max(int(params.targetTriangleCount * triangleRatio), 1);
+        }
+
+        MeshDecimation::Result result = MeshDecimation::decimate(triangulation, meshParams, meshProgress);
+        *ptrVecSourceNode = std::move(result.vecSourceNode);
+        return result.triangulation;
+    };
+    this->processPureMeshTriangulations(labelEntity, fnProcess, progress);
+}
+
+void AppModule::processPureMeshTriangulations(
+        const TDF_Label& labelEntity, const FunctionProcessTriangulation& fnProcess, TaskProgress* progress
+    )
+{
+    // Triangulations to be processed along with the faces using them, faces can share the same
+    // triangulation(eg glTF instances)
+    struct MeshItem {
+        Handle_Poly_Triangulation triangulation;
+        std::vector<TopoDS_Face> vecFace;
+        Handle_Poly_Triangulation processedTriangulation;
+        // 1-based index in 'triangulation' of each node of 'processedTriangulation'
+        std::vector<int> vecSourceNode;
+    };
+    std::vector<MeshItem> vecMeshItem;
+    std::unordered_map<const Poly_Triangulation*, std::size_t> mapMeshItemIndex;
+    int entityTriangleCount = 0;
+    BRepUtils::forEachSubFace(XCaf::shape(labelEntity), [&](const TopoDS_Face& face) {
+        TopLoc_Location loc;
+        const Handle_Poly_Triangulation& triangulation = BRep_Tool::Triangulation(face, loc);
+        if (!triangulation)
+            return;
+
+        auto [it, isNewItem] = mapMeshItemIndex.insert({ triangulation.get(), vecMeshItem.size() });
+        if (isNewItem) {
+            vecMeshItem.push_back({ triangulation, { face }, {}, {} });
+            entityTriangleCount += triangulation->NbTriangles();
+        }
+        else {
+            vecMeshItem.at(it->second).vecFace.push_back(face);
+        }
+    });
+
+    // Node colors held by the annex data are bound to the single triangulation of the entity
+    auto annexData = CafUtils::findAttribute<TriangulationAnnexData>(labelEntity);
+    const bool hasNodeColors = annexData && !annexData->nodeColors().empty();
+    if (hasNodeColors) {
+        if (vecMeshItem.size() != 1
+                || CppUtils::cmpNotEqual(annexData->nodeColors().size(), vecMeshItem.front().triangulation->NbNodes()))
+        {
+            return;
+        }
+    }
+
+    auto fnProcessItem = [&](int i, TaskProgress* meshProgress) {
+        MeshItem& item = vecMeshItem.at(i);
+        item.processedTriangulation = fnProcess(item.triangulation, entityTriangleCount, &item.vecSourceNode, meshProgress);
+    };
+
+    // TaskProgress isn't thread-safe, so progress is only reported from the calling thread: after
+    // each batch of triangulations processed concurrently
+    const int itemCount = int(vecMeshItem.size());
+    if (itemCount == 1) {
+        fnProcessItem(0, progress);
+    }
+    else {
+        constexpr int progressStepCount = 10;
+        const int batchSize = std::max(itemCount / progressStepCount, 1);
+        for (int first = 0; first < itemCount && !TaskProgress::isAbortRequested(progress); first += batchSize) {
+            const int last = std::min(first + batchSize, itemCount);
+            OSD_Parallel::For(first, last, [&](int i) { fnProcessItem(i, nullptr); });
+            if (progress)
+                progress->setValue(MathUtils::toPercent(last, 0, itemCount));
+        }
+    }
+
+    // Bind new triangulations(eg having split nodes) to the faces
+    BRep_Builder builder;
+    for (const MeshItem& item : vecMeshItem) {
+        if (item.processedTriangulation && item.processedTriangulation != item.triangulation) {
+            for (const TopoDS_Face& face : item.vecFace)
+                builder.UpdateFace(face, item.processedTriangulation);
+        }
+    }
+
+    if (hasNodeColors && vecMeshItem.front().processedTriangulation) {
+        const Span<const Quantity_Color> spanNodeColor = annexData->nodeColors();
+        const std::vector<int>& vecSourceNode = vecMeshItem.front().vecSourceNode;
+        std::vector<Quantity_Color> vecNodeColor(vecSourceNode.size());
+        for (int i = 0; CppUtils::cmpLess(i, vecSourceNode.size()); ++i)
+            vecNodeColor.at(i) = spanNodeColor[vecSourceNode.at(i) - 1];
+
+        TriangulationAnnexData::Set(labelEntity, std::move(vecNodeColor));
+    }
+}
+
+bool AppModule::isImportPostProcessRequired(IO::Format format) const
+{
+    return IO::formatProvidesMesh(format) && this->isPureMeshPostProcessRequired();
+}
+
+void AppModule::postProcessImportedEntity(const TDF_Label& labelEntity, TaskProgress* progress)
+{
+    if (AppModule::isPureMeshEntity(labelEntity))
+        this->postProcessPureMesh(labelEntity, progress);
+    else
+        this->computeBRepMesh(labelEntity, progress);
+}
+
+bool AppModule::computeBRepMeshByUnits(
+        const TopoDS_Shape& shape,
+        BRepMeshQuality quality,
+        bool withLods,
+        const std::function<bool()>& fnStop,
+        std::vector<TopoDS_Face>* ptrVecMeshedFace)
+{
+    // Count of faces meshed at once, meshes are swapped in by such batches of faces
+    constexpr int faceBatchSize = 64;
+
+    // Shape meshed at once while BRep meshes are locked, along with the parameters of its LODs
+    struct MeshUnit {
+        TopoDS_Shape shape;
+        std::vector<OccBRepMeshParameters> vecLodParams;
+    };
+
+    // Adds the faces of 'group' to mesh units, skipping faces whose triangulation already fits
+    std::vector<MeshUnit> vecUnit;
+    auto fnAddMeshUnits = [&](const TopoDS_Shape& group) {
+        auto vecParams = this->brepMeshLodParameters(group, quality);
+        if (!withLods)
+            vecParams.resize(1);
+
+        BRep_Builder builder;
+        int faceBatchCount = 0;
+        BRepUtils::forEachSubFace(group, [&](const TopoDS_Face& face) {
+            if (isBRepMeshConsistent(face, vecParams.front()))
+                return;
+
+            if (faceBatchCount == 0) {
+                TopoDS_Compound faceBatch;
+                builder.MakeCompound(faceBatch);
+                vecUnit.push_back({ faceBatch, vecParams });
+            }
+
+            builder.Add(vecUnit.back().shape, face);
+            faceBatchCount = (faceBatchCount + 1) % faceBatchSize;
+        });
+    };
+
+    if (quality == BRepMeshQuality::Adaptive)
+        forEachBRepMeshPart(shape, fnAddMeshUnits);
+    else
+        fnAddMeshUnits(shape);
+
+    for (const MeshUnit& unit : vecUnit) {
+        {
+            std::lock_guard<std::mutex> lock(m_mutexBRepMeshChange);
+            BRepUtils::computeMeshLods(unit.shape, unit.vecLodParams);
+        }
+
+        if (ptrVecMeshedFace) {
+            BRepUtils::forEachSubFace(unit.shape, [=](const TopoDS_Face& face) {
+                ptrVecMeshedFace->push_back(face);
+            });
+        }
+
+        if (fnStop && fnStop())
+            return false;
+    }
+
+    return true;
+}
+
 void AppModule::addPropertiesProvider(std::unique_ptr<DocumentTreeNodePropertiesProvider> ptr)
 {
     m_vecDocTreeNodePropsProvider.push_back(std::move(ptr));
@@ -343,6 +865,10 @@ AppModule* AppModule::get()
 
 AppModule::~AppModule()
 {
+    // Pending thumbnail writers are referring to this object
+    for (std::future<void>& writer : m_vecThumbnailWriter)
+        writer.wait();
+
     delete m_settings;
     m_settings = nullptr;
 }
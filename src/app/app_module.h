@@ -12,14 +12,18 @@
 #include "../base/document_tree_node_properties_provider.h"
 #include "../base/io_parameters_provider.h"
 #include "../base/io_system.h"
+#include "../base/mesh_decimation.h"
 #include "../base/messenger.h"
 #include "../base/occ_brep_mesh_parameters.h"
 #include "../base/property_value_conversion.h"
 #include "../base/settings.h"
 #include "../base/unit_system.h"
 
+#include <TopoDS_Face.hxx>
+#include <future>
 #include <locale>
 #include <mutex>
+#include <vector>
 
 class TDF_Label;
 class TopoDS_Shape;
@@ -80,15 +84,68 @@ public:
     // Recent files
     void prependRecentFile(const FilePath& fp);
     const RecentFile* findRecentFile(const FilePath& fp) const;
+    // Thumbnails are rendered in the calling(GUI) thread, but converted and written to the cache
+    // directory by worker threads(see RecentFile::writeThumbnail())
     void recordRecentFileThumbnail(GuiDocument* guiDoc);
     void recordRecentFileThumbnails(GuiApplication* guiApp);
     QSize recentFileThumbnailSize() const { return { 190, 150 }; }
+    // Waits for pending thumbnail writes, then deletes thumbnails no longer referenced
+    void waitForRecentFileThumbnails();
+    // Signal emitted(from a worker thread) when the thumbnail of a recent file was written
+    Signal<const FilePath&> signalRecentFileThumbnailWritten;
 
     // Meshing of BRep shapes
+    using BRepMeshQuality = AppModuleProperties::BRepMeshQuality;
     OccBRepMeshParameters brepMeshParameters(const TopoDS_Shape& shape) const;
+    OccBRepMeshParameters brepMeshParameters(const TopoDS_Shape& shape, BRepMeshQuality quality) const;
+    // Parameters of each mesh level of detail(see AppModuleProperties::meshingLodCount)
+    // First item is the finest LOD and corresponds to brepMeshParameters(shape, quality)
+    std::vector<OccBRepMeshParameters> brepMeshLodParameters(const TopoDS_Shape& shape, BRepMeshQuality quality) const;
     void computeBRepMesh(const TopoDS_Shape& shape, TaskProgress* progress = nullptr);
     void computeBRepMesh(const TDF_Label& labelEntity, TaskProgress* progress = nullptr);
 
+    // Progressive meshing of BRep shapes(see AppModuleProperties::meshingProgressive)
+    // A very coarse mesh is computed first so shapes can be displayed without delay, then
+    // refineBRepMesh() runs finer passes until target quality is reached or time budget is exhausted
+    bool isBRepMeshProgressive() const;
+    void computeBRepMeshCoarse(const TDF_Label& labelEntity, TaskProgress* progress = nullptr);
+    void refineBRepMesh(Span<const TDF_Label> spanLabelEntity, TaskProgress* progress = nullptr);
+
+    // Re-meshes the faces of BRep entities whose triangulation doesn't satisfy the current meshing
+    // settings. Faces already satisfying the settings are left untouched
+    // Returns the count of faces actually re-meshed
+    int updateBRepMesh(Span<const TDF_Label> spanLabelEntity, TaskProgress* progress = nullptr);
+
+    // Signal emitted(from the meshing thread) each time the BRep mesh of an entity was changed
+    // by refineBRepMesh() or updateBRepMesh(), along with the faces whose triangulation was replaced
+    Signal<const TDF_Label&, const std::vector<TopoDS_Face>&> signalBRepMeshChanged;
+    // Mutex held while BRep meshes are being changed, to be locked by any concurrent reader
+    // Graphics lock it through GuiApplication::brepMeshMutex()
+    std::mutex& mutexBRepMeshChange() { return m_mutexBRepMeshChange; }
+
+    // Pure meshes are the entities made of triangulations not computed from BRep shapes(eg
+    // imported from STL/OFF/PLY/glTF files)
+    static bool isPureMeshEntity(const TDF_Label& labelEntity);
+    // Returns true if some processing of imported pure meshes is enabled(see AppModuleProperties)
+    bool isPureMeshPostProcessRequired() const;
+    // Applies the processing enabled in AppModuleProperties to the triangulations of pure mesh
+    // 'labelEntity', triangulations are processed concurrently
+    void postProcessPureMesh(const TDF_Label& labelEntity, TaskProgress* progress = nullptr);
+    // Decimates the triangulations of pure mesh 'labelEntity', target triangle count of 'params' is
+    // spread over the triangulations according to their triangle counts. Node colors are kept
+    void decimatePureMesh(
+            const TDF_Label& labelEntity,
+            const MeshDecimation::Parameters& params,
+            TaskProgress* progress = nullptr
+    );
+
+    // Post-processing of the entities imported with IO::System::importInDocument()
+    // BRep shapes are meshed with computeBRepMesh(), pure meshes are processed with postProcessPureMesh()
+    // isImportPostProcessRequired() only tells if pure meshes of 'format' have to be processed, BRep
+    // meshing being up to the caller(eg not needed when converting files)
+    bool isImportPostProcessRequired(IO::Format format) const;
+    void postProcessImportedEntity(const TDF_Label& labelEntity, TaskProgress* progress = nullptr);
+
     // Providers to query document tree node properties
     void addPropertiesProvider(std::unique_ptr<DocumentTreeNodePropertiesProvider> ptr);
     std::unique_ptr<PropertyGroupSignals> properties(const DocumentTreeNode& treeNode) const;
@@ -110,6 +167,38 @@ public:
 
 private:
     AppModule();
+
+    // Meshes 'shape' by small units(batches of faces or parts), BRep meshes are locked while each
+    // unit is meshed so readers aren't blocked for too long
+    // Faces actually meshed are added to 'ptrVecMeshedFace'(if not null)
+    // Returns false if meshing was stopped because 'fnStop' returned true
+    bool computeBRepMeshByUnits(
+            const TopoDS_Shape& shape,
+            BRepMeshQuality quality,
+            bool withLods,
+            const std::function<bool()>& fnStop,
+            std::vector<TopoDS_Face>* ptrVecMeshedFace = nullptr
+    );
+
+    // Replaces the triangulations of pure mesh 'labelEntity' by the ones returned by 'fnProcess',
+    // which is called concurrently for each triangulation. 'fnProcess' receives the count of triangles
+    // of the entity and has to fill the 1-based index of the source node of each output node, this is
+    // used to remap node colors. Null triangulations returned are ignored(eg abort requested)
+    // Progress passed to 'fnProcess' is null unless the entity has a single triangulation
+    using FunctionProcessTriangulation = std::function<Handle_Poly_Triangulation(
+            const Handle_Poly_Triangulation& triangulation,
+            int entityTriangleCount,
+            std::vector<int>* ptrVecSourceNode,
+            TaskProgress* progress
+    )>;
+    void processPureMeshTriangulations(
+            const TDF_Label& labelEntity, const FunctionProcessTriangulation& fnProcess, TaskProgress* progress
+    );
+
+    // Renders thumbnail of 'guiDoc' and queues a worker writing it to the file associated with
+    // 'recentFile'
+    bool startRecentFileThumbnailWrite(const RecentFile& recentFile, GuiDocument* guiDoc);
+
     AppModule(const AppModule&) = delete; // Not copyable
     AppModule& operator=(const AppModule&) = delete; // Not copyable
 
@@ -118,6 +207,9 @@ private:
     AppModuleProperties m_props;
     std::vector<Message> m_messageLog;
     std::mutex m_mutexMessageLog;
+    std::mutex m_mutexBRepMeshChange;
+    std::mutex m_mutexThumbnailWriter;
+    std::vector<std::future<void>> m_vecThumbnailWriter;
     std::locale m_stdLocale;
     QLocale m_qtLocale;
     std::vector<std::unique_ptr<DocumentTreeNodePropertiesProvider>> m_vecDocTreeNodePropsProvider;
@@ -11,6 +11,7 @@
 #include "../base/io_writer.h"
 #include "../base/io_system.h"
 #include "../base/settings.h"
+#include "../base/tkernel_utils.h"
 #include "../base/unit_system.h"
 #include "../graphics/graphics_mesh_object_driver.h"
 
@@ -27,6 +28,7 @@ AppModuleProperties::AppModuleProperties(Settings* settings)
     const auto groupId_graphics = settings->addGroup(textId("graphics"));
 
     const auto sectionId_systemUnits = settings->addSection(this->groupId_system, textId("units"));
+    const auto sectionId_meshingPureMeshes = settings->addSection(groupId_meshing, textId("pureMeshes"));
     const auto sectionId_graphicsClipPlanes = settings->addSection(groupId_graphics, textId("clipPlanes"));
     const auto sectionId_graphicsMeshDefaults = settings->addSection(groupId_graphics, textId("meshDefaults"));
 
@@ -57,6 +59,27 @@ AppModuleProperties::AppModuleProperties(Settings* settings)
     settings->addSetting(&this->meshingChordalDeflection, groupId_meshing);
     settings->addSetting(&this->meshingAngularDeflection, groupId_meshing);
     settings->addSetting(&this->meshingRelative, groupId_meshing);
+    settings->addSetting(&this->meshingProgressive, groupId_meshing);
+    settings->addSetting(&this->meshingProgressiveTimeBudget, groupId_meshing);
+    settings->addSetting(&this->meshingLodCount, groupId_meshing);
+    this->meshingLodCount.setRange(1, 4);
+    this->meshingLodCount.setSingleStep(1);
+    this->meshingLodCount.setConstraintsEnabled(true);
+#if OCC_VERSION_HEX < OCC_VERSION_CHECK(7, 6, 0)
+    this->meshingLodCount.setEnabled(false);
+#endif
+    settings->addSetting(&this->meshingMemoryBudget, groupId_meshing);
+    this->meshingMemoryBudget.setRange(0, 1024 * 1024);
+    this->meshingMemoryBudget.setSingleStep(64);
+    this->meshingMemoryBudget.setConstraintsEnabled(true);
+    // -- Pure meshes
+    settings->addSetting(&this->pureMeshOptimizeLayout, sectionId_meshingPureMeshes);
+    settings->addSetting(&this->pureMeshComputeNormals, sectionId_meshingPureMeshes);
+    settings->addSetting(&this->pureMeshNormalCreaseAngle, sectionId_meshingPureMeshes);
+    settings->addSetting(&this->pureMeshLodCount, sectionId_meshingPureMeshes);
+    this->pureMeshLodCount.setRange(1, 4);
+    this->pureMeshLodCount.setSingleStep(1);
+    this->pureMeshLodCount.setConstraintsEnabled(true);
 
     // Graphics
     settings->addSetting(&this->navigationStyle, groupId_graphics);
@@ -101,6 +124,16 @@ AppModuleProperties::AppModuleProperties(Settings* settings)
         this->meshingChordalDeflection.setQuantity(1 * Quantity_Millimeter);
         this->meshingAngularDeflection.setQuantity(20 * Quantity_Degree);
         this->meshingRelative.setValue(false);
+        this->meshingProgressive.setValue(false);
+        this->meshingProgressiveTimeBudget.setQuantity(60 * Quantity_Second);
+        this->meshingLodCount.setValue(1);
+        this->meshingMemoryBudget.setValue(0);
+    });
+    settings->addResetFunction(sectionId_meshingPureMeshes, [=]{
+        this->pureMeshOptimizeLayout.setValue(true);
+        this->pureMeshComputeNormals.setValue(true);
+        this->pureMeshNormalCreaseAngle.setQuantity(30 * Quantity_Degree);
+        this->pureMeshLodCount.setValue(GraphicsMeshObjectDriver::DefaultValues{}.levelOfDetailCount);
     });
     settings->addResetFunction(sectionId_graphicsClipPlanes, [=]{
         this->clipPlanesCappingOn.setValue(true);
@@ -176,7 +209,10 @@ void AppModuleProperties::retranslate()
 
     // Meshing
     this->meshingQuality.setDescription(
-                textIdTr("Controls precision of the mesh to be computed from the BRep shape"));
+                textIdTr("Controls precision of the mesh to be computed from the BRep shape\n\n"
+                         "With `Adaptive` the deflection is computed for each part(solid, free shell or "
+                         "free face) from its own extent instead of the extent of the whole shape, so "
+                         "small parts of large assemblies get a finer mesh"));
     this->meshingChordalDeflection.setDescription(
                 textIdTr("For the tessellation of faces the chordal deflection limits the distance between "
                          "a curve and its tessellation"));
@@ -188,6 +224,44 @@ void AppModuleProperties::retranslate()
                          "If activated, deflection used for the polygonalisation of each edge will be "
                          "`ChordalDeflection` &#215; `SizeOfEdge`. The deflection used for the faces will be "
                          "the maximum deflection of their edges."));
+    this->meshingProgressive.setDescription(
+                textIdTr("Compute first a very coarse mesh of the BRep shapes so they can be displayed "
+                         "without delay, then refine the mesh in background until the target precision "
+                         "is reached"));
+    this->meshingProgressiveTimeBudget.setDescription(
+                textIdTr("Maximum time spent in background to refine the meshes of imported BRep shapes. "
+                         "Refinement stops when this time budget is exhausted"));
+    this->meshingLodCount.setDescription(
+                textIdTr("Count of mesh levels of detail(LOD) computed for each face of BRep shapes.\n\n"
+                         "Each additional LOD is coarser than the previous one, the 3D view then selects "
+                         "the LOD of each object from its size on screen. Value `1` disables LODs.\n\n"
+                         "This option is applicable when OpenCascade ≥ 7.6 version"));
+    this->meshingMemoryBudget.setDescription(
+                textIdTr("Maximum memory(in megabytes) used by the meshes of BRep shapes. Value `0` means "
+                         "no limit.\n\n"
+                         "When exceeded, the meshes of the parts hidden in the 3D view are released, "
+                         "starting from the ones hidden for the longest time. Released meshes are "
+                         "computed again once the parts are shown back"));
+
+    // -- Meshing/PureMeshes
+    this->pureMeshOptimizeLayout.setDescription(
+                textIdTr("Reorder the triangles and nodes of imported meshes(eg STL, OFF, PLY files) so "
+                         "consecutive triangles share most of their nodes.\n\n"
+                         "This improves the efficiency of the caches of the graphics card and processor, "
+                         "so display and processing of the meshes are faster"));
+    this->pureMeshComputeNormals.setDescription(
+                textIdTr("Compute once the normals at the nodes of imported meshes not providing them(eg "
+                         "STL, OFF files). Normals are then used for smooth shading in the 3D view and "
+                         "are written by exporters supporting them(eg PLY, glTF, OBJ)"));
+    this->pureMeshNormalCreaseAngle.setDescription(
+                textIdTr("Maximum angle between adjacent triangles for their normals to be smoothed.\n\n"
+                         "Nodes shared by triangles forming a greater angle are duplicated, so sharp edges "
+                         "are kept"));
+    this->pureMeshLodCount.setDescription(
+                textIdTr("Count of levels of detail(LOD) of meshes displayed in the 3D view.\n\n"
+                         "Coarser LODs are computed by decimation of the meshes, each one having about 4 "
+                         "times fewer triangles than the previous one. The 3D view then selects the LOD of "
+                         "each mesh from its size on screen. Value `1` disables LODs"));
 
     // Graphics
     this->navigationStyle.setDescription(
@@ -227,6 +301,17 @@ void AppModuleProperties::onPropertyChanged(Property* prop)
         this->meshingAngularDeflection.setEnabled(isUserDefined);
         this->meshingRelative.setEnabled(isUserDefined);
     }
+    else if (prop == &this->meshingProgressive) {
+        this->meshingProgressiveTimeBudget.setEnabled(this->meshingProgressive.value());
+    }
+    else if (prop == &this->pureMeshComputeNormals) {
+        this->pureMeshNormalCreaseAngle.setEnabled(this->pureMeshComputeNormals.value());
+    }
+    else if (prop == &this->pureMeshLodCount) {
+        auto values = GraphicsMeshObjectDriver::defaultValues();
+        values.levelOfDetailCount = this->pureMeshLodCount.value();
+        GraphicsMeshObjectDriver::setDefaultValues(values);
+    }
 
     PropertyGroup::onPropertyChanged(prop);
 }
@@ -54,11 +54,20 @@ public:
     PropertyBool linkWithDocumentSelector{ this, textId("linkWithDocumentSelector") };
     PropertyBool forceOpenGlFallbackWidget{ this, textId("forceOpenGlFallbackWidget") };
     // Meshing
-    enum class BRepMeshQuality { VeryCoarse, Coarse, Normal, Precise, VeryPrecise, UserDefined };
+    enum class BRepMeshQuality { VeryCoarse, Coarse, Normal, Precise, VeryPrecise, Adaptive, UserDefined };
     PropertyEnum<BRepMeshQuality> meshingQuality{ this, textId("meshingQuality") };
     PropertyLength meshingChordalDeflection{ this, textId("meshingChordalDeflection") };
     PropertyAngle meshingAngularDeflection{ this, textId("meshingAngularDeflection") };
     PropertyBool meshingRelative{ this, textId("meshingRelative") };
+    PropertyBool meshingProgressive{ this, textId("meshingProgressive") };
+    PropertyTime meshingProgressiveTimeBudget{ this, textId("meshingProgressiveTimeBudget") };
+    PropertyInt meshingLodCount{ this, textId("meshingLodCount") };
+    PropertyInt meshingMemoryBudget{ this, textId("meshingMemoryBudget") };
+    // -- Meshing/PureMeshes
+    PropertyBool pureMeshOptimizeLayout{ this, textId("optimizeLayout") };
+    PropertyBool pureMeshComputeNormals{ this, textId("computeNormals") };
+    PropertyAngle pureMeshNormalCreaseAngle{ this, textId("normalCreaseAngle") };
+    PropertyInt pureMeshLodCount{ this, textId("lodCount") };
     // Graphics
     PropertyEnum<WidgetOccViewController::NavigationStyle> navigationStyle{ this, textId("navigationStyle") };
     PropertyBool defaultShowOriginTrihedron{ this, textId("defaultShowOriginTrihedron") };
@@ -0,0 +1,378 @@
+/****************************************************************************
+** Copyright (c) 2021, Fougue Ltd. <http://www.fougue.pro>
+** All rights reserved.
+** See license at https://github.com/fougue/mayo/blob/master/LICENSE.txt
+****************************************************************************/
+
+#include "brep_mesh_memory_budget.h"
+
+#include "../base/application.h"
+#include "../base/brep_utils.h"
+#include "../base/task_manager.h"
+#include "../base/task_progress.h"
+#include "../base/xcaf.h"
+#include "../gui/gui_application.h"
+#include "app_module.h"
+
+#include <AIS_ConnectedInteractive.hxx>
+#include <BRepTools.hxx>
+#include <algorithm>
+#include <mutex>
+#include <unordered_set>
+
+namespace Mayo {
+
+BRepMeshMemoryBudget::BRepMeshMemoryBudget(GuiApplication* guiApp, TaskManager* taskMgr)
+    : m_guiApp(guiApp),
+      m_taskMgr(taskMgr)
+{
+    guiApp->signalGuiDocumentAdded.connectSlot(&BRepMeshMemoryBudget::onGuiDocumentAdded, this);
+    guiApp->signalGuiDocumentErased.connectSlot(&BRepMeshMemoryBudget::onGuiDocumentErased, this);
+    m_signalProductReloaded.connectSlot(&BRepMeshMemoryBudget::onProductReloaded, this);
+    AppModule::get()->signalBRepMeshChanged.connectSlot(&BRepMeshMemoryBudget::onBRepMeshChanged, this);
+    for (GuiDocument* guiDoc : guiApp->guiDocuments())
+        this->onGuiDocumentAdded(guiDoc);
+}
+
+std::size_t BRepMeshMemoryBudget::budget() const
+{
+    const int budgetMegaBytes = AppModule::get()->properties()->meshingMemoryBudget.value();
+    return std::size_t(std::max(budgetMegaBytes, 0)) * 1024 * 1024;
+}
+
+std::size_t BRepMeshMemoryBudget::memoryUsage() const
+{
+    return m_memoryUsage;
+}
+
+void BRepMeshMemoryBudget::enforce()
+{
+    const std::size_t budget = this->budget();
+    if (budget == 0 || m_memoryUsage <= budget)
+        return;
+
+    std::vector<Product> vecHiddenProduct;
+    for (const auto& [docId, docIndex] : m_mapDocumentIndex) {
+        for (const auto& [label, product] : docIndex.mapHiddenProduct)
+            vecHiddenProduct.push_back(product);
+    }
+
+    // Products hidden for the longest time are evicted first
+    std::sort(
+                vecHiddenProduct.begin(), vecHiddenProduct.end(),
+                [](const Product& lhs, const Product& rhs) { return lhs.timeHidden < rhs.timeHidden; }
+    );
+    for (const Product& product : vecHiddenProduct) {
+        if (m_memoryUsage <= budget)
+            break;
+
+        this->evict(product); // Updates memory usage
+        DocumentIndex& docIndex = m_mapDocumentIndex[product.docId];
+        docIndex.mapHiddenProduct.erase(product.label);
+        docIndex.mapEvictedProduct.insert({ product.label, product });
+    }
+}
+
+void BRepMeshMemoryBudget::onGuiDocumentAdded(GuiDocument* guiDoc)
+{
+    const DocumentPtr& doc = guiDoc->document();
+    for (int i = 0; i < doc->entityCount(); ++i)
+        this->indexEntity(doc, doc->entityTreeNodeId(i));
+
+    const Document::Identifier docId = doc->identifier();
+    doc->signalEntityAdded.connectSlot([=](TreeNodeId entityTreeNodeId) {
+        const DocumentPtr doc = m_guiApp->application()->findDocumentByIdentifier(docId);
+        if (doc)
+            this->indexEntity(doc, entityTreeNodeId);
+    });
+    doc->signalEntityAboutToBeDestroyed.connectSlot([=](TreeNodeId entityTreeNodeId) {
+        this->unindexEntity(docId, entityTreeNodeId);
+    });
+    guiDoc->signalNodesVisibilityChanged.connectSlot([=](const GuiDocument::MapVisibilityByTreeNodeId& mapNodeId) {
+        this->onNodesVisibilityChanged(guiDoc, mapNodeId);
+    });
+}
+
+void BRepMeshMemoryBudget::onGuiDocumentErased(GuiDocument* guiDoc)
+{
+    // Hidden and evicted products of the document are erased along with its index
+    const Document::Identifier docId = guiDoc->document()->identifier();
+    auto itDocIndex = m_mapDocumentIndex.find(docId);
+    if (itDocIndex != m_mapDocumentIndex.end()) {
+        for (const auto& [entityTreeNodeId, entity] : itDocIndex->second.mapEntity)
+            m_memoryUsage -= std::min(m_memoryUsage, entity.memorySize);
+
+        m_mapDocumentIndex.erase(itDocIndex);
+    }
+}
+
+void BRepMeshMemoryBudget::onNodesVisibilityChanged(
+        GuiDocument* guiDoc, const GuiDocument::MapVisibilityByTreeNodeId& mapNodeId)
+{
+    const DocumentPtr& doc = guiDoc->document();
+    const Tree<TDF_Label>& modelTree = doc->modelTree();
+    DocumentIndex& docIndex = m_mapDocumentIndex[doc->identifier()];
+
+    // Products whose graphics might have been shown or hidden
+    std::vector<Product> vecProduct;
+    std::unordered_set<TDF_Label> setProductLabel;
+    for (const auto& [nodeId, state] : mapNodeId) {
+        MAYO_UNUSED(state);
+        const TDF_Label& label = modelTree.nodeData(nodeId);
+        if (!modelTree.nodeIsLeaf(nodeId) || !XCaf::isShape(label))
+            continue;
+
+        if (setProductLabel.insert(label).second) {
+            const TDF_Label labelEntity = modelTree.nodeData(modelTree.nodeRoot(nodeId));
+            vecProduct.push_back({ doc->identifier(), labelEntity, label, Clock::now() });
+        }
+    }
+
+    std::vector<Product> vecProductToReload;
+    for (const Product& product : vecProduct) {
+        auto itHidden = docIndex.mapHiddenProduct.find(product.label);
+        auto itEvicted = docIndex.mapEvictedProduct.find(product.label);
+        if (this->isProductHidden(guiDoc, product.label)) {
+            if (itHidden == docIndex.mapHiddenProduct.end() && itEvicted == docIndex.mapEvictedProduct.end())
+                docIndex.mapHiddenProduct.insert({ product.label, product });
+        }
+        else if (itHidden != docIndex.mapHiddenProduct.end()) {
+            docIndex.mapHiddenProduct.erase(itHidden);
+        }
+        else if (itEvicted != docIndex.mapEvictedProduct.end()) {
+            vecProductToReload.push_back(itEvicted->second);
+            docIndex.mapEvictedProduct.erase(itEvicted);
+        }
+    }
+
+    this->reload(vecProductToReload);
+    this->enforce();
+}
+
+void BRepMeshMemoryBudget::onProductReloaded(const Product& product)
+{
+    GuiDocument* guiDoc = this->findGuiDocument(product.docId);
+    if (!guiDoc)
+        return;
+
+    EntityIndex* entity = this->findEntityIndex(product.docId, product.labelEntity);
+    if (entity)
+        this->addEntityMemorySize(entity, std::ptrdiff_t(this->triangulationMemorySize(product.label)));
+
+    const std::vector<TreeNodeId>& vecNodeId = this->findProductNodes(product.docId, product.label);
+    setProductAutoTriangulation(guiDoc, vecNodeId, true);
+    for (TreeNodeId nodeId : vecNodeId)
+        guiDoc->recomputeGraphics(nodeId);
+}
+
+GuiDocument* BRepMeshMemoryBudget::findGuiDocument(Document::Identifier docId) const
+{
+    const DocumentPtr doc = m_guiApp->application()->findDocumentByIdentifier(docId);
+    return doc ? m_guiApp->findGuiDocument(doc) : nullptr;
+}
+
+void BRepMeshMemoryBudget::onBRepMeshChanged(const TDF_Label& labelEntity, const std::vector<TopoDS_Face>& vecFace)
+{
+    MAYO_UNUSED(vecFace);
+    for (const auto& [docId, docIndex] : m_mapDocumentIndex) {
+        EntityIndex* entity = this->findEntityIndex(docId, labelEntity);
+        if (entity) {
+            const std::size_t memorySize = this->triangulationMemorySize(labelEntity);
+            this->addEntityMemorySize(entity, std::ptrdiff_t(memorySize) - std::ptrdiff_t(entity->memorySize));
+            return;
+        }
+    }
+}
+
+void BRepMeshMemoryBudget::indexEntity(const DocumentPtr& doc, TreeNodeId entityTreeNodeId)
+{
+    DocumentIndex& docIndex = m_mapDocumentIndex[doc->identifier()];
+    if (docIndex.mapEntity.find(entityTreeNodeId) != docIndex.mapEntity.cend())
+        return; // Already indexed
+
+    const Tree<TDF_Label>& modelTree = doc->modelTree();
+    EntityIndex entity;
+    entity.label = modelTree.nodeData(entityTreeNodeId);
+    if (!XCaf::isShape(entity.label))
+        return;
+
+    traverseTree(entityTreeNodeId, modelTree, [&](TreeNodeId nodeId) {
+        const TDF_Label& label = modelTree.nodeData(nodeId);
+        if (modelTree.nodeIsLeaf(nodeId) && XCaf::isShape(label)) {
+            entity.vecProductNode.push_back({ label, nodeId });
+            docIndex.mapProductNodes[label].push_back(nodeId);
+        }
+    });
+
+    entity.memorySize = this->triangulationMemorySize(entity.label);
+    m_memoryUsage += entity.memorySize;
+    docIndex.mapEntityNode.insert({ entity.label, entityTreeNodeId });
+    docIndex.mapEntity.insert({ entityTreeNodeId, std::move(entity) });
+}
+
+void BRepMeshMemoryBudget::unindexEntity(Document::Identifier docId, TreeNodeId entityTreeNodeId)
+{
+    auto itDocIndex = m_mapDocumentIndex.find(docId);
+    if (itDocIndex == m_mapDocumentIndex.end())
+        return;
+
+    DocumentIndex& docIndex = itDocIndex->second;
+    auto itEntity = docIndex.mapEntity.find(entityTreeNodeId);
+    if (itEntity == docIndex.mapEntity.end())
+        return;
+
+    const EntityIndex& entity = itEntity->second;
+    for (const auto& [label, nodeId] : entity.vecProductNode) {
+        auto itProduct = docIndex.mapProductNodes.find(label);
+        if (itProduct == docIndex.mapProductNodes.end())
+            continue;
+
+        std::vector<TreeNodeId>& vecNodeId = itProduct->second;
+        vecNodeId.erase(std::remove(vecNodeId.begin(), vecNodeId.end(), nodeId), vecNodeId.end());
+        if (vecNodeId.empty())
+            docIndex.mapProductNodes.erase(itProduct);
+    }
+
+    // Forget about the products of the entity, their labels are about to be destroyed
+    auto fnEraseEntityProduct = [&](std::unordered_map<TDF_Label, Product>& mapProduct, const TDF_Label& label) {
+        auto itProduct = mapProduct.find(label);
+        if (itProduct != mapProduct.end() && itProduct->second.labelEntity == entity.label)
+            mapProduct.erase(itProduct);
+    };
+    for (const auto& [label, nodeId] : entity.vecProductNode) {
+        MAYO_UNUSED(nodeId);
+        fnEraseEntityProduct(docIndex.mapHiddenProduct, label);
+        fnEraseEntityProduct(docIndex.mapEvictedProduct, label);
+    }
+
+    m_memoryUsage -= std::min(m_memoryUsage, entity.memorySize);
+    docIndex.mapEntityNode.erase(entity.label);
+    docIndex.mapEntity.erase(itEntity);
+}
+
+BRepMeshMemoryBudget::EntityIndex* BRepMeshMemoryBudget::findEntityIndex(
+        Document::Identifier docId, const TDF_Label& labelEntity)
+{
+    auto itDocIndex = m_mapDocumentIndex.find(docId);
+    if (itDocIndex == m_mapDocumentIndex.end())
+        return nullptr;
+
+    DocumentIndex& docIndex = itDocIndex->second;
+    auto itEntityNode = docIndex.mapEntityNode.find(labelEntity);
+    if (itEntityNode == docIndex.mapEntityNode.end())
+        return nullptr;
+
+    auto itEntity = docIndex.mapEntity.find(itEntityNode->second);
+    return itEntity != docIndex.mapEntity.end() ? &itEntity->second : nullptr;
+}
+
+void BRepMeshMemoryBudget::addEntityMemorySize(EntityIndex* entity, std::ptrdiff_t delta)
+{
+    // Products sharing faces might be counted twice, so sizes are kept positive
+    const std::size_t entitySize = std::size_t(std::max<std::ptrdiff_t>(std::ptrdiff_t(entity->memorySize) + delta, 0));
+    m_memoryUsage -= std::min(m_memoryUsage, entity->memorySize);
+    m_memoryUsage += entitySize;
+    entity->memorySize = entitySize;
+}
+
+std::size_t BRepMeshMemoryBudget::triangulationMemorySize(const TDF_Label& label) const
+{
+    std::lock_guard<std::mutex> lock(AppModule::get()->mutexBRepMeshChange());
+    return BRepUtils::triangulationMemorySize(XCaf::shape(label));
+}
+
+const std::vector<TreeNodeId>& BRepMeshMemoryBudget::findProductNodes(
+        Document::Identifier docId, const TDF_Label& label) const
+{
+    static const std::vector<TreeNodeId> vecEmpty;
+    auto itDocIndex = m_mapDocumentIndex.find(docId);
+    if (itDocIndex == m_mapDocumentIndex.cend())
+        return vecEmpty;
+
+    auto itProduct = itDocIndex->second.mapProductNodes.find(label);
+    return itProduct != itDocIndex->second.mapProductNodes.cend() ? itProduct->second : vecEmpty;
+}
+
+bool BRepMeshMemoryBudget::isProductHidden(const GuiDocument* guiDoc, const TDF_Label& label) const
+{
+    const std::vector<TreeNodeId>& vecNodeId = this->findProductNodes(guiDoc->document()->identifier(), label);
+    return std::all_of(vecNodeId.cbegin(), vecNodeId.cend(), [=](TreeNodeId nodeId) {
+        return guiDoc->nodeVisibleState(nodeId) == CheckState::Off;
+    });
+}
+
+void BRepMeshMemoryBudget::setProductAutoTriangulation(
+        GuiDocument* guiDoc, Span<const TreeNodeId> spanNodeId, bool on)
+{
+    // Automatic triangulation has to be disabled for evicted products, otherwise the computation of
+    // the graphics presentation would re-mesh the BRep shape right away
+    for (TreeNodeId nodeId : spanNodeId) {
+        guiDoc->foreachGraphicsObject(nodeId, [=](GraphicsObjectPtr object) {
+            auto aisLink = Handle_AIS_ConnectedInteractive::DownCast(object);
+            const GraphicsObjectPtr objectProduct =
+                    aisLink && aisLink->HasConnection() ? aisLink->ConnectedTo() : object;
+            objectProduct->Attributes()->SetAutoTriangulation(on);
+        });
+    }
+}
+
+void BRepMeshMemoryBudget::evict(const Product& product)
+{
+    GuiDocument* guiDoc = this->findGuiDocument(product.docId);
+    if (!guiDoc)
+        return;
+
+    std::size_t productMemorySize = 0;
+    {
+        std::lock_guard<std::mutex> lock(AppModule::get()->mutexBRepMeshChange());
+        const TopoDS_Shape shape = XCaf::shape(product.label);
+        productMemorySize = BRepUtils::triangulationMemorySize(shape);
+        BRepTools::Clean(shape);
+    }
+
+    EntityIndex* entity = this->findEntityIndex(product.docId, product.labelEntity);
+    if (entity)
+        this->addEntityMemorySize(entity, -std::ptrdiff_t(productMemorySize));
+
+    // Release graphics data(GPU buffers) of the product
+    const std::vector<TreeNodeId>& vecNodeId = this->findProductNodes(product.docId, product.label);
+    setProductAutoTriangulation(guiDoc, vecNodeId, false);
+    for (TreeNodeId nodeId : vecNodeId)
+        guiDoc->recomputeGraphics(nodeId);
+}
+
+void BRepMeshMemoryBudget::reload(const std::vector<Product>& vecProduct)
+{
+    if (vecProduct.empty())
+        return;
+
+    const TaskId taskId = m_taskMgr->newTask([=](TaskProgress* progress) {
+        AppModule* appModule = AppModule::get();
+        const auto quality = appModule->properties()->meshingQuality.value();
+        for (const Product& product : vecProduct) {
+            if (TaskProgress::isAbortRequested(progress))
+                return;
+
+            // Mesh parameters are deduced from the entity shape so the product gets the same mesh
+            // as when the entity was imported
+            const bool isAdaptive = quality == AppModule::BRepMeshQuality::Adaptive;
+            const TopoDS_Shape productShape = XCaf::shape(product.label);
+            const TopoDS_Shape paramsShape = isAdaptive ? productShape : XCaf::shape(product.labelEntity);
+            TaskProgress productProgress(progress, 100. / vecProduct.size());
+            {
+                std::lock_guard<std::mutex> lock(appModule->mutexBRepMeshChange());
+                BRepUtils::computeMeshLods(
+                            productShape,
+                            appModule->brepMeshLodParameters(paramsShape, quality),
+                            &productProgress
+                );
+            }
+
+            m_signalProductReloaded.send(product);
+        }
+    });
+    m_taskMgr->setTitle(taskId, BRepMeshMemoryBudget::textIdTr("Reload BRep meshes"));
+    m_taskMgr->run(taskId);
+}
+
+} // namespace Mayo
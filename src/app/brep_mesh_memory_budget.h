@@ -0,0 +1,105 @@
+/****************************************************************************
+** Copyright (c) 2021, Fougue Ltd. <http://www.fougue.pro>
+** All rights reserved.
+** See license at https://github.com/fougue/mayo/blob/master/LICENSE.txt
+****************************************************************************/
+
+#pragma once
+
+#include "../base/caf_utils.h"
+#include "../base/document.h"
+#include "../base/signal.h"
+#include "../base/text_id.h"
+#include "../gui/gui_document.h"
+
+#include <TDF_Label.hxx>
+#include <TopoDS_Face.hxx>
+#include <chrono>
+#include <cstddef>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace Mayo {
+
+class GuiApplication;
+class TaskManager;
+
+// Keeps the memory used by the BRep triangulations of opened documents within a budget
+// (see AppModuleProperties::meshingMemoryBudget)
+// When the budget is exceeded, the triangulations of the products hidden in the 3D view are dropped
+// along with their graphics, products hidden for the longest time are dropped first
+// Dropped triangulations are recomputed in background as soon as the products are shown again
+// Products and triangulation memory sizes are indexed when entities are added to documents and
+// updated incrementally, so the model trees are never scanned entirely
+class BRepMeshMemoryBudget {
+    MAYO_DECLARE_TEXT_ID_FUNCTIONS(Mayo::BRepMeshMemoryBudget)
+public:
+    BRepMeshMemoryBudget(GuiApplication* guiApp, TaskManager* taskMgr);
+
+    // Not copyable
+    BRepMeshMemoryBudget(const BRepMeshMemoryBudget&) = delete;
+    BRepMeshMemoryBudget& operator=(const BRepMeshMemoryBudget&) = delete;
+
+    // Memory budget in bytes, zero if unlimited
+    std::size_t budget() const;
+
+    // Estimated memory used by the BRep triangulations of all opened documents, in bytes
+    std::size_t memoryUsage() const;
+
+    // Drops triangulations of hidden products until memory usage fits within the budget
+    void enforce();
+
+private:
+    using Clock = std::chrono::steady_clock;
+    struct Product {
+        Document::Identifier docId;
+        TDF_Label labelEntity;
+        TDF_Label label;
+        Clock::time_point timeHidden;
+    };
+
+    struct EntityIndex {
+        TDF_Label label;
+        std::size_t memorySize = 0; // Of BRep triangulations
+        std::vector<std::pair<TDF_Label, TreeNodeId>> vecProductNode;
+    };
+
+    struct DocumentIndex {
+        std::unordered_map<TreeNodeId, EntityIndex> mapEntity;
+        std::unordered_map<TDF_Label, TreeNodeId> mapEntityNode;
+        std::unordered_map<TDF_Label, std::vector<TreeNodeId>> mapProductNodes;
+        // Hidden products whose triangulations are still loaded, and evicted ones
+        std::unordered_map<TDF_Label, Product> mapHiddenProduct;
+        std::unordered_map<TDF_Label, Product> mapEvictedProduct;
+    };
+
+    void onGuiDocumentAdded(GuiDocument* guiDoc);
+    void onGuiDocumentErased(GuiDocument* guiDoc);
+    void onNodesVisibilityChanged(GuiDocument* guiDoc, const GuiDocument::MapVisibilityByTreeNodeId& mapNodeId);
+    void onProductReloaded(const Product& product);
+    void onBRepMeshChanged(const TDF_Label& labelEntity, const std::vector<TopoDS_Face>& vecFace);
+
+    void indexEntity(const DocumentPtr& doc, TreeNodeId entityTreeNodeId);
+    void unindexEntity(Document::Identifier docId, TreeNodeId entityTreeNodeId);
+    EntityIndex* findEntityIndex(Document::Identifier docId, const TDF_Label& labelEntity);
+    // Adds 'delta' to the memory size of the entity and to the total memory usage
+    void addEntityMemorySize(EntityIndex* entity, std::ptrdiff_t delta);
+    std::size_t triangulationMemorySize(const TDF_Label& label) const;
+
+    GuiDocument* findGuiDocument(Document::Identifier docId) const;
+    const std::vector<TreeNodeId>& findProductNodes(Document::Identifier docId, const TDF_Label& label) const;
+    bool isProductHidden(const GuiDocument* guiDoc, const TDF_Label& label) const;
+    static void setProductAutoTriangulation(GuiDocument* guiDoc, Span<const TreeNodeId> spanNodeId, bool on);
+
+    void evict(const Product& product);
+    void reload(const std::vector<Product>& vecProduct);
+
+    GuiApplication* m_guiApp = nullptr;
+    TaskManager* m_taskMgr = nullptr;
+    std::unordered_map<Document::Identifier, DocumentIndex> m_mapDocumentIndex;
+    std::size_t m_memoryUsage = 0;
+    Signal<const Product&> m_signalProductReloaded;
+};
+
+} // namespace Mayo
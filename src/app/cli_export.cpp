@@ -119,15 +119,34 @@ bool importInDocument(DocumentPtr doc, const CliExportArgs& args, Helper* helper
             break; // Interrupt
     }
 
+    MeshDecimation::Parameters decimationParams;
+    decimationParams.targetTriangleCount = args.decimationTargetTriangleCount;
+    decimationParams.maxError = args.decimationMaxError;
+    const bool decimationRequired = decimationParams.targetTriangleCount > 0 || decimationParams.maxError >= 0;
+
     ErrorMessageCollect errorCollect;
     const bool okImport = appModule->ioSystem()->importInDocument()
         .targetDocument(doc)
         .withFilepaths(args.filesToOpen)
         .withParametersProvider(appModule)
         .withEntityPostProcess([=](TDF_Label labelEntity, TaskProgress* progress) {
-            appModule->computeBRepMesh(labelEntity, progress);
+            if (decimationRequired) {
+                TaskProgress decimationProgress(progress, 50);
+                appModule->decimatePureMesh(labelEntity, decimationParams, &decimationProgress);
+            }
+
+            // BRep shapes are meshed only if the export needs it
+            TaskProgress postProcessProgress(progress, decimationRequired ? 50 : 100);
+            if (AppModule::isPureMeshEntity(labelEntity))
+                appModule->postProcessPureMesh(labelEntity, &postProcessProgress);
+            else if (brepMeshRequired)
+                appModule->computeBRepMesh(labelEntity, &postProcessProgress);
+        })
+        .withEntityPostProcessRequiredIf([=](IO::Format format) {
+            return brepMeshRequired
+                    || (decimationRequired && IO::formatProvidesMesh(format))
+                    || appModule->isImportPostProcessRequired(format);
         })
-        .withEntityPostProcessRequiredIf([=](IO::Format){ return brepMeshRequired; })
         .withEntityPostProcessInfoProgress(20, CliExport::textIdTr("Mesh BRep shapes"))
         .withMessenger(&errorCollect)
         .withTaskProgress(progress)
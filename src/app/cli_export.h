@@ -20,6 +20,9 @@ struct CliExportArgs {
     bool progressReport = true;
     Span<const FilePath> filesToOpen;
     Span<const FilePath> filesToExport;
+    // Decimation of imported meshes(not BRep shapes), disabled if count is zero and error is negative
+    int decimationTargetTriangleCount = 0;
+    double decimationMaxError = -1.;
 };
 
 // Asynchronously exports input file(s) listed in 'args'
@@ -0,0 +1,156 @@
+/****************************************************************************
+** Copyright (c) 2023, Fougue Ltd. <http://www.fougue.pro>
+** All rights reserved.
+** See license at https://github.com/fougue/mayo/blob/master/LICENSE.txt
+****************************************************************************/
+
+#include "cli_render.h"
+
+#include "app_module.h"
+#include "console.h"
+#include "../base/application.h"
+#include "../base/filepath_conv.h"
+#include "../base/io_system.h"
+#include "../base/messenger.h"
+#include "../io_image/io_image.h"
+
+#include <Message.hxx>
+
+#include <QtCore/QtDebug>
+
+#include <fmt/format.h>
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace Mayo {
+
+class CliRender {
+    MAYO_DECLARE_TEXT_ID_FUNCTIONS(Mayo::CliRender)
+};
+
+int cli_renderDocuments(Application* app, GuiApplication* guiApp, const CliRenderArgs& args)
+{
+    auto appModule = AppModule::get();
+
+    // Suppress output from OpenCascade
+    Message::DefaultMessenger()->RemovePrinters(Message_Printer::get_type_descriptor());
+
+    // Rendering options(background, camera projection, ...) are the ones of the image writer
+    IO::ImageWriter imageWriter(guiApp);
+    const PropertyGroup* imageWriterParams = appModule->findWriterParameters(IO::Format_Image);
+    if (imageWriterParams)
+        imageWriter.applyProperties(imageWriterParams);
+
+    const IO::ImageWriter::Parameters& params = imageWriter.constParameters();
+    std::vector<CliRenderArgs::ImageSize> vecImageSize(args.imageSizes.begin(), args.imageSizes.end());
+    if (vecImageSize.empty())
+        vecImageSize.push_back({ params.width, params.height });
+
+    const int turntableCount = std::max(args.turntableCount, 1);
+    const std::vector<gp_Vec> vecCameraOrientation =
+            IO::ImageBatchRenderer::turntableOrientations(params.cameraOrientation, turntableCount);
+
+    std::error_code errorCode;
+    std_filesystem::create_directories(args.outputDirectory, errorCode);
+    if (!std_filesystem::is_directory(args.outputDirectory, errorCode)) {
+        const std::string strDir = args.outputDirectory.u8string();
+        qCritical().noquote() << QString::fromStdString(
+                    fmt::format(CliRender::textIdTr("Output directory can't be created [path={}]"), strDir)
+        );
+        return EXIT_FAILURE;
+    }
+
+    // Single offscreen view reused for all the documents
+    IO::ImageBatchRenderer renderer(guiApp, params);
+    const int fileCount = int(args.filesToOpen.size());
+    int fileIndex = 0;
+    int errorCount = 0;
+    for (const FilePath& filepath : args.filesToOpen) {
+        ++fileIndex;
+        const std::string strFilename = filepath.filename().u8string();
+        std::string errorMessage;
+        MessengerByCallback errorCollect([&](Messenger::MessageType msgType, std::string_view text) {
+            if (msgType == Messenger::MessageType::Error) {
+                errorMessage += text;
+                errorMessage += " ";
+            }
+        });
+
+        DocumentPtr doc = app->newDocument();
+        const bool okImport = appModule->ioSystem()->importInDocument()
+                .targetDocument(doc)
+                .withFilepath(filepath)
+                .withParametersProvider(appModule)
+                .withEntityPostProcess([=](TDF_Label labelEntity, TaskProgress* progress) {
+                    appModule->postProcessImportedEntity(labelEntity, progress);
+                })
+                .withEntityPostProcessRequiredIf([=](IO::Format format) {
+                    return IO::formatProvidesBRep(format) || appModule->isImportPostProcessRequired(format);
+                })
+                .withMessenger(&errorCollect)
+                .execute();
+        int imageCount = 0;
+        if (okImport) {
+            const ApplicationItem appItems[] = { doc };
+            renderer.setItems(appItems);
+            for (int i = 0; i < turntableCount; ++i) {
+                for (const CliRenderArgs::ImageSize& imageSize : vecImageSize) {
+                    std::string strImageName = filepath.stem().u8string();
+                    if (turntableCount > 1)
+                        strImageName += fmt::format("_{:03}", i);
+
+                    if (vecImageSize.size() > 1)
+                        strImageName += fmt::format("_{}x{}", imageSize.width, imageSize.height);
+
+                    strImageName += "." + args.imageFormat;
+                    const FilePath imageFilepath = args.outputDirectory / filepathFrom(strImageName);
+                    const gp_Vec& cameraOrientation = vecCameraOrientation.at(i);
+                    Handle_Image_AlienPixMap pixmap =
+                            renderer.renderImage(imageSize.width, imageSize.height, cameraOrientation);
+                    if (pixmap && pixmap->Save(filepathTo<TCollection_AsciiString>(imageFilepath))) {
+                        ++imageCount;
+                    }
+                    else {
+                        ++errorCount;
+                        errorMessage += fmt::format(CliRender::textIdTr("Failed to write {}"), strImageName);
+                        errorMessage += " ";
+                    }
+                }
+            }
+
+            renderer.clearItems();
+        }
+        else {
+            ++errorCount;
+            if (errorMessage.empty())
+                errorMessage = CliRender::textIdTr("Import failed");
+        }
+
+        app->closeDocument(doc);
+        const std::string strProgress = fmt::format("[{}/{}] ", fileIndex, fileCount);
+        const std::string strStatus = fmt::format(CliRender::textIdTr("{} rendered into {} image(s)"), strFilename, imageCount);
+        if (errorMessage.empty()) {
+            if (args.progressReport)
+                std::cout << strProgress << consoleToPrintable(strStatus) << std::endl;
+            else
+                qInfo().noquote() << QString::fromStdString(strProgress + strStatus);
+        }
+        else {
+            if (args.progressReport) {
+                consoleSetTextColor(ConsoleColor::Red);
+                std::cout << strProgress << consoleToPrintable(strFilename + ": " + errorMessage) << std::endl;
+                consoleSetTextColor(ConsoleColor::Default);
+            }
+            else {
+                qCritical().noquote() << QString::fromStdString(strProgress + strFilename + ": " + errorMessage);
+            }
+        }
+    }
+
+    return errorCount == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+} // namespace Mayo
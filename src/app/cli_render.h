@@ -0,0 +1,40 @@
+/****************************************************************************
+** Copyright (c) 2023, Fougue Ltd. <http://www.fougue.pro>
+** All rights reserved.
+** See license at https://github.com/fougue/mayo/blob/master/LICENSE.txt
+****************************************************************************/
+
+#pragma once
+
+#include "../base/filepath.h"
+#include "../base/span.h"
+
+#include <string>
+
+namespace Mayo {
+
+class Application;
+class GuiApplication;
+
+// Contains arguments for the cli_renderDocuments() function
+struct CliRenderArgs {
+    struct ImageSize {
+        int width = 0;
+        int height = 0;
+    };
+
+    bool progressReport = true;
+    Span<const FilePath> filesToOpen;
+    FilePath outputDirectory;
+    Span<const ImageSize> imageSizes; // If empty then size defined in image writer parameters
+    int turntableCount = 1; // Count of camera orientations around Z axis
+    std::string imageFormat = "png"; // File extension of output images
+};
+
+// Renders images of input file(s) listed in 'args' with a single offscreen 3D view
+// Each file is imported in its own document, which is rendered for each camera orientation and
+// image size then closed. Output images are named after the input file
+// Returns the application exit code
+int cli_renderDocuments(Application* app, GuiApplication* guiApp, const CliRenderArgs& args);
+
+} // namespace Mayo
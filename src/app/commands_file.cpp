@@ -7,8 +7,12 @@
 #include "commands_file.h"
 
 #include "../base/application.h"
+#include "../base/brep_utils.h"
 #include "../base/task_manager.h"
+#include "../base/task_progress.h"
+#include "../base/xcaf.h"
 #include "../gui/gui_application.h"
+#include "../gui/gui_document.h"
 #include "app_module.h"
 #include "filepath_conv.h"
 #include "qstring_conv.h"
@@ -16,9 +20,11 @@
 #include "theme.h"
 
 #include <fmt/format.h>
+#include <gsl/util>
 #include <QtCore/QtDebug>
 #include <QtCore/QElapsedTimer>
 #include <QtCore/QMimeData>
+#include <QtCore/QTimer>
 #include <QtGui/QDragEnterEvent>
 #include <QtGui/QDropEvent>
 #include <QtWidgets/QApplication>
@@ -143,6 +149,61 @@ struct OpenFileNames {
     }
 };
 
+// Provides the meshing of BRep entities imported by the commands
+// When progressive meshing is enabled, a coarse mesh is computed at import and the entities are
+// recorded so their mesh can be refined once the import is done
+// The triangle count of the BRep meshes is reported once, at the end of the import
+struct ImportBRepMeshing {
+    bool isProgressive = AppModule::get()->isBRepMeshProgressive();
+    std::vector<TDF_Label> vecLabelEntity;
+
+    static bool isRequired(IO::Format format)
+    {
+        return IO::formatProvidesBRep(format) || AppModule::get()->isImportPostProcessRequired(format);
+    }
+
+    void computeMesh(const TDF_Label& labelEntity, TaskProgress* progress)
+    {
+        if (AppModule::isPureMeshEntity(labelEntity)) {
+            AppModule::get()->postProcessPureMesh(labelEntity, progress);
+        }
+        else if (this->isProgressive) {
+            AppModule::get()->computeBRepMeshCoarse(labelEntity, progress);
+            this->vecLabelEntity.push_back(labelEntity);
+        }
+        else {
+            AppModule::get()->computeBRepMesh(labelEntity, progress);
+            this->vecLabelEntity.push_back(labelEntity);
+        }
+    }
+
+    // Portion of the task progress assigned to the import
+    double importProgressPortion() const { return this->isProgressive ? 40 : 100; }
+
+    void refineMesh(TaskProgress* progress)
+    {
+        if (this->isProgressive && !this->vecLabelEntity.empty()) {
+            const double portionSize = 100 - this->importProgressPortion();
+            TaskProgress subProgress(progress, portionSize, Command::textIdTr("Refine BRep meshes"));
+            AppModule::get()->refineBRepMesh(this->vecLabelEntity, &subProgress);
+        }
+    }
+
+    void reportTriangleCount() const
+    {
+        if (this->vecLabelEntity.empty())
+            return;
+
+        std::int64_t triangleCount = 0;
+        for (const TDF_Label& labelEntity : this->vecLabelEntity) {
+            if (XCaf::isShape(labelEntity))
+                triangleCount += BRepUtils::triangleCount(XCaf::shape(labelEntity));
+        }
+
+        AppModule::get()->emitInfo(fmt::format(Command::textIdTr("BRep mesh triangle count: {}"), triangleCount));
+    }
+};
+
 QString strFilepathQuoted(const QString& filepath)
 {
     for (QChar c : filepath) {
@@ -182,21 +243,26 @@ void FileCommandTools::openDocumentsFromList(IAppContext* context, Span<const Fi
             const TaskId taskId = context->taskMgr()->newTask([=](TaskProgress* progress) {
                 QElapsedTimer chrono;
                 chrono.start();
+                ImportBRepMeshing meshing;
+                TaskProgress importProgress(progress, meshing.importProgressPortion());
                 const bool okImport =
                         appModule->ioSystem()->importInDocument()
                         .targetDocument(app->findDocumentByIdentifier(newDocId))
                         .withFilepath(fp)
                         .withParametersProvider(appModule)
-                        .withEntityPostProcess([=](TDF_Label labelEntity, TaskProgress* progress) {
-                            appModule->computeBRepMesh(labelEntity, progress);
+                        .withEntityPostProcess([&](TDF_Label labelEntity, TaskProgress* progress) {
+                            meshing.computeMesh(labelEntity, progress);
                         })
-                        .withEntityPostProcessRequiredIf(&IO::formatProvidesBRep)
+                        .withEntityPostProcessRequiredIf(&ImportBRepMeshing::isRequired)
                         .withEntityPostProcessInfoProgress(20, Command::textIdTr("Mesh BRep shapes"))
                         .withMessenger(appModule)
-                        .withTaskProgress(progress)
+                        .withTaskProgress(&importProgress)
                         .execute();
-                if (okImport)
+                if (okImport) {
                     appModule->emitInfo(fmt::format(Command::textIdTr("Import time: {}ms"), chrono.elapsed()));
+                    meshing.refineMesh(progress);
+                    meshing.reportTriangleCount();
+                }
             });
             context->taskMgr()->setTitle(taskId, fp.stem().u8string());
             context->taskMgr()->run(taskId);
@@ -344,7 +410,7 @@ CommandImportInCurrentDocument::CommandImportInCurrentDocument(IAppContext* cont
 
 void CommandImportInCurrentDocument::execute()
 {
-    const GuiDocument* guiDoc = this->currentGuiDocument();
+    GuiDocument* guiDoc = this->currentGuiDocument();
     if (!guiDoc)
         return;
 
@@ -352,25 +418,53 @@ void CommandImportInCurrentDocument::execute()
     if (resFileNames.listFilepath.empty())
         return;
 
+    // Imported entities are mapped to graphics all at once when the import is finished, so view
+    // fitting and redraw are done once instead of once per file
+    const bool batchEntityMapping = resFileNames.listFilepath.size() > 1;
+    if (batchEntityMapping)
+        guiDoc->beginEntityMappingBatch();
+
     auto appModule = AppModule::get();
+    const DocumentPtr doc = guiDoc->document();
     const TaskId taskId = this->taskMgr()->newTask([=](TaskProgress* progress) {
         QElapsedTimer chrono;
         chrono.start();
 
-        const bool okImport = appModule->ioSystem()->importInDocument()
-                .targetDocument(guiDoc->document())
-                .withFilepaths(resFileNames.listFilepath)
-                .withParametersProvider(appModule)
-                .withEntityPostProcess([=](TDF_Label labelEntity, TaskProgress* progress) {
-                        appModule->computeBRepMesh(labelEntity, progress);
-                })
-                .withEntityPostProcessRequiredIf(&IO::formatProvidesBRep)
-                .withEntityPostProcessInfoProgress(20, Command::textIdTr("Mesh BRep shapes"))
-                .withMessenger(appModule)
-                .withTaskProgress(progress)
-                .execute();
-        if (okImport)
+        ImportBRepMeshing meshing;
+        TaskProgress importProgress(progress, meshing.importProgressPortion());
+        bool okImport = false;
+        {
+            // Batch is ended even if the import throws, otherwise the document would keep deferring
+            // entity mapping. Queued after the "entity added" notifications of the import
+            auto _ = gsl::finally([=]{
+                if (!batchEntityMapping)
+                    return;
+
+                QTimer::singleShot(0, this, [=]{
+                    GuiDocument* guiDoc = this->guiApp()->findGuiDocument(doc);
+                    if (guiDoc)
+                        guiDoc->endEntityMappingBatch();
+                });
+            });
+            okImport = appModule->ioSystem()->importInDocument()
+                    .targetDocument(doc)
+                    .withFilepaths(resFileNames.listFilepath)
+                    .withParametersProvider(appModule)
+                    .withEntityPostProcess([&](TDF_Label labelEntity, TaskProgress* progress) {
+                            meshing.computeMesh(labelEntity, progress);
+                    })
+                    .withEntityPostProcessRequiredIf(&ImportBRepMeshing::isRequired)
+                    .withEntityPostProcessInfoProgress(20, Command::textIdTr("Mesh BRep shapes"))
+                    .withMessenger(appModule)
+                    .withTaskProgress(&importProgress)
+                    .execute();
+        }
+
+        if (okImport) {
             appModule->emitInfo(fmt::format(Command::textIdTr("Import time: {}ms"), chrono.elapsed()));
+            meshing.refineMesh(progress);
+            meshing.reportTriangleCount();
+        }
     });
     const QString taskTitle =
             resFileNames.listFilepath.size() > 1 ?
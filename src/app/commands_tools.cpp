@@ -8,16 +8,22 @@
 
 #include "../base/application.h"
 #include "../base/application_item_selection_model.h"
+#include "../base/global.h"
+#include "../base/task_manager.h"
 #include "../gui/gui_application.h"
 #include "../gui/gui_document.h"
 #include "app_module.h"
 #include "dialog_inspect_xde.h"
 #include "dialog_options.h"
 #include "dialog_save_image_view.h"
+#include "qstring_conv.h"
 #include "qtwidgets_utils.h"
 #include "theme.h"
 
+#include <fmt/format.h>
+#include <QtCore/QElapsedTimer>
 #include <QtWidgets/QWidget>
+#include <vector>
 
 namespace Mayo {
 
@@ -80,6 +86,47 @@ bool CommandInspectXde::getEnabledStatus() const
             && firstAppItem.document()->isXCafDocument();
 }
 
+CommandUpdateBRepMesh::CommandUpdateBRepMesh(IAppContext* context)
+    : Command(context)
+{
+    auto action = new QAction(this);
+    action->setText(Command::tr("Update BRep Meshes"));
+    action->setToolTip(Command::tr("Re-mesh faces of BRep shapes not matching current meshing options"));
+    this->setAction(action);
+}
+
+void CommandUpdateBRepMesh::execute()
+{
+    const GuiDocument* guiDoc = this->currentGuiDocument();
+    if (!guiDoc)
+        return;
+
+    // Document handle is captured so entity labels stay valid until the task is done
+    const DocumentPtr doc = guiDoc->document();
+    std::vector<TDF_Label> vecLabelEntity;
+    for (int i = 0; i < doc->entityCount(); ++i)
+        vecLabelEntity.push_back(doc->entityLabel(i));
+
+    auto appModule = AppModule::get();
+    const TaskId taskId = this->taskMgr()->newTask([=](TaskProgress* progress) {
+        QElapsedTimer chrono;
+        chrono.start();
+        const int faceCount = appModule->updateBRepMesh(vecLabelEntity, progress);
+        appModule->emitInfo(fmt::format(
+                                Command::textIdTr("BRep meshes update: {} faces re-meshed in {}ms"),
+                                faceCount, chrono.elapsed()
+        ));
+        MAYO_UNUSED(doc);
+    });
+    this->taskMgr()->setTitle(taskId, to_stdString(Command::tr("Update BRep meshes")));
+    this->taskMgr()->run(taskId);
+}
+
+bool CommandUpdateBRepMesh::getEnabledStatus() const
+{
+    return this->app()->documentCount() != 0;
+}
+
 CommandEditOptions::CommandEditOptions(IAppContext* context)
     : Command(context)
 {
@@ -24,6 +24,13 @@ public:
     bool getEnabledStatus() const override;
 };
 
+class CommandUpdateBRepMesh : public Command {
+public:
+    CommandUpdateBRepMesh(IAppContext* context);
+    void execute() override;
+    bool getEnabledStatus() const override;
+};
+
 class CommandEditOptions : public Command {
 public:
     CommandEditOptions(IAppContext* context);
@@ -5,6 +5,7 @@
 ****************************************************************************/
 
 #include "../base/application.h"
+#include "../base/document.h"
 #include "../base/document_tree_node_properties_provider.h"
 #include "../base/io_system.h"
 #include "../base/settings.h"
@@ -16,12 +17,15 @@
 #include "../io_off/io_off_writer.h"
 #include "../io_ply/io_ply_reader.h"
 #include "../io_ply/io_ply_writer.h"
+#include "../graphics/graphics_mesh_array_object_driver.h"
 #include "../graphics/graphics_mesh_object_driver.h"
 #include "../graphics/graphics_point_cloud_object_driver.h"
 #include "../graphics/graphics_shape_object_driver.h"
 #include "../gui/gui_application.h"
+#include "../gui/gui_document.h"
 #include "app_module.h"
 #include "cli_export.h"
+#include "cli_render.h"
 #include "console.h"
 #include "document_tree_node_properties_providers.h"
 #include "filepath_conv.h"
@@ -54,6 +58,7 @@
 #include <fstream>
 #include <iostream>
 #include <memory>
+#include <mutex>
 #include <unordered_map>
 
 #ifdef Q_OS_WIN
@@ -82,6 +87,12 @@ struct CommandLineArguments {
     std::vector<FilePath> listFilepathToExport;
     std::vector<FilePath> listFilepathToOpen;
     bool cliProgressReport = true;
+    FilePath dirRenderOutput;
+    std::vector<CliRenderArgs::ImageSize> listRenderImageSize;
+    int renderTurntableCount = 1;
+    std::string renderImageFormat = "png";
+    int decimationTargetTriangleCount = 0;
+    double decimationMaxError = -1.;
 };
 
 // Provides customization of Qt message handler
@@ -209,6 +220,50 @@ static CommandLineArguments processCommandLine()
     );
     cmdParser.addOption(cmdFileToExport);
 
+    const QCommandLineOption cmdRenderDir(
+                QStringList{ "render" },
+                Main::tr("Render images of opened files into output directory, a single offscreen "
+                         "view is used for all images"),
+                Main::tr("directory")
+    );
+    cmdParser.addOption(cmdRenderDir);
+
+    const QCommandLineOption cmdRenderSize(
+                QStringList{ "render-size" },
+                Main::tr("Size of rendered images, can be repeated for different sizes"
+                         "(eg. --render-size 256x256 --render-size 1024x768)"),
+                Main::tr("WxH")
+    );
+    cmdParser.addOption(cmdRenderSize);
+
+    const QCommandLineOption cmdRenderTurntable(
+                QStringList{ "render-turntable" },
+                Main::tr("Count of camera orientations evenly spaced around Z axis for rendered images"),
+                Main::tr("count")
+    );
+    cmdParser.addOption(cmdRenderTurntable);
+
+    const QCommandLineOption cmdRenderFormat(
+                QStringList{ "render-format" },
+                Main::tr("Image format(file extension) of rendered images, default is png"),
+                Main::tr("extension")
+    );
+    cmdParser.addOption(cmdRenderFormat);
+
+    const QCommandLineOption cmdDecimateTriangles(
+                QStringList{ "decimate-triangles" },
+                Main::tr("Decimate imported meshes down to this count of triangles before export"),
+                Main::tr("count")
+    );
+    cmdParser.addOption(cmdDecimateTriangles);
+
+    const QCommandLineOption cmdDecimateError(
+                QStringList{ "decimate-error" },
+                Main::tr("Decimate imported meshes until this geometric error is reached, before export"),
+                Main::tr("distance")
+    );
+    cmdParser.addOption(cmdDecimateError);
+
     const QCommandLineOption cmdFileLog(
                 QStringList{ "log-file" },
                 Main::tr("Writes log messages into output file"),
@@ -260,6 +315,51 @@ static CommandLineArguments processCommandLine()
             args.listFilepathToExport.push_back(filepathFrom(strFilepath));
     }
 
+    if (cmdParser.isSet(cmdRenderDir))
+        args.dirRenderOutput = filepathFrom(cmdParser.value(cmdRenderDir));
+
+    for (const QString& strSize : cmdParser.values(cmdRenderSize)) {
+        const QStringList listDim = strSize.split('x');
+        bool okWidth = false;
+        bool okHeight = false;
+        CliRenderArgs::ImageSize imageSize;
+        if (listDim.size() == 2) {
+            imageSize.width = listDim.at(0).toInt(&okWidth);
+            imageSize.height = listDim.at(1).toInt(&okHeight);
+        }
+
+        if (!okWidth || !okHeight || imageSize.width <= 0 || imageSize.height <= 0) {
+            qCritical().noquote() << Main::tr("Invalid image size '%1'").arg(strSize);
+            std::exit(EXIT_FAILURE);
+        }
+
+        args.listRenderImageSize.push_back(imageSize);
+    }
+
+    if (cmdParser.isSet(cmdRenderTurntable))
+        args.renderTurntableCount = std::max(cmdParser.value(cmdRenderTurntable).toInt(), 1);
+
+    if (cmdParser.isSet(cmdRenderFormat))
+        args.renderImageFormat = to_stdString(cmdParser.value(cmdRenderFormat));
+
+    if (cmdParser.isSet(cmdDecimateTriangles)) {
+        bool ok = false;
+        args.decimationTargetTriangleCount = cmdParser.value(cmdDecimateTriangles).toInt(&ok);
+        if (!ok || args.decimationTargetTriangleCount <= 0) {
+            qCritical().noquote() << Main::tr("Invalid count of triangles '%1'").arg(cmdParser.value(cmdDecimateTriangles));
+            std::exit(EXIT_FAILURE);
+        }
+    }
+
+    if (cmdParser.isSet(cmdDecimateError)) {
+        bool ok = false;
+        args.decimationMaxError = cmdParser.value(cmdDecimateError).toDouble(&ok);
+        if (!ok || args.decimationMaxError < 0) {
+            qCritical().noquote() << Main::tr("Invalid decimation error '%1'").arg(cmdParser.value(cmdDecimateError));
+            std::exit(EXIT_FAILURE);
+        }
+    }
+
     for (const QString& posArg : cmdParser.positionalArguments())
         args.listFilepathToOpen.push_back(filepathFrom(posArg));
 
@@ -409,6 +509,8 @@ static void initGui(GuiApplication* guiApp)
 
     // Register Graphics entity drivers
     guiApp->addGraphicsObjectDriver(std::make_unique<GraphicsShapeObjectDriver>());
+    // Large meshes are handled by GraphicsMeshArrayObjectDriver, must be added before GraphicsMeshObjectDriver
+    guiApp->addGraphicsObjectDriver(std::make_unique<GraphicsMeshArrayObjectDriver>());
     guiApp->addGraphicsObjectDriver(std::make_unique<GraphicsMeshObjectDriver>());
     guiApp->addGraphicsObjectDriver(std::make_unique<GraphicsPointCloudObjectDriver>());
 }
@@ -502,14 +604,52 @@ static int runApp(QCoreApplication* qtApp)
             cliArgs.progressReport = args.cliProgressReport;
             cliArgs.filesToOpen = args.listFilepathToOpen;
             cliArgs.filesToExport = args.listFilepathToExport;
+            cliArgs.decimationTargetTriangleCount = args.decimationTargetTriangleCount;
+            cliArgs.decimationMaxError = args.decimationMaxError;
             cli_asyncExportDocuments(app, cliArgs, [=](int retcode) { qtApp->exit(retcode); });
         });
         return qtApp->exec();
     }
 
+    if (!args.dirRenderOutput.empty()) {
+        if (args.listFilepathToOpen.empty())
+            fnCriticalExit(Main::tr("No input files -> nothing to render"));
+
+        guiApp->setAutomaticDocumentMapping(false); // GuiDocument objects aren't needed
+        appModule->settings()->resetAll();
+        fnLoadAppSettings(appModule->settings());
+        QTimer::singleShot(0, qtApp, [=]{
+            CliRenderArgs cliArgs;
+            cliArgs.progressReport = args.cliProgressReport;
+            cliArgs.filesToOpen = args.listFilepathToOpen;
+            cliArgs.outputDirectory = args.dirRenderOutput;
+            cliArgs.imageSizes = args.listRenderImageSize;
+            cliArgs.turntableCount = args.renderTurntableCount;
+            cliArgs.imageFormat = args.renderImageFormat;
+            qtApp->exit(cli_renderDocuments(app, guiApp, cliArgs));
+        });
+        return qtApp->exec();
+    }
+
     // Record recent files when documents are closed
     guiApp->signalGuiDocumentErased.connectSlot(&AppModule::recordRecentFileThumbnail, AppModule::get());
 
+    // Graphics read BRep meshes while they might be changed in background(eg progressive meshing)
+    guiApp->setBRepMeshMutex(&appModule->mutexBRepMeshChange());
+
+    // Update graphics of entities whose BRep mesh was changed in background(eg progressive meshing)
+    appModule->signalBRepMeshChanged.connectSlot([=](const TDF_Label& labelEntity, const std::vector<TopoDS_Face>& vecFace) {
+        DocumentPtr doc = Document::findFrom(labelEntity);
+        GuiDocument* guiDoc = guiApp->findGuiDocument(doc);
+        if (!guiDoc)
+            return;
+
+        for (int i = 0; i < doc->entityCount(); ++i) {
+            if (doc->entityLabel(i) == labelEntity)
+                guiDoc->recomputeBRepMeshGraphics(doc->entityTreeNodeId(i), vecFace);
+        }
+    });
+
     // Register WidgetModelTreeBuilter prototypes
     WidgetModelTree::addPrototypeBuilder(std::make_unique<WidgetModelTreeBuilder_Mesh>());
     WidgetModelTree::addPrototypeBuilder(std::make_unique<WidgetModelTreeBuilder_Xde>());
@@ -540,6 +680,7 @@ static int runApp(QCoreApplication* qtApp)
     fnLoadAppSettings(appModule->settings());
     const int code = qtApp->exec();
     appModule->recordRecentFileThumbnails(guiApp);
+    appModule->waitForRecentFileThumbnails();
     appModule->settings()->save();
     return code;
 }
@@ -581,7 +722,7 @@ int main(int argc, char* argv[])
     QCoreApplication::setOrganizationDomain("www.fougue.pro");
     QCoreApplication::setApplicationName("Mayo");
     QCoreApplication::setApplicationVersion(QString::fromUtf8(Mayo::strVersion));
-    const bool isAppCliMode = fnArgsContainAnyOf({ "-e", "--export", "-h", "--help", "-v", "--version" });
+    const bool isAppCliMode = fnArgsContainAnyOf({ "-e", "--export", "--render", "-h", "--help", "-v", "--version" });
     std::unique_ptr<QCoreApplication> ptrApp(
             isAppCliMode ? new QCoreApplication(argc, argv) : new QApplication(argc, argv)
     );
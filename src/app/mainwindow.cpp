@@ -19,6 +19,7 @@
 #include "../gui/gui_document.h"
 #include "app_context.h"
 #include "app_module.h"
+#include "brep_mesh_memory_budget.h"
 #include "commands_file.h"
 #include "commands_display.h"
 #include "commands_tools.h"
@@ -44,7 +45,9 @@
 #  include "windows/win_taskbar_global_progress.h"
 #endif
 
+#include <QtCore/QPointer>
 #include <QtCore/QTimer>
+#include <QtGui/QCursor>
 #include <QtDebug>
 
 namespace Mayo {
@@ -142,6 +145,7 @@ MainWindow::MainWindow(GuiApplication* guiApp, QWidget *parent)
     }
 
     new DialogTaskManager(&m_taskMgr, this);
+    m_brepMeshMemoryBudget = std::make_unique<BRepMeshMemoryBudget>(guiApp, &m_taskMgr);
 
     // BEWARE MainWindow::onGuiDocumentAdded() must be called before
     // MainWindow::onCurrentDocumentIndexChanged()
@@ -233,6 +237,7 @@ void MainWindow::createCommands()
     // "Tools" commands
     this->addCommand<CommandSaveViewImage>("save-view-image");
     this->addCommand<CommandInspectXde>("inspect-xde");
+    this->addCommand<CommandUpdateBRepMesh>("update-brep-mesh");
     this->addCommand<CommandEditOptions>("edit-options");
 
     // "Window" commands
@@ -286,6 +291,7 @@ void MainWindow::createMenus()
         auto menu = m_ui->menu_Tools;
         menu->addAction(fnGetAction("save-view-image"));
         menu->addAction(fnGetAction("inspect-xde"));
+        menu->addAction(fnGetAction("update-brep-mesh"));
         menu->addSeparator();
         menu->addAction(fnGetAction("edit-options"));
     }
@@ -424,9 +430,11 @@ void MainWindow::onGuiDocumentAdded(GuiDocument* guiDoc)
         gfxScene->highlightAt(xPos * dpRatio, yPos * dpRatio, guiDoc->v3dView());
         widget->view()->redraw();
         auto selector = gfxScene->mainSelector();
-        selector->Pick(xPos, yPos, guiDoc->v3dView());
+        if (gfxScene->isPickingReady())
+            selector->Pick(xPos, yPos, guiDoc->v3dView());
+
         const gp_Pnt pos3d =
-                selector->NbPicked() > 0 ?
+                gfxScene->isPickingReady() && selector->NbPicked() > 0 ?
                     selector->PickedPoint(1) :
                     GraphicsUtils::V3dView_to3dPosition(guiDoc->v3dView(), xPos, yPos);
         m_ui->label_ValuePosX->setText(QString::number(pos3d.X(), 'f', 3));
@@ -434,6 +442,18 @@ void MainWindow::onGuiDocumentAdded(GuiDocument* guiDoc)
         m_ui->label_ValuePosZ->setText(QString::number(pos3d.Z(), 'f', 3));
     });
 
+    // Highlighting was suspended while selection structures were built, update it at mouse position
+    QPointer<WidgetGuiDocument> widgetPtr = widget;
+    gfxScene->signalPickingReady.connectSlot([=]{
+        if (!widgetPtr || !widgetPtr->guiDocument()->graphicsScene()->isPickingReady())
+            return;
+
+        QWidget* viewWidget = widgetPtr->view()->widget();
+        const QPoint pos = viewWidget->mapFromGlobal(QCursor::pos());
+        if (viewWidget->rect().contains(pos))
+            widgetPtr->controller()->signalMouseMoved.send(pos.x(), pos.y());
+    });
+
     m_ui->stack_GuiDocuments->addWidget(widget);
     this->updateControlsActivation();
     const int newDocIndex = m_guiApp->application()->documentCount() - 1;
@@ -18,6 +18,7 @@ class QFileInfo;
 
 namespace Mayo {
 
+class BRepMeshMemoryBudget;
 class Command;
 class GuiApplication;
 class GuiDocument;
@@ -72,6 +73,7 @@ private:
 
     IAppContext* m_appContext = nullptr;
     GuiApplication* m_guiApp = nullptr;
+    std::unique_ptr<BRepMeshMemoryBudget> m_brepMeshMemoryBudget; // Must outlive m_taskMgr
     TaskManager m_taskMgr;
     class Ui_MainWindow* m_ui = nullptr;
     std::unordered_map<std::string_view, Command*> m_mapCommand;
@@ -187,7 +187,7 @@ Quantity_Color toPreferredColorSpace(const QColor& c)
 #endif
 }
 
-QPixmap toQPixmap(const Image_PixMap& pixmap)
+QImage toQImage(const Image_PixMap& pixmap)
 {
     auto fnToQImageFormat = [](Image_Format occFormat) {
         switch (occFormat) {
@@ -204,6 +204,13 @@ QPixmap toQPixmap(const Image_PixMap& pixmap)
                      int(pixmap.Height()),
                      int(pixmap.SizeRowBytes()),
                      fnToQImageFormat(pixmap.Format()));
+    // Deep copy, 'img' doesn't own the data of 'pixmap'
+    return img.copy();
+}
+
+QPixmap toQPixmap(const Image_PixMap& pixmap)
+{
+    const QImage img = toQImage(pixmap);
     if (img.isNull())
         return {};
 
@@ -14,6 +14,7 @@
 #include <QtGui/QColor>
 #include <QtGui/QFont>
 #include <QtGui/QGradient>
+#include <QtGui/QImage>
 #include <QtGui/QPixmap>
 class QScreen;
 
@@ -37,6 +38,10 @@ Quantity_Color toColor(const QColor& c);
 
 Quantity_Color toPreferredColorSpace(const QColor& c);
 
+// Converts (OCCT)Image_Pixmap -> QImage
+// Unlike QPixmap, the returned QImage can be safely used outside of the GUI thread
+QImage toQImage(const Image_PixMap& pixmap);
+
 // Converts (OCCT)Image_Pixmap -> QPixmap
 QPixmap toQPixmap(const Image_PixMap& pixmap);
 
@@ -17,45 +17,94 @@
 
 #include <fmt/format.h>
 #include <QtCore/QtDebug>
+#include <QtCore/QCryptographicHash>
+#include <QtCore/QSaveFile>
+#include <QtCore/QStandardPaths>
+#include <set>
 
 namespace Mayo {
 
-bool RecentFile::recordThumbnail(GuiDocument* guiDoc, QSize size)
+namespace Internal {
+
+static FilePath& thumbnailCacheDirectory()
+{
+    static FilePath dir;
+    return dir;
+}
+
+} // namespace Internal
+
+Handle_Image_AlienPixMap RecentFile::renderThumbnail(GuiDocument* guiDoc, QSize size) const
 {
     if (!guiDoc)
-        return false;
+        return {};
 
     if (!filepathEquivalent(this->filepath, guiDoc->document()->filePath())) {
         qDebug() << fmt::format("Filepath mismatch with GUI document\n"
                                       "    Function: {}\n    Filepath: {}\n    Document: {}",
                                 Q_FUNC_INFO, this->filepath.u8string(), guiDoc->document()->filePath().u8string())
                     .c_str();
-        return false;
+        return {};
     }
 
-    if (this->thumbnailTimestamp == RecentFile::timestampLastModified(this->filepath))
-        return true;
-
     IO::ImageWriter::Parameters params;
     params.width = size.width();
     params.height = size.height();
     params.backgroundColor = QtGuiUtils::toPreferredColorSpace(mayoTheme()->color(Theme::Color::Palette_Window));
     Handle_Image_AlienPixMap pixmap = IO::ImageWriter::createImage(guiDoc, params);
-    if (!pixmap) {
+    if (!pixmap)
         qDebug() << "Empty pixmap returned by IO::ImageWriter::createImage()";
+
+    return pixmap;
+}
+
+bool RecentFile::writeThumbnail(const Handle_Image_AlienPixMap& image, const FilePath& fpThumbnail)
+{
+    if (!image || fpThumbnail.empty())
         return false;
-    }
 
-    GraphicsUtils::ImagePixmap_flipY(*pixmap);
-    Image_PixMap::SwapRgbaBgra(*pixmap);
-    this->thumbnail = QtGuiUtils::toQPixmap(*pixmap);
-    this->thumbnailTimestamp = RecentFile::timestampLastModified(this->filepath);
-    return true;
+    GraphicsUtils::ImagePixmap_flipY(*image);
+    Image_PixMap::SwapRgbaBgra(*image);
+    const QImage img = QtGuiUtils::toQImage(*image);
+    if (img.isNull())
+        return false;
+
+    std::error_code errorCode;
+    std_filesystem::create_directories(fpThumbnail.parent_path(), errorCode);
+    // Write to a temporary file then rename, so a partially written thumbnail is never loaded
+    QSaveFile file(filepathTo<QString>(fpThumbnail));
+    if (!file.open(QIODevice::WriteOnly) || !img.save(&file, "PNG"))
+        return false;
+
+    return file.commit();
+}
+
+QImage RecentFile::loadThumbnail() const
+{
+    const FilePath fpThumbnail = this->thumbnailFilepath();
+    if (!filepathExists(fpThumbnail))
+        return {};
+
+    return QImage(filepathTo<QString>(fpThumbnail), "PNG");
+}
+
+FilePath RecentFile::thumbnailFilepath() const
+{
+    return RecentFile::thumbnailFilepath(this->filepath, this->thumbnailTimestamp);
+}
+
+FilePath RecentFile::thumbnailFilepath(const FilePath& fp, int64_t timestamp)
+{
+    const std::string key = fmt::format("{}|{}", fp.u8string(), timestamp);
+    const QByteArray hash = QCryptographicHash::hash(QByteArray::fromStdString(key), QCryptographicHash::Sha1);
+    const std::string filename = hash.toHex().toStdString() + ".png";
+    return RecentFile::thumbnailCacheDirectory() / filename;
 }
 
 bool RecentFile::isThumbnailOutOfSync() const
 {
-    return this->thumbnailTimestamp != RecentFile::timestampLastModified(this->filepath);
+    return this->thumbnailTimestamp != RecentFile::timestampLastModified(this->filepath)
+            || !filepathExists(this->thumbnailFilepath());
 }
 
 int64_t RecentFile::timestampLastModified(const FilePath& fp)
@@ -72,17 +121,32 @@ int64_t RecentFile::timestampLastModified(const FilePath& fp)
     }
 }
 
+FilePath RecentFile::thumbnailCacheDirectory()
+{
+    FilePath& dir = Internal::thumbnailCacheDirectory();
+    if (dir.empty()) {
+        const QString strCacheDir = QStandardPaths::writableLocation(QStandardPaths::CacheLocation);
+        dir = filepathFrom(strCacheDir) / "thumbnails";
+    }
+
+    return dir;
+}
+
+void RecentFile::setThumbnailCacheDirectory(const FilePath& dir)
+{
+    Internal::thumbnailCacheDirectory() = dir;
+}
+
 bool operator==(const RecentFile& lhs, const RecentFile& rhs)
 {
-    return lhs.filepath == rhs.filepath
-            && lhs.thumbnail.cacheKey() == rhs.thumbnail.cacheKey()
-            && lhs.thumbnailTimestamp == rhs.thumbnailTimestamp;
+    return lhs.filepath == rhs.filepath && lhs.thumbnailTimestamp == rhs.thumbnailTimestamp;
 }
 
 QDataStream& operator<<(QDataStream& stream, const RecentFile& recentFile)
 {
     stream << filepathTo<QString>(recentFile.filepath);
-    stream << recentFile.thumbnail;
+    // Thumbnail used to be stored here, a null image keeps the format readable by older versions
+    stream << QImage();
     stream << qint64(recentFile.thumbnailTimestamp);
     return stream;
 }
@@ -92,12 +156,23 @@ QDataStream& operator>>(QDataStream& stream, RecentFile& recentFile)
     QString strFilepath;
     stream >> strFilepath;
     recentFile.filepath = filepathFrom(strFilepath);
-    stream >> recentFile.thumbnail;
+    // Thumbnail stored by older versions, null otherwise
+    QImage legacyThumbnail;
+    stream >> legacyThumbnail;
     // Read thumbnail timestamp
     // Warning: qint64 and int64_t may not be the exact same type(eg __int64 and longlong with Windows/MSVC)
     qint64 timestamp;
     stream >> timestamp;
     recentFile.thumbnailTimestamp = timestamp;
+    // Move legacy thumbnail to the cache directory
+    if (!legacyThumbnail.isNull()) {
+        const FilePath fpThumbnail = recentFile.thumbnailFilepath();
+        std::error_code errorCode;
+        std_filesystem::create_directories(fpThumbnail.parent_path(), errorCode);
+        if (!filepathExists(fpThumbnail))
+            legacyThumbnail.save(filepathTo<QString>(fpThumbnail), "PNG");
+    }
+
     return stream;
 }
 
@@ -132,6 +207,24 @@ QDataStream& operator>>(QDataStream& stream, RecentFiles& recentFiles)
     return stream;
 }
 
+void pruneRecentFileThumbnails(const RecentFiles& recentFiles)
+{
+    std::set<FilePath> setThumbnailFilepath;
+    for (const RecentFile& recentFile : recentFiles)
+        setThumbnailFilepath.insert(recentFile.thumbnailFilepath().filename());
+
+    std::error_code errorCode;
+    std_filesystem::directory_iterator itDir(RecentFile::thumbnailCacheDirectory(), errorCode);
+    if (errorCode)
+        return;
+
+    for (const auto& entry : itDir) {
+        const FilePath& fp = entry.path();
+        if (fp.extension() == ".png" && setThumbnailFilepath.find(fp.filename()) == setThumbnailFilepath.cend())
+            std_filesystem::remove(fp, errorCode);
+    }
+}
+
 template<> const char PropertyRecentFiles::TypeName[] = "Mayo::PropertyRecentFiles";
 
 } // namespace Mayo
@@ -9,7 +9,8 @@
 #include "../base/filepath.h"
 #include "../base/property_builtins.h"
 
-#include <QtGui/QPixmap>
+#include <Image_AlienPixMap.hxx>
+#include <QtGui/QImage>
 #include <vector>
 class QDataStream;
 
@@ -18,13 +19,35 @@ namespace Mayo {
 class GuiDocument;
 
 // Provides information about a "recently" opened file
+// Thumbnail image isn't held by the RecentFile object, it's stored as a PNG file in a cache
+// directory(see thumbnailCacheDirectory()). The name of that file depends on the path of the
+// recent file and the thumbnail timestamp, so outdated thumbnails are never picked
 struct RecentFile {
     FilePath filepath;
-    QPixmap thumbnail;
     int64_t thumbnailTimestamp = 0;
-    bool recordThumbnail(GuiDocument* guiDoc, QSize size);
+
+    // Renders thumbnail image of 'guiDoc', must be called from the GUI thread
+    // Returned image has to be written with writeThumbnail(), it's null in case of error
+    Handle_Image_AlienPixMap renderThumbnail(GuiDocument* guiDoc, QSize size) const;
+
+    // Converts and writes 'image' to PNG file 'fpThumbnail', can be called from any thread
+    // 'image' is modified in-place, it's expected to be the output of renderThumbnail()
+    static bool writeThumbnail(const Handle_Image_AlienPixMap& image, const FilePath& fpThumbnail);
+
+    // Reads the thumbnail image from the cache, returns a null image if it doesn't exist
+    QImage loadThumbnail() const;
+
+    // Path of the thumbnail file in the cache directory, it may not exist
+    FilePath thumbnailFilepath() const;
+    static FilePath thumbnailFilepath(const FilePath& fp, int64_t timestamp);
+
     bool isThumbnailOutOfSync() const;
     static int64_t timestampLastModified(const FilePath& fp);
+
+    // Directory where thumbnail files are stored
+    // Defaults to "thumbnails" sub-directory of QStandardPaths::CacheLocation
+    static FilePath thumbnailCacheDirectory();
+    static void setThumbnailCacheDirectory(const FilePath& dir);
 };
 
 // Alias for "array of RecentFile objects"
@@ -48,4 +71,7 @@ QDataStream& operator>>(QDataStream& stream, RecentFile& recentFile);
 // Extracts array of RecentFile objects from QDataStream
 QDataStream& operator>>(QDataStream& stream, RecentFiles& recentFiles);
 
+// Deletes the files in thumbnail cache directory not referenced by 'recentFiles'
+void pruneRecentFileThumbnails(const RecentFiles& recentFiles);
+
 } // namespace Mayo
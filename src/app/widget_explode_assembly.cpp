@@ -24,11 +24,22 @@ WidgetExplodeAssembly::WidgetExplodeAssembly(GuiDocument* guiDoc, QWidget* paren
         m_ui->edit_Factor->setValue(pct);
         m_guiDoc->setExplodingFactor(pct / 100.);
     });
+    // Dragging the slider is an interaction like camera manipulation, full quality is restored on release
+    QObject::connect(m_ui->slider_Factor, &QSlider::sliderPressed, this, [=]{
+        m_guiDoc->setRenderingQuality(GuiDocument::RenderingQuality::Interactive);
+    });
+    QObject::connect(m_ui->slider_Factor, &QSlider::sliderReleased, this, [=]{
+        m_guiDoc->setRenderingQuality(GuiDocument::RenderingQuality::Full);
+    });
     QObject::connect(m_ui->edit_Factor, qOverload<int>(&QSpinBox::valueChanged), this, [=](int pct) {
         QSignalBlocker sigBlock(m_ui->slider_Factor);
         m_ui->slider_Factor->setValue(pct);
         m_guiDoc->setExplodingFactor(pct / 100.);
     });
+    m_ui->check_Hierarchical->setChecked(m_guiDoc->explodingMode() == GuiDocument::ExplodingMode::Hierarchical);
+    QObject::connect(m_ui->check_Hierarchical, &QCheckBox::toggled, this, [=](bool on) {
+        m_guiDoc->setExplodingMode(on ? GuiDocument::ExplodingMode::Hierarchical : GuiDocument::ExplodingMode::Flat);
+    });
 }
 
 WidgetExplodeAssembly::~WidgetExplodeAssembly()
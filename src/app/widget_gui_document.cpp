@@ -24,6 +24,7 @@
 #include <QtCore/QtDebug>
 #include <QtCore/QAbstractAnimation>
 #include <QtCore/QEasingCurve>
+#include <QtCore/QTimer>
 #include <QtGui/QPainter>
 #include <QtGui/QGuiApplication>
 #include <QtWidgets/QBoxLayout>
@@ -169,6 +170,13 @@ WidgetGuiDocument::WidgetGuiDocument(GuiDocument* guiDoc, QWidget* parent)
     layoutBtns->addWidget(m_btnMeasure);
     m_widgetBtns = this->createWidgetPanelContainer(widgetBtnsContents);
 
+    // HLR projection is updated once exploding/visibility changes have settled for some idle time
+    auto timerHiddenLineRemoval = new QTimer(this);
+    timerHiddenLineRemoval->setSingleShot(true);
+    timerHiddenLineRemoval->setInterval(300);
+    QObject::connect(timerHiddenLineRemoval, &QTimer::timeout, this, [=]{ m_guiDoc->updateHiddenLineRemoval(); });
+    m_guiDoc->signalHiddenLineRemovalDeferred.connectSlot([=]{ timerHiddenLineRemoval->start(); });
+
     auto gfxScene = m_guiDoc->graphicsScene();
     gfxScene->signalRedrawRequested.connectSlot([=](const Handle_V3d_View& view) {
         if (view == m_qtOccView->v3dView())
@@ -194,7 +202,15 @@ WidgetGuiDocument::WidgetGuiDocument(GuiDocument* guiDoc, QWidget* parent)
                 this, &WidgetGuiDocument::toggleWidgetMeasure
     );
     m_controller->signalDynamicActionStarted.connectSlot([=]{ m_guiDoc->stopViewCameraAnimation(); });
-    m_controller->signalViewScaled.connectSlot([=]{ m_guiDoc->stopViewCameraAnimation(); });
+    m_controller->signalViewScaled.connectSlot([=]{
+        m_guiDoc->stopViewCameraAnimation();
+        m_guiDoc->updateLevelOfDetail();
+    });
+    m_controller->signalDynamicActionEnded.connectSlot([=]{ m_guiDoc->updateLevelOfDetail(); });
+    m_controller->signalInteractionModeChanged.connectSlot([=](bool on) {
+        using RenderingQuality = GuiDocument::RenderingQuality;
+        m_guiDoc->setRenderingQuality(on ? RenderingQuality::Interactive : RenderingQuality::Full);
+    });
     m_controller->signalMouseButtonClicked.connectSlot([=](Aspect_VKeyMouse btn) {
         if (btn == Aspect_VKeyMouse_LeftButton && !m_guiDoc->processAction(gfxScene->currentHighlightedOwner())) {
             gfxScene->select();
@@ -208,8 +224,10 @@ WidgetGuiDocument::WidgetGuiDocument(GuiDocument* guiDoc, QWidget* parent)
 
     m_guiDoc->viewCameraAnimation()->setBackend(std::make_unique<QtAnimationBackend>(QEasingCurve::OutExpo));
     m_guiDoc->viewCameraAnimation()->setRenderFunction([=](const Handle_V3d_View& view){
-        if (view == m_qtOccView->v3dView())
+        if (view == m_qtOccView->v3dView()) {
+            m_controller->notifyCameraInteraction();
             m_qtOccView->redraw();
+        }
     });
 }
 
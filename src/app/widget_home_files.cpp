@@ -84,8 +84,9 @@ public:
             pixmap = fnPixmap(mayoTheme()->icon(Theme::Icon::OpenFiles), 128, 96);
         }
         else {
+            // Called only for painted items, so thumbnails are loaded from disk as they get visible
             const RecentFile* recentFile = AppModule::get()->findRecentFile(filepathFrom(url));
-            pixmap = recentFile ? recentFile->thumbnail : QPixmap();
+            pixmap = recentFile ? QPixmap::fromImage(recentFile->loadThumbnail()) : QPixmap();
             if (pixmap.isNull()) {
                 const QIcon icon = m_fileIconProvider.icon(QFileInfo(url));
                 pixmap = fnPixmap(icon, 64, 64);
@@ -106,6 +107,19 @@ public:
         this->endResetModel();
     }
 
+    // Drops the pixmap cached for recent file 'fp' so its new thumbnail gets loaded on next paint
+    void refreshThumbnail(const FilePath& fp)
+    {
+        for (int i = 0; i < int(m_storage->m_items.size()); ++i) {
+            const HomeFileItem& item = m_storage->m_items.at(i);
+            if (item.type == HomeFileItem::Type::RecentFile && filepathEquivalent(item.filepath, fp)) {
+                QPixmapCache::remove(item.imageUrl);
+                const QModelIndex itemIndex = this->index(i);
+                emit this->dataChanged(itemIndex, itemIndex, { RoleItemImage });
+            }
+        }
+    }
+
 private:
     void reloadRecentFiles()
     {
@@ -226,6 +240,9 @@ WidgetHomeFiles::WidgetHomeFiles(QWidget* parent)
         if (setting == &appModule->properties()->recentFiles)
             model->reload();
     });
+    appModule->signalRecentFileThumbnailWritten.connectSlot([=](const FilePath& fp) {
+        model->refreshThumbnail(fp);
+    });
 }
 
 void WidgetHomeFiles::resizeEvent(QResizeEvent* event)
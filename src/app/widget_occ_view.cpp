@@ -13,7 +13,12 @@
 
 #include "occt_window.h"
 
+#include <QtCore/QTimer>
+#include <QtGui/QGuiApplication>
 #include <QtGui/QResizeEvent>
+#include <QtGui/QScreen>
+#include <algorithm>
+#include <cmath>
 #if OCC_VERSION_HEX >= 0x070600
 #  include <Aspect_NeutralWindow.hxx>
 #endif
@@ -39,6 +44,46 @@ IWidgetOccView* IWidgetOccView::create(const Handle_V3d_View& view, QWidget* par
     return fn(view, parent);
 }
 
+IWidgetOccView::IWidgetOccView(const Handle_V3d_View& view)
+    : m_view(view)
+{
+    const QScreen* screen = QGuiApplication::primaryScreen();
+    const double refreshRate = screen ? screen->refreshRate() : 60.;
+    m_frameInterval = refreshRate > 0. ? int(std::floor(1000. / refreshRate)) : 16;
+}
+
+void IWidgetOccView::redraw()
+{
+    ++m_frameStats.redrawRequestCount;
+    if (m_isRedrawPending)
+        return;
+
+    // Schedule rendering so that frames are spaced by at least frameInterval()
+    m_isRedrawPending = true;
+    int delay = 0;
+    if (m_lastFrameTimer.isValid())
+        delay = std::max(0, m_frameInterval - int(m_lastFrameTimer.elapsed()));
+
+    QTimer::singleShot(delay, this->widget(), [=]{
+        m_isRedrawPending = false;
+        this->renderFrame();
+    });
+}
+
+void IWidgetOccView::redrawV3dView()
+{
+    QElapsedTimer chrono;
+    chrono.start();
+    m_view->Redraw();
+    const double frameTimeMs = chrono.nsecsElapsed() / 1000000.;
+    m_lastFrameTimer.start();
+
+    ++m_frameStats.frameCount;
+    m_frameStats.lastFrameTimeMs = frameTimeMs;
+    m_frameStats.maxFrameTimeMs = std::max(m_frameStats.maxFrameTimeMs, frameTimeMs);
+    m_frameStats.totalFrameTimeMs += frameTimeMs;
+}
+
 #if OCC_VERSION_HEX >= 0x070600
 
 // Defined in widget_occ_view.cpp
@@ -95,7 +140,7 @@ QOpenGLWidgetOccView::QOpenGLWidgetOccView(const Handle_V3d_View& view, QWidget*
     this->setFormat(glFormat);
 }
 
-void QOpenGLWidgetOccView::redraw()
+void QOpenGLWidgetOccView::renderFrame()
 {
     this->update();
 }
@@ -145,7 +190,7 @@ void QOpenGLWidgetOccView::paintGL()
 
     // Redraw the viewer
     //this->v3dView()->InvalidateImmediate();
-    this->v3dView()->Redraw();
+    this->redrawV3dView();
 }
 
 #endif // OCC_VERSION_HEX >= 0x070600
@@ -171,9 +216,9 @@ Handle_Graphic3d_GraphicDriver QWidgetOccView::createCompatibleGraphicsDriver()
     return QWidgetOccView_createCompatibleGraphicsDriver();
 }
 
-void QWidgetOccView::redraw()
+void QWidgetOccView::renderFrame()
 {
-    this->v3dView()->Redraw();
+    this->redrawV3dView();
 }
 
 QWidgetOccView* QWidgetOccView::create(const Handle_V3d_View& view, QWidget* parent)
@@ -195,7 +240,7 @@ void QWidgetOccView::showEvent(QShowEvent*)
 
 void QWidgetOccView::paintEvent(QPaintEvent*)
 {
-    this->v3dView()->Redraw();
+    this->redrawV3dView();
 }
 
 void QWidgetOccView::resizeEvent(QResizeEvent* event)
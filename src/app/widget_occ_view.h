@@ -10,6 +10,7 @@
 #include <Standard_Version.hxx>
 #include <V3d_View.hxx>
 
+#include <QtCore/QElapsedTimer>
 #include <QtWidgets/QWidget>
 #if OCC_VERSION_HEX >= 0x070600
 #  include <QOpenGLWidget> // WARNING Qt5 <QtWidgets/...> / Qt6 <QtOpenGLWidgets/...>
@@ -19,13 +20,36 @@
 
 namespace Mayo {
 
+// Statistics about the frames rendered by a IWidgetOccView
+struct WidgetOccViewFrameStats {
+    int redrawRequestCount = 0; // Count of calls to IWidgetOccView::redraw()
+    int frameCount = 0; // Count of frames actually rendered
+    double lastFrameTimeMs = 0.;
+    double maxFrameTimeMs = 0.;
+    double totalFrameTimeMs = 0.;
+
+    double averageFrameTimeMs() const { return frameCount > 0 ? totalFrameTimeMs / frameCount : 0.; }
+};
+
 // Base interface for bridging Qt and OpenCascade 3D view
 // IWidgetOccView does not handle input devices interaction like keyboard and mouse
 class IWidgetOccView {
 public:
     const Handle_V3d_View& v3dView() const { return m_view; }
 
-    virtual void redraw() = 0;
+    // Marks the view as dirty, rendering is deferred to the event loop
+    // Redraw requests are coalesced so the view is rendered at most once per frameInterval()
+    void redraw();
+    bool isRedrawPending() const { return m_isRedrawPending; }
+
+    // Minimum time between two frames, in milliseconds
+    // Defaults to the refresh period of the primary screen
+    int frameInterval() const { return m_frameInterval; }
+    void setFrameInterval(int ms) { m_frameInterval = ms; }
+
+    const WidgetOccViewFrameStats& frameStats() const { return m_frameStats; }
+    void resetFrameStats() { m_frameStats = {}; }
+
     virtual QWidget* widget() = 0;
     virtual bool supportsWidgetOpacity() const = 0;
 
@@ -34,10 +58,20 @@ public:
     static IWidgetOccView* create(const Handle_V3d_View& view, QWidget* parent = nullptr);
 
 protected:
-    IWidgetOccView(const Handle_V3d_View& view) : m_view(view) {}
+    IWidgetOccView(const Handle_V3d_View& view);
+
+    // Renders a frame for a pending redraw request, might be asynchronous(eg QWidget::update())
+    virtual void renderFrame() = 0;
+
+    // Redraws V3d_View and records frame time, to be called by the actual painting function
+    void redrawV3dView();
 
 private:
     Handle_V3d_View m_view;
+    bool m_isRedrawPending = false;
+    int m_frameInterval = 0;
+    QElapsedTimer m_lastFrameTimer;
+    WidgetOccViewFrameStats m_frameStats;
 };
 
 #if OCC_VERSION_HEX >= 0x070600
@@ -48,7 +82,6 @@ class QOpenGLWidgetOccView : public QOpenGLWidget, public IWidgetOccView {
 public:
     QOpenGLWidgetOccView(const Handle_V3d_View& view, QWidget* parent = nullptr);
 
-    void redraw() override;
     QWidget* widget() override { return this; }
     bool supportsWidgetOpacity() const override { return true; }
 
@@ -56,6 +89,8 @@ public:
     static Handle_Graphic3d_GraphicDriver createCompatibleGraphicsDriver();
 
 protected:
+    void renderFrame() override;
+
     // -- QOpenGLWidget
     void initializeGL() override;
     void paintGL() override;
@@ -67,7 +102,6 @@ class QWidgetOccView : public QWidget, public IWidgetOccView {
 public:
     QWidgetOccView(const Handle_V3d_View& view, QWidget* parent = nullptr);
 
-    void redraw() override;
     QWidget* widget() override { return this; }
     bool supportsWidgetOpacity() const override { return false; }
 
@@ -75,6 +109,8 @@ public:
     static Handle_Graphic3d_GraphicDriver createCompatibleGraphicsDriver();
 
 protected:
+    void renderFrame() override;
+
     // -- QWidget
     void showEvent(QShowEvent* event) override;
     void paintEvent(QPaintEvent* event) override;
@@ -5,6 +5,7 @@
 ****************************************************************************/
 
 #include "widget_occ_view_controller.h"
+#include "../base/unit_system.h"
 #include "widget_occ_view.h"
 #include "theme.h"
 
@@ -109,6 +110,8 @@ WidgetOccViewController::WidgetOccViewController(IWidgetOccView* occView)
     m_inputSequence.setPrePushCallback([=](Input in) { m_actionMatcher->onInputPrePush(in); });
     m_inputSequence.setPreReleaseCallback([=](Input in) { m_actionMatcher->onInputPreRelease(in); });
     m_inputSequence.setClearCallback([=] { m_actionMatcher->onInputCleared(); });
+    m_interactionIdleTimer.setSingleShot(true);
+    QObject::connect(&m_interactionIdleTimer, &QTimer::timeout, this, [=]{ this->endInteractionMode(); });
 }
 
 bool WidgetOccViewController::eventFilter(QObject* watched, QEvent* event)
@@ -192,6 +195,11 @@ std::unique_ptr<V3dViewController::IRubberBand> WidgetOccViewController::createR
     return std::make_unique<RubberBand>(m_occView->widget());
 }
 
+void WidgetOccViewController::startInteractionIdleTimer(QuantityTime idleTime)
+{
+    m_interactionIdleTimer.start(static_cast<int>(UnitSystem::milliseconds(idleTime).value));
+}
+
 void WidgetOccViewController::handleEvent(const QEvent* event)
 {
     switch (event->type()) {
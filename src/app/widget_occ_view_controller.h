@@ -11,6 +11,7 @@
 
 #include <QtCore/QObject>
 #include <QtCore/QPoint>
+#include <QtCore/QTimer>
 #include <functional>
 #include <memory>
 #include <vector>
@@ -51,6 +52,8 @@ private:
     std::unique_ptr<IRubberBand> createRubberBand() override;
     struct RubberBand;
 
+    void startInteractionIdleTimer(QuantityTime idleTime) override;
+
     void handleEvent(const QEvent* event);
     void handleKeyPress(const QKeyEvent* event);
     void handleKeyRelease(const QKeyEvent* event);
@@ -124,6 +127,7 @@ private:
     NavigationStyle m_navigStyle = NavigationStyle::Mayo;
     InputSequence m_inputSequence;
     std::unique_ptr<ActionMatcher> m_actionMatcher;
+    QTimer m_interactionIdleTimer;
 };
 
 } // namespace Mayo
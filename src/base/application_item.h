@@ -33,3 +33,16 @@ private:
 };
 
 } // namespace Mayo
+
+namespace std {
+
+// Specialization of C++11 std::hash<> functor for ApplicationItem
+template<> struct hash<Mayo::ApplicationItem> {
+    inline size_t operator()(const Mayo::ApplicationItem& item) const {
+        const size_t hashDoc = hash<const Mayo::Document*>{}(item.document().get());
+        const size_t hashNode = hash<Mayo::TreeNodeId>{}(item.documentTreeNode().id());
+        return hashDoc ^ (hashNode + 0x9e3779b9 + (hashDoc << 6) + (hashDoc >> 2));
+    }
+};
+
+} // namespace std
@@ -6,23 +6,9 @@
 
 #include "application_item_selection_model.h"
 
-namespace Mayo {
-
-namespace Internal {
-
-static bool hasApplicationItem(Span<ApplicationItem> vec, const ApplicationItem& item)
-{
-    auto itFound = std::find(vec.begin(), vec.end(), item);
-    return itFound != vec.end();
-}
+#include <algorithm>
 
-static std::vector<ApplicationItem>::iterator findApplicationItem(
-        std::vector<ApplicationItem>& vec, const ApplicationItem& item)
-{
-    return std::find(vec.begin(), vec.end(), item);
-}
-
-} // namespace Internal
+namespace Mayo {
 
 Span<const ApplicationItem> ApplicationItemSelectionModel::selectedItems() const
 {
@@ -31,12 +17,12 @@ Span<const ApplicationItem> ApplicationItemSelectionModel::selectedItems() const
 
 bool ApplicationItemSelectionModel::isSelected(const ApplicationItem& item)
 {
-    return Internal::hasApplicationItem(m_vecSelectedItem, item);
+    return m_setSelectedItem.find(item) != m_setSelectedItem.cend();
 }
 
 void ApplicationItemSelectionModel::add(const ApplicationItem& item)
 {
-    if (!Internal::hasApplicationItem(m_vecSelectedItem, item)) {
+    if (m_setSelectedItem.insert(item).second) {
         m_vecSelectedItem.push_back(item);
         std::vector<ApplicationItem> vecItem = { item };
         this->signalChanged.send(vecItem, {});
@@ -47,7 +33,7 @@ void ApplicationItemSelectionModel::add(Span<ApplicationItem> vecItem)
 {
     std::vector<ApplicationItem> signalVecItem;
     for (const ApplicationItem& item : vecItem) {
-        if (!Internal::hasApplicationItem(m_vecSelectedItem, item)) {
+        if (m_setSelectedItem.insert(item).second) {
             m_vecSelectedItem.push_back(item);
             signalVecItem.push_back(item);
         }
@@ -59,8 +45,8 @@ void ApplicationItemSelectionModel::add(Span<ApplicationItem> vecItem)
 
 void ApplicationItemSelectionModel::remove(const ApplicationItem& item)
 {
-    auto itFound = Internal::findApplicationItem(m_vecSelectedItem, item);
-    if (itFound != m_vecSelectedItem.end()) {
+    if (m_setSelectedItem.erase(item) != 0) {
+        auto itFound = std::find(m_vecSelectedItem.begin(), m_vecSelectedItem.end(), item);
         m_vecSelectedItem.erase(itFound);
         std::vector<ApplicationItem> vecItem = { item };
         this->signalChanged.send({}, vecItem);
@@ -69,17 +55,26 @@ void ApplicationItemSelectionModel::remove(const ApplicationItem& item)
 
 void ApplicationItemSelectionModel::remove(Span<ApplicationItem> vecItem)
 {
+    std::unordered_set<ApplicationItem> setRemovedItem;
     std::vector<ApplicationItem> signalVecItem;
     for (const ApplicationItem& item : vecItem) {
-        auto itFound = Internal::findApplicationItem(m_vecSelectedItem, item);
-        if (itFound != m_vecSelectedItem.end()) {
-            m_vecSelectedItem.erase(itFound);
+        if (m_setSelectedItem.erase(item) != 0) {
+            setRemovedItem.insert(item);
             signalVecItem.push_back(item);
         }
     }
 
-    if (!signalVecItem.empty())
-        this->signalChanged.send({}, signalVecItem);
+    if (signalVecItem.empty())
+        return;
+
+    // Single pass over selected items, keeping selection order
+    auto itRemoved = std::remove_if(
+                m_vecSelectedItem.begin(),
+                m_vecSelectedItem.end(),
+                [&](const ApplicationItem& item) { return setRemovedItem.find(item) != setRemovedItem.cend(); }
+    );
+    m_vecSelectedItem.erase(itRemoved, m_vecSelectedItem.end());
+    this->signalChanged.send({}, signalVecItem);
 }
 
 void ApplicationItemSelectionModel::clear()
@@ -88,6 +83,7 @@ void ApplicationItemSelectionModel::clear()
         // Warning: slots connected to changed() signal may indirectly access m_vecSelectedItem
         const auto vecDeselectedItem = m_vecSelectedItem;
         m_vecSelectedItem.clear();
+        m_setSelectedItem.clear();
         this->signalChanged.send({}, vecDeselectedItem);
     }
 }
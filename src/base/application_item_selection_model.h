@@ -10,6 +10,9 @@
 #include "signal.h"
 #include "span.h"
 
+#include <unordered_set>
+#include <vector>
+
 namespace Mayo {
 
 // Keeps track of the items selected in an Application object
@@ -31,7 +34,8 @@ public:
     Signal<Span<const ApplicationItem>, Span<const ApplicationItem>> signalChanged;
 
 private:
-    std::vector<ApplicationItem> m_vecSelectedItem;
+    std::vector<ApplicationItem> m_vecSelectedItem; // Keeps selection order
+    std::unordered_set<ApplicationItem> m_setSelectedItem; // Fast lookup
 };
 
 } // namespace Mayo
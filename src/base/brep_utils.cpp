@@ -6,7 +6,10 @@
 
 #include "brep_utils.h"
 
+#include "cpp_utils.h"
 #include "global.h"
+#include "mesh_utils.h"
+#include "task_progress.h"
 #include "tkernel_utils.h"
 #if OCC_VERSION_HEX >= OCC_VERSION_CHECK(7, 5, 0)
 #  include "occ_progress_indicator.h"
@@ -16,9 +19,16 @@
 #include <BRep_Builder.hxx>
 #include <BRep_Tool.hxx>
 #include <BRepTools.hxx>
+#include <TopExp.hxx>
 #include <TopoDS_Compound.hxx>
+#include <TopTools_IndexedMapOfShape.hxx>
+#include <TopTools_MapOfShape.hxx>
+#if OCC_VERSION_HEX >= OCC_VERSION_CHECK(7, 6, 0)
+#  include <Poly_ListOfTriangulation.hxx>
+#endif
 #include <climits>
 #include <sstream>
+#include <vector>
 
 namespace Mayo {
 
@@ -80,6 +90,39 @@ bool BRepUtils::isGeometric(const TopoDS_Face& face)
 #endif
 }
 
+std::int64_t BRepUtils::triangleCount(const TopoDS_Shape& shape)
+{
+    TopTools_MapOfShape mapFace;
+    std::int64_t count = 0;
+    BRepUtils::forEachSubFace(shape, [&](const TopoDS_Face& face) {
+        if (mapFace.Add(face.Located(TopLoc_Location()))) {
+            TopLoc_Location loc;
+            const Handle_Poly_Triangulation& triangulation = BRep_Tool::Triangulation(face, loc);
+            if (!triangulation.IsNull())
+                count += triangulation->NbTriangles();
+        }
+    });
+    return count;
+}
+
+std::size_t BRepUtils::triangulationMemorySize(const TopoDS_Shape& shape)
+{
+    TopTools_MapOfShape mapFace;
+    std::size_t size = 0;
+    BRepUtils::forEachSubFace(shape, [&](const TopoDS_Face& face) {
+        if (mapFace.Add(face.Located(TopLoc_Location()))) {
+            TopLoc_Location loc;
+#if OCC_VERSION_HEX >= OCC_VERSION_CHECK(7, 6, 0)
+            for (const Handle_Poly_Triangulation& triangulation : BRep_Tool::Triangulations(face, loc))
+                size += MeshUtils::triangulationMemorySize(triangulation);
+#else
+            size += MeshUtils::triangulationMemorySize(BRep_Tool::Triangulation(face, loc));
+#endif
+        }
+    });
+    return size;
+}
+
 void BRepUtils::computeMesh(
         const TopoDS_Shape& shape, const OccBRepMeshParameters& params, TaskProgress* progress)
 {
@@ -93,4 +136,44 @@ void BRepUtils::computeMesh(
     MAYO_UNUSED(mesher);
 }
 
+void BRepUtils::computeMeshLods(
+        const TopoDS_Shape& shape, Span<const OccBRepMeshParameters> spanParams, TaskProgress* progress)
+{
+    if (spanParams.empty())
+        return;
+
+#if OCC_VERSION_HEX >= OCC_VERSION_CHECK(7, 6, 0)
+    if (spanParams.size() == 1) {
+        BRepUtils::computeMesh(shape, spanParams.front(), progress);
+        return;
+    }
+
+    TopTools_IndexedMapOfShape mapFace;
+    TopExp::MapShapes(shape, TopAbs_FACE, mapFace);
+    std::vector<Poly_ListOfTriangulation> vecFaceLods(mapFace.Extent());
+    // BRepMesh replaces the active triangulation of faces, so LODs are computed from coarsest to finest
+    // Triangulation is kept even if not recomputed for a LOD, so LOD indices are the same for all faces
+    const auto lodCount = spanParams.size();
+    for (auto lod = lodCount; lod > 0; --lod) {
+        TaskProgress lodProgress(progress, 100. / lodCount);
+        BRepUtils::computeMesh(shape, spanParams[lod - 1], &lodProgress);
+        for (int i = 1; i <= mapFace.Extent(); ++i) {
+            TopLoc_Location loc;
+            const Handle_Poly_Triangulation& triangulation = BRep_Tool::Triangulation(TopoDS::Face(mapFace(i)), loc);
+            if (!triangulation.IsNull())
+                vecFaceLods.at(i - 1).Prepend(triangulation);
+        }
+    }
+
+    BRep_Builder builder;
+    for (int i = 1; i <= mapFace.Extent(); ++i) {
+        const Poly_ListOfTriangulation& listTriangulation = vecFaceLods.at(i - 1);
+        if (listTriangulation.Size() == CppUtils::safeStaticCast<int>(lodCount))
+            builder.UpdateFace(TopoDS::Face(mapFace(i)), listTriangulation, listTriangulation.First());
+    }
+#else
+    BRepUtils::computeMesh(shape, spanParams.front(), progress);
+#endif
+}
+
 } // namespace Mayo
@@ -7,11 +7,14 @@
 #pragma once
 
 #include "occ_brep_mesh_parameters.h"
+#include "span.h"
 
 #include <Poly_Triangulation.hxx>
 #include <TopoDS_Face.hxx>
 #include <TopExp_Explorer.hxx>
 #include <TopoDS.hxx>
+#include <cstddef>
+#include <cstdint>
 #include <string>
 
 namespace Mayo {
@@ -59,12 +62,31 @@ struct BRepUtils {
     // Does 'face' rely on a geometric surface?
     static bool isGeometric(const TopoDS_Face& face);
 
+    // Returns the count of triangles held by the faces of 'shape'
+    // Faces sharing the same underlying geometry(eg instances of a product) are counted once
+    static std::int64_t triangleCount(const TopoDS_Shape& shape);
+
+    // Returns the estimated memory size in bytes of the triangulations held by the faces of 'shape'
+    // All the levels of detail of the faces are accounted for
+    // Faces sharing the same underlying geometry(eg instances of a product) are counted once
+    static std::size_t triangulationMemorySize(const TopoDS_Shape& shape);
+
     // Computes a mesh representation of 'shape' using OpenCascade meshing algorithm
     static void computeMesh(
             const TopoDS_Shape& shape,
             const OccBRepMeshParameters& params,
             TaskProgress* progress = nullptr
     );
+
+    // Computes multiple mesh representations(levels of detail) of 'shape', one per item of 'spanParams'
+    // Each face then holds one triangulation per LOD, ordered as 'spanParams'(finest LOD expected first)
+    // The finest LOD is the active triangulation of the faces
+    // Requires OpenCascade >= 7.6, otherwise only the first LOD is computed
+    static void computeMeshLods(
+            const TopoDS_Shape& shape,
+            Span<const OccBRepMeshParameters> spanParams,
+            TaskProgress* progress = nullptr
+    );
 };
 
 
@@ -19,6 +19,9 @@ struct BndBoxCoords;
 // Provides helper functions for mathematics purpose
 namespace MathUtils {
 
+// Value of PI, portable replacement of M_PI which isn't standard(eg MSVC needs _USE_MATH_DEFINES)
+constexpr double pi = 3.14159265358979323846;
+
 // Returns the value 'val' which is in range [omin..omax] to the corresponding value in range [nmin..nmax]
 template<typename T, typename T1, typename T2, typename T3, typename T4>
 double mappedValue(T val, T1 omin, T2 omax, T3 nmin, T4 nmax);
@@ -0,0 +1,839 @@
+/****************************************************************************
+** Copyright (c) 2023, Fougue Ltd. <http://www.fougue.pro>
+** All rights reserved.
+** See license at https://github.com/fougue/mayo/blob/master/LICENSE.txt
+****************************************************************************/
+
+#include "mesh_decimation.h"
+#include "mesh_utils.h"
+#include "task_progress.h"
+
+#include <OSD_Parallel.hxx>
+#include <gp_XYZ.hxx>
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <numeric>
+
+namespace Mayo {
+
+namespace {
+
+using TriangleNodes = std::array<int, 3>; // 0-based nodes, -1 if triangle was removed
+
+// Symmetric 4x4 matrix of a quadric error, the sum of the squared distances to a set of planes
+struct Quadric {
+    double a2 = 0, ab = 0, ac = 0, ad = 0, b2 = 0, bc = 0, bd = 0, c2 = 0, cd = 0, d2 = 0;
+
+    // Quadric of the plane of triangle(p1, p2, p3), zero if triangle is degenerate
+    static Quadric fromTriangle(const gp_XYZ& p1, const gp_XYZ& p2, const gp_XYZ& p3)
+    {
+        gp_XYZ n = (p2 - p1).Crossed(p3 - p1);
+        const double nLength = n.Modulus();
+        if (nLength <= 0.)
+            return {};
+
+        n /= nLength;
+        const double a = n.X();
+        const double b = n.Y();
+        const double c = n.Z();
+        const double d = -n.Dot(p1);
+        return { a*a, a*b, a*c, a*d, b*b, b*c, b*d, c*c, c*d, d*d };
+    }
+
+    Quadric& operator+=(const Quadric& other)
+    {
+        a2 += other.a2; ab += other.ab; ac += other.ac; ad += other.ad; b2 += other.b2;
+        bc += other.bc; bd += other.bd; c2 += other.c2; cd += other.cd; d2 += other.d2;
+        return *this;
+    }
+
+    Quadric& operator-=(const Quadric& other)
+    {
+        a2 -= other.a2; ab -= other.ab; ac -= other.ac; ad -= other.ad; b2 -= other.b2;
+        bc -= other.bc; bd -= other.bd; c2 -= other.c2; cd -= other.cd; d2 -= other.d2;
+        return *this;
+    }
+
+    Quadric operator+(const Quadric& other) const
+    {
+        Quadric q = *this;
+        q += other;
+        return q;
+    }
+
+    double error(const gp_XYZ& p) const
+    {
+        const double x = p.X();
+        const double y = p.Y();
+        const double z = p.Z();
+        const double err =
+                a2*x*x + 2*ab*x*y + 2*ac*x*z + 2*ad*x
+                + b2*y*y + 2*bc*y*z + 2*bd*y
+                + c2*z*z + 2*cd*z
+                + d2;
+        return std::max(err, 0.); // Might be slightly negative because of rounding errors
+    }
+
+    // Position minimizing the error, returns false if the quadric matrix is close to singular(eg all
+    // planes are parallel)
+    bool optimalPosition(gp_XYZ* pos) const
+    {
+        const double det = a2*(b2*c2 - bc*bc) - ab*(ab*c2 - bc*ac) + ac*(ab*bc - b2*ac);
+        const double trace = a2 + b2 + c2;
+        if (std::abs(det) <= 1e-8 * trace * trace * trace)
+            return false;
+
+        // Cramer's rule
+        const double rx = -ad;
+        const double ry = -bd;
+        const double rz = -cd;
+        const double detX = rx*(b2*c2 - bc*bc) - ab*(ry*c2 - bc*rz) + ac*(ry*bc - b2*rz);
+        const double detY = a2*(ry*c2 - rz*bc) - rx*(ab*c2 - bc*ac) + ac*(ab*rz - ry*ac);
+        const double detZ = a2*(b2*rz - bc*ry) - ab*(ab*rz - ry*ac) + rx*(ab*bc - b2*ac);
+        pos->SetCoord(detX / det, detY / det, detZ / det);
+        return true;
+    }
+};
+
+// Sorted unique edges of 'vecTriangle'(each edge being a pair of 0-based nodes, lowest one first)
+// Item 'ptrVecEdgeTriangleCount'(optional) receives the count of triangles owning each edge
+std::vector<std::pair<int, int>> uniqueEdges(
+        const std::vector<TriangleNodes>& vecTriangle, std::vector<int>* ptrVecEdgeTriangleCount = nullptr
+    )
+{
+    std::vector<std::pair<int, int>> vecEdge;
+    vecEdge.reserve(3 * vecTriangle.size());
+    for (const TriangleNodes& triangle : vecTriangle) {
+        if (triangle[0] < 0)
+            continue;
+
+        for (int i = 0; i < 3; ++i) {
+            const int n1 = triangle[i];
+            const int n2 = triangle[(i + 1) % 3];
+            vecEdge.emplace_back(std::min(n1, n2), std::max(n1, n2));
+        }
+    }
+
+    std::sort(vecEdge.begin(), vecEdge.end());
+    if (ptrVecEdgeTriangleCount) {
+        ptrVecEdgeTriangleCount->clear();
+        std::size_t writePos = 0;
+        for (std::size_t i = 0; i < vecEdge.size();) {
+            std::size_t j = i + 1;
+            while (j < vecEdge.size() && vecEdge[j] == vecEdge[i])
+                ++j;
+
+            vecEdge[writePos++] = vecEdge[i];
+            ptrVecEdgeTriangleCount->push_back(int(j - i));
+            i = j;
+        }
+
+        vecEdge.resize(writePos);
+    }
+    else {
+        vecEdge.erase(std::unique(vecEdge.begin(), vecEdge.end()), vecEdge.end());
+    }
+
+    return vecEdge;
+}
+
+// Decimates a triangulation held in plain arrays, nodes being 0-based
+// Locked nodes are never moved nor removed, they can only absorb unlocked neighbor nodes
+class QuadricSimplifier {
+public:
+    std::vector<gp_XYZ> vecNodePos;
+    std::vector<Quadric> vecNodeQuadric;
+    std::vector<char> vecNodeLocked;
+    std::vector<TriangleNodes> vecTriangle;
+
+    // Collapses edges by increasing error until triangle count is less or equal to 'targetTriangleCount'
+    // (0 means no target) or error would exceed 'maxSquaredError'(negative means no limit)
+    // Returns false if 'fnAbort' requested interruption
+    bool run(int targetTriangleCount, double maxSquaredError, const std::function<bool()>& fnAbort);
+
+    int triangleCount() const { return m_triangleCount; }
+    double maxSquaredError() const { return m_maxSquaredError; }
+
+private:
+    // Collapse of node 'nodeRemoved' into 'node', which is moved at position 'pos'
+    struct Collapse {
+        double error;
+        int node;
+        int nodeRemoved;
+        gp_XYZ pos;
+    };
+
+    // Collapse waiting in the heap. Position isn't stored to keep items small, the collapse is
+    // evaluated again when popped which gives the same result as its nodes weren't changed meanwhile
+    struct HeapItem {
+        double error;
+        int node;
+        int nodeRemoved;
+        int stamp; // Version of 'node' when collapse was evaluated
+        int stampRemoved; // Version of 'nodeRemoved' when collapse was evaluated
+    };
+
+    // Ordering of the heap, lowest error on top. Ties are broken by node indices so the order of
+    // the collapses is fully determined
+    struct HeapItemGreater {
+        bool operator()(const HeapItem& lhs, const HeapItem& rhs) const {
+            if (lhs.error != rhs.error)
+                return lhs.error > rhs.error;
+
+            if (lhs.node != rhs.node)
+                return lhs.node > rhs.node;
+
+            return lhs.nodeRemoved > rhs.nodeRemoved;
+        }
+    };
+
+    HeapItem heapItem(const Collapse& collapse) const {
+        return {
+            collapse.error, collapse.node, collapse.nodeRemoved,
+            m_vecNodeStamp[collapse.node], m_vecNodeStamp[collapse.nodeRemoved]
+        };
+    }
+
+    bool evaluateCollapse(int n1, int n2, Collapse* collapse) const;
+    bool isCollapseValid(const Collapse& collapse);
+    void applyCollapse(const Collapse& collapse);
+    void collectNeighbors(int node, std::vector<int>* vecNeighbor) const;
+    bool triangleHasNode(int triangle, int node) const;
+
+    std::vector<std::vector<int>> m_vecNodeTriangles;
+    std::vector<int> m_vecNodeStamp;
+    std::vector<HeapItem> m_heapCollapse;
+    std::vector<int> m_vecNeighbor1;
+    std::vector<int> m_vecNeighbor2;
+    int m_triangleCount = 0;
+    double m_maxSquaredError = 0.;
+};
+
+bool QuadricSimplifier::run(int targetTriangleCount, double maxSquaredError, const std::function<bool()>& fnAbort)
+{
+    const auto nodeCount = this->vecNodePos.size();
+    m_vecNodeTriangles.assign(nodeCount, {});
+    m_vecNodeStamp.assign(nodeCount, 0);
+    m_triangleCount = 0;
+    for (int it = 0; it < int(this->vecTriangle.size()); ++it) {
+        const TriangleNodes& triangle = this->vecTriangle[it];
+        if (triangle[0] < 0)
+            continue;
+
+        for (int n : triangle)
+            m_vecNodeTriangles[n].push_back(it);
+
+        ++m_triangleCount;
+    }
+
+    auto fnTargetReached = [=]{ return targetTriangleCount > 0 && m_triangleCount <= targetTriangleCount; };
+    if (fnTargetReached())
+        return true;
+
+    // Initial collapses, evaluated concurrently
+    const std::vector<std::pair<int, int>> vecEdge = uniqueEdges(this->vecTriangle);
+    std::vector<HeapItem> vecHeapItem(vecEdge.size());
+    std::vector<char> vecCollapseDefined(vecEdge.size(), 0);
+    OSD_Parallel::For(0, int(vecEdge.size()), [&](int i) {
+        const auto& [n1, n2] = vecEdge[i];
+        Collapse collapse;
+        if (this->evaluateCollapse(n1, n2, &collapse)) {
+            vecHeapItem[i] = this->heapItem(collapse);
+            vecCollapseDefined[i] = 1;
+        }
+    });
+
+    m_heapCollapse.clear();
+    m_heapCollapse.reserve(vecEdge.size());
+    for (std::size_t i = 0; i < vecHeapItem.size(); ++i) {
+        if (vecCollapseDefined[i])
+            m_heapCollapse.push_back(vecHeapItem[i]);
+    }
+
+    vecHeapItem = {};
+    std::make_heap(m_heapCollapse.begin(), m_heapCollapse.end(), HeapItemGreater());
+
+    unsigned iteration = 0;
+    while (!m_heapCollapse.empty() && !fnTargetReached()) {
+        if ((++iteration & 0xFFF) == 0 && fnAbort && fnAbort())
+            return false;
+
+        std::pop_heap(m_heapCollapse.begin(), m_heapCollapse.end(), HeapItemGreater());
+        const HeapItem item = m_heapCollapse.back();
+        m_heapCollapse.pop_back();
+        // Skip collapses evaluated before one of their nodes was changed
+        if (item.stamp != m_vecNodeStamp[item.node] || item.stampRemoved != m_vecNodeStamp[item.nodeRemoved])
+            continue;
+
+        if (maxSquaredError >= 0 && item.error > maxSquaredError)
+            break;
+
+        Collapse collapse;
+        this->evaluateCollapse(item.node, item.nodeRemoved, &collapse);
+        if (this->isCollapseValid(collapse))
+            this->applyCollapse(collapse);
+    }
+
+    return true;
+}
+
+bool QuadricSimplifier::evaluateCollapse(int n1, int n2, Collapse* collapse) const
+{
+    const bool n1Locked = this->vecNodeLocked[n1];
+    const bool n2Locked = this->vecNodeLocked[n2];
+    if (n1Locked && n2Locked)
+        return false;
+
+    const Quadric quadric = this->vecNodeQuadric[n1] + this->vecNodeQuadric[n2];
+    const gp_XYZ& pnt1 = this->vecNodePos[n1];
+    const gp_XYZ& pnt2 = this->vecNodePos[n2];
+    if (n1Locked || n2Locked) {
+        // Unlocked node is merged into the locked one
+        collapse->node = n1Locked ? n1 : n2;
+        collapse->nodeRemoved = n1Locked ? n2 : n1;
+        collapse->pos = n1Locked ? pnt1 : pnt2;
+        collapse->error = quadric.error(collapse->pos);
+    }
+    else {
+        // Best position among the optimal one(if not too far from the edge), the edge middle and
+        // end points
+        const gp_XYZ pntMid = 0.5 * (pnt1 + pnt2);
+        const double edgeSquareLength = (pnt2 - pnt1).SquareModulus();
+        gp_XYZ candidates[4] = { pntMid, pntMid, pnt1, pnt2 };
+        const bool hasOptimalPos =
+                quadric.optimalPosition(&candidates[0])
+                && (candidates[0] - pntMid).SquareModulus() <= edgeSquareLength;
+        collapse->error = -1;
+        for (int i = hasOptimalPos ? 0 : 1; i < 4; ++i) {
+            const double error = quadric.error(candidates[i]);
+            if (collapse->error < 0 || error < collapse->error) {
+                collapse->error = error;
+                collapse->pos = candidates[i];
+            }
+        }
+
+        // Node closest to the new position is kept, so its per-node data(eg color) stays relevant
+        const bool keepNode1 =
+                (collapse->pos - pnt1).SquareModulus() <= (collapse->pos - pnt2).SquareModulus();
+        collapse->node = keepNode1 ? n1 : n2;
+        collapse->nodeRemoved = keepNode1 ? n2 : n1;
+    }
+
+    return true;
+}
+
+bool QuadricSimplifier::isCollapseValid(const Collapse& collapse)
+{
+    const int node = collapse.node;
+    const int nodeRemoved = collapse.nodeRemoved;
+    int sharedTriangleCount = 0;
+    for (int it : m_vecNodeTriangles[node]) {
+        if (this->triangleHasNode(it, nodeRemoved))
+            ++sharedTriangleCount;
+    }
+
+    if (sharedTriangleCount == 0)
+        return false;
+
+    // Link condition: the nodes adjacent to both edge nodes must be the ones opposite to the edge,
+    // otherwise the collapse would produce non-manifold edges
+    this->collectNeighbors(node, &m_vecNeighbor1);
+    this->collectNeighbors(nodeRemoved, &m_vecNeighbor2);
+    int commonNeighborCount = 0;
+    auto itNeighbor1 = m_vecNeighbor1.cbegin();
+    auto itNeighbor2 = m_vecNeighbor2.cbegin();
+    while (itNeighbor1 != m_vecNeighbor1.cend() && itNeighbor2 != m_vecNeighbor2.cend()) {
+        if (*itNeighbor1 < *itNeighbor2) {
+            ++itNeighbor1;
+        }
+        else if (*itNeighbor2 < *itNeighbor1) {
+            ++itNeighbor2;
+        }
+        else {
+            ++commonNeighborCount;
+            ++itNeighbor1;
+            ++itNeighbor2;
+        }
+    }
+
+    if (commonNeighborCount != sharedTriangleCount)
+        return false;
+
+    // Remaining triangles must not be flipped nor become degenerate
+    constexpr double minNormalCosine = 0.5;
+    for (int movedNode : { node, nodeRemoved }) {
+        for (int it : m_vecNodeTriangles[movedNode]) {
+            if (this->triangleHasNode(it, node) && this->triangleHasNode(it, nodeRemoved))
+                continue; // Triangle removed by the collapse
+
+            const TriangleNodes& triangle = this->vecTriangle[it];
+            gp_XYZ pnts[3];
+            gp_XYZ pntsMoved[3];
+            for (int i = 0; i < 3; ++i) {
+                pnts[i] = this->vecNodePos[triangle[i]];
+                pntsMoved[i] = triangle[i] == movedNode ? collapse.pos : pnts[i];
+            }
+
+            const gp_XYZ normal = (pnts[1] - pnts[0]).Crossed(pnts[2] - pnts[0]);
+            const gp_XYZ normalMoved = (pntsMoved[1] - pntsMoved[0]).Crossed(pntsMoved[2] - pntsMoved[0]);
+            const double normalSquareLength = normal.SquareModulus();
+            if (normalSquareLength <= 0.)
+                continue; // Source triangle already degenerate
+
+            const double cosLimit = minNormalCosine * std::sqrt(normalSquareLength * normalMoved.SquareModulus());
+            if (normal.Dot(normalMoved) <= cosLimit)
+                return false;
+        }
+    }
+
+    return true;
+}
+
+void QuadricSimplifier::applyCollapse(const Collapse& collapse)
+{
+    const int node = collapse.node;
+    const int nodeRemoved = collapse.nodeRemoved;
+    auto fnEraseTriangle = [](std::vector<int>& vecTriangleIndex, int triangle) {
+        auto it = std::find(vecTriangleIndex.begin(), vecTriangleIndex.end(), triangle);
+        if (it != vecTriangleIndex.end()) {
+            *it = vecTriangleIndex.back();
+            vecTriangleIndex.pop_back();
+        }
+    };
+
+    for (int it : m_vecNodeTriangles[nodeRemoved]) {
+        TriangleNodes& triangle = this->vecTriangle[it];
+        if (this->triangleHasNode(it, node)) {
+            // Triangle owning the collapsed edge, it vanishes
+            for (int n : triangle) {
+                if (n != nodeRemoved)
+                    fnEraseTriangle(m_vecNodeTriangles[n], it);
+            }
+
+            triangle = { -1, -1, -1 };
+            --m_triangleCount;
+        }
+        else {
+            std::replace(triangle.begin(), triangle.end(), nodeRemoved, node);
+            m_vecNodeTriangles[node].push_back(it);
+        }
+    }
+
+    m_vecNodeTriangles[nodeRemoved] = {};
+    this->vecNodePos[node] = collapse.pos;
+    this->vecNodeQuadric[node] += this->vecNodeQuadric[nodeRemoved];
+    ++m_vecNodeStamp[node];
+    ++m_vecNodeStamp[nodeRemoved];
+    m_maxSquaredError = std::max(m_maxSquaredError, collapse.error);
+
+    // Collapses of the edges around the kept node have to be evaluated again
+    this->collectNeighbors(node, &m_vecNeighbor1);
+    for (int neighbor : m_vecNeighbor1) {
+        Collapse neighborCollapse;
+        if (this->evaluateCollapse(node, neighbor, &neighborCollapse)) {
+            m_heapCollapse.push_back(this->heapItem(neighborCollapse));
+            std::push_heap(m_heapCollapse.begin(), m_heapCollapse.end(), HeapItemGreater());
+        }
+    }
+}
+
+void QuadricSimplifier::collectNeighbors(int node, std::vector<int>* vecNeighbor) const
+{
+    vecNeighbor->clear();
+    for (int it : m_vecNodeTriangles[node]) {
+        for (int n : this->vecTriangle[it]) {
+            if (n != node)
+                vecNeighbor->push_back(n);
+        }
+    }
+
+    std::sort(vecNeighbor->begin(), vecNeighbor->end());
+    vecNeighbor->erase(std::unique(vecNeighbor->begin(), vecNeighbor->end()), vecNeighbor->end());
+}
+
+bool QuadricSimplifier::triangleHasNode(int triangle, int node) const
+{
+    const TriangleNodes& nodes = this->vecTriangle[triangle];
+    return nodes[0] == node || nodes[1] == node || nodes[2] == node;
+}
+
+// Fills 'simplifier' with the triangles 'vecTriangleIndex' of 'vecTriangle', nodes being renumbered
+// Returns the source node of each node of 'simplifier', by increasing index
+std::vector<int> initSimplifier(
+        QuadricSimplifier* simplifier,
+        const std::vector<TriangleNodes>& vecTriangle,
+        Span<const int> spanTriangleIndex,
+        const std::vector<gp_XYZ>& vecNodePos,
+        const std::vector<Quadric>& vecNodeQuadric,
+        const std::function<bool(int)>& fnIsNodeLocked
+    )
+{
+    std::vector<int> vecSourceNode;
+    vecSourceNode.reserve(3 * spanTriangleIndex.size());
+    for (int it : spanTriangleIndex)
+        vecSourceNode.insert(vecSourceNode.end(), vecTriangle[it].begin(), vecTriangle[it].end());
+
+    std::sort(vecSourceNode.begin(), vecSourceNode.end());
+    vecSourceNode.erase(std::unique(vecSourceNode.begin(), vecSourceNode.end()), vecSourceNode.end());
+    const auto nodeCount = vecSourceNode.size();
+    simplifier->vecNodePos.resize(nodeCount);
+    simplifier->vecNodeQuadric.resize(nodeCount);
+    simplifier->vecNodeLocked.resize(nodeCount);
+    for (std::size_t i = 0; i < nodeCount; ++i) {
+        const int sourceNode = vecSourceNode[i];
+        simplifier->vecNodePos[i] = vecNodePos[sourceNode];
+        simplifier->vecNodeQuadric[i] = vecNodeQuadric[sourceNode];
+        simplifier->vecNodeLocked[i] = fnIsNodeLocked(sourceNode);
+    }
+
+    simplifier->vecTriangle.resize(spanTriangleIndex.size());
+    auto fnNode = [&](int sourceNode) {
+        return int(std::lower_bound(vecSourceNode.cbegin(), vecSourceNode.cend(), sourceNode) - vecSourceNode.cbegin());
+    };
+    for (std::size_t i = 0; i < spanTriangleIndex.size(); ++i) {
+        const TriangleNodes& sourceTriangle = vecTriangle[spanTriangleIndex[i]];
+        simplifier->vecTriangle[i] = { fnNode(sourceTriangle[0]), fnNode(sourceTriangle[1]), fnNode(sourceTriangle[2]) };
+    }
+
+    return vecSourceNode;
+}
+
+} // namespace
+
+MeshDecimation::Result MeshDecimation::decimate(
+        const Handle_Poly_Triangulation& triangulation,
+        const Parameters& params,
+        TaskProgress* progress
+    )
+{
+    Result result;
+    if (!triangulation)
+        return result;
+
+    const int nodeCount = triangulation->NbNodes();
+    const int triangleCount = triangulation->NbTriangles();
+    const bool hasMaxError = params.maxError >= 0;
+    if (params.targetTriangleCount >= triangleCount || (params.targetTriangleCount <= 0 && !hasMaxError)) {
+        result.triangulation = triangulation;
+        result.vecSourceNode.resize(nodeCount);
+        std::iota(result.vecSourceNode.begin(), result.vecSourceNode.end(), 1);
+        return result;
+    }
+
+    const int targetTriangleCount = std::max(params.targetTriangleCount, 0);
+    const double maxSquaredError = hasMaxError ? params.maxError * params.maxError : -1.;
+    auto fnAbort = [=]{ return TaskProgress::isAbortRequested(progress); };
+
+    // Source nodes and triangles, triangles referencing some node more than once are dropped
+    std::vector<gp_XYZ> vecNodePos(nodeCount);
+    OSD_Parallel::For(0, nodeCount, [&](int i) {
+        vecNodePos[i] = triangulation->Node(i + 1).XYZ();
+    });
+
+    std::vector<TriangleNodes> vecTriangle(triangleCount);
+    const Poly_Array1OfTriangle& triangles = MeshUtils::triangles(triangulation);
+    for (int it = 0; it < triangleCount; ++it) {
+        int n1, n2, n3;
+        triangles(it + 1).Get(n1, n2, n3);
+        if (n1 != n2 && n2 != n3 && n3 != n1)
+            vecTriangle[it] = { n1 - 1, n2 - 1, n3 - 1 };
+        else
+            vecTriangle[it] = { -1, -1, -1 };
+    }
+
+    // Quadric at each node is the sum of the quadrics of the planes of the adjacent triangles
+    std::vector<Quadric> vecTriangleQuadric(triangleCount);
+    OSD_Parallel::For(0, triangleCount, [&](int it) {
+        const TriangleNodes& triangle = vecTriangle[it];
+        if (triangle[0] >= 0) {
+            vecTriangleQuadric[it] = Quadric::fromTriangle(
+                        vecNodePos[triangle[0]], vecNodePos[triangle[1]], vecNodePos[triangle[2]]
+            );
+        }
+    });
+
+    std::vector<Quadric> vecNodeQuadric(nodeCount);
+    for (int it = 0; it < triangleCount; ++it) {
+        const TriangleNodes& triangle = vecTriangle[it];
+        if (triangle[0] >= 0) {
+            for (int n : triangle)
+                vecNodeQuadric[n] += vecTriangleQuadric[it];
+        }
+    }
+
+    vecTriangleQuadric = {};
+
+    // Nodes of border and non-manifold edges are locked
+    std::vector<char> vecNodeLocked(nodeCount, 0);
+    {
+        std::vector<int> vecEdgeTriangleCount;
+        const std::vector<std::pair<int, int>> vecEdge = uniqueEdges(vecTriangle, &vecEdgeTriangleCount);
+        for (std::size_t i = 0; i < vecEdge.size(); ++i) {
+            if (vecEdgeTriangleCount[i] != 2) {
+                vecNodeLocked[vecEdge[i].first] = 1;
+                vecNodeLocked[vecEdge[i].second] = 1;
+            }
+        }
+    }
+
+    if (progress)
+        progress->setValue(10);
+
+    std::vector<int> vecTriangleIndex;
+    vecTriangleIndex.reserve(triangleCount);
+    for (int it = 0; it < triangleCount; ++it) {
+        if (vecTriangle[it][0] >= 0)
+            vecTriangleIndex.push_back(it);
+    }
+
+    // Chunks stop a bit above their share of the target, so the final pass can also collapse edges
+    // around the nodes locked by chunks
+    constexpr double chunkTargetRatio = 1.5;
+    constexpr int nodeSharedByChunks = -2;
+    // Chunk count only depends on the triangulation so the result is the same whatever the machine,
+    // chunks are then scheduled over the available threads
+    const int minChunkTriangleCount = std::max(params.minChunkTriangleCount, 1);
+    int chunkCount = int(vecTriangleIndex.size()) / minChunkTriangleCount;
+    auto fnChunkTriangles = [&](int chunk) {
+        const auto count = vecTriangleIndex.size();
+        const auto first = (count * chunk) / chunkCount;
+        const auto last = (count * (chunk + 1)) / chunkCount;
+        return Span<const int>(vecTriangleIndex.data() + first, last - first);
+    };
+
+    std::vector<int> vecNodeChunk;
+    if (chunkCount >= 2) {
+        // Triangles sorted by centroid along the longest axis of the bounding box, then split into
+        // slabs of equal triangle counts
+        gp_XYZ pntMin = vecNodePos.front();
+        gp_XYZ pntMax = vecNodePos.front();
+        for (const gp_XYZ& pnt : vecNodePos) {
+            for (int i = 1; i <= 3; ++i) {
+                pntMin.SetCoord(i, std::min(pntMin.Coord(i), pnt.Coord(i)));
+                pntMax.SetCoord(i, std::max(pntMax.Coord(i), pnt.Coord(i)));
+            }
+        }
+
+        const gp_XYZ boxSize = pntMax - pntMin;
+        int axis = 1;
+        if (boxSize.Y() > boxSize.Coord(axis))
+            axis = 2;
+
+        if (boxSize.Z() > boxSize.Coord(axis))
+            axis = 3;
+
+        std::vector<double> vecTriangleCentroid(triangleCount);
+        OSD_Parallel::For(0, int(vecTriangleIndex.size()), [&](int i) {
+            const TriangleNodes& triangle = vecTriangle[vecTriangleIndex[i]];
+            double centroid = 0.;
+            for (int n : triangle)
+                centroid += vecNodePos[n].Coord(axis);
+
+            vecTriangleCentroid[vecTriangleIndex[i]] = centroid;
+        });
+        std::sort(vecTriangleIndex.begin(), vecTriangleIndex.end(), [&](int lhs, int rhs) {
+            const double lhsCentroid = vecTriangleCentroid[lhs];
+            const double rhsCentroid = vecTriangleCentroid[rhs];
+            return lhsCentroid != rhsCentroid ? lhsCentroid < rhsCentroid : lhs < rhs;
+        });
+        vecTriangleCentroid = {};
+
+        // Nodes used by several chunks are locked during decimation of the chunks
+        vecNodeChunk.resize(nodeCount, -1);
+        for (int chunk = 0; chunk < chunkCount; ++chunk) {
+            for (int it : fnChunkTriangles(chunk)) {
+                for (int n : vecTriangle[it]) {
+                    if (vecNodeChunk[n] == -1)
+                        vecNodeChunk[n] = chunk;
+                    else if (vecNodeChunk[n] != chunk)
+                        vecNodeChunk[n] = nodeSharedByChunks;
+                }
+            }
+        }
+
+        // Chunking is pointless when the target is so low that nodes locked by the chunks would take
+        // a significant part of it
+        const auto sharedNodeCount = std::count(vecNodeChunk.cbegin(), vecNodeChunk.cend(), nodeSharedByChunks);
+        if (targetTriangleCount > 0 && 4 * sharedNodeCount > targetTriangleCount)
+            chunkCount = 0;
+    }
+
+    double maxChunkSquaredError = 0.;
+    if (chunkCount >= 2) {
+        auto fnIsChunkNodeLocked = [&](int n) {
+            return vecNodeLocked[n] || vecNodeChunk[n] == nodeSharedByChunks;
+        };
+
+        // Target is spread over the chunks according to their triangle counts
+        std::vector<QuadricSimplifier> vecChunkSimplifier(chunkCount);
+        std::vector<std::vector<int>> vecChunkSourceNode(chunkCount);
+        std::vector<char> vecChunkDone(chunkCount, 0);
+        OSD_Parallel::For(0, chunkCount, [&](int chunk) {
+            const Span<const int> spanChunkTriangle = fnChunkTriangles(chunk);
+            QuadricSimplifier& simplifier = vecChunkSimplifier[chunk];
+            vecChunkSourceNode[chunk] = initSimplifier(
+                        &simplifier, vecTriangle, spanChunkTriangle, vecNodePos, vecNodeQuadric, fnIsChunkNodeLocked
+            );
+            const int chunkTarget =
+                    targetTriangleCount > 0 ?
+                        std::max(int((chunkTargetRatio * targetTriangleCount * spanChunkTriangle.size()) / triangleCount), 1) :
+                        0;
+            vecChunkDone[chunk] = simplifier.run(chunkTarget, maxSquaredError, fnAbort);
+        });
+
+        if (std::find(vecChunkDone.cbegin(), vecChunkDone.cend(), 0) != vecChunkDone.cend())
+            return result; // Aborted
+
+        // Merge chunks. Nodes shared by chunks weren't moved but may have absorbed nodes in each
+        // chunk, so they receive the sum of the quadrics absorbed
+        std::vector<Quadric> vecSharedNodeQuadric;
+        std::vector<int> vecSharedNode;
+        for (int chunk = 0; chunk < chunkCount; ++chunk) {
+            const QuadricSimplifier& simplifier = vecChunkSimplifier[chunk];
+            const std::vector<int>& vecSourceNode = vecChunkSourceNode[chunk];
+            for (std::size_t i = 0; i < vecSourceNode.size(); ++i) {
+                const int n = vecSourceNode[i];
+                if (vecNodeChunk[n] != nodeSharedByChunks) {
+                    vecNodePos[n] = simplifier.vecNodePos[i];
+                    vecNodeQuadric[n] = simplifier.vecNodeQuadric[i];
+                }
+                else {
+                    Quadric absorbedQuadric = simplifier.vecNodeQuadric[i];
+                    absorbedQuadric -= vecNodeQuadric[n];
+                    vecSharedNode.push_back(n);
+                    vecSharedNodeQuadric.push_back(absorbedQuadric);
+                }
+            }
+
+            maxChunkSquaredError = std::max(maxChunkSquaredError, simplifier.maxSquaredError());
+        }
+
+        for (std::size_t i = 0; i < vecSharedNode.size(); ++i)
+            vecNodeQuadric[vecSharedNode[i]] += vecSharedNodeQuadric[i];
+
+        std::vector<TriangleNodes> vecMergedTriangle;
+        for (int chunk = 0; chunk < chunkCount; ++chunk) {
+            const std::vector<int>& vecSourceNode = vecChunkSourceNode[chunk];
+            for (const TriangleNodes& triangle : vecChunkSimplifier[chunk].vecTriangle) {
+                if (triangle[0] >= 0)
+                    vecMergedTriangle.push_back({ vecSourceNode[triangle[0]], vecSourceNode[triangle[1]], vecSourceNode[triangle[2]] });
+            }
+
+            vecChunkSimplifier[chunk] = {};
+        }
+
+        vecTriangle = std::move(vecMergedTriangle);
+        vecTriangleIndex.resize(vecTriangle.size());
+        std::iota(vecTriangleIndex.begin(), vecTriangleIndex.end(), 0);
+        if (progress)
+            progress->setValue(70);
+    }
+
+    // Final pass over the whole triangulation, nodes not used by any triangle are dropped
+    QuadricSimplifier simplifier;
+    const std::vector<int> vecSourceNode = initSimplifier(
+                &simplifier, vecTriangle, vecTriangleIndex, vecNodePos, vecNodeQuadric,
+                [&](int n) { return bool(vecNodeLocked[n]); }
+    );
+    vecTriangle = {};
+    vecNodeQuadric = {};
+    if (!simplifier.run(targetTriangleCount, maxSquaredError, fnAbort))
+        return result; // Aborted
+
+    if (progress)
+        progress->setValue(90);
+
+    // Output nodes keep the order of the source nodes
+    std::vector<int> vecOutputNode(vecSourceNode.size(), -1);
+    for (const TriangleNodes& triangle : simplifier.vecTriangle) {
+        for (int n : triangle) {
+            if (n >= 0)
+                vecOutputNode[n] = 0;
+        }
+    }
+
+    for (std::size_t i = 0; i < vecOutputNode.size(); ++i) {
+        if (vecOutputNode[i] == 0) {
+            vecOutputNode[i] = int(result.vecSourceNode.size()) + 1;
+            result.vecSourceNode.push_back(vecSourceNode[i] + 1);
+        }
+    }
+
+    const int outputNodeCount = int(result.vecSourceNode.size());
+    const bool hasUVNodes = triangulation->HasUVNodes();
+    const bool hasNormals = triangulation->HasNormals();
+    Handle_Poly_Triangulation outputTriangulation =
+            new Poly_Triangulation(outputNodeCount, simplifier.triangleCount(), hasUVNodes);
+    result.maxError = std::sqrt(std::max(maxChunkSquaredError, simplifier.maxSquaredError()));
+    outputTriangulation->Deflection(std::max(triangulation->Deflection(), result.maxError));
+    if (hasNormals)
+        MeshUtils::allocateNormals(outputTriangulation);
+
+    for (std::size_t i = 0; i < vecOutputNode.size(); ++i) {
+        const int outputNode = vecOutputNode[i];
+        if (outputNode <= 0)
+            continue;
+
+        const int sourceNode = vecSourceNode[i] + 1;
+        MeshUtils::setNode(outputTriangulation, outputNode, simplifier.vecNodePos[i]);
+        if (hasUVNodes)
+            MeshUtils::setUVNode(outputTriangulation, outputNode, triangulation->UVNode(sourceNode));
+
+        if (hasNormals)
+            MeshUtils::setNormal(outputTriangulation, outputNode, MeshUtils::normal(triangulation, sourceNode));
+    }
+
+    int outputTriangleIndex = 0;
+    for (const TriangleNodes& triangle : simplifier.vecTriangle) {
+        if (triangle[0] >= 0) {
+            const Poly_Triangle outputTriangle(
+                        vecOutputNode[triangle[0]], vecOutputNode[triangle[1]], vecOutputNode[triangle[2]]
+            );
+            MeshUtils::setTriangle(outputTriangulation, ++outputTriangleIndex, outputTriangle);
+        }
+    }
+
+    result.triangulation = outputTriangulation;
+    if (progress)
+        progress->setValue(100);
+
+    return result;
+}
+
+void MeshDecimation::computeLevelsOfDetail(
+        const Handle_Poly_Triangulation& triangulation,
+        int lodCount,
+        const std::function<bool(Result&&)>& fnLodComputed)
+{
+    // Ratio between the triangle counts of two subsequent levels of detail
+    constexpr int lodTriangleCountRatio = 4;
+    // Coarser levels of detail aren't computed below this count of triangles
+    constexpr int lodMinTriangleCount = 5000;
+
+    Handle_Poly_Triangulation prevTriangulation = triangulation;
+    std::vector<int> prevVecSourceNode;
+    for (int lod = 1; lod < lodCount && prevTriangulation; ++lod) {
+        const int prevTriangleCount = prevTriangulation->NbTriangles();
+        Parameters params;
+        params.targetTriangleCount = prevTriangleCount / lodTriangleCountRatio;
+        if (params.targetTriangleCount < lodMinTriangleCount)
+            return;
+
+        Result result = MeshDecimation::decimate(prevTriangulation, params);
+        if (!result.triangulation || result.triangulation->NbTriangles() > (3 * prevTriangleCount) / 4)
+            return;
+
+        if (!prevVecSourceNode.empty()) {
+            for (int& sourceNode : result.vecSourceNode)
+                sourceNode = prevVecSourceNode.at(sourceNode - 1);
+        }
+
+        prevTriangulation = result.triangulation;
+        prevVecSourceNode = result.vecSourceNode;
+        if (!fnLodComputed(std::move(result)))
+            return;
+    }
+}
+
+} // namespace Mayo
@@ -0,0 +1,69 @@
+/****************************************************************************
+** Copyright (c) 2023, Fougue Ltd. <http://www.fougue.pro>
+** All rights reserved.
+** See license at https://github.com/fougue/mayo/blob/master/LICENSE.txt
+****************************************************************************/
+
+#pragma once
+
+#include <Poly_Triangulation.hxx>
+#include <functional>
+#include <vector>
+
+namespace Mayo {
+
+class TaskProgress;
+
+// Simplification of triangulations by iterative edge collapses ordered by quadric error metrics, see
+// Garland and Heckbert "Surface Simplification Using Quadric Error Metrics"
+// Error of a collapse is the sum of the squared distances between the merged node and the planes of
+// the source triangles merged into it, so its square root overestimates the deviation from the source
+// Nodes on borders(edges owned by a single triangle) and non-manifold edges are never moved, so
+// borders and seams between triangulations are preserved
+// Large triangulations are split into spatial chunks decimated concurrently, nodes shared by chunks
+// being locked meanwhile, then a final pass runs on the merged triangulation
+// Result is deterministic, whatever the count of threads
+struct MeshDecimation {
+    struct Parameters {
+        // Decimation stops once triangle count is less or equal to this value, 0 means no target
+        int targetTriangleCount = 0;
+        // Decimation stops before a collapse whose error(as a distance) exceeds this value
+        // Negative value means no limit
+        double maxError = -1.;
+        // Triangulations having at least twice this count of triangles are decimated by chunks of at
+        // least this count of triangles, concurrently
+        int minChunkTriangleCount = 100000;
+    };
+
+    struct Result {
+        // Decimated triangulation, null if decimation was aborted
+        // Normals and UV nodes are the ones of the source nodes, if any
+        Handle_Poly_Triangulation triangulation;
+        // Each node of 'triangulation' is a node(possibly moved) of the source triangulation
+        // Item i is the 1-based index in the source triangulation of the node i+1, so per-node
+        // data(eg colors) can be remapped
+        std::vector<int> vecSourceNode;
+        // Maximum error of the collapses, as a distance
+        double maxError = 0.;
+    };
+
+    // Returns 'triangulation' itself if there is nothing to do(eg target already reached)
+    static Result decimate(
+            const Handle_Poly_Triangulation& triangulation,
+            const Parameters& params,
+            TaskProgress* progress = nullptr
+    );
+
+    // Successive decimations of 'triangulation' into coarser levels of detail(LOD), 'triangulation'
+    // itself being LOD 0. Each LOD has about four times less triangles than the previous one which
+    // it's decimated from, its 'vecSourceNode' being mapped to the nodes of 'triangulation'
+    // 'fnLodComputed' is called for each LOD in order. Stops once 'lodCount' LODs are reached, when
+    // 'fnLodComputed' returns false or when decimation can't significantly reduce the triangle count
+    static void computeLevelsOfDetail(
+            const Handle_Poly_Triangulation& triangulation,
+            int lodCount,
+            const std::function<bool(Result&&)>& fnLodComputed
+    );
+};
+
+} // namespace Mayo
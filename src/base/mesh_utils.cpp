@@ -5,12 +5,185 @@
 ****************************************************************************/
 
 #include "mesh_utils.h"
+#include "cpp_utils.h"
 #include "math_utils.h"
+#include <OSD_Parallel.hxx>
 #include <Standard_Version.hxx>
+#include <algorithm>
 #include <cmath>
+#include <iterator>
+#include <limits>
 
 namespace Mayo {
 
+namespace {
+
+// Provides the triangle corners adjacent to each node of a triangulation
+// Corner 'c' is the node at position 'c % 3' in triangle 'c / 3'(0-based indices)
+struct NodeCornerAdjacency {
+    std::vector<int> vecCornerNode; // 0-based node of each corner
+    std::vector<int> vecNodeOffset; // Corners of node 'n' are in range [vecNodeOffset[n], vecNodeOffset[n + 1])
+    std::vector<int> vecNodeCorner;
+
+    NodeCornerAdjacency(const Handle_Poly_Triangulation& triangulation)
+    {
+        const int nodeCount = triangulation->NbNodes();
+        const int triangleCount = triangulation->NbTriangles();
+        this->vecCornerNode.resize(3 * std::size_t(triangleCount));
+        for (int it = 0; it < triangleCount; ++it) {
+            int n1, n2, n3;
+            triangulation->Triangle(it + 1).Get(n1, n2, n3);
+            this->vecCornerNode[3 * it] = n1 - 1;
+            this->vecCornerNode[3 * it + 1] = n2 - 1;
+            this->vecCornerNode[3 * it + 2] = n3 - 1;
+        }
+
+        this->vecNodeOffset.resize(nodeCount + 1, 0);
+        for (int n : this->vecCornerNode)
+            ++this->vecNodeOffset[n + 1];
+
+        for (int n = 0; n < nodeCount; ++n)
+            this->vecNodeOffset[n + 1] += this->vecNodeOffset[n];
+
+        std::vector<int> vecNodeCornerCount(nodeCount, 0);
+        this->vecNodeCorner.resize(this->vecCornerNode.size());
+        for (int c = 0; c < int(this->vecCornerNode.size()); ++c) {
+            const int n = this->vecCornerNode[c];
+            this->vecNodeCorner[this->vecNodeOffset[n] + vecNodeCornerCount[n]] = c;
+            ++vecNodeCornerCount[n];
+        }
+    }
+
+    int cornerCount(int node) const {
+        return this->vecNodeOffset[node + 1] - this->vecNodeOffset[node];
+    }
+};
+
+// Sums of the properties of a range of triangles, used to compute MeshUtils::Metrics
+// Coordinates are kept in plain arrays so loops can be vectorized by the compiler
+struct MetricsSums {
+    static constexpr double maxDouble = std::numeric_limits<double>::max();
+    double area = 0;
+    double areaMoment[3] = {}; // Sum of the triangle areas times the triangle centroids
+    // Sum of the determinants(ie 6 * signed volume) of the tetrahedra(origin, p1, p2, p3)
+    double volume6 = 0;
+    double volumeMoment[3] = {}; // Sum of the determinants times the sums of the tetrahedron nodes
+    // Sum of 120 * second moments(xx, yy, zz, xy, yz, zx) of the tetrahedra(origin, p1, p2, p3)
+    double covariance[6] = {};
+    double bndMin[3] = { maxDouble, maxDouble, maxDouble };
+    double bndMax[3] = { -maxDouble, -maxDouble, -maxDouble };
+
+    void addTriangle(const gp_XYZ& p1, const gp_XYZ& p2, const gp_XYZ& p3)
+    {
+        const double p[3][3] = {
+            { p1.X(), p1.Y(), p1.Z() }, { p2.X(), p2.Y(), p2.Z() }, { p3.X(), p3.Y(), p3.Z() }
+        };
+        double s[3];
+        for (int k = 0; k < 3; ++k)
+            s[k] = p[0][k] + p[1][k] + p[2][k];
+
+        const double triArea = MeshUtils::triangleArea(p1, p2, p3);
+        this->area += triArea;
+        for (int k = 0; k < 3; ++k)
+            this->areaMoment[k] += triArea * s[k] / 3.;
+
+        const double det =
+                p[0][0] * (p[1][1] * p[2][2] - p[1][2] * p[2][1])
+                + p[0][1] * (p[1][2] * p[2][0] - p[1][0] * p[2][2])
+                + p[0][2] * (p[1][0] * p[2][1] - p[1][1] * p[2][0]);
+        this->volume6 += det;
+        for (int k = 0; k < 3; ++k)
+            this->volumeMoment[k] += det * s[k];
+
+        // Integral of x.y over tetrahedron(origin, p1, p2, p3) is det/120 * (sum(pi.x * pi.y) + s.x * s.y)
+        constexpr int indexA[6] = { 0, 1, 2, 0, 1, 2 };
+        constexpr int indexB[6] = { 0, 1, 2, 1, 2, 0 };
+        for (int k = 0; k < 6; ++k) {
+            const int a = indexA[k];
+            const int b = indexB[k];
+            const double sumProducts = p[0][a] * p[0][b] + p[1][a] * p[1][b] + p[2][a] * p[2][b];
+            this->covariance[k] += det * (sumProducts + s[a] * s[b]);
+        }
+
+        for (int k = 0; k < 3; ++k) {
+            this->bndMin[k] = std::min({ this->bndMin[k], p[0][k], p[1][k], p[2][k] });
+            this->bndMax[k] = std::max({ this->bndMax[k], p[0][k], p[1][k], p[2][k] });
+        }
+    }
+
+    MetricsSums& operator+=(const MetricsSums& other)
+    {
+        this->area += other.area;
+        this->volume6 += other.volume6;
+        for (int k = 0; k < 3; ++k) {
+            this->areaMoment[k] += other.areaMoment[k];
+            this->volumeMoment[k] += other.volumeMoment[k];
+            this->bndMin[k] = std::min(this->bndMin[k], other.bndMin[k]);
+            this->bndMax[k] = std::max(this->bndMax[k], other.bndMax[k]);
+        }
+
+        for (int k = 0; k < 6; ++k)
+            this->covariance[k] += other.covariance[k];
+
+        return *this;
+    }
+};
+
+// Calls 'fnAddTriangle(sums, p1, p2, p3)' for each triangle in 'spanTriangulation', nodes being
+// transformed by the triangulation location and ordered according to its orientation
+// Triangles are split into blocks of fixed size processed concurrently, block sums are then added in
+// order so the result is the same whatever the count of threads
+template<typename Sums, typename FunctionAddTriangle>
+Sums reduceTriangles(Span<const MeshUtils::LocatedTriangulation> spanTriangulation, FunctionAddTriangle fnAddTriangle)
+{
+    constexpr int blockSize = 4096;
+    struct TriangleBlock {
+        int item; // Index in 'spanTriangulation'
+        int first; // 1-based index of first triangle
+        int last; // 1-based index of last triangle(included)
+    };
+    std::vector<TriangleBlock> vecBlock;
+    for (int i = 0; CppUtils::cmpLess(i, spanTriangulation.size()); ++i) {
+        const Handle_Poly_Triangulation& triangulation = spanTriangulation[i].triangulation;
+        const int triangleCount = triangulation ? triangulation->NbTriangles() : 0;
+        for (int first = 1; first <= triangleCount; first += blockSize)
+            vecBlock.push_back({ i, first, std::min(first + blockSize - 1, triangleCount) });
+    }
+
+    std::vector<Sums> vecBlockSums(vecBlock.size(), Sums{});
+    OSD_Parallel::For(0, int(vecBlock.size()), [&](int ib) {
+        const TriangleBlock& block = vecBlock[ib];
+        const MeshUtils::LocatedTriangulation& located = spanTriangulation[block.item];
+        const Handle_Poly_Triangulation& triangulation = located.triangulation;
+        const bool hasTrsf = !located.location.IsIdentity();
+        const gp_Trsf trsf = located.location.Transformation();
+        auto fnNode = [&](int n) {
+            gp_XYZ pnt = triangulation->Node(n).XYZ();
+            if (hasTrsf)
+                trsf.Transforms(pnt);
+
+            return pnt;
+        };
+        Sums& sums = vecBlockSums[ib];
+        for (int it = block.first; it <= block.last; ++it) {
+            int n1, n2, n3;
+            triangulation->Triangle(it).Get(n1, n2, n3);
+            if (located.reversed)
+                std::swap(n2, n3);
+
+            fnAddTriangle(sums, fnNode(n1), fnNode(n2), fnNode(n3));
+        }
+    });
+
+    Sums sums{};
+    for (const Sums& blockSums : vecBlockSums)
+        sums += blockSums;
+
+    return sums;
+}
+
+} // namespace
+
 double MeshUtils::triangleSignedVolume(const gp_XYZ& p1, const gp_XYZ& p2, const gp_XYZ& p3)
 {
     return p1.Dot(p2.Crossed(p3)) / 6.0f;
@@ -35,17 +208,13 @@ double MeshUtils::triangulationVolume(const Handle_Poly_Triangulation& triangula
     if (!triangulation)
         return 0;
 
-    double volume = 0;
-    // TODO Parallelize computation
-    for (const Poly_Triangle& tri : MeshUtils::triangles(triangulation)) {
-        int v1, v2, v3;
-        tri.Get(v1, v2, v3);
-        volume += MeshUtils::triangleSignedVolume(
-                    triangulation->Node(v1).Coord(),
-                    triangulation->Node(v2).Coord(),
-                    triangulation->Node(v3).Coord());
-    }
-
+    const LocatedTriangulation located{ triangulation, {} };
+    const double volume = reduceTriangles<double>(
+                Span<const LocatedTriangulation>(&located, 1),
+                [](double& sum, const gp_XYZ& p1, const gp_XYZ& p2, const gp_XYZ& p3) {
+                    sum += MeshUtils::triangleSignedVolume(p1, p2, p3);
+                }
+    );
     return std::abs(volume);
 }
 
@@ -54,18 +223,83 @@ double MeshUtils::triangulationArea(const Handle_Poly_Triangulation& triangulati
     if (!triangulation)
         return 0;
 
-    double area = 0;
-    // TODO Parallelize computation
-    for (const Poly_Triangle& tri : MeshUtils::triangles(triangulation)) {
-        int v1, v2, v3;
-        tri.Get(v1, v2, v3);
-        area += MeshUtils::triangleArea(
-                    triangulation->Node(v1).Coord(),
-                    triangulation->Node(v2).Coord(),
-                    triangulation->Node(v3).Coord());
+    const LocatedTriangulation located{ triangulation, {} };
+    return reduceTriangles<double>(
+                Span<const LocatedTriangulation>(&located, 1),
+                [](double& sum, const gp_XYZ& p1, const gp_XYZ& p2, const gp_XYZ& p3) {
+                    sum += MeshUtils::triangleArea(p1, p2, p3);
+                }
+    );
+}
+
+MeshUtils::Metrics MeshUtils::triangulationMetrics(const Handle_Poly_Triangulation& triangulation)
+{
+    const LocatedTriangulation located{ triangulation, {} };
+    return MeshUtils::triangulationMetrics(Span<const LocatedTriangulation>(&located, 1));
+}
+
+MeshUtils::Metrics MeshUtils::triangulationMetrics(Span<const LocatedTriangulation> spanTriangulation)
+{
+    const MetricsSums sums = reduceTriangles<MetricsSums>(
+                spanTriangulation,
+                [](MetricsSums& sums, const gp_XYZ& p1, const gp_XYZ& p2, const gp_XYZ& p3) {
+                    sums.addTriangle(p1, p2, p3);
+                }
+    );
+
+    Metrics metrics;
+    metrics.area = sums.area;
+    if (sums.area > 0)
+        metrics.areaCentroid = gp_XYZ(sums.areaMoment[0], sums.areaMoment[1], sums.areaMoment[2]) / sums.area;
+
+    const double volume = sums.volume6 / 6.;
+    metrics.signedVolume = volume;
+    if (volume != 0) {
+        // Tetrahedron centroid is the sum of its nodes divided by 4, origin being one of them
+        const gp_XYZ centroid = gp_XYZ(sums.volumeMoment[0], sums.volumeMoment[1], sums.volumeMoment[2]) / (4 * sums.volume6);
+        metrics.volumeCentroid = centroid;
+        // Second moments about the origin, then about the centroid
+        const double cxx = sums.covariance[0] / 120. - volume * centroid.X() * centroid.X();
+        const double cyy = sums.covariance[1] / 120. - volume * centroid.Y() * centroid.Y();
+        const double czz = sums.covariance[2] / 120. - volume * centroid.Z() * centroid.Z();
+        const double cxy = sums.covariance[3] / 120. - volume * centroid.X() * centroid.Y();
+        const double cyz = sums.covariance[4] / 120. - volume * centroid.Y() * centroid.Z();
+        const double czx = sums.covariance[5] / 120. - volume * centroid.Z() * centroid.X();
+        // Volume of inward oriented meshes is negative, so are their second moments
+        const double sign = volume < 0 ? -1. : 1.;
+        metrics.inertia = gp_Mat(
+                    sign * (cyy + czz), -sign * cxy, -sign * czx,
+                    -sign * cxy, sign * (cxx + czz), -sign * cyz,
+                    -sign * czx, -sign * cyz, sign * (cxx + cyy)
+        );
     }
 
-    return area;
+    if (sums.bndMin[0] <= sums.bndMax[0]) {
+        metrics.boundingBox.Update(
+                    sums.bndMin[0], sums.bndMin[1], sums.bndMin[2],
+                    sums.bndMax[0], sums.bndMax[1], sums.bndMax[2]
+        );
+    }
+
+    return metrics;
+}
+
+std::size_t MeshUtils::triangulationMemorySize(const Handle_Poly_Triangulation& triangulation)
+{
+    if (!triangulation)
+        return 0;
+
+    const std::size_t nodeCount = triangulation->NbNodes();
+    std::size_t size = sizeof(Poly_Triangulation);
+    size += nodeCount * sizeof(gp_Pnt);
+    size += triangulation->NbTriangles() * sizeof(Poly_Triangle);
+    if (triangulation->HasUVNodes())
+        size += nodeCount * sizeof(gp_Pnt2d);
+
+    if (triangulation->HasNormals())
+        size += nodeCount * 3 * sizeof(float);
+
+    return size;
 }
 
 void MeshUtils::setNode(const Handle_Poly_Triangulation& triangulation, int index, const gp_Pnt& pnt)
@@ -108,6 +342,406 @@ void MeshUtils::allocateNormals(const Handle_Poly_Triangulation& triangulation)
 #endif
 }
 
+void MeshUtils::setUVNode(const Handle_Poly_Triangulation& triangulation, int index, const gp_Pnt2d& pnt)
+{
+#if OCC_VERSION_HEX >= 0x070600
+    triangulation->SetUVNode(index, pnt);
+#else
+    triangulation->ChangeUVNode(index) = pnt;
+#endif
+}
+
+MeshUtils::Poly_Triangulation_NormalType MeshUtils::normal(const Handle_Poly_Triangulation& triangulation, int index)
+{
+#if OCC_VERSION_HEX >= 0x070600
+    gp_Vec3f n;
+    triangulation->Normal(index, n);
+    return n;
+#else
+    const TShort_Array1OfShortReal& normals = triangulation->Normals();
+    return gp_Vec(normals.Value(index * 3 - 2), normals.Value(index * 3 - 1), normals.Value(index * 3));
+#endif
+}
+
+gp_Vec MeshUtils::toGpVec(const Poly_Triangulation_NormalType& n)
+{
+#if OCC_VERSION_HEX >= 0x070600
+    return gp_Vec(n.x(), n.y(), n.z());
+#else
+    return n;
+#endif
+}
+
+std::vector<int> MeshUtils::vertexCacheTriangleOrder(const Handle_Poly_Triangulation& triangulation, int cacheSize)
+{
+    if (!triangulation)
+        return {};
+
+    const int nodeCount = triangulation->NbNodes();
+    const int triangleCount = triangulation->NbTriangles();
+    cacheSize = std::max(cacheSize, 4);
+
+    // Triangles adjacent to each node, the first 'vecNodeTriangleCount[n]' ones of the range of node
+    // 'n' are the triangles not emitted yet
+    NodeCornerAdjacency adjacency(triangulation);
+    const std::vector<int>& vecTriangleNode = adjacency.vecCornerNode;
+    const std::vector<int>& vecNodeTriangleOffset = adjacency.vecNodeOffset;
+    std::vector<int>& vecNodeTriangle = adjacency.vecNodeCorner;
+    for (int& corner : vecNodeTriangle)
+        corner /= 3;
+
+    std::vector<int> vecNodeTriangleCount(nodeCount);
+    for (int n = 0; n < nodeCount; ++n)
+        vecNodeTriangleCount[n] = adjacency.cornerCount(n);
+
+    // Scoring functions from Forsyth's article, tabulated
+    const float cacheDecayPower = 1.5f;
+    const float lastTriangleScore = 0.75f;
+    const float valenceBoostScale = 2.f;
+    const float valenceBoostPower = 0.5f;
+    std::vector<float> vecCachePosScore(cacheSize);
+    for (int i = 0; i < cacheSize; ++i) {
+        if (i < 3)
+            vecCachePosScore[i] = lastTriangleScore; // Used by the last triangle
+        else
+            vecCachePosScore[i] = std::pow(1.f - float(i - 3) / float(cacheSize - 3), cacheDecayPower);
+    }
+
+    // Favor nodes having few triangles left, so lone triangles don't remain until the end
+    std::vector<float> vecValenceScore(64);
+    for (int i = 1; i < int(vecValenceScore.size()); ++i)
+        vecValenceScore[i] = valenceBoostScale * std::pow(float(i), -valenceBoostPower);
+
+    auto fnNodeScore = [&](int cachePos, int remainingTriangleCount) {
+        if (remainingTriangleCount == 0)
+            return -1.f; // No triangle needs this node
+
+        const float score = cachePos >= 0 ? vecCachePosScore[cachePos] : 0.f;
+        if (remainingTriangleCount < int(vecValenceScore.size()))
+            return score + vecValenceScore[remainingTriangleCount];
+        else
+            return score + valenceBoostScale * std::pow(float(remainingTriangleCount), -valenceBoostPower);
+    };
+
+    std::vector<int> vecNodeCachePos(nodeCount, -1);
+    std::vector<float> vecNodeScore(nodeCount);
+    for (int n = 0; n < nodeCount; ++n)
+        vecNodeScore[n] = fnNodeScore(-1, vecNodeTriangleCount[n]);
+
+    auto fnTriangleScore = [&](int it) {
+        return vecNodeScore[vecTriangleNode[3 * it]]
+                + vecNodeScore[vecTriangleNode[3 * it + 1]]
+                + vecNodeScore[vecTriangleNode[3 * it + 2]];
+    };
+
+    std::vector<bool> vecTriangleEmitted(triangleCount, false);
+    std::vector<float> vecTriangleScore(triangleCount);
+    int bestTriangle = -1;
+    for (int it = 0; it < triangleCount; ++it) {
+        vecTriangleScore[it] = fnTriangleScore(it);
+        if (bestTriangle < 0 || vecTriangleScore[it] > vecTriangleScore[bestTriangle])
+            bestTriangle = it;
+    }
+
+    std::vector<int> vecOrder;
+    vecOrder.reserve(triangleCount);
+    std::vector<int> vecCache;
+    std::vector<int> vecNewCache;
+    vecCache.reserve(cacheSize + 3);
+    vecNewCache.reserve(cacheSize + 3);
+    int nextTriangle = 0; // Cursor to the first triangle possibly not emitted
+    while (int(vecOrder.size()) < triangleCount) {
+        if (bestTriangle < 0) {
+            // No candidate adjacent to the cached nodes, pick the next triangle in input order
+            while (vecTriangleEmitted[nextTriangle])
+                ++nextTriangle;
+
+            bestTriangle = nextTriangle;
+        }
+
+        vecOrder.push_back(bestTriangle + 1);
+        vecTriangleEmitted[bestTriangle] = true;
+
+        // Remove emitted triangle from the remaining triangles of its nodes
+        const int* triNodes = &vecTriangleNode[3 * bestTriangle];
+        for (int k = 0; k < 3; ++k) {
+            const int n = triNodes[k];
+            int* itFirst = &vecNodeTriangle[vecNodeTriangleOffset[n]];
+            int* itLast = itFirst + vecNodeTriangleCount[n];
+            int* itFound = std::find(itFirst, itLast, bestTriangle);
+            if (itFound != itLast) {
+                std::swap(*itFound, *(itLast - 1));
+                --vecNodeTriangleCount[n];
+            }
+        }
+
+        // Nodes of the emitted triangle move to the front of the cache
+        vecNewCache.clear();
+        for (int k = 0; k < 3; ++k) {
+            if (std::find(vecNewCache.cbegin(), vecNewCache.cend(), triNodes[k]) == vecNewCache.cend())
+                vecNewCache.push_back(triNodes[k]);
+        }
+
+        for (int n : vecCache) {
+            if (n != triNodes[0] && n != triNodes[1] && n != triNodes[2])
+                vecNewCache.push_back(n);
+        }
+
+        // Update scores of the nodes in cache(and the ones just evicted)
+        for (int i = 0; i < int(vecNewCache.size()); ++i) {
+            const int n = vecNewCache[i];
+            vecNodeCachePos[n] = i < cacheSize ? i : -1;
+            vecNodeScore[n] = fnNodeScore(vecNodeCachePos[n], vecNodeTriangleCount[n]);
+        }
+
+        // Next triangle is the best one adjacent to the nodes in cache
+        bestTriangle = -1;
+        for (int n : vecNewCache) {
+            const int offset = vecNodeTriangleOffset[n];
+            for (int i = 0; i < vecNodeTriangleCount[n]; ++i) {
+                const int it = vecNodeTriangle[offset + i];
+                vecTriangleScore[it] = fnTriangleScore(it);
+                if (bestTriangle < 0 || vecTriangleScore[it] > vecTriangleScore[bestTriangle])
+                    bestTriangle = it;
+            }
+        }
+
+        if (int(vecNewCache.size()) > cacheSize)
+            vecNewCache.resize(cacheSize);
+
+        std::swap(vecCache, vecNewCache);
+    }
+
+    return vecOrder;
+}
+
+double MeshUtils::averageCacheMissRatio(const Handle_Poly_Triangulation& triangulation, int cacheSize)
+{
+    if (!triangulation || triangulation->NbTriangles() == 0)
+        return 0;
+
+    // Simulate FIFO cache: a node is in cache if less than 'cacheSize' nodes were loaded since its
+    // own loading
+    std::vector<int> vecNodeLoadTime(triangulation->NbNodes(), -1);
+    int loadCount = 0;
+    for (const Poly_Triangle& tri : MeshUtils::triangles(triangulation)) {
+        for (int k = 1; k <= 3; ++k) {
+            int& loadTime = vecNodeLoadTime[tri.Value(k) - 1];
+            if (loadTime < 0 || loadCount - loadTime >= cacheSize)
+                loadTime = loadCount++;
+        }
+    }
+
+    return double(loadCount) / double(triangulation->NbTriangles());
+}
+
+std::vector<int> MeshUtils::reorderTriangulation(
+        const Handle_Poly_Triangulation& triangulation, Span<const int> triangleOrder
+    )
+{
+    if (!triangulation || int(triangleOrder.size()) != triangulation->NbTriangles())
+        return {};
+
+    // Compute new node indices by order of first use
+    const int nodeCount = triangulation->NbNodes();
+    std::vector<int> vecNewNodeIndex(nodeCount, 0);
+    int newNodeIndex = 0;
+    for (int it : triangleOrder) {
+        const Poly_Triangle& tri = triangulation->Triangle(it);
+        for (int k = 1; k <= 3; ++k) {
+            int& n = vecNewNodeIndex[tri.Value(k) - 1];
+            if (n == 0)
+                n = ++newNodeIndex;
+        }
+    }
+
+    for (int& n : vecNewNodeIndex) {
+        if (n == 0)
+            n = ++newNodeIndex;
+    }
+
+    // Reorder triangles
+    std::vector<Poly_Triangle> vecTriangle;
+    vecTriangle.reserve(triangleOrder.size());
+    for (int it : triangleOrder) {
+        int n1, n2, n3;
+        triangulation->Triangle(it).Get(n1, n2, n3);
+        vecTriangle.emplace_back(vecNewNodeIndex[n1 - 1], vecNewNodeIndex[n2 - 1], vecNewNodeIndex[n3 - 1]);
+    }
+
+    for (int it = 0; it < int(vecTriangle.size()); ++it)
+        MeshUtils::setTriangle(triangulation, it + 1, vecTriangle[it]);
+
+    // Reorder per-node data
+    {
+        std::vector<gp_Pnt> vecNode(nodeCount);
+        for (int n = 0; n < nodeCount; ++n)
+            vecNode[vecNewNodeIndex[n] - 1] = triangulation->Node(n + 1);
+
+        for (int n = 0; n < nodeCount; ++n)
+            MeshUtils::setNode(triangulation, n + 1, vecNode[n]);
+    }
+
+    if (triangulation->HasUVNodes()) {
+        std::vector<gp_Pnt2d> vecUVNode(nodeCount);
+        for (int n = 0; n < nodeCount; ++n)
+            vecUVNode[vecNewNodeIndex[n] - 1] = triangulation->UVNode(n + 1);
+
+        for (int n = 0; n < nodeCount; ++n)
+            MeshUtils::setUVNode(triangulation, n + 1, vecUVNode[n]);
+    }
+
+    if (triangulation->HasNormals()) {
+        std::vector<Poly_Triangulation_NormalType> vecNormal(nodeCount);
+        for (int n = 0; n < nodeCount; ++n)
+            vecNormal[vecNewNodeIndex[n] - 1] = MeshUtils::normal(triangulation, n + 1);
+
+        for (int n = 0; n < nodeCount; ++n)
+            MeshUtils::setNormal(triangulation, n + 1, vecNormal[n]);
+    }
+
+    return vecNewNodeIndex;
+}
+
+Handle_Poly_Triangulation MeshUtils::computeSmoothNormals(
+        const Handle_Poly_Triangulation& triangulation,
+        double creaseAngle,
+        NormalWeighting weighting,
+        std::vector<int>* ptrVecSourceNode
+    )
+{
+    if (!triangulation)
+        return {};
+
+    const int nodeCount = triangulation->NbNodes();
+    const int triangleCount = triangulation->NbTriangles();
+    const NodeCornerAdjacency adjacency(triangulation);
+
+    // Unit normal of each triangle, and weight of each triangle corner
+    std::vector<gp_XYZ> vecTriangleNormal(triangleCount);
+    std::vector<double> vecCornerWeight(3 * std::size_t(triangleCount), 0.);
+    OSD_Parallel::For(0, triangleCount, [&](int it) {
+        const gp_XYZ pnts[] = {
+            triangulation->Node(adjacency.vecCornerNode[3 * it] + 1).Coord(),
+            triangulation->Node(adjacency.vecCornerNode[3 * it + 1] + 1).Coord(),
+            triangulation->Node(adjacency.vecCornerNode[3 * it + 2] + 1).Coord()
+        };
+        const gp_XYZ cross = (pnts[1] - pnts[0]).Crossed(pnts[2] - pnts[0]);
+        const double crossMagnitude = cross.Modulus();
+        if (crossMagnitude <= std::numeric_limits<double>::min())
+            return; // Degenerated triangle, null normal and weights
+
+        vecTriangleNormal[it] = cross / crossMagnitude;
+        for (int k = 0; k < 3; ++k) {
+            double& weight = vecCornerWeight[3 * it + k];
+            if (weighting == NormalWeighting::Area) {
+                weight = crossMagnitude;
+            }
+            else {
+                const gp_XYZ vec1 = pnts[(k + 1) % 3] - pnts[k];
+                const gp_XYZ vec2 = pnts[(k + 2) % 3] - pnts[k];
+                weight = std::atan2(vec1.Crossed(vec2).Modulus(), vec1.Dot(vec2));
+            }
+        }
+    });
+
+    // Group the corners of each node into smoothing groups: a corner joins the first group whose
+    // seed triangle normal doesn't deviate by more than the crease angle
+    const bool hasCrease = creaseAngle < MathUtils::pi;
+    const double cosCreaseAngle = std::cos(creaseAngle);
+    std::vector<int> vecCornerGroup(adjacency.vecCornerNode.size(), 0);
+    std::vector<int> vecNodeGroupCount(nodeCount, 1);
+    if (hasCrease) {
+        OSD_Parallel::For(0, nodeCount, [&](int n) {
+            std::vector<gp_XYZ> vecGroupSeed;
+            for (int i = adjacency.vecNodeOffset[n]; i < adjacency.vecNodeOffset[n + 1]; ++i) {
+                const int corner = adjacency.vecNodeCorner[i];
+                const gp_XYZ& triNormal = vecTriangleNormal[corner / 3];
+                if (triNormal.SquareModulus() == 0.)
+                    continue; // Degenerated triangle, no contribution so keep default group
+
+                auto itGroup = std::find_if(vecGroupSeed.cbegin(), vecGroupSeed.cend(), [&](const gp_XYZ& seed) {
+                    return triNormal.Dot(seed) >= cosCreaseAngle;
+                });
+                if (itGroup == vecGroupSeed.cend()) {
+                    vecGroupSeed.push_back(triNormal);
+                    itGroup = std::prev(vecGroupSeed.cend());
+                }
+
+                vecCornerGroup[corner] = int(itGroup - vecGroupSeed.cbegin());
+            }
+
+            vecNodeGroupCount[n] = std::max(int(vecGroupSeed.size()), 1);
+        });
+    }
+
+    // Nodes of the target triangulation, groups of a node get consecutive indices
+    std::vector<int> vecNodeFirstIndex(nodeCount + 1, 0);
+    for (int n = 0; n < nodeCount; ++n)
+        vecNodeFirstIndex[n + 1] = vecNodeFirstIndex[n] + vecNodeGroupCount[n];
+
+    const int targetNodeCount = vecNodeFirstIndex[nodeCount];
+    std::vector<gp_XYZ> vecTargetNormal(targetNodeCount);
+    OSD_Parallel::For(0, nodeCount, [&](int n) {
+        // Sum contributions in adjacency order, so the result doesn't depend on threads scheduling
+        for (int i = adjacency.vecNodeOffset[n]; i < adjacency.vecNodeOffset[n + 1]; ++i) {
+            const int corner = adjacency.vecNodeCorner[i];
+            const gp_XYZ& triNormal = vecTriangleNormal[corner / 3];
+            vecTargetNormal[vecNodeFirstIndex[n] + vecCornerGroup[corner]] += vecCornerWeight[corner] * triNormal;
+        }
+
+        for (int i = vecNodeFirstIndex[n]; i < vecNodeFirstIndex[n + 1]; ++i) {
+            gp_XYZ& normal = vecTargetNormal[i];
+            const double modulus = normal.Modulus();
+            if (modulus > std::numeric_limits<double>::min())
+                normal /= modulus;
+            else
+                normal = gp_XYZ(0, 0, 1); // Isolated node or only degenerated triangles
+        }
+    });
+
+    if (ptrVecSourceNode) {
+        ptrVecSourceNode->resize(targetNodeCount);
+        for (int n = 0; n < nodeCount; ++n)
+            std::fill_n(ptrVecSourceNode->begin() + vecNodeFirstIndex[n], vecNodeGroupCount[n], n + 1);
+    }
+
+    Handle_Poly_Triangulation targetTriangulation = triangulation;
+    if (targetNodeCount != nodeCount) {
+        const bool hasUVNodes = triangulation->HasUVNodes();
+        targetTriangulation = new Poly_Triangulation(targetNodeCount, triangleCount, hasUVNodes);
+        targetTriangulation->Deflection(triangulation->Deflection());
+        for (int n = 0; n < nodeCount; ++n) {
+            const gp_Pnt pnt = triangulation->Node(n + 1);
+            for (int i = vecNodeFirstIndex[n]; i < vecNodeFirstIndex[n + 1]; ++i) {
+                MeshUtils::setNode(targetTriangulation, i + 1, pnt);
+                if (hasUVNodes)
+                    MeshUtils::setUVNode(targetTriangulation, i + 1, triangulation->UVNode(n + 1));
+            }
+        }
+
+        for (int it = 0; it < triangleCount; ++it) {
+            int nodes[3];
+            for (int k = 0; k < 3; ++k) {
+                const int corner = 3 * it + k;
+                nodes[k] = vecNodeFirstIndex[adjacency.vecCornerNode[corner]] + vecCornerGroup[corner] + 1;
+            }
+
+            MeshUtils::setTriangle(targetTriangulation, it + 1, Poly_Triangle(nodes[0], nodes[1], nodes[2]));
+        }
+    }
+
+    if (!targetTriangulation->HasNormals())
+        MeshUtils::allocateNormals(targetTriangulation);
+
+    for (int i = 0; i < targetNodeCount; ++i) {
+        const gp_XYZ& n = vecTargetNormal[i];
+        MeshUtils::setNormal(targetTriangulation, i + 1, Poly_Triangulation_NormalType(float(n.X()), float(n.Y()), float(n.Z())));
+    }
+
+    return targetTriangulation;
+}
+
 // Adapted from http://cs.smith.edu/~jorourke/Code/polyorient.C
 MeshUtils::Orientation MeshUtils::orientation(const AdaptorPolyline2d& polyline)
 {
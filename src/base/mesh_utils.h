@@ -6,9 +6,16 @@
 
 #pragma once
 
+#include "span.h"
+
+#include <Bnd_Box.hxx>
 #include <Poly_Triangulation.hxx>
 #include <Standard_Version.hxx>
-class gp_XYZ;
+#include <TopLoc_Location.hxx>
+#include <gp_Mat.hxx>
+#include <gp_XYZ.hxx>
+#include <cstddef>
+#include <vector>
 
 namespace Mayo {
 
@@ -20,6 +27,35 @@ struct MeshUtils {
     static double triangulationVolume(const Handle_Poly_Triangulation& triangulation);
     static double triangulationArea(const Handle_Poly_Triangulation& triangulation);
 
+    // Triangulation along with its location, eg as returned by BRep_Tool::Triangulation()
+    // 'reversed' flips the orientation of the triangles, it must be set for the triangulations of
+    // faces having orientation TopAbs_REVERSED
+    struct LocatedTriangulation {
+        Handle_Poly_Triangulation triangulation;
+        TopLoc_Location location;
+        bool reversed = false;
+    };
+
+    // Geometric properties of a mesh, volume properties are meaningful for closed meshes only and
+    // assume a unit density
+    struct Metrics {
+        double area = 0;
+        gp_XYZ areaCentroid; // Centroid of the surface
+        double signedVolume = 0; // Positive when triangles are oriented outwards
+        gp_XYZ volumeCentroid;
+        gp_Mat inertia; // Inertia tensor of the volume about 'volumeCentroid'
+        Bnd_Box boundingBox; // Bounding box of the nodes used by the triangles
+    };
+
+    // Computes metrics of the triangles in parallel. Triangles are summed by blocks of fixed size
+    // whose sums are then added in order, so results don't depend on the count of threads
+    // Null triangulations are ignored
+    static Metrics triangulationMetrics(const Handle_Poly_Triangulation& triangulation);
+    static Metrics triangulationMetrics(Span<const LocatedTriangulation> spanTriangulation);
+
+    // Estimated size in bytes of the data held by 'triangulation'(nodes, triangles, normals, UV nodes)
+    static std::size_t triangulationMemorySize(const Handle_Poly_Triangulation& triangulation);
+
 #if OCC_VERSION_HEX >= 0x070600
     using Poly_Triangulation_NormalType = gp_Vec3f;
 #else
@@ -29,6 +65,9 @@ struct MeshUtils {
     static void setNode(const Handle_Poly_Triangulation& triangulation, int index, const gp_Pnt& pnt);
     static void setTriangle(const Handle_Poly_Triangulation& triangulation, int index, const Poly_Triangle& triangle);
     static void setNormal(const Handle_Poly_Triangulation& triangulation, int index, const Poly_Triangulation_NormalType& n);
+    static void setUVNode(const Handle_Poly_Triangulation& triangulation, int index, const gp_Pnt2d& pnt);
+    static Poly_Triangulation_NormalType normal(const Handle_Poly_Triangulation& triangulation, int index);
+    static gp_Vec toGpVec(const Poly_Triangulation_NormalType& n);
     static void allocateNormals(const Handle_Poly_Triangulation& triangulation);
 
     static const Poly_Array1OfTriangle& triangles(const Handle_Poly_Triangulation& triangulation) {
@@ -40,6 +79,45 @@ struct MeshUtils {
 #endif
     }
 
+    // Returns an order of the triangles in 'triangulation' maximizing reuse of the post-transform
+    // vertex cache of 'cacheSize' entries, see Tom Forsyth's "Linear-Speed Vertex Cache Optimisation"
+    // Items are the 1-based indices of the triangles
+    static std::vector<int> vertexCacheTriangleOrder(const Handle_Poly_Triangulation& triangulation, int cacheSize = 32);
+
+    // Average count of nodes transformed per triangle(ACMR) when drawing 'triangulation' with a FIFO
+    // vertex cache of 'cacheSize' entries. Lower is better, 3 is the worst case
+    static double averageCacheMissRatio(const Handle_Poly_Triangulation& triangulation, int cacheSize = 32);
+
+    // Reorders triangles of 'triangulation' as specified by 'triangleOrder'(1-based indices), then
+    // renumbers the nodes by order of first use in triangles. Nodes not used are moved at the end
+    // Normals and UV nodes are reordered accordingly
+    // Returns the new 1-based index of each node, so per-node data(eg colors) can be remapped: item
+    // at position i is the new index of node i+1
+    static std::vector<int> reorderTriangulation(
+            const Handle_Poly_Triangulation& triangulation, Span<const int> triangleOrder
+    );
+
+    // Weighting of the triangle normals contributing to the normal at a node
+    enum class NormalWeighting {
+        Area, // Triangle area
+        Angle // Angle of the triangle at the node, independent of the tessellation density
+    };
+
+    // Computes smooth normals at the nodes of 'triangulation', each one being the weighted average of
+    // the normals of the adjacent triangles. Computation is done in parallel
+    // Nodes shared by triangles whose normals deviate by more than 'creaseAngle'(radians) are split,
+    // so each side of the crease gets its own normal. In such case a new triangulation is returned,
+    // otherwise normals are stored in 'triangulation' which is returned(always the case when
+    // 'creaseAngle' >= PI)
+    // Item i of 'ptrVecSourceNode'(optional) receives the 1-based index in 'triangulation' of the node
+    // i+1 of the returned triangulation, so per-node data(eg colors) can be remapped
+    static Handle_Poly_Triangulation computeSmoothNormals(
+            const Handle_Poly_Triangulation& triangulation,
+            double creaseAngle,
+            NormalWeighting weighting = NormalWeighting::Angle,
+            std::vector<int>* ptrVecSourceNode = nullptr
+    );
+
     enum class Orientation {
         Unknown,
         Clockwise,
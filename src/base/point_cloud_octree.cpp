@@ -0,0 +1,160 @@
+/****************************************************************************
+** Copyright (c) 2023, Fougue Ltd. <http://www.fougue.pro>
+** All rights reserved.
+** See license at https://github.com/fougue/mayo/blob/master/LICENSE.txt
+****************************************************************************/
+
+#include "point_cloud_octree.h"
+
+#include "bnd_utils.h"
+
+#include <Precision.hxx>
+#include <gp_Vec.hxx>
+#include <algorithm>
+#include <numeric>
+#include <utility>
+
+namespace Mayo {
+
+bool PointCloudOctree::Node::isLeaf() const
+{
+    return std::all_of(children.cbegin(), children.cend(), [](int child) { return child < 0; });
+}
+
+void PointCloudOctree::build(const Handle(Graphic3d_ArrayOfPoints)& points, const Parameters& params)
+{
+    this->clear();
+    if (!points || points->VertexNumber() <= 0)
+        return;
+
+    m_pointCount = points->VertexNumber();
+    for (int i = 1; i <= m_pointCount; ++i)
+        m_bndBox.Add(points->Vertice(i));
+
+    const BndBoxCoords bndCoords = BndBoxCoords::get(m_bndBox);
+    Node root;
+    root.center = bndCoords.center();
+    root.halfSize = 0.5 * std::max({
+            bndCoords.xmax - bndCoords.xmin, bndCoords.ymax - bndCoords.ymin, bndCoords.zmax - bndCoords.zmin
+    });
+    root.halfSize = std::max(root.halfSize, Precision::Confusion());
+    m_vecNode.push_back(std::move(root));
+
+    // Nodes still having to distribute their points
+    struct PendingNode {
+        int index;
+        std::vector<int> vecPointIndex;
+    };
+    std::vector<PendingNode> vecPendingNode;
+    vecPendingNode.push_back({ 0, std::vector<int>(m_pointCount) });
+    std::iota(vecPendingNode.front().vecPointIndex.begin(), vecPendingNode.front().vecPointIndex.end(), 1);
+
+    const int gridRes = std::max(params.gridResolution, 1);
+    const int gridCellCount = gridRes * gridRes * gridRes;
+    std::vector<bool> vecCellOccupied(gridCellCount, false);
+    std::vector<int> vecOccupiedCell;
+    while (!vecPendingNode.empty()) {
+        PendingNode pending = std::move(vecPendingNode.back());
+        vecPendingNode.pop_back();
+        const gp_Pnt center = m_vecNode.at(pending.index).center;
+        const double halfSize = m_vecNode.at(pending.index).halfSize;
+        const int depth = m_vecNode.at(pending.index).depth;
+        m_depth = std::max(m_depth, depth);
+        if (int(pending.vecPointIndex.size()) <= gridCellCount || depth >= params.maxDepth) {
+            m_vecNode.at(pending.index).vecPointIndex = std::move(pending.vecPointIndex);
+            continue;
+        }
+
+        // Retain the first point of each sampling cell, hand down the others to child octants
+        const gp_XYZ cornerMin = center.XYZ() - gp_XYZ(halfSize, halfSize, halfSize);
+        const double cellSize = 2 * halfSize / gridRes;
+        auto fnCellCoord = [=](double coord, double coordMin) {
+            return std::clamp(static_cast<int>((coord - coordMin) / cellSize), 0, gridRes - 1);
+        };
+
+        std::vector<int> vecRetainedPointIndex;
+        std::array<std::vector<int>, 8> arrayChildPointIndex;
+        for (int pntIndex : pending.vecPointIndex) {
+            const gp_XYZ pnt = points->Vertice(pntIndex).XYZ();
+            const int ix = fnCellCoord(pnt.X(), cornerMin.X());
+            const int iy = fnCellCoord(pnt.Y(), cornerMin.Y());
+            const int iz = fnCellCoord(pnt.Z(), cornerMin.Z());
+            const int cell = (ix * gridRes + iy) * gridRes + iz;
+            if (!vecCellOccupied[cell]) {
+                vecCellOccupied[cell] = true;
+                vecOccupiedCell.push_back(cell);
+                vecRetainedPointIndex.push_back(pntIndex);
+            }
+            else {
+                const int octant =
+                        (pnt.X() >= center.X() ? 1 : 0)
+                        | (pnt.Y() >= center.Y() ? 2 : 0)
+                        | (pnt.Z() >= center.Z() ? 4 : 0);
+                arrayChildPointIndex[octant].push_back(pntIndex);
+            }
+        }
+
+        for (int cell : vecOccupiedCell)
+            vecCellOccupied[cell] = false;
+
+        vecOccupiedCell.clear();
+        m_vecNode.at(pending.index).vecPointIndex = std::move(vecRetainedPointIndex);
+        pending.vecPointIndex = std::vector<int>(); // Release memory early
+
+        for (int octant = 0; octant < 8; ++octant) {
+            if (arrayChildPointIndex[octant].empty())
+                continue;
+
+            const double childHalfSize = halfSize / 2.;
+            Node child;
+            child.center = center.Translated(gp_Vec(
+                    octant & 1 ? childHalfSize : -childHalfSize,
+                    octant & 2 ? childHalfSize : -childHalfSize,
+                    octant & 4 ? childHalfSize : -childHalfSize
+            ));
+            child.halfSize = childHalfSize;
+            child.depth = depth + 1;
+            child.parent = pending.index;
+            const int childIndex = int(m_vecNode.size());
+            m_vecNode.at(pending.index).children[octant] = childIndex;
+            m_vecNode.push_back(std::move(child));
+            vecPendingNode.push_back({ childIndex, std::move(arrayChildPointIndex[octant]) });
+        }
+    }
+}
+
+Handle(Graphic3d_ArrayOfPoints) PointCloudOctree::sortPointsByNode(const Handle(Graphic3d_ArrayOfPoints)& points)
+{
+    if (!points || m_vecNode.empty())
+        return {};
+
+    const bool hasColors = points->HasVertexColors();
+    const bool hasNormals = points->HasVertexNormals();
+    Handle_Graphic3d_ArrayOfPoints sortedPoints = new Graphic3d_ArrayOfPoints(m_pointCount, hasColors, hasNormals);
+    for (Node& node : m_vecNode) {
+        node.sortedPointFirst = sortedPoints->VertexNumber() + 1;
+        node.sortedPointCount = int(node.vecPointIndex.size());
+        for (int pntIndex : node.vecPointIndex) {
+            const int vertexIndex = sortedPoints->AddVertex(points->Vertice(pntIndex));
+            if (hasColors)
+                sortedPoints->SetVertexColor(vertexIndex, points->VertexColor(pntIndex));
+
+            if (hasNormals)
+                sortedPoints->SetVertexNormal(vertexIndex, points->VertexNormal(pntIndex));
+        }
+
+        node.vecPointIndex = std::vector<int>(); // Release memory
+    }
+
+    return sortedPoints;
+}
+
+void PointCloudOctree::clear()
+{
+    m_vecNode.clear();
+    m_pointCount = 0;
+    m_depth = 0;
+    m_bndBox.SetVoid();
+}
+
+} // namespace Mayo
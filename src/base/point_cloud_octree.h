@@ -0,0 +1,75 @@
+/****************************************************************************
+** Copyright (c) 2023, Fougue Ltd. <http://www.fougue.pro>
+** All rights reserved.
+** See license at https://github.com/fougue/mayo/blob/master/LICENSE.txt
+****************************************************************************/
+
+#pragma once
+
+#include <Bnd_Box.hxx>
+#include <Graphic3d_ArrayOfPoints.hxx>
+#include <gp_Pnt.hxx>
+#include <array>
+#include <vector>
+
+namespace Mayo {
+
+// Octree partitioning the points of a Graphic3d_ArrayOfPoints for level-of-detail rendering
+// Each node retains a spatially uniform subset of the points within its cube: at most one point per
+// cell of a regular sampling grid. Points not retained are handed down to the child nodes, so the
+// points of a node together with the ones of its ancestors approximate the cloud at the resolution
+// of the node. Each point belongs to exactly one node
+// Nodes refer to points by their index in the source array(1-based as in Graphic3d_ArrayOfPoints)
+// until sortPointsByNode() is called, then they refer to a contiguous range of the sorted array
+class PointCloudOctree {
+public:
+    struct Node {
+        gp_Pnt center;
+        double halfSize = 0.; // Half length of the cube edges
+        int depth = 0;
+        int parent = -1;
+        std::array<int, 8> children = { -1, -1, -1, -1, -1, -1, -1, -1 }; // -1 if no child
+        std::vector<int> vecPointIndex; // Empty once points are sorted
+        int sortedPointFirst = 0; // Index in the array returned by sortPointsByNode()
+        int sortedPointCount = 0;
+
+        int pointCount() const { return vecPointIndex.empty() ? sortedPointCount : int(vecPointIndex.size()); }
+        bool isLeaf() const;
+    };
+
+    struct Parameters {
+        // Sampling grid of a node has 'gridResolution^3' cells, this is the maximum point count of
+        // a node(apart leaves at 'maxDepth' which keep all their points)
+        int gridResolution = 32;
+        int maxDepth = 20;
+    };
+
+    void build(const Handle(Graphic3d_ArrayOfPoints)& points, const Parameters& params);
+    void build(const Handle(Graphic3d_ArrayOfPoints)& points) { this->build(points, Parameters{}); }
+    void clear();
+
+    // Returns a copy of 'points'(expected to be the array the octree was built from) where the points
+    // of each node are contiguous. Point indices of the nodes are released
+    Handle(Graphic3d_ArrayOfPoints) sortPointsByNode(const Handle(Graphic3d_ArrayOfPoints)& points);
+
+    bool isEmpty() const { return m_vecNode.empty(); }
+
+    // Root node has index zero
+    const std::vector<Node>& nodes() const { return m_vecNode; }
+    const Node& node(int index) const { return m_vecNode.at(index); }
+    int nodeCount() const { return int(m_vecNode.size()); }
+
+    int pointCount() const { return m_pointCount; }
+    int depth() const { return m_depth; }
+
+    // Bounding box of the points(tighter than the cube of the root node)
+    const Bnd_Box& boundingBox() const { return m_bndBox; }
+
+private:
+    std::vector<Node> m_vecNode;
+    int m_pointCount = 0;
+    int m_depth = 0;
+    Bnd_Box m_bndBox;
+};
+
+} // namespace Mayo
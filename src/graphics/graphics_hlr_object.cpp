@@ -0,0 +1,259 @@
+/****************************************************************************
+** Copyright (c) 2022, Fougue Ltd. <http://www.fougue.pro>
+** All rights reserved.
+** See license at https://github.com/fougue/mayo/blob/master/LICENSE.txt
+****************************************************************************/
+
+#include "graphics_hlr_object.h"
+
+#include "../base/bnd_utils.h"
+
+#include <BRepBndLib.hxx>
+#include <BRepBuilderAPI_Copy.hxx>
+#include <BRep_Tool.hxx>
+#include <Graphic3d_Group.hxx>
+#include <HLRAlgo_Projector.hxx>
+#include <HLRBRep_PolyAlgo.hxx>
+#include <HLRBRep_PolyHLRToShape.hxx>
+#include <Prs3d_LineAspect.hxx>
+#include <Standard_Failure.hxx>
+#include <TopExp.hxx>
+#include <TopExp_Explorer.hxx>
+#include <TopoDS_Iterator.hxx>
+#include <TopoDS.hxx>
+#include <cmath>
+#include <thread>
+#include <vector>
+
+namespace Mayo {
+
+GraphicsHlrObject::GraphicsHlrObject(const TopoDS_Shape& shape, std::mutex* brepMeshMutex)
+    : m_brepMeshMutex(brepMeshMutex),
+      m_shape(shape)
+{
+    myDrawer->SetSeenLineAspect(new Prs3d_LineAspect(Quantity_NOC_BLACK, Aspect_TOL_SOLID, 1.5));
+    myDrawer->SetHiddenLineAspect(new Prs3d_LineAspect(Quantity_NOC_GRAY40, Aspect_TOL_DASH, 1.));
+    this->SetDisplayMode(0);
+}
+
+GraphicsHlrObject::~GraphicsHlrObject()
+{
+    this->cancel();
+}
+
+void GraphicsHlrObject::setShape(const TopoDS_Shape& shape)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_shape = shape;
+    ++m_generation;
+    m_mapCache.clear();
+    m_queueCacheKey.clear();
+    m_currentProjection.reset();
+    m_hasPendingRequest = false; // Outdated
+}
+
+bool GraphicsHlrObject::isSameShape(const TopoDS_Shape& shape) const
+{
+    if (m_shape.IsNull() || shape.IsNull())
+        return m_shape.IsNull() && shape.IsNull();
+
+    TopoDS_Iterator it(m_shape);
+    TopoDS_Iterator itOther(shape);
+    for (; it.More() && itOther.More(); it.Next(), itOther.Next()) {
+        if (!it.Value().IsEqual(itOther.Value()))
+            return false;
+    }
+
+    return !it.More() && !itOther.More();
+}
+
+bool GraphicsHlrObject::requestProjection(const gp_Dir& eyeDir)
+{
+    if (m_isCancelled || m_shape.IsNull())
+        return false;
+
+    const CacheKey key = toCacheKey(eyeDir);
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_requestedKey = key;
+    auto itCache = m_mapCache.find(key);
+    if (itCache != m_mapCache.cend()) {
+        m_currentProjection = itCache->second;
+        m_hasPendingRequest = false; // Outdated
+        return true;
+    }
+
+    m_pendingEyeDir = eyeDir;
+    m_hasPendingRequest = true;
+    if (!m_isWorkerRunning) {
+        m_isWorkerRunning = true;
+        // The worker thread is detached and keeps the object alive until it's finished, so cancel()
+        // and the destructor never have to wait for a projection to complete
+        const Handle(GraphicsHlrObject) self = this;
+        std::thread([=]{ self->runWorker(); }).detach();
+    }
+
+    return false;
+}
+
+void GraphicsHlrObject::cancel()
+{
+    // Worker sends signalProjectionReady with 'm_mutex' locked, so it isn't sent once this returns
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_isCancelled = true;
+    m_hasPendingRequest = false;
+}
+
+int GraphicsHlrObject::maxCacheSize()
+{
+    return 32;
+}
+
+void GraphicsHlrObject::Compute(
+        const Handle(PrsMgr_PresentationManager)&,
+        const Handle(Prs3d_Presentation)& pres,
+        const int mode)
+{
+    if (mode != 0 || !m_currentProjection)
+        return;
+
+    auto fnAddLines = [&](const Handle_Graphic3d_ArrayOfSegments& lines, const Handle_Prs3d_LineAspect& aspect) {
+        if (!lines || lines->VertexNumber() <= 0)
+            return;
+
+        Handle_Graphic3d_Group group = pres->NewGroup();
+        group->SetGroupPrimitivesAspect(aspect->Aspect());
+        group->AddPrimitiveArray(lines);
+    };
+
+    fnAddLines(m_currentProjection->visibleLines, myDrawer->SeenLineAspect());
+    if (m_isHiddenLinesVisible)
+        fnAddLines(m_currentProjection->hiddenLines, myDrawer->HiddenLineAspect());
+}
+
+GraphicsHlrObject::CacheKey GraphicsHlrObject::toCacheKey(const gp_Dir& eyeDir)
+{
+    // Directions closer than ~0.05 degree share the same projection
+    constexpr double quantization = 1000.;
+    return {
+        static_cast<int>(std::lround(eyeDir.X() * quantization)),
+        static_cast<int>(std::lround(eyeDir.Y() * quantization)),
+        static_cast<int>(std::lround(eyeDir.Z() * quantization))
+    };
+}
+
+GraphicsHlrObject::ProjectionPtr GraphicsHlrObject::computeProjection(
+        const TopoDS_Shape& shape, const gp_Pnt& center, const gp_Dir& eyeDir)
+{
+    auto projection = std::make_shared<Projection>();
+    try {
+        const HLRAlgo_Projector projector(gp_Ax2(center, eyeDir));
+        Handle_HLRBRep_PolyAlgo algo = new HLRBRep_PolyAlgo;
+        algo->Load(shape);
+        algo->Projector(projector);
+        algo->Update();
+        HLRBRep_PolyHLRToShape hlrToShape;
+        hlrToShape.Update(algo);
+
+        // Resulting edges are straight segments in the projection plane(XY of projector frame)
+        const gp_Trsf& trsfToWorld = projector.InvertedTransformation();
+        auto fnCreateLines = [&](std::initializer_list<TopoDS_Shape> listShape) {
+            std::vector<gp_Pnt> vecPnt;
+            for (const TopoDS_Shape& shape : listShape) {
+                for (TopExp_Explorer expEdge(shape, TopAbs_EDGE); expEdge.More(); expEdge.Next()) {
+                    TopoDS_Vertex vertexFirst;
+                    TopoDS_Vertex vertexLast;
+                    TopExp::Vertices(TopoDS::Edge(expEdge.Current()), vertexFirst, vertexLast);
+                    if (vertexFirst.IsNull() || vertexLast.IsNull())
+                        continue;
+
+                    vecPnt.push_back(BRep_Tool::Pnt(vertexFirst).Transformed(trsfToWorld));
+                    vecPnt.push_back(BRep_Tool::Pnt(vertexLast).Transformed(trsfToWorld));
+                }
+            }
+
+            Handle_Graphic3d_ArrayOfSegments lines;
+            if (!vecPnt.empty()) {
+                lines = new Graphic3d_ArrayOfSegments(int(vecPnt.size()));
+                for (const gp_Pnt& pnt : vecPnt)
+                    lines->AddVertex(pnt);
+            }
+
+            return lines;
+        };
+
+        projection->visibleLines = fnCreateLines({ hlrToShape.VCompound(), hlrToShape.OutLineVCompound() });
+        projection->hiddenLines = fnCreateLines({ hlrToShape.HCompound(), hlrToShape.OutLineHCompound() });
+    }
+    catch (const Standard_Failure&) {
+        // Keep empty projection, so it isn't computed again
+    }
+
+    return projection;
+}
+
+void GraphicsHlrObject::runWorker()
+{
+    // Copy of the shape to project, made once per generation
+    TopoDS_Shape shapeCopy;
+    gp_Pnt center;
+    unsigned copyGeneration = 0;
+    bool hasCopy = false;
+    while (!m_isCancelled) {
+        gp_Dir eyeDir;
+        TopoDS_Shape shape;
+        unsigned generation = 0;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (!m_hasPendingRequest) {
+                m_isWorkerRunning = false;
+                return;
+            }
+
+            eyeDir = m_pendingEyeDir;
+            shape = m_shape;
+            generation = m_generation;
+            m_hasPendingRequest = false;
+        }
+
+        if (!hasCopy || copyGeneration != generation) {
+            // Geometry is read-only so it's shared, but triangulations have to be copied
+            constexpr bool copyGeom = false;
+            constexpr bool copyMesh = true;
+            {
+                std::unique_lock<std::mutex> brepMeshLock;
+                if (m_brepMeshMutex)
+                    brepMeshLock = std::unique_lock<std::mutex>(*m_brepMeshMutex);
+
+                shapeCopy = BRepBuilderAPI_Copy(shape, copyGeom, copyMesh).Shape();
+            }
+
+            Bnd_Box bndBox;
+            BRepBndLib::Add(shapeCopy, bndBox);
+            center = !bndBox.IsVoid() ? BndBoxCoords::get(bndBox).center() : gp_Pnt();
+            copyGeneration = generation;
+            hasCopy = true;
+        }
+
+        const ProjectionPtr projection = computeProjection(shapeCopy, center, eyeDir);
+        const CacheKey key = toCacheKey(eyeDir);
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (generation != m_generation)
+            continue; // Shape changed meanwhile, drop the projection
+
+        if (m_mapCache.insert({ key, projection }).second) {
+            m_queueCacheKey.push_back(key);
+            if (m_queueCacheKey.size() > static_cast<size_t>(maxCacheSize())) {
+                m_mapCache.erase(m_queueCacheKey.front());
+                m_queueCacheKey.pop_front();
+            }
+        }
+
+        if (key == m_requestedKey && !m_isCancelled)
+            this->signalProjectionReady.send();
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_isWorkerRunning = false;
+}
+
+} // namespace Mayo
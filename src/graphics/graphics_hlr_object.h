@@ -0,0 +1,122 @@
+/****************************************************************************
+** Copyright (c) 2022, Fougue Ltd. <http://www.fougue.pro>
+** All rights reserved.
+** See license at https://github.com/fougue/mayo/blob/master/LICENSE.txt
+****************************************************************************/
+
+#pragma once
+
+#include "../base/signal.h"
+#include "../base/tkernel_utils.h"
+
+#include <AIS_InteractiveObject.hxx>
+#include <Graphic3d_ArrayOfSegments.hxx>
+#include <Prs3d_Presentation.hxx>
+#include <PrsMgr_PresentationManager.hxx>
+#include <SelectMgr_Selection.hxx>
+#include <TopoDS_Shape.hxx>
+#include <gp_Dir.hxx>
+#include <gp_Pnt.hxx>
+#include <array>
+#include <atomic>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+
+#if OCC_VERSION_HEX < OCC_VERSION_CHECK(7, 5, 0)
+#  include <Prs3d_Projector.hxx>
+#endif
+
+namespace Mayo {
+
+// Graphics object displaying the hidden-line-removal(HLR) projection of a triangulated shape
+// Projections are computed by a detached worker thread with the polygonal HLR algorithm and cached
+// per view direction. Requests made while a projection is being computed replace any request still
+// waiting, so only the latest camera orientation is computed next
+// Each call to setShape() starts a new generation: the cache is cleared and projections of the
+// previous generation still being computed are dropped once done
+// Projection lines lie in the plane orthogonal to the view direction and passing through the center
+// of the shape, which is exact for orthographic cameras
+// Display modes:
+//     0 -> visible lines(solid) and hidden lines(dashed)
+class GraphicsHlrObject : public AIS_InteractiveObject {
+public:
+    // 'shape' is expected in world coordinates, it's copied by the worker thread so projections
+    // don't share topology with the rest of the application(eg triangulations switched when refining)
+    // The copy is made while 'brepMeshMutex' is locked, if any
+    GraphicsHlrObject(const TopoDS_Shape& shape, std::mutex* brepMeshMutex = nullptr);
+    ~GraphicsHlrObject();
+
+    const TopoDS_Shape& shape() const { return m_shape; }
+    void setShape(const TopoDS_Shape& shape);
+    // Whether 'shape' has the same sub-shapes(with same locations) than the current shape, then
+    // cached projections still apply provided triangulations weren't changed
+    bool isSameShape(const TopoDS_Shape& shape) const;
+
+    // Requests HLR projection for 'eyeDir', the direction pointing from the view center to the eye
+    // Returns true if the projection is available right away(cached), then it's the one displayed on
+    // next presentation computation
+    // Otherwise it's computed in background and signalProjectionReady is sent once done
+    bool requestProjection(const gp_Dir& eyeDir);
+
+    // Abandons pending projection requests, doesn't wait for the worker thread to finish
+    // Nothing is computed after the current projection and signalProjectionReady isn't sent anymore
+    void cancel();
+    bool isCancelled() const { return m_isCancelled; }
+
+    // Maximum count of projections kept in cache
+    static int maxCacheSize();
+
+    void setHiddenLinesVisible(bool on) { m_isHiddenLinesVisible = on; }
+
+    bool AcceptDisplayMode(const int mode) const override { return mode == 0; }
+    void ComputeSelection(const Handle(SelectMgr_Selection)&, const int) override {}
+
+    // Signal sent from the worker thread when the projection of the latest request is available
+    Signal<> signalProjectionReady;
+
+    DEFINE_STANDARD_RTTI_INLINE(GraphicsHlrObject, AIS_InteractiveObject)
+
+protected:
+    void Compute(
+            const Handle(PrsMgr_PresentationManager)& pm,
+            const Handle(Prs3d_Presentation)& pres,
+            const int mode) override;
+
+#if OCC_VERSION_HEX < OCC_VERSION_CHECK(7, 5, 0)
+    void Compute(const Handle(Prs3d_Projector)&, const Handle(Prs3d_Presentation)&) override {}
+#endif
+
+private:
+    struct Projection {
+        Handle_Graphic3d_ArrayOfSegments visibleLines;
+        Handle_Graphic3d_ArrayOfSegments hiddenLines;
+    };
+    using ProjectionPtr = std::shared_ptr<const Projection>;
+    using CacheKey = std::array<int, 3>; // Quantized view direction
+
+    static CacheKey toCacheKey(const gp_Dir& eyeDir);
+    static ProjectionPtr computeProjection(const TopoDS_Shape& shape, const gp_Pnt& center, const gp_Dir& eyeDir);
+    void runWorker();
+
+    std::mutex* m_brepMeshMutex = nullptr;
+    bool m_isHiddenLinesVisible = true;
+    ProjectionPtr m_currentProjection;
+
+    // Shared with the worker thread
+    std::mutex m_mutex;
+    TopoDS_Shape m_shape;
+    unsigned m_generation = 0;
+    std::map<CacheKey, ProjectionPtr> m_mapCache;
+    std::deque<CacheKey> m_queueCacheKey; // Insertion order, to evict oldest projections
+    CacheKey m_requestedKey = {};
+    gp_Dir m_pendingEyeDir;
+    bool m_hasPendingRequest = false;
+    bool m_isWorkerRunning = false;
+    std::atomic<bool> m_isCancelled{false};
+};
+
+DEFINE_STANDARD_HANDLE(GraphicsHlrObject, AIS_InteractiveObject)
+
+} // namespace Mayo
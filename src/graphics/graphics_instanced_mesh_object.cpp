@@ -0,0 +1,435 @@
+/****************************************************************************
+** Copyright (c) 2022, Fougue Ltd. <http://www.fougue.pro>
+** All rights reserved.
+** See license at https://github.com/fougue/mayo/blob/master/LICENSE.txt
+****************************************************************************/
+
+#include "graphics_instanced_mesh_object.h"
+
+#include "../base/mesh_utils.h"
+#include "graphics_mesh_array_object.h"
+
+#include <BRep_Tool.hxx>
+#include <Graphic3d_Group.hxx>
+#include <Prs3d_ShadingAspect.hxx>
+#include <Select3D_SensitiveTriangulation.hxx>
+#include <TopExp_Explorer.hxx>
+#include <TopoDS.hxx>
+#include <TopoDS_Face.hxx>
+#include <algorithm>
+#include <utility>
+
+#if OCC_VERSION_HEX >= OCC_VERSION_CHECK(7, 5, 0)
+#  include <TopLoc_Datum3D.hxx>
+#else
+#  include <Geom_Transformation.hxx>
+#endif
+
+namespace Mayo {
+
+namespace {
+
+void setPresentationTransformation(const Handle(Prs3d_Presentation)& pres, const gp_Trsf& trsf)
+{
+#if OCC_VERSION_HEX >= OCC_VERSION_CHECK(7, 5, 0)
+    pres->SetTransformation(new TopLoc_Datum3D(trsf));
+#else
+    pres->SetTransformation(new Geom_Transformation(trsf));
+#endif
+}
+
+} // namespace
+
+GraphicsInstanceOwner::GraphicsInstanceOwner(const Handle(GraphicsInstancedMeshObject)& object, int instanceIndex)
+    : SelectMgr_EntityOwner(object),
+      m_instanceIndex(instanceIndex)
+{
+}
+
+void GraphicsInstanceOwner::updateHighlight()
+{
+    if (!m_prsHighlight || !m_aspectHighlight)
+        return;
+
+    auto object = Handle(GraphicsInstancedMeshObject)::DownCast(this->Selectable());
+    if (object) {
+        const gp_Trsf trsf = object->Transformation() * object->instanceTransformation(m_instanceIndex);
+        setPresentationTransformation(m_prsHighlight, trsf);
+    }
+}
+
+void GraphicsInstanceOwner::HilightWithColor(
+        const Handle(PrsMgr_PresentationManager)& pm, const Handle(Prs3d_Drawer)& style, const int)
+{
+    auto object = Handle(GraphicsInstancedMeshObject)::DownCast(this->Selectable());
+    if (!object)
+        return;
+
+    if (!m_prsHighlight)
+        m_prsHighlight = new Prs3d_Presentation(pm->StructureManager());
+
+    Handle_Prs3d_ShadingAspect shadingAspect = new Prs3d_ShadingAspect;
+    shadingAspect->SetMaterial(object->Attributes()->ShadingAspect()->Material());
+    shadingAspect->SetColor(style->Color());
+    m_aspectHighlight = shadingAspect->Aspect();
+
+    m_prsHighlight->Clear();
+    object->computeInstancePresentation(m_prsHighlight, m_aspectHighlight);
+    this->updateHighlight();
+    // Highlight geometry coincides with the instanced geometry, draw it on top
+    const Graphic3d_ZLayerId zLayer =
+            style->ZLayer() != Graphic3d_ZLayerId_UNKNOWN ? style->ZLayer() : Graphic3d_ZLayerId_Top;
+    m_prsHighlight->SetZLayer(zLayer);
+    if (pm->IsImmediateModeOn())
+        pm->AddToImmediateList(m_prsHighlight);
+    else
+        m_prsHighlight->Display();
+}
+
+void GraphicsInstanceOwner::Unhilight(const Handle(PrsMgr_PresentationManager)&, const int)
+{
+    if (m_prsHighlight)
+        m_prsHighlight->Erase();
+
+    m_aspectHighlight.Nullify();
+}
+
+bool GraphicsInstanceOwner::IsHilighted(const Handle(PrsMgr_PresentationManager)&, const int) const
+{
+    return m_prsHighlight && m_prsHighlight->IsDisplayed();
+}
+
+void GraphicsInstanceOwner::Clear(const Handle(PrsMgr_PresentationManager)&, const int)
+{
+    if (m_prsHighlight) {
+        m_prsHighlight->Clear();
+        m_prsHighlight->Erase();
+    }
+
+    m_aspectHighlight.Nullify();
+}
+
+GraphicsInstancedMeshObject::GraphicsInstancedMeshObject(const TopoDS_Shape& shape)
+    : m_shape(shape)
+{
+    this->updateTriangulations();
+
+    // Own shading aspect, otherwise the one of the default drawer would be altered by setters
+    myDrawer->SetShadingAspect(new Prs3d_ShadingAspect);
+    myDrawer->ShadingAspect()->Aspect()->SetInteriorStyle(Aspect_IS_SOLID);
+    myDrawer->ShadingAspect()->Aspect()->SetDrawEdges(false);
+    this->SetDisplayMode(0);
+}
+
+void GraphicsInstancedMeshObject::updateTriangulations()
+{
+    m_vecFace.clear();
+    m_vecChunk.clear(); // Presentation has to be recomputed
+    m_nodeCount = 0;
+    m_triangleCount = 0;
+    m_bndBox.SetVoid();
+    for (TopExp_Explorer expFace(m_shape, TopAbs_FACE); expFace.More(); expFace.Next()) {
+        const TopoDS_Face& face = TopoDS::Face(expFace.Current());
+        TopLoc_Location loc;
+        const Handle_Poly_Triangulation& triangulation = BRep_Tool::Triangulation(face, loc);
+        if (!triangulation)
+            continue;
+
+        Face item;
+        item.triangulation = triangulation;
+        item.trsf = loc.Transformation();
+        item.reversed = face.Orientation() == TopAbs_REVERSED;
+
+        // Accumulate normals of the triangles around each node, weighted by triangle area
+        item.vecNodeNormal.resize(triangulation->NbNodes(), gp_Vec(0, 0, 0));
+        for (const Poly_Triangle& triangle : MeshUtils::triangles(triangulation)) {
+            int v[3];
+            triangle.Get(v[0], v[1], v[2]);
+            if (item.reversed)
+                std::swap(v[1], v[2]);
+
+            const gp_XYZ p0 = triangulation->Node(v[0]).XYZ();
+            const gp_XYZ p1 = triangulation->Node(v[1]).XYZ();
+            const gp_XYZ p2 = triangulation->Node(v[2]).XYZ();
+            const gp_Vec n((p1 - p0).Crossed(p2 - p0));
+            for (int nodeId : v)
+                item.vecNodeNormal[nodeId - 1] += n;
+        }
+
+        for (int i = 1; i <= triangulation->NbNodes(); ++i)
+            m_bndBox.Add(triangulation->Node(i).Transformed(item.trsf));
+
+        m_nodeCount += triangulation->NbNodes();
+        m_triangleCount += triangulation->NbTriangles();
+        m_vecFace.push_back(std::move(item));
+    }
+}
+
+bool GraphicsInstancedMeshObject::isShapeSupported(const TopoDS_Shape& shape)
+{
+    bool hasFace = false;
+    for (TopExp_Explorer expFace(shape, TopAbs_FACE); expFace.More(); expFace.Next()) {
+        TopLoc_Location loc;
+        if (!BRep_Tool::Triangulation(TopoDS::Face(expFace.Current()), loc))
+            return false;
+
+        hasFace = true;
+    }
+
+    return hasFace;
+}
+
+int GraphicsInstancedMeshObject::addInstance(const gp_Trsf& trsf)
+{
+    const int index = this->instanceCount();
+    Instance instance;
+    instance.trsf = trsf;
+    instance.owner = new GraphicsInstanceOwner(this, index);
+    m_vecInstance.push_back(std::move(instance));
+    return index;
+}
+
+const gp_Trsf& GraphicsInstancedMeshObject::instanceTransformation(int index) const
+{
+    return m_vecInstance.at(index).trsf;
+}
+
+void GraphicsInstancedMeshObject::setInstanceTransformation(int index, const gp_Trsf& trsf)
+{
+    Instance& instance = m_vecInstance.at(index);
+    instance.trsf = trsf;
+    if (instance.owner->isHighlighted())
+        instance.owner->updateHighlight();
+
+    if (m_isMotionModeOn)
+        setPresentationTransformation(m_vecInstanceShadow.at(index), this->Transformation() * trsf);
+
+    this->setInstanceOutdated(index);
+}
+
+bool GraphicsInstancedMeshObject::isInstanceVisible(int index) const
+{
+    return m_vecInstance.at(index).visible;
+}
+
+void GraphicsInstancedMeshObject::setInstanceVisible(int index, bool on)
+{
+    Instance& instance = m_vecInstance.at(index);
+    if (instance.visible != on) {
+        instance.visible = on;
+        if (m_isMotionModeOn && on)
+            m_vecInstanceShadow.at(index)->Display();
+        else if (m_isMotionModeOn)
+            m_vecInstanceShadow.at(index)->Erase();
+
+        this->setInstanceOutdated(index);
+    }
+}
+
+const Handle(GraphicsInstanceOwner)& GraphicsInstancedMeshObject::instanceOwner(int index) const
+{
+    return m_vecInstance.at(index).owner;
+}
+
+Bnd_Box GraphicsInstancedMeshObject::instanceBoundingBox(int index) const
+{
+    return m_bndBox.Transformed(m_vecInstance.at(index).trsf);
+}
+
+Quantity_Color GraphicsInstancedMeshObject::color() const
+{
+    return myDrawer->ShadingAspect()->Color();
+}
+
+void GraphicsInstancedMeshObject::setColor(const Quantity_Color& color)
+{
+    myDrawer->ShadingAspect()->SetColor(color);
+}
+
+void GraphicsInstancedMeshObject::setMaterial(const Graphic3d_MaterialAspect& material)
+{
+    myDrawer->ShadingAspect()->SetMaterial(material);
+}
+
+void GraphicsInstancedMeshObject::computeInstancePresentation(
+        const Handle(Prs3d_Presentation)& pres, const Handle(Graphic3d_AspectFillArea3d)& aspect) const
+{
+    Handle_Graphic3d_ArrayOfTriangles array =
+            new Graphic3d_ArrayOfTriangles(m_nodeCount, 3 * m_triangleCount, true);
+    this->addInstanceTriangles(gp_Trsf(), array);
+    Handle_Graphic3d_Group group = pres->NewGroup();
+    group->SetGroupPrimitivesAspect(aspect);
+    group->AddPrimitiveArray(array);
+}
+
+void GraphicsInstancedMeshObject::ComputeSelection(const Handle(SelectMgr_Selection)& sel, const int mode)
+{
+    if (mode != 0)
+        return;
+
+    for (const Instance& instance : m_vecInstance) {
+        if (!instance.visible)
+            continue;
+
+        for (const Face& face : m_vecFace) {
+            const TopLoc_Location loc(instance.trsf * face.trsf);
+            sel->Add(new Select3D_SensitiveTriangulation(instance.owner, face.triangulation, loc, true));
+        }
+    }
+}
+
+void GraphicsInstancedMeshObject::Compute(
+        const Handle(PrsMgr_PresentationManager)& pm,
+        const Handle(Prs3d_Presentation)& pres,
+        const int mode)
+{
+    if (mode != 0)
+        return;
+
+    // Chunks are built with the current instance transformations, shadows aren't needed anymore
+    this->setMotionModeOn(false);
+    m_prs = pres;
+    m_structureManager = pm->StructureManager();
+    m_vecChunk.clear();
+    if (m_triangleCount <= 0)
+        return;
+
+    const int chunkInstanceCount = this->chunkInstanceCount();
+    for (int first = 0; first < this->instanceCount(); first += chunkInstanceCount) {
+        Chunk chunk;
+        chunk.firstInstance = first;
+        chunk.instanceCount = std::min(chunkInstanceCount, this->instanceCount() - first);
+        chunk.group = pres->NewGroup();
+        this->fillChunkGroup(chunk);
+        m_vecChunk.push_back(std::move(chunk));
+    }
+}
+
+void GraphicsInstancedMeshObject::updatePresentation()
+{
+    if (m_isMotionModeOn)
+        return;
+
+    bool isUpdated = false;
+    for (Chunk& chunk : m_vecChunk) {
+        if (chunk.outdated) {
+            this->fillChunkGroup(chunk);
+            chunk.outdated = false;
+            isUpdated = true;
+        }
+    }
+
+    if (isUpdated) {
+        m_prs->CalculateBoundBox();
+        m_prs->Update(true/*updateLayer*/);
+    }
+}
+
+void GraphicsInstancedMeshObject::setMotionModeOn(bool on)
+{
+    if (on == m_isMotionModeOn)
+        return;
+
+    if (on && (m_vecChunk.empty() || !m_prs->IsDisplayed()))
+        return;
+
+    m_isMotionModeOn = on;
+    if (on) {
+        m_prsInstance = new Prs3d_Presentation(m_structureManager);
+        this->computeInstancePresentation(m_prsInstance, myDrawer->ShadingAspect()->Aspect());
+        m_vecInstanceShadow.reserve(m_vecInstance.size());
+        for (const Instance& instance : m_vecInstance) {
+            Handle(Prs3d_PresentationShadow) shadow = new Prs3d_PresentationShadow(m_structureManager, m_prsInstance);
+            shadow->SetZLayer(m_prs->GetZLayer());
+            setPresentationTransformation(shadow, this->Transformation() * instance.trsf);
+            if (instance.visible)
+                shadow->Display();
+
+            m_vecInstanceShadow.push_back(shadow);
+        }
+
+        // Chunks are rebuilt once motion is over, their arrays would be outdated at each step anyway
+        for (Chunk& chunk : m_vecChunk) {
+            chunk.group->Clear(false);
+            chunk.outdated = true;
+        }
+
+        m_prs->CalculateBoundBox();
+        m_prs->Update(true/*updateLayer*/);
+    }
+    else {
+        for (const Handle(Prs3d_PresentationShadow)& shadow : m_vecInstanceShadow)
+            shadow->Erase();
+
+        m_vecInstanceShadow.clear();
+        m_prsInstance.Nullify();
+    }
+}
+
+void GraphicsInstancedMeshObject::setInstanceOutdated(int index)
+{
+    if (m_vecChunk.empty())
+        return;
+
+    const size_t chunkIndex = index / this->chunkInstanceCount();
+    if (chunkIndex < m_vecChunk.size())
+        m_vecChunk.at(chunkIndex).outdated = true;
+}
+
+int GraphicsInstancedMeshObject::chunkInstanceCount() const
+{
+    // Small enough so rebuilding a chunk is fast, big enough to keep the count of draw calls low
+    constexpr int chunkTriangleCount = 1 << 18;
+    const int maxTriangleCount = std::min(chunkTriangleCount, GraphicsMeshArrayObject::maxArrayTriangleCount());
+    return std::max(1, maxTriangleCount / std::max(m_triangleCount, 1));
+}
+
+void GraphicsInstancedMeshObject::fillChunkGroup(const Chunk& chunk) const
+{
+    chunk.group->Clear(false);
+    chunk.group->SetGroupPrimitivesAspect(myDrawer->ShadingAspect()->Aspect());
+    const auto itFirst = m_vecInstance.cbegin() + chunk.firstInstance;
+    const auto itLast = itFirst + chunk.instanceCount;
+    const int visibleCount =
+            int(std::count_if(itFirst, itLast, [](const Instance& instance) { return instance.visible; }));
+    if (visibleCount == 0)
+        return;
+
+    Handle_Graphic3d_ArrayOfTriangles array = new Graphic3d_ArrayOfTriangles(
+                visibleCount * m_nodeCount, 3 * visibleCount * m_triangleCount, true
+    );
+    for (auto it = itFirst; it != itLast; ++it) {
+        if (it->visible)
+            this->addInstanceTriangles(it->trsf, array);
+    }
+
+    chunk.group->AddPrimitiveArray(array);
+}
+
+void GraphicsInstancedMeshObject::addInstanceTriangles(
+        const gp_Trsf& trsf, const Handle(Graphic3d_ArrayOfTriangles)& array) const
+{
+    for (const Face& face : m_vecFace) {
+        const gp_Trsf trsfFace = trsf * face.trsf;
+        const Handle_Poly_Triangulation& triangulation = face.triangulation;
+        const int vertexOffset = array->VertexNumber();
+        for (int i = 1; i <= triangulation->NbNodes(); ++i) {
+            const gp_Pnt pnt = triangulation->Node(i).Transformed(trsfFace);
+            gp_Vec n = face.vecNodeNormal[i - 1].Transformed(trsfFace);
+            const double nLength = n.Magnitude();
+            n = nLength > 0. ? n / nLength : gp_Vec(0, 0, 1);
+            array->AddVertex(pnt.X(), pnt.Y(), pnt.Z(), n.X(), n.Y(), n.Z());
+        }
+
+        for (const Poly_Triangle& triangle : MeshUtils::triangles(triangulation)) {
+            int v[3];
+            triangle.Get(v[0], v[1], v[2]);
+            if (face.reversed)
+                std::swap(v[1], v[2]);
+
+            array->AddEdges(vertexOffset + v[0], vertexOffset + v[1], vertexOffset + v[2]);
+        }
+    }
+}
+
+} // namespace Mayo
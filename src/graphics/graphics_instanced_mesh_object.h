@@ -0,0 +1,182 @@
+/****************************************************************************
+** Copyright (c) 2022, Fougue Ltd. <http://www.fougue.pro>
+** All rights reserved.
+** See license at https://github.com/fougue/mayo/blob/master/LICENSE.txt
+****************************************************************************/
+
+#pragma once
+
+#include "../base/tkernel_utils.h"
+
+#include <AIS_InteractiveObject.hxx>
+#include <Bnd_Box.hxx>
+#include <Graphic3d_ArrayOfTriangles.hxx>
+#include <Graphic3d_AspectFillArea3d.hxx>
+#include <Poly_Triangulation.hxx>
+#include <Prs3d_Presentation.hxx>
+#include <Prs3d_PresentationShadow.hxx>
+#include <PrsMgr_PresentationManager.hxx>
+#include <Quantity_Color.hxx>
+#include <SelectMgr_EntityOwner.hxx>
+#include <SelectMgr_Selection.hxx>
+#include <TopoDS_Shape.hxx>
+#include <gp_Trsf.hxx>
+#include <gp_Vec.hxx>
+#include <vector>
+
+#if OCC_VERSION_HEX < OCC_VERSION_CHECK(7, 5, 0)
+#  include <Prs3d_Projector.hxx>
+#endif
+
+namespace Mayo {
+
+class GraphicsInstancedMeshObject;
+DEFINE_STANDARD_HANDLE(GraphicsInstancedMeshObject, AIS_InteractiveObject)
+
+// Selection owner of a single instance within a GraphicsInstancedMeshObject
+// Highlighting is restricted to the geometry of the instance
+class GraphicsInstanceOwner : public SelectMgr_EntityOwner {
+public:
+    GraphicsInstanceOwner(const Handle(GraphicsInstancedMeshObject)& object, int instanceIndex);
+
+    int instanceIndex() const { return m_instanceIndex; }
+
+    // Whether highlighted(or selected), ie HilightWithColor() was called and not undone since
+    bool isHighlighted() const { return !m_aspectHighlight.IsNull(); }
+    // Moves the highlight presentation to the current instance transformation, geometry isn't recomputed
+    void updateHighlight();
+
+    void HilightWithColor(
+            const Handle(PrsMgr_PresentationManager)& pm,
+            const Handle(Prs3d_Drawer)& style,
+            const int mode) override;
+    void Unhilight(const Handle(PrsMgr_PresentationManager)& pm, const int mode) override;
+    bool IsHilighted(const Handle(PrsMgr_PresentationManager)& pm, const int mode) const override;
+    void Clear(const Handle(PrsMgr_PresentationManager)& pm, const int mode) override;
+
+    DEFINE_STANDARD_RTTI_INLINE(GraphicsInstanceOwner, SelectMgr_EntityOwner)
+
+private:
+    int m_instanceIndex = -1;
+    Handle_Prs3d_Presentation m_prsHighlight;
+    Handle_Graphic3d_AspectFillArea3d m_aspectHighlight;
+};
+
+// Graphics object drawing all the instances(occurrences) of a triangulated shape with a single
+// primitive array, so there is one draw call whatever the instance count
+// OpenCascade doesn't provide instanced drawing, so the geometry of visible instances is expanded
+// into the array with their transformation applied. Instances are split into chunks of consecutive
+// instances, each chunk having its own group and array, so changing some instances only rebuilds
+// the arrays of their chunks(see updatePresentation())
+// Each instance has its own transformation, visible state and selection owner
+// While instances are moved continuously(eg exploding slider dragged) the motion mode avoids to
+// rebuild the chunks at each step(see setMotionModeOn())
+// Display modes:
+//     0 -> shaded
+class GraphicsInstancedMeshObject : public AIS_InteractiveObject {
+public:
+    // 'shape' must be completely triangulated(see isShapeSupported())
+    GraphicsInstancedMeshObject(const TopoDS_Shape& shape);
+
+    // Whether all faces of 'shape' have a triangulation
+    static bool isShapeSupported(const TopoDS_Shape& shape);
+
+    const TopoDS_Shape& shape() const { return m_shape; }
+
+    // Reloads the current triangulations of the shape faces, to be called when they were changed
+    // (eg BRep mesh refined or dropped). Presentation and selection have then to be recomputed
+    // Presentation and selection only read the reloaded triangulations, not the shape faces
+    void updateTriangulations();
+
+    int triangleCount() const { return m_triangleCount; }
+
+    int addInstance(const gp_Trsf& trsf);
+    int instanceCount() const { return int(m_vecInstance.size()); }
+
+    const gp_Trsf& instanceTransformation(int index) const;
+    void setInstanceTransformation(int index, const gp_Trsf& trsf);
+
+    bool isInstanceVisible(int index) const;
+    void setInstanceVisible(int index, bool on);
+
+    // Rebuilds in the computed presentation the arrays of the instances whose transformation or
+    // visible state changed, which is much cheaper than a complete recompute of the presentation
+    // Selection isn't updated, it has to be recomputed afterwards
+    // Does nothing while motion mode is on
+    void updatePresentation();
+
+    // Motion mode draws each visible instance with a shadow structure of the instance geometry, so
+    // changing an instance transformation is just a matter of moving its structure. Chunks are hidden
+    // meanwhile. When turned off, all chunks are outdated and updatePresentation() has to be called
+    // Turning on has no effect if the presentation isn't computed and displayed yet
+    bool isMotionModeOn() const { return m_isMotionModeOn; }
+    void setMotionModeOn(bool on);
+
+    const Handle(GraphicsInstanceOwner)& instanceOwner(int index) const;
+    Bnd_Box instanceBoundingBox(int index) const;
+
+    Quantity_Color color() const;
+    void setColor(const Quantity_Color& color);
+    void setMaterial(const Graphic3d_MaterialAspect& material);
+
+    // Adds to 'pres' the geometry of a single instance, without instance transformation
+    void computeInstancePresentation(
+            const Handle(Prs3d_Presentation)& pres, const Handle(Graphic3d_AspectFillArea3d)& aspect
+    ) const;
+
+    bool AcceptDisplayMode(const int mode) const override { return mode == 0; }
+    void ComputeSelection(const Handle(SelectMgr_Selection)& sel, const int mode) override;
+
+    DEFINE_STANDARD_RTTI_INLINE(GraphicsInstancedMeshObject, AIS_InteractiveObject)
+
+protected:
+    void Compute(
+            const Handle(PrsMgr_PresentationManager)& pm,
+            const Handle(Prs3d_Presentation)& pres,
+            const int mode) override;
+
+#if OCC_VERSION_HEX < OCC_VERSION_CHECK(7, 5, 0)
+    void Compute(const Handle(Prs3d_Projector)&, const Handle(Prs3d_Presentation)&) override {}
+#endif
+
+private:
+    struct Face {
+        Handle_Poly_Triangulation triangulation;
+        gp_Trsf trsf;
+        bool reversed = false;
+        std::vector<gp_Vec> vecNodeNormal;
+    };
+
+    struct Instance {
+        gp_Trsf trsf;
+        bool visible = true;
+        Handle(GraphicsInstanceOwner) owner;
+    };
+
+    struct Chunk {
+        int firstInstance = 0;
+        int instanceCount = 0;
+        Handle_Graphic3d_Group group;
+        bool outdated = false;
+    };
+
+    void addInstanceTriangles(const gp_Trsf& trsf, const Handle(Graphic3d_ArrayOfTriangles)& array) const;
+    void setInstanceOutdated(int index);
+    int chunkInstanceCount() const;
+    void fillChunkGroup(const Chunk& chunk) const;
+
+    TopoDS_Shape m_shape;
+    std::vector<Face> m_vecFace;
+    std::vector<Instance> m_vecInstance;
+    std::vector<Chunk> m_vecChunk; // Empty until presentation is computed
+    Handle_Prs3d_Presentation m_prs;
+    Handle_Graphic3d_StructureManager m_structureManager;
+    bool m_isMotionModeOn = false;
+    Handle_Prs3d_Presentation m_prsInstance; // Geometry shared by the shadows, motion mode only
+    std::vector<Handle(Prs3d_PresentationShadow)> m_vecInstanceShadow; // Motion mode only
+    int m_nodeCount = 0;
+    int m_triangleCount = 0;
+    Bnd_Box m_bndBox;
+};
+
+} // namespace Mayo
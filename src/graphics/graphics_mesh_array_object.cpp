@@ -0,0 +1,293 @@
+/****************************************************************************
+** Copyright (c) 2022, Fougue Ltd. <http://www.fougue.pro>
+** All rights reserved.
+** See license at https://github.com/fougue/mayo/blob/master/LICENSE.txt
+****************************************************************************/
+
+#include "graphics_mesh_array_object.h"
+
+#include "../base/cpp_utils.h"
+#include "../base/mesh_utils.h"
+
+#include <Graphic3d_AspectFillArea3d.hxx>
+#include <Graphic3d_Group.hxx>
+#include <Prs3d_ShadingAspect.hxx>
+#include <Select3D_SensitiveTriangulation.hxx>
+#include <SelectMgr_EntityOwner.hxx>
+#include <algorithm>
+
+namespace Mayo {
+
+namespace {
+
+// Per-node normals of 'mesh', computed from the triangles when the mesh doesn't hold them
+std::vector<Graphic3d_Vec3> computeNodeNormals(const Handle_Poly_Triangulation& mesh)
+{
+    const int nodeCount = mesh->NbNodes();
+    std::vector<Graphic3d_Vec3> vecNormal(nodeCount, Graphic3d_Vec3(0.f, 0.f, 0.f));
+    if (mesh->HasNormals()) {
+        for (int i = 1; i <= nodeCount; ++i) {
+#if OCC_VERSION_HEX >= OCC_VERSION_CHECK(7, 6, 0)
+            mesh->Normal(i, vecNormal[i - 1]);
+#else
+            const TShort_Array1OfShortReal& normals = mesh->Normals();
+            const int k = normals.Lower() + 3 * (i - 1);
+            vecNormal[i - 1] = Graphic3d_Vec3(normals(k), normals(k + 1), normals(k + 2));
+#endif
+        }
+
+        return vecNormal;
+    }
+
+    // Accumulate normals of the triangles around each node, weighted by triangle area
+    for (const Poly_Triangle& triangle : MeshUtils::triangles(mesh)) {
+        int v[3];
+        triangle.Get(v[0], v[1], v[2]);
+        const gp_XYZ p0 = mesh->Node(v[0]).XYZ();
+        const gp_XYZ p1 = mesh->Node(v[1]).XYZ();
+        const gp_XYZ p2 = mesh->Node(v[2]).XYZ();
+        const gp_XYZ n = (p1 - p0).Crossed(p2 - p0);
+        const Graphic3d_Vec3 nf(float(n.X()), float(n.Y()), float(n.Z()));
+        for (int nodeId : v)
+            vecNormal[nodeId - 1] += nf;
+    }
+
+    for (Graphic3d_Vec3& n : vecNormal) {
+        if (n.SquareModulus() > 0.f)
+            n.Normalize();
+        else
+            n = Graphic3d_Vec3(0.f, 0.f, 1.f);
+    }
+
+    return vecNormal;
+}
+
+// Vertex arrays of the triangles of 'mesh', split so each array has at most maxArrayTriangleCount()
+// triangles. 'spanNodeColor' is ignored unless it has an item per node
+std::vector<Handle_Graphic3d_ArrayOfTriangles> createVertexArrays(
+        const Handle_Poly_Triangulation& mesh, Span<const Quantity_Color> spanNodeColor)
+{
+    std::vector<Handle_Graphic3d_ArrayOfTriangles> vecArray;
+    if (!mesh || mesh->NbTriangles() <= 0)
+        return vecArray;
+
+    const std::vector<Graphic3d_Vec3> vecNodeNormal = computeNodeNormals(mesh);
+    const bool hasNodeColors = CppUtils::cmpEqual(spanNodeColor.size(), mesh->NbNodes());
+    const Poly_Array1OfTriangle& triangles = MeshUtils::triangles(mesh);
+    const int triangleCount = mesh->NbTriangles();
+    const int maxArrayTriangleCount = GraphicsMeshArrayObject::maxArrayTriangleCount();
+
+    // Index of each mesh node in the array being built, zero if not part of the array
+    std::vector<int> vecNodeArrayIndex(mesh->NbNodes() + 1, 0);
+    std::vector<int> vecArrayNode;
+    for (int first = 1; first <= triangleCount; first += maxArrayTriangleCount) {
+        const int last = std::min(triangleCount, first + maxArrayTriangleCount - 1);
+        vecArrayNode.clear();
+        for (int i = first; i <= last; ++i) {
+            int v[3];
+            triangles.Value(i).Get(v[0], v[1], v[2]);
+            for (int nodeId : v) {
+                if (vecNodeArrayIndex.at(nodeId) == 0) {
+                    vecArrayNode.push_back(nodeId);
+                    vecNodeArrayIndex[nodeId] = int(vecArrayNode.size());
+                }
+            }
+        }
+
+        Handle_Graphic3d_ArrayOfTriangles array = new Graphic3d_ArrayOfTriangles(
+                    int(vecArrayNode.size()), 3 * (last - first + 1), true, hasNodeColors, false
+        );
+        for (int nodeId : vecArrayNode) {
+            const gp_Pnt pnt = mesh->Node(nodeId);
+            const Graphic3d_Vec3& n = vecNodeNormal[nodeId - 1];
+            const int vertexIndex = array->AddVertex(
+                        float(pnt.X()), float(pnt.Y()), float(pnt.Z()), n.x(), n.y(), n.z()
+            );
+            if (hasNodeColors)
+                array->SetVertexColor(vertexIndex, spanNodeColor[nodeId - 1]);
+        }
+
+        for (int i = first; i <= last; ++i) {
+            int v[3];
+            triangles.Value(i).Get(v[0], v[1], v[2]);
+            array->AddEdges(vecNodeArrayIndex[v[0]], vecNodeArrayIndex[v[1]], vecNodeArrayIndex[v[2]]);
+        }
+
+        vecArray.push_back(array);
+        for (int nodeId : vecArrayNode)
+            vecNodeArrayIndex[nodeId] = 0;
+    }
+
+    return vecArray;
+}
+
+} // namespace
+
+GraphicsMeshArrayObject::GraphicsMeshArrayObject(const Handle_Poly_Triangulation& mesh)
+    : m_mesh(mesh)
+{
+    // Own shading aspect, otherwise the one of the default drawer would be altered by setters
+    myDrawer->SetShadingAspect(new Prs3d_ShadingAspect);
+    myDrawer->ShadingAspect()->Aspect()->SetInteriorStyle(Aspect_IS_SOLID);
+    myDrawer->ShadingAspect()->Aspect()->SetDrawEdges(false);
+    this->SetDisplayMode(0);
+}
+
+void GraphicsMeshArrayObject::setNodeColors(Span<const Quantity_Color> spanNodeColor)
+{
+    m_spanNodeColor = spanNodeColor;
+    m_vecArray.clear();
+}
+
+Quantity_Color GraphicsMeshArrayObject::color() const
+{
+    return myDrawer->ShadingAspect()->Color();
+}
+
+void GraphicsMeshArrayObject::setColor(const Quantity_Color& color)
+{
+    myDrawer->ShadingAspect()->SetColor(color);
+}
+
+Quantity_Color GraphicsMeshArrayObject::edgeColor() const
+{
+    return myDrawer->ShadingAspect()->Aspect()->EdgeColor();
+}
+
+void GraphicsMeshArrayObject::setEdgeColor(const Quantity_Color& color)
+{
+    myDrawer->ShadingAspect()->Aspect()->SetEdgeColor(color);
+}
+
+bool GraphicsMeshArrayObject::isEdgesVisible() const
+{
+    return myDrawer->ShadingAspect()->Aspect()->ToDrawEdges();
+}
+
+void GraphicsMeshArrayObject::setEdgesVisible(bool on)
+{
+    myDrawer->ShadingAspect()->Aspect()->SetDrawEdges(on);
+}
+
+void GraphicsMeshArrayObject::setMaterial(const Graphic3d_MaterialAspect& material)
+{
+    myDrawer->ShadingAspect()->SetMaterial(material);
+}
+
+int GraphicsMeshArrayObject::maxArrayTriangleCount()
+{
+    // With 32-bit indices and float vertex attributes(position, normal, color) this keeps the byte
+    // size of the vertex and index buffers of a single array below INT_MAX
+    return 1 << 24;
+}
+
+void GraphicsMeshArrayObject::ComputeSelection(const Handle(SelectMgr_Selection)& sel, const int mode)
+{
+    if (mode != 0 || !m_mesh)
+        return;
+
+    // Select3D_SensitiveTriangulation builds a BVH of the triangles on first picking
+    Handle_SelectMgr_EntityOwner owner = new SelectMgr_EntityOwner(this);
+    sel->Add(new Select3D_SensitiveTriangulation(owner, m_mesh, TopLoc_Location(), true));
+}
+
+void GraphicsMeshArrayObject::Compute(
+        const Handle(PrsMgr_PresentationManager)&,
+        const Handle(Prs3d_Presentation)& pres,
+        const int mode)
+{
+    this->prepare();
+    const auto activeLod = m_activeLod > 0 ? m_lods.at(m_activeLod) : nullptr;
+    const ArrayOfTrianglesVector& vecArray = activeLod ? activeLod->data : m_vecArray;
+    if (vecArray.empty())
+        return;
+
+    Handle_Graphic3d_AspectFillArea3d aspect = myDrawer->ShadingAspect()->Aspect();
+    if (mode == 1) {
+        aspect = new Graphic3d_AspectFillArea3d(*aspect);
+        aspect->SetInteriorStyle(Aspect_IS_EMPTY);
+        aspect->SetDrawEdges(true);
+    }
+
+    Handle_Graphic3d_Group group = pres->NewGroup();
+    group->SetGroupPrimitivesAspect(aspect);
+    for (const Handle_Graphic3d_ArrayOfTriangles& array : vecArray)
+        group->AddPrimitiveArray(array);
+}
+
+void GraphicsMeshArrayObject::prepare()
+{
+    if (m_vecArray.empty())
+        m_vecArray = createVertexArrays(m_mesh, m_spanNodeColor);
+}
+
+void GraphicsMeshArrayObject::computeLevelsOfDetail(int lodCount)
+{
+    const Handle(GraphicsMeshArrayObject) self = this;
+    m_lods.computeAsync(self, m_mesh, lodCount, [=](const auto& lod) {
+        // Node colors are owned by the document, they aren't read anymore once LODs are cancelled
+        std::vector<Quantity_Color> vecLodNodeColor;
+        if (!self->m_spanNodeColor.empty()) {
+            self->m_lods.callIfNotCancelled([&]{
+                vecLodNodeColor.reserve(lod.vecSourceNode.size());
+                for (int sourceNode : lod.vecSourceNode)
+                    vecLodNodeColor.push_back(self->m_spanNodeColor[sourceNode - 1]);
+            });
+        }
+
+        return createVertexArrays(lod.triangulation, vecLodNodeColor);
+    });
+}
+
+bool GraphicsMeshArrayObject::setActiveLevelOfDetail(int lod)
+{
+    const int lodIndex = std::clamp(lod, 0, m_lods.count() - 1);
+    if (lodIndex == m_activeLod)
+        return false;
+
+    m_activeLod = lodIndex;
+    return true;
+}
+
+std::vector<Graphic3d_Vec3> GraphicsMeshArrayObject::computeNodeNormals() const
+{
+    const int nodeCount = m_mesh->NbNodes();
+    std::vector<Graphic3d_Vec3> vecNormal(nodeCount, Graphic3d_Vec3(0.f, 0.f, 0.f));
+    if (m_mesh->HasNormals()) {
+        for (int i = 1; i <= nodeCount; ++i) {
+#if OCC_VERSION_HEX >= OCC_VERSION_CHECK(7, 6, 0)
+            m_mesh->Normal(i, vecNormal[i - 1]);
+#else
+            const TShort_Array1OfShortReal& normals = m_mesh->Normals();
+            const int k = normals.Lower() + 3 * (i - 1);
+            vecNormal[i - 1] = Graphic3d_Vec3(normals(k), normals(k + 1), normals(k + 2));
+#endif
+        }
+
+        return vecNormal;
+    }
+
+    // Accumulate normals of the triangles around each node, weighted by triangle area
+    for (const Poly_Triangle& triangle : MeshUtils::triangles(m_mesh)) {
+        int v[3];
+        triangle.Get(v[0], v[1], v[2]);
+        const gp_XYZ p0 = m_mesh->Node(v[0]).XYZ();
+        const gp_XYZ p1 = m_mesh->Node(v[1]).XYZ();
+        const gp_XYZ p2 = m_mesh->Node(v[2]).XYZ();
+        const gp_XYZ n = (p1 - p0).Crossed(p2 - p0);
+        const Graphic3d_Vec3 nf(float(n.X()), float(n.Y()), float(n.Z()));
+        for (int nodeId : v)
+            vecNormal[nodeId - 1] += nf;
+    }
+
+    for (Graphic3d_Vec3& n : vecNormal) {
+        if (n.SquareModulus() > 0.f)
+            n.Normalize();
+        else
+            n = Graphic3d_Vec3(0.f, 0.f, 1.f);
+    }
+
+    return vecNormal;
+}
+
+} // namespace Mayo
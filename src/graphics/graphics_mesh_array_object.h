@@ -0,0 +1,101 @@
+/****************************************************************************
+** Copyright (c) 2022, Fougue Ltd. <http://www.fougue.pro>
+** All rights reserved.
+** See license at https://github.com/fougue/mayo/blob/master/LICENSE.txt
+****************************************************************************/
+
+#pragma once
+
+#include "../base/span.h"
+#include "../base/tkernel_utils.h"
+#include "graphics_mesh_lods.h"
+
+#include <AIS_InteractiveObject.hxx>
+#include <Graphic3d_ArrayOfTriangles.hxx>
+#include <Graphic3d_Vec3.hxx>
+#include <Poly_Triangulation.hxx>
+#include <Prs3d_Presentation.hxx>
+#include <PrsMgr_PresentationManager.hxx>
+#include <Quantity_Color.hxx>
+#include <SelectMgr_Selection.hxx>
+#include <vector>
+
+#if OCC_VERSION_HEX < OCC_VERSION_CHECK(7, 5, 0)
+#  include <Prs3d_Projector.hxx>
+#endif
+
+namespace Mayo {
+
+// Graphics object displaying a triangulation through vertex arrays built directly from mesh data
+// Triangles are split into several arrays when needed so buffer sizes fit within 32-bit limits
+// Display modes:
+//     0 -> shaded
+//     1 -> wireframe(triangle edges)
+// Selection mode 0 picks the whole object, sensitive triangles are organized in a BVH
+// Coarser levels of detail(LOD) of the mesh can be computed in background, only the presentation of
+// the active LOD is displayed. Selection always relies on the source mesh
+class GraphicsMeshArrayObject : public AIS_InteractiveObject {
+public:
+    GraphicsMeshArrayObject(const Handle_Poly_Triangulation& mesh);
+
+    const Handle_Poly_Triangulation& mesh() const { return m_mesh; }
+
+    // Optional per-node colors, must have NbNodes() items
+    // Colors aren't copied so 'spanNodeColor' must remain valid during the lifetime of the object
+    void setNodeColors(Span<const Quantity_Color> spanNodeColor);
+
+    Quantity_Color color() const;
+    void setColor(const Quantity_Color& color);
+
+    Quantity_Color edgeColor() const;
+    void setEdgeColor(const Quantity_Color& color);
+
+    bool isEdgesVisible() const;
+    void setEdgesVisible(bool on);
+
+    void setMaterial(const Graphic3d_MaterialAspect& material);
+
+    // Builds the vertex arrays of the presentation, can be called from a worker thread before the
+    // object is displayed. Otherwise arrays are built on first presentation computation
+    void prepare();
+
+    // Starts computation in background of the coarser LODs until 'lodCount' LODs are available
+    // Vertex arrays of each LOD are built along, see GraphicsMeshLods
+    void computeLevelsOfDetail(int lodCount);
+    GraphicsMeshLodsBase& levelsOfDetail() { return m_lods; }
+
+    // LOD 0 is the source mesh
+    int levelOfDetailCount() const { return m_lods.count(); }
+    int activeLevelOfDetail() const { return m_activeLod; }
+    // Returns true if active LOD changed, presentation has then to be recomputed
+    bool setActiveLevelOfDetail(int lod);
+
+    // Maximum count of triangles in a single vertex array
+    static int maxArrayTriangleCount();
+
+    bool AcceptDisplayMode(const int mode) const override { return mode == 0 || mode == 1; }
+    void ComputeSelection(const Handle(SelectMgr_Selection)& sel, const int mode) override;
+
+    DEFINE_STANDARD_RTTI_INLINE(GraphicsMeshArrayObject, AIS_InteractiveObject)
+
+protected:
+    void Compute(
+            const Handle(PrsMgr_PresentationManager)& pm,
+            const Handle(Prs3d_Presentation)& pres,
+            const int mode) override;
+
+#if OCC_VERSION_HEX < OCC_VERSION_CHECK(7, 5, 0)
+    void Compute(const Handle(Prs3d_Projector)&, const Handle(Prs3d_Presentation)&) override {}
+#endif
+
+private:
+    using ArrayOfTrianglesVector = std::vector<Handle_Graphic3d_ArrayOfTriangles>;
+
+    Handle_Poly_Triangulation m_mesh;
+    Span<const Quantity_Color> m_spanNodeColor;
+    ArrayOfTrianglesVector m_vecArray;
+    GraphicsMeshLods<ArrayOfTrianglesVector> m_lods;
+    int m_activeLod = 0;
+};
+
+} // namespace Mayo
@@ -0,0 +1,221 @@
+/****************************************************************************
+** Copyright (c) 2022, Fougue Ltd. <http://www.fougue.pro>
+** All rights reserved.
+** See license at https://github.com/fougue/mayo/blob/master/LICENSE.txt
+****************************************************************************/
+
+#include "graphics_mesh_array_object_driver.h"
+
+#include "../base/caf_utils.h"
+#include "../base/cpp_utils.h"
+#include "../base/property_builtins.h"
+#include "../base/triangulation_annex_data.h"
+#include "../base/xcaf.h"
+#include "graphics_mesh_array_object.h"
+#include "graphics_mesh_object_driver.h"
+#include "graphics_utils.h"
+
+#include <BRep_TFace.hxx>
+#include <OSD_Parallel.hxx>
+
+namespace Mayo {
+
+namespace {
+struct GraphicsMeshArrayObjectDriverI18N { MAYO_DECLARE_TEXT_ID_FUNCTIONS(Mayo::GraphicsMeshArrayObjectDriver) };
+
+Handle_Poly_Triangulation findTriangulation(const TDF_Label& label)
+{
+    if (XCaf::isShape(label)) {
+        const TopoDS_Shape shape = XCaf::shape(label);
+        if (shape.ShapeType() == TopAbs_FACE) {
+            auto tface = Handle_BRep_TFace::DownCast(shape.TShape());
+            if (tface)
+                return tface->Triangulation();
+        }
+    }
+
+    return {};
+}
+
+} // namespace
+
+GraphicsMeshArrayObjectDriver::GraphicsMeshArrayObjectDriver()
+{
+    this->setDisplayModes({
+        { DisplayMode_Wireframe, GraphicsMeshArrayObjectDriverI18N::textId("Mesh_Wireframe") },
+        { DisplayMode_Shaded, GraphicsMeshArrayObjectDriverI18N::textId("Mesh_Shaded") }
+    });
+    this->setDefaultDisplayMode(DisplayMode_Shaded);
+}
+
+GraphicsMeshArrayObjectDriver::Support GraphicsMeshArrayObjectDriver::supportStatus(const TDF_Label& label) const
+{
+    if (GraphicsMeshObjectDriver::meshSupportStatus(label) == Support::None)
+        return Support::None;
+
+    const Handle_Poly_Triangulation polyTri = findTriangulation(label);
+    if (polyTri && polyTri->NbTriangles() >= minimumTriangleCount())
+        return Support::Complete;
+
+    return Support::None;
+}
+
+GraphicsObjectPtr GraphicsMeshArrayObjectDriver::createObject(const TDF_Label& label) const
+{
+    const Handle_Poly_Triangulation polyTri = findTriangulation(label);
+    if (!polyTri)
+        return {};
+
+    Handle(GraphicsMeshArrayObject) object = new GraphicsMeshArrayObject(polyTri);
+    auto attrMeshData = CafUtils::findAttribute<TriangulationAnnexData>(label);
+    if (attrMeshData)
+        object->setNodeColors(attrMeshData->nodeColors());
+
+    const GraphicsMeshObjectDriver::DefaultValues& defaultValues = GraphicsMeshObjectDriver::defaultValues();
+    object->setColor(defaultValues.color);
+    object->setEdgeColor(defaultValues.edgeColor);
+    object->setEdgesVisible(defaultValues.showEdges);
+    object->setMaterial(Graphic3d_MaterialAspect(defaultValues.material));
+    object->SetDisplayMode(DisplayMode_Shaded);
+    object->SetOwner(this);
+    return object;
+}
+
+void GraphicsMeshArrayObjectDriver::applyDisplayMode(GraphicsObjectPtr object, Enumeration::Value mode) const
+{
+    this->throwIf_differentDriver(object);
+    this->throwIf_invalidDisplayMode(mode);
+    GraphicsUtils::AisObject_contextPtr(object)->SetDisplayMode(object, mode, false);
+}
+
+Enumeration::Value GraphicsMeshArrayObjectDriver::currentDisplayMode(const GraphicsObjectPtr& object) const
+{
+    this->throwIf_differentDriver(object);
+    return object->DisplayMode();
+}
+
+class GraphicsMeshArrayObjectDriver::ObjectProperties : public PropertyGroupSignals {
+public:
+    ObjectProperties(Span<const GraphicsObjectPtr> spanObject)
+    {
+        NCollection_Vec3<float> sumColor = {};
+        NCollection_Vec3<float> sumEdgeColor = {};
+        int countShowEdges = 0;
+        for (const GraphicsObjectPtr& object : spanObject) {
+            auto meshObject = Handle(GraphicsMeshArrayObject)::DownCast(object);
+            sumColor += meshObject->color();
+            sumEdgeColor += meshObject->edgeColor();
+            countShowEdges += meshObject->isEdgesVisible() ? 1 : 0;
+            m_vecMeshObject.push_back(meshObject);
+        }
+
+        // Init properties
+        Mayo_PropertyChangedBlocker(this);
+
+        m_propertyColor.setValue(Quantity_Color(sumColor / float(spanObject.size())));
+        m_propertyEdgeColor.setValue(Quantity_Color(sumEdgeColor / float(spanObject.size())));
+        if (countShowEdges == 0)
+            m_propertyShowEdges.setValue(CheckState::Off);
+        else if (CppUtils::cmpEqual(countShowEdges, spanObject.size()))
+            m_propertyShowEdges.setValue(CheckState::On);
+        else
+            m_propertyShowEdges.setValue(CheckState::Partially);
+    }
+
+    void onPropertyChanged(Property* prop) override
+    {
+        auto fnRedisplay = [](const GraphicsObjectPtr& object) {
+            object->Redisplay(true); // All modes
+        };
+
+        for (const Handle(GraphicsMeshArrayObject)& meshObject : m_vecMeshObject) {
+            if (prop == &m_propertyShowEdges && m_propertyShowEdges.value() != CheckState::Partially) {
+                meshObject->setEdgesVisible(m_propertyShowEdges.value() == CheckState::On);
+                fnRedisplay(meshObject);
+            }
+            else if (prop == &m_propertyColor) {
+                meshObject->setColor(m_propertyColor);
+                fnRedisplay(meshObject);
+            }
+            else if (prop == &m_propertyEdgeColor) {
+                meshObject->setEdgeColor(m_propertyEdgeColor);
+                fnRedisplay(meshObject);
+            }
+        }
+
+        PropertyGroupSignals::onPropertyChanged(prop);
+    }
+
+    std::vector<Handle(GraphicsMeshArrayObject)> m_vecMeshObject;
+    PropertyOccColor m_propertyColor{ this, GraphicsMeshArrayObjectDriverI18N::textId("color") };
+    PropertyOccColor m_propertyEdgeColor{ this, GraphicsMeshArrayObjectDriverI18N::textId("edgeColor") };
+    PropertyCheckState m_propertyShowEdges{ this, GraphicsMeshArrayObjectDriverI18N::textId("showEdges") };
+};
+
+std::unique_ptr<PropertyGroupSignals>
+GraphicsMeshArrayObjectDriver::properties(Span<const GraphicsObjectPtr> spanObject) const
+{
+    this->throwIf_differentDriver(spanObject);
+    return std::make_unique<ObjectProperties>(spanObject);
+}
+
+int GraphicsMeshArrayObjectDriver::levelOfDetailCount(const GraphicsObjectPtr& object) const
+{
+    this->throwIf_differentDriver(object);
+    return Handle(GraphicsMeshArrayObject)::DownCast(object)->levelOfDetailCount();
+}
+
+bool GraphicsMeshArrayObjectDriver::setLevelOfDetail(const GraphicsObjectPtr& object, int lod) const
+{
+    this->throwIf_differentDriver(object);
+    // Vertex arrays of the LODs are built in background, so any of them is cheap to activate
+    auto meshObject = Handle(GraphicsMeshArrayObject)::DownCast(object);
+    if (!meshObject->setActiveLevelOfDetail(lod))
+        return false;
+
+    AIS_InteractiveContext* context = GraphicsUtils::AisObject_contextPtr(object);
+    if (context)
+        context->Redisplay(object, false);
+
+    return true;
+}
+
+GraphicsMeshLodsBase* GraphicsMeshArrayObjectDriver::meshLevelsOfDetail(const GraphicsObjectPtr& object) const
+{
+    this->throwIf_differentDriver(object);
+    return &Handle(GraphicsMeshArrayObject)::DownCast(object)->levelsOfDetail();
+}
+
+void GraphicsMeshArrayObjectDriver::prepareObjects(Span<const GraphicsObjectPtr> spanObject) const
+{
+    this->throwIf_differentDriver(spanObject);
+    OSD_Parallel::ForEach(spanObject.begin(), spanObject.end(), [](const GraphicsObjectPtr& object) {
+        Handle(GraphicsMeshArrayObject)::DownCast(object)->prepare();
+    });
+
+    const int lodCount = GraphicsMeshObjectDriver::defaultValues().levelOfDetailCount;
+    for (const GraphicsObjectPtr& object : spanObject)
+        Handle(GraphicsMeshArrayObject)::DownCast(object)->computeLevelsOfDetail(lodCount);
+}
+
+namespace Internal {
+
+static int& graphicsMeshArrayMinimumTriangleCount()
+{
+    static int count = 1000000;
+    return count;
+}
+
+} // namespace Internal
+
+int GraphicsMeshArrayObjectDriver::minimumTriangleCount()
+{
+    return Internal::graphicsMeshArrayMinimumTriangleCount();
+}
+
+void GraphicsMeshArrayObjectDriver::setMinimumTriangleCount(int count)
+{
+    Internal::graphicsMeshArrayMinimumTriangleCount() = count;
+}
+
+} // namespace Mayo
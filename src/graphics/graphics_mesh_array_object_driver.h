@@ -0,0 +1,52 @@
+/****************************************************************************
+** Copyright (c) 2022, Fougue Ltd. <http://www.fougue.pro>
+** All rights reserved.
+** See license at https://github.com/fougue/mayo/blob/master/LICENSE.txt
+****************************************************************************/
+
+#pragma once
+
+#include "graphics_object_driver.h"
+
+namespace Mayo {
+
+class GraphicsMeshArrayObjectDriver;
+DEFINE_STANDARD_HANDLE(GraphicsMeshArrayObjectDriver, GraphicsObjectDriver)
+using GraphicsMeshArrayObjectDriverPtr = Handle(GraphicsMeshArrayObjectDriver);
+
+// Provides creation and configuration of graphics objects for large meshes(triangulations)
+// Unlike GraphicsMeshObjectDriver, MeshVS is not involved: vertex arrays are directly built from
+// the triangulation and picking relies on a BVH of the triangles
+// Only meshes having at least minimumTriangleCount() triangles are supported
+class GraphicsMeshArrayObjectDriver : public GraphicsObjectDriver {
+public:
+    GraphicsMeshArrayObjectDriver();
+
+    Support supportStatus(const TDF_Label& label) const override;
+    GraphicsObjectPtr createObject(const TDF_Label& label) const override;
+    void applyDisplayMode(GraphicsObjectPtr object, Enumeration::Value mode) const override;
+    Enumeration::Value currentDisplayMode(const GraphicsObjectPtr& object) const override;
+    std::unique_ptr<PropertyGroupSignals> properties(Span<const GraphicsObjectPtr> spanObject) const override;
+    int levelOfDetailCount(const GraphicsObjectPtr& object) const override;
+    bool setLevelOfDetail(const GraphicsObjectPtr& object, int lod) const override;
+    GraphicsMeshLodsBase* meshLevelsOfDetail(const GraphicsObjectPtr& object) const override;
+    // Also starts computation of the levels of detail of the meshes in background(see
+    // GraphicsMeshObjectDriver::DefaultValues::levelOfDetailCount)
+    void prepareObjects(Span<const GraphicsObjectPtr> spanObject) const override;
+
+    enum DisplayMode {
+        DisplayMode_Shaded = 0,
+        DisplayMode_Wireframe = 1
+    };
+
+    // Threshold on the triangle count from which a mesh is handled by this driver
+    static int minimumTriangleCount();
+    static void setMinimumTriangleCount(int count);
+
+    DEFINE_STANDARD_RTTI_INLINE(GraphicsMeshArrayObjectDriver, GraphicsObjectDriver)
+
+private:
+    class ObjectProperties;
+};
+
+} // namespace Mayo
@@ -8,11 +8,8 @@
 
 #include "../base/mesh_utils.h"
 
+#include <OSD_Parallel.hxx>
 #include <Precision.hxx>
-#include <Standard_Type.hxx>
-#include <TColgp_SequenceOfXYZ.hxx>
-#include <TColStd_DataMapOfIntegerInteger.hxx>
-#include <TColStd_DataMapOfIntegerReal.hxx>
 
 namespace Mayo {
 
@@ -20,45 +17,8 @@ GraphicsMeshDataSource::GraphicsMeshDataSource(const Handle_Poly_Triangulation&
     : m_mesh(mesh)
 {
     if (!m_mesh.IsNull()) {
-        const int lenCoords = m_mesh->NbNodes();
-        m_nodeCoords = new TColStd_HArray2OfReal(1, lenCoords, 1, 3);
-
-        for(int i = 1; i <= lenCoords; ++i) {
-            m_nodes.Add(i);
-            const gp_XYZ xyz = m_mesh->Node(i).XYZ();
-            m_nodeCoords->SetValue(i, 1, xyz.X());
-            m_nodeCoords->SetValue(i, 2, xyz.Y());
-            m_nodeCoords->SetValue(i, 3, xyz.Z());
-        }
-
-        const Poly_Array1OfTriangle& aSeq = MeshUtils::triangles(m_mesh);
-        const int lenTriangles = aSeq.Length();
-        m_elemNormals = new TColStd_HArray2OfReal(1, lenTriangles, 1, 3);
-        m_elemNodes = new TColStd_HArray2OfInteger(1, lenTriangles, 1, 3);
-
-        for(int i = 1; i <= lenTriangles; ++i ) {
-            m_elements.Add(i);
-            const Poly_Triangle& aTri = aSeq(i);
-
-            int V[3];
-            aTri.Get(V[0], V[1], V[2]);
-
-            const gp_Vec aV1(m_mesh->Node(V[0]), m_mesh->Node(V[1]));
-            const gp_Vec aV2(m_mesh->Node(V[1]), m_mesh->Node(V[2]));
-
-            gp_Vec aN = aV1.Crossed(aV2);
-            if (aN.SquareMagnitude() > Precision::SquareConfusion())
-                aN.Normalize();
-            else
-                aN.SetCoord(0.0, 0.0, 0.0);
-
-            for (int j = 0; j < 3; ++j)
-                m_elemNodes->SetValue(i, j+1, V[j]);
-
-            m_elemNormals->SetValue (i, 1, aN.X());
-            m_elemNormals->SetValue (i, 2, aN.Y());
-            m_elemNormals->SetValue (i, 3, aN.Z());
-        }
+        m_nodeCount = m_mesh->NbNodes();
+        m_elementCount = m_mesh->NbTriangles();
     }
 }
 
@@ -73,13 +33,16 @@ bool GraphicsMeshDataSource::GetGeom(
         return false;
 
     if (IsElement) {
-        if (ID >= 1 && ID <= m_elements.Extent()) {
+        if (this->isElementId(ID)) {
             Type = MeshVS_ET_Face;
             NbNodes = 3;
-            for (int i = 1, k = 1; i <= 3; ++i) {
-                const int IdxNode = m_elemNodes->Value(ID, i);
-                for (int j = 1; j <= 3; ++j, ++k)
-                    Coords(k) = m_nodeCoords->Value(IdxNode, j);
+            int V[3];
+            MeshUtils::triangles(m_mesh).Value(ID).Get(V[0], V[1], V[2]);
+            for (int i = 0, k = Coords.Lower(); i < 3; ++i) {
+                const gp_Pnt pnt = m_mesh->Node(V[i]);
+                Coords(k++) = pnt.X();
+                Coords(k++) = pnt.Y();
+                Coords(k++) = pnt.Z();
             }
 
             return true;
@@ -88,13 +51,15 @@ bool GraphicsMeshDataSource::GetGeom(
         return false;
     }
     else {
-        if (ID >= 1 && ID <= m_nodes.Extent()) {
+        if (this->isNodeId(ID)) {
             Type = MeshVS_ET_Node;
             NbNodes = 1;
 
-            Coords(1) = m_nodeCoords->Value(ID, 1);
-            Coords(2) = m_nodeCoords->Value(ID, 2);
-            Coords(3) = m_nodeCoords->Value(ID, 3);
+            const gp_Pnt pnt = m_mesh->Node(ID);
+            const int k = Coords.Lower();
+            Coords(k) = pnt.X();
+            Coords(k + 1) = pnt.Y();
+            Coords(k + 2) = pnt.Z();
             return true;
         }
 
@@ -113,11 +78,9 @@ bool GraphicsMeshDataSource::GetNodesByElement(const int ID, TColStd_Array1OfInt
     if (m_mesh.IsNull())
         return false;
 
-    if (ID >= 1 && ID <= m_elements.Extent() && theNodeIDs.Length() >= 3) {
+    if (this->isElementId(ID) && theNodeIDs.Length() >= 3) {
         const int aLow = theNodeIDs.Lower();
-        theNodeIDs(aLow)     = m_elemNodes->Value(ID, 1);
-        theNodeIDs(aLow + 1) = m_elemNodes->Value(ID, 2);
-        theNodeIDs(aLow + 2) = m_elemNodes->Value(ID, 3);
+        MeshUtils::triangles(m_mesh).Value(ID).Get(theNodeIDs(aLow), theNodeIDs(aLow + 1), theNodeIDs(aLow + 2));
         return true;
     }
 
@@ -129,14 +92,73 @@ bool GraphicsMeshDataSource::GetNormal(const int Id, const int Max, double& nx,
     if (m_mesh.IsNull())
         return false;
 
-    if (Id >= 1 && Id <= m_elements.Extent() && Max >= 3) {
-        nx = m_elemNormals->Value(Id, 1);
-        ny = m_elemNormals->Value(Id, 2);
-        nz = m_elemNormals->Value(Id, 3);
+    if (this->isElementId(Id) && Max >= 3) {
+        std::call_once(m_elemNormalsFlag, [=]{
+            m_elemNormals.resize(3 * std::size_t(m_elementCount));
+            const Poly_Array1OfTriangle& triangles = MeshUtils::triangles(m_mesh);
+            OSD_Parallel::For(0, m_elementCount, [&](int i) {
+                int V[3];
+                triangles.Value(i + 1).Get(V[0], V[1], V[2]);
+                const gp_Pnt pnt0 = m_mesh->Node(V[0]);
+                const gp_Pnt pnt1 = m_mesh->Node(V[1]);
+                const gp_Pnt pnt2 = m_mesh->Node(V[2]);
+                gp_Vec n = gp_Vec(pnt0, pnt1).Crossed(gp_Vec(pnt1, pnt2));
+                if (n.SquareMagnitude() > Precision::SquareConfusion())
+                    n.Normalize();
+                else
+                    n.SetCoord(0., 0., 0.);
+
+                float* ptrNormal = m_elemNormals.data() + 3 * std::size_t(i);
+                ptrNormal[0] = float(n.X());
+                ptrNormal[1] = float(n.Y());
+                ptrNormal[2] = float(n.Z());
+            });
+        });
+
+        const float* ptrNormal = m_elemNormals.data() + 3 * std::size_t(Id - 1);
+        nx = ptrNormal[0];
+        ny = ptrNormal[1];
+        nz = ptrNormal[2];
         return true;
     }
 
     return false;
 }
 
+bool GraphicsMeshDataSource::GetNodeNormal(
+        const int RankNode, const int ElementId, double& nx, double& ny, double& nz) const
+{
+    if (m_mesh.IsNull() || !m_mesh->HasNormals())
+        return false;
+
+    if (this->isElementId(ElementId) && RankNode >= 1 && RankNode <= 3) {
+        const int nodeId = MeshUtils::triangles(m_mesh).Value(ElementId).Value(RankNode);
+        const gp_Vec n = MeshUtils::toGpVec(MeshUtils::normal(m_mesh, nodeId));
+        nx = n.X();
+        ny = n.Y();
+        nz = n.Z();
+        return true;
+    }
+
+    return false;
+}
+
+const TColStd_PackedMapOfInteger& GraphicsMeshDataSource::GetAllNodes() const
+{
+    std::call_once(m_nodesFlag, [=]{
+        for (int i = 1; i <= m_nodeCount; ++i)
+            m_nodes.Add(i);
+    });
+    return m_nodes;
+}
+
+const TColStd_PackedMapOfInteger& GraphicsMeshDataSource::GetAllElements() const
+{
+    std::call_once(m_elementsFlag, [=]{
+        for (int i = 1; i <= m_elementCount; ++i)
+            m_elements.Add(i);
+    });
+    return m_elements;
+}
+
 } // namespace Mayo
@@ -14,11 +14,15 @@
 #include <MeshVS_EntityType.hxx>
 #include <Poly_Triangulation.hxx>
 #include <TColStd_PackedMapOfInteger.hxx>
-#include <TColStd_HArray2OfInteger.hxx>
-#include <TColStd_HArray2OfReal.hxx>
+#include <mutex>
+#include <vector>
 
 namespace Mayo {
 
+// Nodes and elements data are directly read from the source Poly_Triangulation object(no copy)
+// Node and element identifiers are the contiguous ranges [1, NbNodes] and [1, NbTriangles]
+// Element normals are lazily computed(in parallel) on first request
+// Node normals are the ones stored in the Poly_Triangulation object, if any
 class GraphicsMeshDataSource : public MeshVS_DataSource {
 public:
     GraphicsMeshDataSource(const Handle_Poly_Triangulation& mesh);
@@ -27,17 +31,25 @@ public:
     bool GetGeomType(const int ID, const bool IsElement, MeshVS_EntityType& Type) const override;
     Standard_Address GetAddr(const int /*ID*/, const bool /*IsElement*/) const override { return nullptr; }
     bool GetNodesByElement(const int ID, TColStd_Array1OfInteger& NodeIDs, int& NbNodes) const override;
-    const TColStd_PackedMapOfInteger& GetAllNodes() const override { return m_nodes; }
-    const TColStd_PackedMapOfInteger& GetAllElements() const override { return m_elements; }
+    const TColStd_PackedMapOfInteger& GetAllNodes() const override;
+    const TColStd_PackedMapOfInteger& GetAllElements() const override;
     bool GetNormal(const int Id, const int Max, double& nx, double& ny, double& nz) const override;
+    bool GetNodeNormal(const int RankNode, const int ElementId, double& nx, double& ny, double& nz) const override;
 
 private:
-  Handle_Poly_Triangulation m_mesh;
-  TColStd_PackedMapOfInteger m_nodes;
-  TColStd_PackedMapOfInteger m_elements;
-  Handle_TColStd_HArray2OfInteger m_elemNodes;
-  Handle_TColStd_HArray2OfReal m_nodeCoords;
-  Handle_TColStd_HArray2OfReal m_elemNormals;
+    bool isNodeId(int id) const { return id >= 1 && id <= m_nodeCount; }
+    bool isElementId(int id) const { return id >= 1 && id <= m_elementCount; }
+
+    Handle_Poly_Triangulation m_mesh;
+    int m_nodeCount = 0;
+    int m_elementCount = 0;
+    // MeshVS_DataSource API requires maps of identifiers, they are populated on first request
+    mutable TColStd_PackedMapOfInteger m_nodes;
+    mutable TColStd_PackedMapOfInteger m_elements;
+    mutable std::once_flag m_nodesFlag;
+    mutable std::once_flag m_elementsFlag;
+    mutable std::vector<float> m_elemNormals;
+    mutable std::once_flag m_elemNormalsFlag;
 };
 
 } // namespace Mayo
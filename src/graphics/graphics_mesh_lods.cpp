@@ -0,0 +1,59 @@
+/****************************************************************************
+** Copyright (c) 2023, Fougue Ltd. <http://www.fougue.pro>
+** All rights reserved.
+** See license at https://github.com/fougue/mayo/blob/master/LICENSE.txt
+****************************************************************************/
+
+#include "graphics_mesh_lods.h"
+
+#include <deque>
+#include <thread>
+
+namespace Mayo {
+
+namespace {
+
+struct LodJobQueue {
+    std::mutex mutex;
+    std::deque<std::function<void()>> queueJob;
+    bool isWorkerRunning = false;
+};
+
+// Never deleted, the detached worker thread might still be running at application exit
+LodJobQueue* lodJobQueue()
+{
+    static LodJobQueue* jobQueue = new LodJobQueue;
+    return jobQueue;
+}
+
+} // namespace
+
+void GraphicsMeshLodsBase::runAsync(std::function<void()> job)
+{
+    LodJobQueue* jobQueue = lodJobQueue();
+    std::lock_guard<std::mutex> lock(jobQueue->mutex);
+    jobQueue->queueJob.push_back(std::move(job));
+    if (jobQueue->isWorkerRunning)
+        return;
+
+    jobQueue->isWorkerRunning = true;
+    std::thread([=]{
+        for (;;) {
+            std::function<void()> nextJob;
+            {
+                std::lock_guard<std::mutex> lock(jobQueue->mutex);
+                if (jobQueue->queueJob.empty()) {
+                    jobQueue->isWorkerRunning = false;
+                    return;
+                }
+
+                nextJob = std::move(jobQueue->queueJob.front());
+                jobQueue->queueJob.pop_front();
+            }
+
+            nextJob();
+        }
+    }).detach();
+}
+
+} // namespace Mayo
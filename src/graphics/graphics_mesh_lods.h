@@ -0,0 +1,134 @@
+/****************************************************************************
+** Copyright (c) 2023, Fougue Ltd. <http://www.fougue.pro>
+** All rights reserved.
+** See license at https://github.com/fougue/mayo/blob/master/LICENSE.txt
+****************************************************************************/
+
+#pragma once
+
+#include "../base/global.h"
+#include "../base/mesh_decimation.h"
+#include "../base/signal.h"
+
+#include <Poly_Triangulation.hxx>
+#include <Standard_Transient.hxx>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace Mayo {
+
+// State shared with the worker thread computing the levels of detail(LOD) of a mesh graphics object
+class GraphicsMeshLodsBase {
+public:
+    // Abandons computation of the LODs, doesn't wait for the worker thread to finish
+    // Worker sends signalLevelOfDetailAdded with the mutex locked, so it isn't sent once this returns
+    void cancel()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_isCancelled = true;
+    }
+
+    bool isCancelled() const { return m_isCancelled; }
+
+    // Calls 'fn' with the mutex locked unless cancel() was called, returns false in that case
+    // Allows the worker thread to read data of client code that remains valid until cancel()
+    bool callIfNotCancelled(const std::function<void()>& fn) const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_isCancelled)
+            return false;
+
+        fn();
+        return true;
+    }
+
+    // Signal sent from the worker thread each time a LOD is available
+    Signal<> signalLevelOfDetailAdded;
+
+protected:
+    // Runs 'job' in a detached worker thread shared by all mesh graphics objects, jobs are run one
+    // at a time as decimation of large triangulations is itself spread over threads
+    static void runAsync(std::function<void()> job);
+
+    mutable std::mutex m_mutex;
+    std::atomic<bool> m_isCancelled{false};
+};
+
+// Coarser levels of detail of a triangulation along with their presentation data of type 'LodData'
+// LODs are decimated by a worker thread(see MeshDecimation::computeLevelsOfDetail()) which also
+// builds their presentation data, so activating a LOD from the UI thread is cheap
+// LOD 0 is the source triangulation, it's up to the owner graphics object to handle it
+template<typename LodData>
+class GraphicsMeshLods : public GraphicsMeshLodsBase {
+public:
+    struct LevelOfDetail {
+        Handle_Poly_Triangulation triangulation;
+        // 1-based index in the source triangulation of each node
+        std::vector<int> vecSourceNode;
+        LodData data;
+    };
+
+    using LevelOfDetailPtr = std::shared_ptr<const LevelOfDetail>;
+    using DataFunction = std::function<LodData(const LevelOfDetail&)>;
+
+    // Count of LODs available, including the source one
+    int count() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return 1 + int(m_vecLod.size());
+    }
+
+    // Coarser LOD 'lod' in [1,count()-1]
+    LevelOfDetailPtr at(int lod) const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_vecLod.at(lod - 1);
+    }
+
+    // Starts computation of the LODs of 'source' until 'lodCount' is reached, does nothing if already
+    // started. 'fnData' is called from the worker thread to build the presentation data of each LOD
+    // The worker thread keeps 'owner'(the graphics object holding this object) alive until finished,
+    // so neither cancel() nor the destructor of 'owner' have to wait for a decimation to complete
+    void computeAsync(
+            const Handle(Standard_Transient)& owner,
+            const Handle_Poly_Triangulation& source,
+            int lodCount,
+            const DataFunction& fnData)
+    {
+        if (m_isStarted || m_isCancelled || !source || lodCount < 2)
+            return;
+
+        m_isStarted = true;
+        GraphicsMeshLodsBase::runAsync([this, owner, source, lodCount, fnData]{
+            MAYO_UNUSED(owner);
+            if (m_isCancelled)
+                return;
+
+            MeshDecimation::computeLevelsOfDetail(source, lodCount, [=](MeshDecimation::Result&& result) {
+                if (m_isCancelled)
+                    return false;
+
+                auto lod = std::make_shared<LevelOfDetail>();
+                lod->triangulation = std::move(result.triangulation);
+                lod->vecSourceNode = std::move(result.vecSourceNode);
+                lod->data = fnData(*lod);
+                std::lock_guard<std::mutex> lock(m_mutex);
+                if (m_isCancelled)
+                    return false;
+
+                m_vecLod.push_back(std::move(lod));
+                this->signalLevelOfDetailAdded.send();
+                return true;
+            });
+        });
+    }
+
+private:
+    bool m_isStarted = false; // Accessed only by the UI thread
+    std::vector<LevelOfDetailPtr> m_vecLod; // Shared with the worker thread
+};
+
+} // namespace Mayo
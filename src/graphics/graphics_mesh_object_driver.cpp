@@ -14,20 +14,65 @@
 #include "../base/property_builtins.h"
 #include "../base/xcaf.h"
 #include "graphics_mesh_data_source.h"
+#include "graphics_mesh_lods.h"
 #include "graphics_utils.h"
 
 #include <BRep_TFace.hxx>
+#include <MeshVS_DataMapOfIntegerColor.hxx>
 #include <MeshVS_DisplayModeFlags.hxx>
 #include <MeshVS_DrawerAttribute.hxx>
 #include <MeshVS_Drawer.hxx>
 #include <MeshVS_Mesh.hxx>
 #include <MeshVS_MeshPrsBuilder.hxx>
 #include <MeshVS_NodalColorPrsBuilder.hxx>
+#include <OSD_Parallel.hxx>
+#include <algorithm>
 
 namespace Mayo {
 
 namespace {
+
 struct GraphicsMeshObjectDriverI18N { MAYO_DECLARE_TEXT_ID_FUNCTIONS(Mayo::GraphicsMeshObjectDriver) };
+
+// Mesh graphics object holding levels of detail(LOD), which are decimated versions of the source
+// triangulation computed in background. The data source of the object is the one of the active LOD
+class GraphicsMeshLodObject : public MeshVS_Mesh {
+public:
+    Handle_Poly_Triangulation sourceTriangulation;
+    Handle_MeshVS_DataSource sourceDataSource;
+    GraphicsMeshLods<Handle_MeshVS_DataSource> lods;
+    int activeLod = 0;
+    Span<const Quantity_Color> spanNodeColor; // Colors of the source nodes, empty if none
+    Handle_MeshVS_NodalColorPrsBuilder nodalColorPrsBuilder;
+
+    DEFINE_STANDARD_RTTI_INLINE(GraphicsMeshLodObject, MeshVS_Mesh)
+};
+
+// Assigns to the 'nodeCount' nodes of a LOD the colors of their source nodes
+// 'vecSourceNode' maps LOD nodes to source nodes, empty for the source LOD
+void setNodeColors(const GraphicsMeshLodObject& object, int nodeCount, const std::vector<int>& vecSourceNode)
+{
+    MeshVS_DataMapOfIntegerColor mapNodeColor;
+    for (int i = 0; i < nodeCount; ++i) {
+        const int sourceNode = !vecSourceNode.empty() ? vecSourceNode.at(i) : i + 1;
+        if (CppUtils::cmpLessEqual(sourceNode, object.spanNodeColor.size()))
+            mapNodeColor.Bind(i + 1, object.spanNodeColor[sourceNode - 1]);
+    }
+
+    object.nodalColorPrsBuilder->SetColors(mapNodeColor);
+}
+
+// Triggers computation of the data lazily built by GraphicsMeshDataSource
+void prepareDataSource(const Handle_MeshVS_DataSource& dataSource)
+{
+    if (dataSource) {
+        dataSource->GetAllNodes();
+        dataSource->GetAllElements();
+        double nx, ny, nz;
+        dataSource->GetNormal(1, 3, nx, ny, nz);
+    }
+}
+
 } // namespace
 
 GraphicsMeshObjectDriver::GraphicsMeshObjectDriver()
@@ -66,15 +111,18 @@ GraphicsObjectPtr GraphicsMeshObjectDriver::createObject(const TDF_Label& label)
     }
 
     if (polyTri) {
-        Handle_MeshVS_Mesh object = new MeshVS_Mesh;
-        object->SetDataSource(new GraphicsMeshDataSource(polyTri));
+        Handle(GraphicsMeshLodObject) object = new GraphicsMeshLodObject;
+        object->sourceTriangulation = polyTri;
+        object->sourceDataSource = new GraphicsMeshDataSource(polyTri);
+        object->SetDataSource(object->sourceDataSource);
         // meshVisu->AddBuilder(..., false); -> No selection
         if (!spanNodeColor.empty()) {
-            auto meshPrsBuilder = new MeshVS_NodalColorPrsBuilder(object, MeshVS_DMF_NodalColorDataPrs | MeshVS_DMF_OCCMask);
-            for (int i = 0; CppUtils::cmpLess(i, spanNodeColor.size()); ++i)
-                meshPrsBuilder->SetColor(i + 1, spanNodeColor[i]);
-
-            object->AddBuilder(meshPrsBuilder, true);
+            object->spanNodeColor = spanNodeColor;
+            object->nodalColorPrsBuilder = new MeshVS_NodalColorPrsBuilder(
+                        object, MeshVS_DMF_NodalColorDataPrs | MeshVS_DMF_OCCMask
+            );
+            setNodeColors(*object, polyTri->NbNodes(), {});
+            object->AddBuilder(object->nodalColorPrsBuilder, true);
         }
         else {
             object->AddBuilder(new MeshVS_MeshPrsBuilder(object), true);
@@ -89,6 +137,8 @@ GraphicsObjectPtr GraphicsMeshObjectDriver::createObject(const TDF_Label& label)
         );
         object->GetDrawer()->SetColor(MeshVS_DA_EdgeColor, defaultValues().edgeColor);
         object->GetDrawer()->SetBoolean(MeshVS_DA_ColorReflection, true);
+        // Use node normals computed at import(see GraphicsMeshDataSource::GetNodeNormal())
+        object->GetDrawer()->SetBoolean(MeshVS_DA_SmoothShading, polyTri->HasNormals());
         object->SetDisplayMode(MeshVS_DMF_Shading);
 
         //object->SetHilightMode(MeshVS_DMF_WireFrame);
@@ -210,6 +260,82 @@ GraphicsMeshObjectDriver::properties(Span<const GraphicsObjectPtr> spanObject) c
     return std::make_unique<ObjectProperties>(spanObject);
 }
 
+int GraphicsMeshObjectDriver::levelOfDetailCount(const GraphicsObjectPtr& object) const
+{
+    this->throwIf_differentDriver(object);
+    auto lodObject = Handle(GraphicsMeshLodObject)::DownCast(object);
+    return lodObject ? lodObject->lods.count() : 1;
+}
+
+bool GraphicsMeshObjectDriver::isLevelOfDetailComputed(const GraphicsObjectPtr& object, int lod) const
+{
+    this->throwIf_differentDriver(object);
+    // Presentation holds only the active LOD
+    auto lodObject = Handle(GraphicsMeshLodObject)::DownCast(object);
+    return !lodObject || std::clamp(lod, 0, this->levelOfDetailCount(object) - 1) == lodObject->activeLod;
+}
+
+bool GraphicsMeshObjectDriver::setLevelOfDetail(const GraphicsObjectPtr& object, int lod) const
+{
+    this->throwIf_differentDriver(object);
+    auto lodObject = Handle(GraphicsMeshLodObject)::DownCast(object);
+    if (!lodObject)
+        return false;
+
+    const int lodIndex = std::clamp(lod, 0, lodObject->lods.count() - 1);
+    if (lodIndex == lodObject->activeLod)
+        return false;
+
+    if (lodIndex > 0) {
+        const auto activeLod = lodObject->lods.at(lodIndex);
+        lodObject->SetDataSource(activeLod->data);
+        if (lodObject->nodalColorPrsBuilder)
+            setNodeColors(*lodObject, activeLod->triangulation->NbNodes(), activeLod->vecSourceNode);
+    }
+    else {
+        lodObject->SetDataSource(lodObject->sourceDataSource);
+        if (lodObject->nodalColorPrsBuilder)
+            setNodeColors(*lodObject, lodObject->sourceTriangulation->NbNodes(), {});
+    }
+
+    lodObject->activeLod = lodIndex;
+    AIS_InteractiveContext* context = GraphicsUtils::AisObject_contextPtr(object);
+    if (context)
+        context->Redisplay(object, false);
+
+    return true;
+}
+
+GraphicsMeshLodsBase* GraphicsMeshObjectDriver::meshLevelsOfDetail(const GraphicsObjectPtr& object) const
+{
+    this->throwIf_differentDriver(object);
+    auto lodObject = Handle(GraphicsMeshLodObject)::DownCast(object);
+    return lodObject ? &lodObject->lods : nullptr;
+}
+
+void GraphicsMeshObjectDriver::prepareObjects(Span<const GraphicsObjectPtr> spanObject) const
+{
+    this->throwIf_differentDriver(spanObject);
+    OSD_Parallel::ForEach(spanObject.begin(), spanObject.end(), [](const GraphicsObjectPtr& object) {
+        auto meshVisu = Handle_MeshVS_Mesh::DownCast(object);
+        prepareDataSource(meshVisu->GetDataSource());
+    });
+
+    // Data source of each LOD is prepared by the worker thread too
+    const int lodCount = defaultValues().levelOfDetailCount;
+    for (const GraphicsObjectPtr& object : spanObject) {
+        auto lodObject = Handle(GraphicsMeshLodObject)::DownCast(object);
+        if (!lodObject)
+            continue;
+
+        lodObject->lods.computeAsync(lodObject, lodObject->sourceTriangulation, lodCount, [](const auto& lod) {
+            Handle_MeshVS_DataSource dataSource = new GraphicsMeshDataSource(lod.triangulation);
+            prepareDataSource(dataSource);
+            return dataSource;
+        });
+    }
+}
+
 GraphicsMeshObjectDriver::Support GraphicsMeshObjectDriver::meshSupportStatus(const TDF_Label& label)
 {
     const LabelDataFlags flags = findLabelDataFlags(label);
@@ -24,6 +24,13 @@ public:
     void applyDisplayMode(GraphicsObjectPtr object, Enumeration::Value mode) const override;
     Enumeration::Value currentDisplayMode(const GraphicsObjectPtr& object) const override;
     std::unique_ptr<PropertyGroupSignals> properties(Span<const GraphicsObjectPtr> spanObject) const override;
+    int levelOfDetailCount(const GraphicsObjectPtr& object) const override;
+    bool isLevelOfDetailComputed(const GraphicsObjectPtr& object, int lod) const override;
+    bool setLevelOfDetail(const GraphicsObjectPtr& object, int lod) const override;
+    GraphicsMeshLodsBase* meshLevelsOfDetail(const GraphicsObjectPtr& object) const override;
+    // Also starts computation of the levels of detail of the meshes in background(see
+    // DefaultValues::levelOfDetailCount)
+    void prepareObjects(Span<const GraphicsObjectPtr> spanObject) const override;
 
     static Support meshSupportStatus(const TDF_Label& label);
 
@@ -33,6 +40,9 @@ public:
         Graphic3d_NameOfMaterial material = Graphic3d_NOM_PLASTER;
         Quantity_Color color = Quantity_NOC_BISQUE;
         Quantity_Color edgeColor = Quantity_NOC_BLACK;
+        // Count of levels of detail of the meshes, coarser ones are computed by mesh decimation
+        // Value 1 disables levels of detail
+        int levelOfDetailCount = 1;
     };
     static const DefaultValues& defaultValues();
     static void setDefaultValues(const DefaultValues& values);
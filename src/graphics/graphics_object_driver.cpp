@@ -10,6 +10,30 @@ namespace Mayo {
 
 namespace { struct GraphicsObjectDriverI18N { MAYO_DECLARE_TEXT_ID_FUNCTIONS(Mayo::GraphicsObjectDriver) }; }
 
+int GraphicsObjectDriver::levelOfDetailCount(const GraphicsObjectPtr& /*object*/) const
+{
+    return 1;
+}
+
+bool GraphicsObjectDriver::isLevelOfDetailComputed(const GraphicsObjectPtr& /*object*/, int /*lod*/) const
+{
+    return true;
+}
+
+bool GraphicsObjectDriver::setLevelOfDetail(const GraphicsObjectPtr& /*object*/, int /*lod*/) const
+{
+    return false;
+}
+
+GraphicsMeshLodsBase* GraphicsObjectDriver::meshLevelsOfDetail(const GraphicsObjectPtr& /*object*/) const
+{
+    return nullptr;
+}
+
+void GraphicsObjectDriver::prepareObjects(Span<const GraphicsObjectPtr> /*spanObject*/) const
+{
+}
+
 GraphicsObjectDriverPtr GraphicsObjectDriver::get(const GraphicsObjectPtr& object)
 {
     if (object)
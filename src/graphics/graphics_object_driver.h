@@ -18,6 +18,7 @@
 
 namespace Mayo {
 
+class GraphicsMeshLodsBase;
 class GraphicsObjectDriver;
 DEFINE_STANDARD_HANDLE(GraphicsObjectDriver, Standard_Transient)
 using GraphicsObjectDriverPtr = Handle(GraphicsObjectDriver);
@@ -38,6 +39,27 @@ public:
 
     virtual std::unique_ptr<PropertyGroupSignals> properties(Span<const GraphicsObjectPtr> spanObject) const = 0;
 
+    // Levels of detail(LOD) available for graphics 'object', LOD 0 is the most detailed one
+    // Returns 1 if the driver doesn't support multiple LODs
+    virtual int levelOfDetailCount(const GraphicsObjectPtr& object) const;
+    // Whether the presentation of LOD 'lod' is already computed for graphics 'object', so activating
+    // it is cheap(eg while the camera is being manipulated)
+    virtual bool isLevelOfDetailComputed(const GraphicsObjectPtr& object, int lod) const;
+    // Activates LOD 'lod' for graphics 'object', the driver updates the presentation of 'object'
+    // Data of the document(eg active triangulations of BRep faces) is never changed
+    // Returns true if active LOD changed, views have then to be redrawn
+    virtual bool setLevelOfDetail(const GraphicsObjectPtr& object, int lod) const;
+    // Coarser LODs of a mesh graphics 'object' being computed in background once prepared(see
+    // prepareObjects()), null if not applicable. Its signal tells when LODs are added
+    virtual GraphicsMeshLodsBase* meshLevelsOfDetail(const GraphicsObjectPtr& object) const;
+
+    // Computes in advance data the presentations of the graphics objects depend on, so they are
+    // faster to display afterwards. Objects in 'spanObject' aren't displayed yet and are independent
+    // from each other, so the work can be spread over worker threads
+    // Presentations are computed afterwards in the UI thread when objects are displayed, how much
+    // of their work is done in advance depends on the driver
+    virtual void prepareObjects(Span<const GraphicsObjectPtr> spanObject) const;
+
     static GraphicsObjectDriverPtr get(const GraphicsObjectPtr& object);
     static GraphicsObjectDriverPtr getCommon(Span<const GraphicsObjectPtr> spanObject);
 
@@ -0,0 +1,382 @@
+/****************************************************************************
+** Copyright (c) 2023, Fougue Ltd. <http://www.fougue.pro>
+** All rights reserved.
+** See license at https://github.com/fougue/mayo/blob/master/LICENSE.txt
+****************************************************************************/
+
+#include "graphics_point_cloud_object.h"
+
+#include "../base/unit_system.h"
+
+#include <Graphic3d_Camera.hxx>
+#include <Graphic3d_Group.hxx>
+#include <Prs3d_PointAspect.hxx>
+#include <Select3D_SensitivePrimitiveArray.hxx>
+#include <SelectMgr_EntityOwner.hxx>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <queue>
+#include <utility>
+
+namespace Mayo {
+
+namespace Internal {
+
+static int& pointCloudPointBudget()
+{
+    static int count = 8000000;
+    return count;
+}
+
+static int& pointCloudInteractivePointBudget()
+{
+    static int count = 1000000;
+    return count;
+}
+
+} // namespace Internal
+
+GraphicsPointCloudObject::GraphicsPointCloudObject(const Handle(Graphic3d_ArrayOfPoints)& points)
+    : m_points(points),
+      m_pointCount(points ? points->VertexNumber() : 0)
+{
+    myDrawer->SetPointAspect(new Prs3d_PointAspect(Aspect_TOM_POINT, Quantity_NOC_YELLOW, 1.));
+    this->SetDisplayMode(0);
+}
+
+GraphicsPointCloudObject::~GraphicsPointCloudObject()
+{
+    this->cancel();
+}
+
+void GraphicsPointCloudObject::prepare()
+{
+    std::call_once(m_prepareFlag, [=]{
+        m_octree.build(m_points);
+        m_points = m_octree.sortPointsByNode(m_points);
+        std::vector<Handle_Graphic3d_ArrayOfPoints> vecNodeArray(m_octree.nodeCount());
+        int64_t loadedPointCount = 0;
+
+        // Coarse levels are loaded breadth-first, initially visible as long as they fit in the budget
+        std::vector<int> vecResidentNode;
+        for (int i = 0; i < m_octree.nodeCount(); ++i) {
+            if (m_octree.node(i).depth <= residentDepth())
+                vecResidentNode.push_back(i);
+        }
+
+        std::stable_sort(vecResidentNode.begin(), vecResidentNode.end(), [=](int lhs, int rhs) {
+            return m_octree.node(lhs).depth < m_octree.node(rhs).depth;
+        });
+
+        int64_t visiblePointCount = 0;
+        bool isBudgetReached = false;
+        for (int nodeIndex : vecResidentNode) {
+            const int nodePointCount = m_octree.node(nodeIndex).pointCount();
+            vecNodeArray.at(nodeIndex) = this->createNodeArray(nodeIndex);
+            loadedPointCount += nodePointCount;
+            isBudgetReached = isBudgetReached || visiblePointCount + nodePointCount > pointBudget();
+            if (!isBudgetReached || m_vecVisibleNode.empty()) {
+                m_vecVisibleNode.push_back(nodeIndex);
+                visiblePointCount += nodePointCount;
+            }
+        }
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_vecNodeArray = std::move(vecNodeArray);
+        m_loadedPointCount = loadedPointCount;
+    });
+}
+
+bool GraphicsPointCloudObject::updateVisibleNodes(
+        const Handle(V3d_View)& view, int pointBudget, bool cullOutsideView)
+{
+    this->prepare();
+    if (m_isCancelled || m_octree.isEmpty() || !view || !view->Window())
+        return false;
+
+    Standard_Integer viewWidth = 0;
+    Standard_Integer viewHeight = 0;
+    view->Window()->Size(viewWidth, viewHeight);
+    if (viewWidth <= 0 || viewHeight <= 0)
+        return false;
+
+    const Handle_Graphic3d_Camera& camera = view->Camera();
+    const gp_Trsf& trsf = this->Transformation();
+    const double trsfScale = std::abs(trsf.ScaleFactor());
+    const double tanHalfFovy = std::tan(UnitSystem::radians(camera->FOVy() * Quantity_Degree).value / 2.);
+
+    // Size on screen of the bounding sphere of a node, in pixels
+    // Returns a negative value if the node is culled
+    auto fnScreenSize = [&](const PointCloudOctree::Node& node) -> double {
+        const gp_Pnt center = node.center.Transformed(trsf);
+        const double radius = std::sqrt(3.) * node.halfSize * trsfScale;
+        double pixelsPerUnit = 0.;
+        if (camera->IsOrthographic()) {
+            pixelsPerUnit = viewHeight / camera->ViewDimensions().Y();
+        }
+        else {
+            const double depth = gp_Vec(camera->Eye(), center).Dot(gp_Vec(camera->Direction()));
+            if (cullOutsideView && depth < -radius)
+                return -1.;
+
+            const double distance = center.Distance(camera->Eye());
+            if (distance <= radius)
+                return std::numeric_limits<double>::max();
+
+            pixelsPerUnit = viewHeight / (2 * distance * tanHalfFovy);
+        }
+
+        const double screenRadius = radius * pixelsPerUnit;
+        if (cullOutsideView) {
+            const gp_Pnt ndc = camera->Project(center);
+            if (std::abs(ndc.X()) > 1 + 2 * screenRadius / viewWidth
+                    || std::abs(ndc.Y()) > 1 + 2 * screenRadius / viewHeight)
+            {
+                return -1.;
+            }
+        }
+
+        return 2 * screenRadius;
+    };
+
+    // Screen-space error of a node is the size on screen of its sampling cells. Children are refining
+    // the node only if this error is above one pixel
+    const double gridResolution = PointCloudOctree::Parameters{}.gridResolution;
+    using NodeScreenSize = std::pair<double, int>;
+    std::priority_queue<NodeScreenSize> queueNode;
+    queueNode.push({ std::max(fnScreenSize(m_octree.node(0)), 0.), 0 }); // Root is always visible
+    std::vector<int> vecVisibleNode;
+    int64_t visiblePointCount = 0;
+    while (!queueNode.empty()) {
+        const auto [screenSize, nodeIndex] = queueNode.top();
+        queueNode.pop();
+        const PointCloudOctree::Node& node = m_octree.node(nodeIndex);
+        if (!vecVisibleNode.empty() && visiblePointCount + node.pointCount() > pointBudget)
+            break;
+
+        vecVisibleNode.push_back(nodeIndex);
+        visiblePointCount += node.pointCount();
+        if (screenSize / gridResolution < 1.)
+            continue;
+
+        for (int childIndex : node.children) {
+            if (childIndex < 0)
+                continue;
+
+            const double childScreenSize = fnScreenSize(m_octree.node(childIndex));
+            if (childScreenSize >= 0.)
+                queueNode.push({ childScreenSize, childIndex });
+        }
+    }
+
+    const bool isSelectionChanged = vecVisibleNode != m_vecVisibleNode;
+    m_vecVisibleNode = std::move(vecVisibleNode);
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    // Replace any pending request, nodes larger on screen are loaded first
+    m_vecPendingNode.clear();
+    for (auto it = m_vecVisibleNode.crbegin(); it != m_vecVisibleNode.crend(); ++it) {
+        if (!m_vecNodeArray.at(*it))
+            m_vecPendingNode.push_back(*it);
+    }
+
+    // Loaded nodes are notified in a few batches, so the presentation isn't recomputed for each one
+    m_batchPointCount = std::max(pointBudget / 4, 1);
+    this->releaseNodeArrays(2 * std::max(pointBudget, GraphicsPointCloudObject::pointBudget()));
+    if (!m_vecPendingNode.empty() && !m_isWorkerRunning) {
+        m_isWorkerRunning = true;
+        m_worker = std::async(std::launch::async, [=]{ this->runWorker(); });
+    }
+
+    return isSelectionChanged;
+}
+
+int GraphicsPointCloudObject::visiblePointCount() const
+{
+    int count = 0;
+    for (int nodeIndex : m_vecVisibleNode)
+        count += m_octree.node(nodeIndex).pointCount();
+
+    return count;
+}
+
+void GraphicsPointCloudObject::cancel()
+{
+    m_isCancelled = true;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_vecPendingNode.clear();
+    }
+
+    if (m_worker.valid())
+        m_worker.wait();
+}
+
+int GraphicsPointCloudObject::pointBudget()
+{
+    return Internal::pointCloudPointBudget();
+}
+
+void GraphicsPointCloudObject::setPointBudget(int count)
+{
+    Internal::pointCloudPointBudget() = count;
+}
+
+int GraphicsPointCloudObject::interactivePointBudget()
+{
+    return Internal::pointCloudInteractivePointBudget();
+}
+
+void GraphicsPointCloudObject::setInteractivePointBudget(int count)
+{
+    Internal::pointCloudInteractivePointBudget() = count;
+}
+
+int GraphicsPointCloudObject::residentDepth()
+{
+    return 2;
+}
+
+void GraphicsPointCloudObject::ComputeSelection(const Handle(SelectMgr_Selection)& sel, const int mode)
+{
+    this->prepare();
+    if (mode != 0 || m_octree.isEmpty())
+        return;
+
+    // Points of the nodes currently drawn, so picking matches what's on screen
+    Handle_SelectMgr_EntityOwner owner = new SelectMgr_EntityOwner(this);
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (int nodeIndex : m_vecVisibleNode) {
+        const Handle_Graphic3d_ArrayOfPoints& array = m_vecNodeArray.at(nodeIndex);
+        if (!array)
+            continue;
+
+        Handle_Select3D_SensitivePrimitiveArray sensitive = new Select3D_SensitivePrimitiveArray(owner);
+        if (sensitive->InitPoints(array->Attributes(), TopLoc_Location()))
+            sel->Add(sensitive);
+    }
+}
+
+void GraphicsPointCloudObject::Compute(
+        const Handle(PrsMgr_PresentationManager)&,
+        const Handle(Prs3d_Presentation)& pres,
+        const int mode)
+{
+    this->prepare();
+    if (mode != 0)
+        return;
+
+    Handle_Graphic3d_Group group = pres->NewGroup();
+    group->SetGroupPrimitivesAspect(myDrawer->PointAspect()->Aspect());
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (int nodeIndex : m_vecVisibleNode) {
+        const Handle_Graphic3d_ArrayOfPoints& array = m_vecNodeArray.at(nodeIndex);
+        if (array)
+            group->AddPrimitiveArray(array);
+    }
+}
+
+Handle_Graphic3d_ArrayOfPoints GraphicsPointCloudObject::createNodeArray(int nodeIndex) const
+{
+    const PointCloudOctree::Node& node = m_octree.node(nodeIndex);
+    if (node.pointCount() <= 0)
+        return {};
+
+    const bool hasColors = m_points->HasVertexColors();
+    const bool hasNormals = m_points->HasVertexNormals();
+    Handle_Graphic3d_ArrayOfPoints array = new Graphic3d_ArrayOfPoints(node.pointCount(), hasColors, hasNormals);
+    const int pntIndexEnd = node.sortedPointFirst + node.sortedPointCount;
+    for (int pntIndex = node.sortedPointFirst; pntIndex < pntIndexEnd; ++pntIndex) {
+        const int vertexIndex = array->AddVertex(m_points->Vertice(pntIndex));
+        if (hasColors)
+            array->SetVertexColor(vertexIndex, m_points->VertexColor(pntIndex));
+
+        if (hasNormals)
+            array->SetVertexNormal(vertexIndex, m_points->VertexNormal(pntIndex));
+    }
+
+    return array;
+}
+
+void GraphicsPointCloudObject::releaseNodeArrays(int maxLoadedPointCount)
+{
+    // Note: m_mutex is expected to be locked by caller
+    if (m_loadedPointCount <= maxLoadedPointCount)
+        return;
+
+    std::vector<bool> vecNodeVisible(m_octree.nodeCount(), false);
+    for (int nodeIndex : m_vecVisibleNode)
+        vecNodeVisible.at(nodeIndex) = true;
+
+    std::vector<int> vecReleasableNode;
+    for (int i = 0; i < m_octree.nodeCount(); ++i) {
+        if (m_vecNodeArray.at(i) && !vecNodeVisible.at(i) && m_octree.node(i).depth > residentDepth())
+            vecReleasableNode.push_back(i);
+    }
+
+    // Deepest nodes are the less likely to be visible again
+    std::sort(vecReleasableNode.begin(), vecReleasableNode.end(), [=](int lhs, int rhs) {
+        return m_octree.node(lhs).depth > m_octree.node(rhs).depth;
+    });
+
+    for (int nodeIndex : vecReleasableNode) {
+        if (m_loadedPointCount <= maxLoadedPointCount)
+            break;
+
+        m_vecNodeArray.at(nodeIndex).Nullify();
+        m_loadedPointCount -= m_octree.node(nodeIndex).pointCount();
+    }
+}
+
+void GraphicsPointCloudObject::runWorker()
+{
+    int batchPointCount = 0;
+    auto fnNotifyBatch = [&]{
+        if (batchPointCount > 0 && !m_isCancelled)
+            this->signalNodesLoaded.send();
+
+        batchPointCount = 0;
+    };
+
+    bool isIdle = false;
+    while (!m_isCancelled && !isIdle) {
+        int nodeIndex = -1;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            while (nodeIndex < 0 && !m_vecPendingNode.empty()) {
+                const int pendingIndex = m_vecPendingNode.back();
+                m_vecPendingNode.pop_back();
+                if (!m_vecNodeArray.at(pendingIndex))
+                    nodeIndex = pendingIndex;
+            }
+
+            if (nodeIndex < 0) {
+                m_isWorkerRunning = false;
+                isIdle = true;
+                continue;
+            }
+        }
+
+        const Handle_Graphic3d_ArrayOfPoints array = this->createNodeArray(nodeIndex);
+        bool isBatchComplete = false;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_vecNodeArray.at(nodeIndex) = array;
+            m_loadedPointCount += m_octree.node(nodeIndex).pointCount();
+            batchPointCount += m_octree.node(nodeIndex).pointCount();
+            isBatchComplete = batchPointCount >= m_batchPointCount || m_vecPendingNode.empty();
+        }
+
+        if (isBatchComplete)
+            fnNotifyBatch();
+    }
+
+    fnNotifyBatch();
+    if (!isIdle) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_isWorkerRunning = false;
+    }
+}
+
+} // namespace Mayo
@@ -0,0 +1,118 @@
+/****************************************************************************
+** Copyright (c) 2023, Fougue Ltd. <http://www.fougue.pro>
+** All rights reserved.
+** See license at https://github.com/fougue/mayo/blob/master/LICENSE.txt
+****************************************************************************/
+
+#pragma once
+
+#include "../base/point_cloud_octree.h"
+#include "../base/signal.h"
+#include "../base/tkernel_utils.h"
+
+#include <AIS_InteractiveObject.hxx>
+#include <Graphic3d_ArrayOfPoints.hxx>
+#include <Prs3d_Presentation.hxx>
+#include <PrsMgr_PresentationManager.hxx>
+#include <SelectMgr_Selection.hxx>
+#include <V3d_View.hxx>
+#include <atomic>
+#include <cstdint>
+#include <future>
+#include <mutex>
+#include <vector>
+
+#if OCC_VERSION_HEX < OCC_VERSION_CHECK(7, 5, 0)
+#  include <Prs3d_Projector.hxx>
+#endif
+
+namespace Mayo {
+
+// Graphics object drawing a point cloud through an octree(see PointCloudOctree)
+// Only a selection of octree nodes is drawn, picked by decreasing size on screen until a point budget
+// is reached. Points of the selected nodes are copied into arrays by a worker thread, the deepest
+// nodes being streamed as the camera moves. Arrays of the coarse levels(see residentDepth()) are
+// created once and kept, so there is always something to draw while finer nodes are loading
+// Once the octree is built, the object keeps its own copy of the points sorted by octree node and
+// releases its reference to the source array
+// Selection is made of the points of the visible nodes loaded
+// Display modes:
+//     0 -> points
+class GraphicsPointCloudObject : public AIS_InteractiveObject {
+public:
+    GraphicsPointCloudObject(const Handle(Graphic3d_ArrayOfPoints)& points);
+    ~GraphicsPointCloudObject();
+
+    // Builds the octree and the arrays of the coarse levels
+    // Called by updateVisibleNodes() if needed, but can be called explicitly from any thread
+    void prepare();
+
+    // Selects the octree nodes to be drawn in 'view' so that the total point count doesn't exceed
+    // 'pointBudget'. Nodes outside of the view frustum are skipped if 'cullOutsideView' is true
+    // Nodes not yet loaded are queued for the worker thread, signalNodesLoaded is sent when a batch
+    // of them is available
+    // Returns true if the selection changed, then the presentation has to be recomputed
+    bool updateVisibleNodes(const Handle(V3d_View)& view, int pointBudget, bool cullOutsideView);
+
+    int pointCount() const { return m_pointCount; }
+    int visiblePointCount() const;
+
+    // Abandons loading of pending nodes and waits for the worker thread to finish
+    // signalNodesLoaded isn't sent anymore after this call
+    void cancel();
+    bool isCancelled() const { return m_isCancelled; }
+
+    // Point count drawn when rendering quality is full(eg camera idle)
+    static int pointBudget();
+    static void setPointBudget(int count);
+
+    // Point count drawn while the camera is manipulated
+    static int interactivePointBudget();
+    static void setInteractivePointBudget(int count);
+
+    // Octree levels which arrays are never released
+    static int residentDepth();
+
+    bool AcceptDisplayMode(const int mode) const override { return mode == 0; }
+    void ComputeSelection(const Handle(SelectMgr_Selection)& sel, const int mode) override;
+
+    // Signal sent from the worker thread when a batch of visible nodes has been loaded
+    Signal<> signalNodesLoaded;
+
+    DEFINE_STANDARD_RTTI_INLINE(GraphicsPointCloudObject, AIS_InteractiveObject)
+
+protected:
+    void Compute(
+            const Handle(PrsMgr_PresentationManager)& pm,
+            const Handle(Prs3d_Presentation)& pres,
+            const int mode) override;
+
+#if OCC_VERSION_HEX < OCC_VERSION_CHECK(7, 5, 0)
+    void Compute(const Handle(Prs3d_Projector)&, const Handle(Prs3d_Presentation)&) override {}
+#endif
+
+private:
+    Handle_Graphic3d_ArrayOfPoints createNodeArray(int nodeIndex) const;
+    void releaseNodeArrays(int maxLoadedPointCount);
+    void runWorker();
+
+    Handle_Graphic3d_ArrayOfPoints m_points; // Sorted by octree node once prepared
+    const int m_pointCount = 0;
+    PointCloudOctree m_octree;
+    std::once_flag m_prepareFlag;
+    std::vector<int> m_vecVisibleNode;
+
+    // Shared with the worker thread
+    mutable std::mutex m_mutex;
+    std::vector<Handle_Graphic3d_ArrayOfPoints> m_vecNodeArray; // Indexed by octree node, null if not loaded
+    int64_t m_loadedPointCount = 0;
+    std::vector<int> m_vecPendingNode; // Loading order is reversed(last one first)
+    int m_batchPointCount = 0;
+    bool m_isWorkerRunning = false;
+    std::future<void> m_worker;
+    std::atomic<bool> m_isCancelled{false};
+};
+
+DEFINE_STANDARD_HANDLE(GraphicsPointCloudObject, AIS_InteractiveObject)
+
+} // namespace Mayo
@@ -9,8 +9,9 @@
 #include "../base/caf_utils.h"
 #include "../base/label_data.h"
 #include "../base/point_cloud_data.h"
+#include "graphics_point_cloud_object.h"
 
-#include <AIS_PointCloud.hxx>
+#include <OSD_Parallel.hxx>
 
 namespace Mayo {
 
@@ -27,8 +28,7 @@ GraphicsObjectPtr GraphicsPointCloudObjectDriver::createObject(const TDF_Label&
 {
     if (findLabelDataFlags(label) & LabelData_HasPointCloudData) {
         auto attrPointCloudData = CafUtils::findAttribute<PointCloudData>(label);
-        auto object = new AIS_PointCloud;
-        object->SetPoints(attrPointCloudData->points());
+        auto object = new GraphicsPointCloudObject(attrPointCloudData->points());
         object->SetOwner(this);
         return object;
     }
@@ -56,6 +56,14 @@ GraphicsPointCloudObjectDriver::properties(Span<const GraphicsObjectPtr> spanObj
     return {};
 }
 
+void GraphicsPointCloudObjectDriver::prepareObjects(Span<const GraphicsObjectPtr> spanObject) const
+{
+    this->throwIf_differentDriver(spanObject);
+    OSD_Parallel::ForEach(spanObject.begin(), spanObject.end(), [](const GraphicsObjectPtr& object) {
+        Handle(GraphicsPointCloudObject)::DownCast(object)->prepare();
+    });
+}
+
 GraphicsPointCloudObjectDriver::Support GraphicsPointCloudObjectDriver::pointCloudSupportStatus(const TDF_Label& label)
 {
     const LabelDataFlags flags = findLabelDataFlags(label);
@@ -16,6 +16,7 @@ DEFINE_STANDARD_HANDLE(GraphicsPointCloudObjectDriver, GraphicsObjectDriver)
 using GraphicsPointCloudObjectDriverPtr = Handle(GraphicsPointCloudObjectDriver);
 
 // Provides creation and configuration of graphics objects for point clouds
+// Created objects are GraphicsPointCloudObject, which stream octree nodes within a point budget
 class GraphicsPointCloudObjectDriver : public GraphicsObjectDriver {
 public:
     GraphicsPointCloudObjectDriver();
@@ -25,6 +26,7 @@ public:
     void applyDisplayMode(GraphicsObjectPtr object, Enumeration::Value mode) const override;
     Enumeration::Value currentDisplayMode(const GraphicsObjectPtr& object) const override;
     std::unique_ptr<PropertyGroupSignals> properties(Span<const GraphicsObjectPtr> spanObject) const override;
+    void prepareObjects(Span<const GraphicsObjectPtr> spanObject) const override;
 
     static Support pointCloudSupportStatus(const TDF_Label& label);
 
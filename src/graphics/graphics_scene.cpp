@@ -10,9 +10,19 @@
 #include "graphics_utils.h"
 
 #include <Graphic3d_GraphicDriver.hxx>
+#include <OSD_Parallel.hxx>
+#include <Select3D_SensitiveEntity.hxx>
+#include <SelectMgr_SensitiveEntity.hxx>
 #include <V3d_TypeOfOrientation.hxx>
 #include <V3d_AmbientLight.hxx>
 #include <V3d_DirectionalLight.hxx>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
 
 namespace Mayo {
 
@@ -84,8 +94,29 @@ public:
     Handle_V3d_Viewer m_v3dViewer;
     Handle_InteractiveContext m_aisContext;
     std::unordered_set<const AIS_InteractiveObject*> m_setClipPlaneSensitive;
+    std::unordered_set<GraphicsObjectPtr> m_setSelectionOutdated;
     bool m_isRedrawBlocked = false;
     SelectionMode m_selectionMode = SelectionMode::Single;
+    std::atomic<int> m_selectionPrecomputeCount{0};
+    std::vector<std::future<void>> m_vecSelectionPrecompute;
+
+    // Generation of the selection of each object, incremented each time its sensitive entities are
+    // replaced. Precompute tasks skip the entities of outdated generations
+    std::mutex m_mutexSelectionGeneration;
+    std::unordered_map<const AIS_InteractiveObject*, unsigned> m_mapSelectionGeneration;
+
+    unsigned selectionGeneration(const AIS_InteractiveObject* object)
+    {
+        std::lock_guard<std::mutex> lock(m_mutexSelectionGeneration);
+        auto it = m_mapSelectionGeneration.find(object);
+        return it != m_mapSelectionGeneration.cend() ? it->second : 0;
+    }
+
+    void nextSelectionGeneration(const AIS_InteractiveObject* object)
+    {
+        std::lock_guard<std::mutex> lock(m_mutexSelectionGeneration);
+        ++m_mapSelectionGeneration[object];
+    }
 };
 
 GraphicsScene::GraphicsScene()
@@ -97,6 +128,10 @@ GraphicsScene::GraphicsScene()
 
 GraphicsScene::~GraphicsScene()
 {
+    // Worker tasks access the scene, wait for them to finish
+    for (std::future<void>& task : d->m_vecSelectionPrecompute)
+        task.wait();
+
     delete d;
 }
 
@@ -130,16 +165,26 @@ const opencascade::handle<Prs3d_Drawer>& GraphicsScene::drawerHighlight(Prs3d_Ty
     return d->m_aisContext->HighlightStyle(style);
 }
 
-void GraphicsScene::addObject(const GraphicsObjectPtr& object)
+void GraphicsScene::addObject(const GraphicsObjectPtr& object, AddObjectFlags flags)
 {
-    if (object)
+    if (!object)
+        return;
+
+    if (flags & AddObjectDisableSelectionMode) {
+        const int displayMode = object->HasDisplayMode() ? object->DisplayMode() : d->m_aisContext->DisplayMode();
+        d->m_aisContext->Display(object, displayMode, -1/*noSelectionMode*/, false);
+    }
+    else {
         d->m_aisContext->Display(object, false);
+    }
 }
 
 void GraphicsScene::eraseObject(const GraphicsObjectPtr& object)
 {
     GraphicsUtils::AisContext_eraseObject(d->m_aisContext, object);
     d->m_setClipPlaneSensitive.erase(object.get());
+    d->m_setSelectionOutdated.erase(object);
+    d->nextSelectionGeneration(object.get());
 }
 
 void GraphicsScene::redraw()
@@ -177,9 +222,90 @@ void GraphicsScene::blockRedraw(bool on)
 
 void GraphicsScene::recomputeObjectPresentation(const GraphicsObjectPtr& object)
 {
+    d->nextSelectionGeneration(object.get());
     d->m_aisContext->Redisplay(object, false);
 }
 
+void GraphicsScene::recomputeObjectPresentationOnly(const GraphicsObjectPtr& object)
+{
+    d->m_aisContext->RecomputePrsOnly(object, false);
+}
+
+void GraphicsScene::recomputeObjectSelection(const GraphicsObjectPtr& object)
+{
+    d->nextSelectionGeneration(object.get());
+    d->m_aisContext->RecomputeSelectionOnly(object);
+}
+
+void GraphicsScene::invalidateObjectSelection(const GraphicsObjectPtr& object)
+{
+    if (object) {
+        d->nextSelectionGeneration(object.get());
+        d->m_setSelectionOutdated.insert(object);
+    }
+}
+
+void GraphicsScene::precomputeObjectSelection(Span<const GraphicsObjectPtr> spanObject)
+{
+    // Sensitive entities are collected in the calling thread as AIS_InteractiveContext isn't thread-safe
+    // The task works on this snapshot: entities hold the handles of the data they are built from(eg
+    // triangulations), so they stay valid even if the selection of the objects is recomputed meanwhile
+    struct SensitiveItem {
+        GraphicsObjectPtr object;
+        unsigned generation;
+        Handle_Select3D_SensitiveEntity entity;
+    };
+    std::vector<SensitiveItem> vecItem;
+    for (const GraphicsObjectPtr& object : spanObject) {
+        if (!object)
+            continue;
+
+        const unsigned generation = d->selectionGeneration(object.get());
+        this->foreachActiveSelectionMode(object, [&](int mode) {
+            const Handle_SelectMgr_Selection& selection = object->Selection(mode);
+            if (!selection)
+                return;
+
+#if OCC_VERSION_HEX >= OCC_VERSION_CHECK(7, 4, 0)
+            for (const Handle_SelectMgr_SensitiveEntity& entity : selection->Entities())
+                vecItem.push_back({ object, generation, entity->BaseSensitive() });
+#else
+            for (selection->Init(); selection->More(); selection->Next())
+                vecItem.push_back({ object, generation, selection->Sensitive()->BaseSensitive() });
+#endif
+        });
+    }
+
+    if (vecItem.empty())
+        return;
+
+    // Forget about finished tasks
+    auto fnIsTaskFinished = [](const std::future<void>& task) {
+        return task.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+    };
+    auto& vecTask = d->m_vecSelectionPrecompute;
+    vecTask.erase(std::remove_if(vecTask.begin(), vecTask.end(), fnIsTaskFinished), vecTask.end());
+
+    ++d->m_selectionPrecomputeCount;
+    auto fnPrecompute = [this](const std::vector<SensitiveItem>& vecSensitive) {
+        // Entities hold independent BVH trees so they can be built concurrently. Entities replaced
+        // meanwhile(stale generation) aren't used anymore by the selection, they are skipped
+        auto fnBuildBvh = [=](const SensitiveItem& item) {
+            if (item.generation == d->selectionGeneration(item.object.get()))
+                item.entity->BVH();
+        };
+        OSD_Parallel::ForEach(vecSensitive.cbegin(), vecSensitive.cend(), fnBuildBvh);
+        if (--d->m_selectionPrecomputeCount == 0)
+            this->signalPickingReady.send();
+    };
+    vecTask.push_back(std::async(std::launch::async, fnPrecompute, std::move(vecItem)));
+}
+
+bool GraphicsScene::isPickingReady() const
+{
+    return d->m_selectionPrecomputeCount == 0;
+}
+
 void GraphicsScene::activateObjectSelection(const GraphicsObjectPtr& object, int mode)
 {
     d->m_aisContext->Activate(object, mode);
@@ -244,6 +370,12 @@ void GraphicsScene::setObjectVisible(const GraphicsObjectPtr& object, bool on)
     GraphicsUtils::AisContext_setObjectVisible(d->m_aisContext, object, on);
 }
 
+void GraphicsScene::setObjectVisibleInView(const GraphicsObjectPtr& object, const Handle_V3d_View& view, bool on)
+{
+    if (object && view)
+        d->m_aisContext->SetViewAffinity(object, view, on);
+}
+
 gp_Trsf GraphicsScene::objectTransformation(const GraphicsObjectPtr& object) const
 {
     return d->m_aisContext->Location(object);
@@ -288,6 +420,27 @@ void GraphicsScene::toggleOwnerSelection(const GraphicsOwnerPtr& gfxOwner)
 
 void GraphicsScene::highlightAt(int xPos, int yPos, const Handle_V3d_View& view)
 {
+    // Picking would race with the background build of selection structures
+    if (!this->isPickingReady())
+        return;
+
+    if (!d->m_setSelectionOutdated.empty()) {
+        // Sensitive entities have to be created in this thread, but their BVH trees are built in
+        // background. Picking is then resumed once they are ready
+        const std::vector<GraphicsObjectPtr> vecObject(
+                    d->m_setSelectionOutdated.cbegin(), d->m_setSelectionOutdated.cend()
+        );
+        d->m_setSelectionOutdated.clear();
+        for (const GraphicsObjectPtr& object : vecObject) {
+            d->nextSelectionGeneration(object.get());
+            d->m_aisContext->RecomputeSelectionOnly(object);
+        }
+
+        this->precomputeObjectSelection(vecObject);
+        if (!this->isPickingReady())
+            return;
+    }
+
     d->m_aisContext->MoveTo(xPos, yPos, view, false);
 }
 
@@ -7,6 +7,7 @@
 #pragma once
 
 #include "../base/signal.h"
+#include "../base/span.h"
 #include "graphics_object_ptr.h"
 #include "graphics_owner_ptr.h"
 
@@ -37,7 +38,15 @@ public:
     const opencascade::handle<Prs3d_Drawer>& drawerDefault() const;
     const opencascade::handle<Prs3d_Drawer>& drawerHighlight(Prs3d_TypeOfHighlight style) const;
 
-    void addObject(const GraphicsObjectPtr& object);
+    enum AddObjectFlag {
+        AddObjectDefault = 0x0,
+        // Default selection mode isn't activated, avoids computation of selection structures when
+        // the scene is only rendered(eg offscreen image)
+        AddObjectDisableSelectionMode = 0x1
+    };
+    using AddObjectFlags = unsigned;
+
+    void addObject(const GraphicsObjectPtr& object, AddObjectFlags flags = AddObjectDefault);
     void eraseObject(const GraphicsObjectPtr& object);
 
     void redraw();
@@ -46,6 +55,20 @@ public:
     void blockRedraw(bool on);
 
     void recomputeObjectPresentation(const GraphicsObjectPtr& object);
+    // Same as recomputeObjectPresentation() but selection of 'object' is left untouched
+    void recomputeObjectPresentationOnly(const GraphicsObjectPtr& object);
+    void recomputeObjectSelection(const GraphicsObjectPtr& object);
+    // Selection of 'object' will be recomputed on next picking(see highlightAt()), suited to objects
+    // whose sensitive entities change often(eg instances being exploded). BVH trees of the recomputed
+    // selection are then built in background(see precomputeObjectSelection())
+    void invalidateObjectSelection(const GraphicsObjectPtr& object);
+
+    // Builds in background the selection structures(BVH of sensitive entities) of active selection
+    // modes for objects in 'spanObject'. Otherwise OpenCascade builds them synchronously on first
+    // picking, which freezes the view for big models
+    // Picking and dynamic highlighting are suspended until isPickingReady() returns true
+    void precomputeObjectSelection(Span<const GraphicsObjectPtr> spanObject);
+    bool isPickingReady() const;
 
     void activateObjectSelection(const GraphicsObjectPtr& object, int mode);
     void deactivateObjectSelection(const GraphicsObjectPtr& object, int mode);
@@ -62,6 +85,8 @@ public:
 
     bool isObjectVisible(const GraphicsObjectPtr& object) const;
     void setObjectVisible(const GraphicsObjectPtr& object, bool on);
+    // Shows/hides a displayed object in a specific view only, visible state of the object is unchanged
+    void setObjectVisibleInView(const GraphicsObjectPtr& object, const Handle_V3d_View& view, bool on);
 
     gp_Trsf objectTransformation(const GraphicsObjectPtr& object) const;
     void setObjectTransformation(const GraphicsObjectPtr& object, const gp_Trsf& trsf);
@@ -101,6 +126,7 @@ public:
     Signal<> signalSelectionChanged;
     Signal<> signalSelectionModeChanged;
     Signal<const Handle_V3d_View&> signalRedrawRequested;
+    Signal<> signalPickingReady; // Sent from a worker thread
 
 private:
     AIS_InteractiveContext* aisContextPtr() const;
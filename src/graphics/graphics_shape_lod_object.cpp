@@ -0,0 +1,338 @@
+/****************************************************************************
+** Copyright (c) 2023, Fougue Ltd. <http://www.fougue.pro>
+** All rights reserved.
+** See license at https://github.com/fougue/mayo/blob/master/LICENSE.txt
+****************************************************************************/
+
+#include "graphics_shape_lod_object.h"
+
+#include "../base/global.h"
+
+#include <AIS_ColoredDrawer.hxx>
+#include <AIS_DisplayMode.hxx>
+#include <BRep_Tool.hxx>
+#include <Graphic3d_ArrayOfSegments.hxx>
+#include <Graphic3d_ArrayOfTriangles.hxx>
+#include <Graphic3d_Group.hxx>
+#include <Prs3d_LineAspect.hxx>
+#include <Prs3d_ShadingAspect.hxx>
+#include <PrsMgr_Presentation.hxx>
+#include <StdPrs_ShadedShape.hxx>
+#include <StdPrs_ToolTriangulatedShape.hxx>
+#include <TopExp_Explorer.hxx>
+#include <TopTools_DataMapOfShapeInteger.hxx>
+#include <TopoDS.hxx>
+#include <algorithm>
+#include <iterator>
+#include <unordered_map>
+#include <vector>
+
+namespace Mayo {
+
+namespace {
+
+// Display modes of LODs > 0 come after this value
+constexpr int lodDisplayModeBase = 100;
+
+#if OCC_VERSION_HEX >= OCC_VERSION_CHECK(7, 6, 0)
+// Triangulation of 'face' for LOD 'lod', the coarsest one if 'lod' exceeds the count of LODs
+Handle_Poly_Triangulation faceLodTriangulation(const TopoDS_Face& face, int lod, TopLoc_Location& loc)
+{
+    const Poly_ListOfTriangulation& listTriangulation = BRep_Tool::Triangulations(face, loc);
+    if (listTriangulation.IsEmpty())
+        return BRep_Tool::Triangulation(face, loc);
+
+    auto it = listTriangulation.cbegin();
+    std::advance(it, std::clamp(lod, 0, listTriangulation.Size() - 1));
+    return *it;
+}
+
+// Per-node normals of 'triangulation', computed locally when the triangulation doesn't hold them
+// as it's not the active one of the face and so mustn't be altered
+std::vector<gp_Vec> nodeNormals(const Handle_Poly_Triangulation& triangulation)
+{
+    std::vector<gp_Vec> vecNormal(triangulation->NbNodes(), gp_Vec(0, 0, 0));
+    if (triangulation->HasNormals()) {
+        for (int i = 1; i <= triangulation->NbNodes(); ++i)
+            vecNormal[i - 1] = gp_Vec(triangulation->Normal(i).XYZ());
+
+        return vecNormal;
+    }
+
+    for (int i = 1; i <= triangulation->NbTriangles(); ++i) {
+        int n1, n2, n3;
+        triangulation->Triangle(i).Get(n1, n2, n3);
+        const gp_Pnt p1 = triangulation->Node(n1);
+        const gp_Vec triNormal = gp_Vec(p1, triangulation->Node(n2)).Crossed(gp_Vec(p1, triangulation->Node(n3)));
+        for (int n : { n1, n2, n3 })
+            vecNormal[n - 1] += triNormal;
+    }
+
+    for (gp_Vec& normal : vecNormal) {
+        if (normal.SquareMagnitude() > gp::Resolution())
+            normal.Normalize();
+    }
+
+    return vecNormal;
+}
+#endif
+
+} // namespace
+
+GraphicsShapeLodObject::GraphicsShapeLodObject(const TDF_Label& label)
+    : XCAFPrs_AISObject(label)
+{
+}
+
+int GraphicsShapeLodObject::shadedDisplayMode(int lod)
+{
+    return lod > 0 ? lodDisplayModeBase + lod : AIS_Shaded;
+}
+
+int GraphicsShapeLodObject::levelOfDetail(int shadedMode)
+{
+    return shadedMode > lodDisplayModeBase ? shadedMode - lodDisplayModeBase : 0;
+}
+
+bool GraphicsShapeLodObject::isShadedDisplayMode(int mode)
+{
+    return mode == AIS_Shaded || mode > lodDisplayModeBase;
+}
+
+bool GraphicsShapeLodObject::prepareShadedPresentation(int mode)
+{
+#if OCC_VERSION_HEX >= OCC_VERSION_CHECK(7, 6, 0)
+    ShadedData data;
+    if (mode == AIS_Shaded) {
+        if (!this->computeShadedData(&data))
+            return false;
+    }
+    else if (mode > lodDisplayModeBase) {
+        data = this->computeShadedLodData(GraphicsShapeLodObject::levelOfDetail(mode));
+    }
+    else {
+        return false;
+    }
+
+    m_mapPreparedShadedData[mode] = std::move(data);
+    return true;
+#else
+    MAYO_UNUSED(mode);
+    return false;
+#endif
+}
+
+bool GraphicsShapeLodObject::preparePresentations()
+{
+#if OCC_VERSION_HEX >= OCC_VERSION_CHECK(7, 6, 0)
+    bool ok = true;
+    for (const Handle(PrsMgr_Presentation)& prs : this->Presentations())
+        ok = this->prepareShadedPresentation(prs->Mode()) && ok;
+
+    return ok;
+#else
+    return this->Presentations().IsEmpty();
+#endif
+}
+
+bool GraphicsShapeLodObject::AcceptDisplayMode(const int mode) const
+{
+    return mode > lodDisplayModeBase || XCAFPrs_AISObject::AcceptDisplayMode(mode);
+}
+
+void GraphicsShapeLodObject::Compute(
+        const Handle(PrsMgr_PresentationManager)& pm,
+        const Handle(Prs3d_Presentation)& prs,
+        const int mode)
+{
+    // Prepared data reflects the triangulations at the time it was built, so it's used only once
+    auto itPrepared = m_mapPreparedShadedData.find(mode);
+    if (itPrepared != m_mapPreparedShadedData.end()) {
+        const ShadedData data = std::move(itPrepared->second);
+        m_mapPreparedShadedData.erase(itPrepared);
+        // Styles might have been changed since AIS_Shaded was prepared
+        const bool isDataValid =
+                data.faceBoundaryDraw == myDrawer->FaceBoundaryDraw()
+                && (mode != AIS_Shaded || (this->areStylesDispatched() && this->CustomAspectsMap().IsEmpty()));
+        if (isDataValid) {
+            this->addShadedData(prs, data);
+            return;
+        }
+    }
+
+#if OCC_VERSION_HEX >= OCC_VERSION_CHECK(7, 6, 0)
+    if (mode > lodDisplayModeBase) {
+        this->addShadedData(prs, this->computeShadedLodData(GraphicsShapeLodObject::levelOfDetail(mode)));
+        return;
+    }
+#endif
+
+    XCAFPrs_AISObject::Compute(pm, prs, GraphicsShapeLodObject::isShadedDisplayMode(mode) ? AIS_Shaded : mode);
+}
+
+bool GraphicsShapeLodObject::computeShadedData(ShadedData* data) const
+{
+#if OCC_VERSION_HEX >= OCC_VERSION_CHECK(7, 6, 0)
+    // Same as the AIS_Shaded presentation of XCAFPrs_AISObject for a shape with a single style. Other
+    // cases(sub-shape styles, free edges and vertices, texture mapping) are left to XCAFPrs_AISObject
+    if (!this->areStylesDispatched() || !this->CustomAspectsMap().IsEmpty() || myshape.IsNull())
+        return false;
+
+    if (myDrawer->ShadingAspect()->Aspect()->ToMapTexture())
+        return false;
+
+    if (TopExp_Explorer(myshape, TopAbs_EDGE, TopAbs_FACE).More()
+            || TopExp_Explorer(myshape, TopAbs_VERTEX, TopAbs_EDGE).More())
+    {
+        return false;
+    }
+
+    // Faces lacking triangulation would be meshed by Compute()(auto-triangulation)
+    for (TopExp_Explorer expl(myshape, TopAbs_FACE); expl.More(); expl.Next()) {
+        TopLoc_Location loc;
+        if (!BRep_Tool::Triangulation(TopoDS::Face(expl.Current()), loc))
+            return false;
+    }
+
+    ShadedGroup group;
+    group.triangles = StdPrs_ShadedShape::FillTriangles(myshape);
+    if (!group.triangles)
+        return false;
+
+    group.isClosed = StdPrs_ToolTriangulatedShape::IsClosed(myshape);
+    data->vecGroup.push_back(std::move(group));
+    data->faceBoundaryDraw = myDrawer->FaceBoundaryDraw();
+    if (data->faceBoundaryDraw)
+        data->faceBoundaries = StdPrs_ShadedShape::FillFaceBoundaries(myshape, myDrawer->FaceBoundaryUpperContinuity());
+
+    return true;
+#else
+    MAYO_UNUSED(data);
+    return false;
+#endif
+}
+
+GraphicsShapeLodObject::ShadedData GraphicsShapeLodObject::computeShadedLodData(int lod) const
+{
+    ShadedData data;
+#if OCC_VERSION_HEX >= OCC_VERSION_CHECK(7, 6, 0)
+    // LOD display modes are only activated on shaded objects, so styles were already dispatched
+    // by the AIS_Shaded presentation(see XCAFPrs_AISObject::Compute())
+    // Custom aspects of sub-shapes override the ones of their parents, so they are applied from
+    // the coarsest shape type(compound) to the finest one(face)
+    std::vector<std::pair<TopoDS_Shape, Handle_AIS_ColoredDrawer>> vecShapeDrawer;
+    for (AIS_DataMapOfShapeDrawer::Iterator it(this->CustomAspectsMap()); it.More(); it.Next())
+        vecShapeDrawer.push_back({ it.Key(), it.Value() });
+
+    std::stable_sort(vecShapeDrawer.begin(), vecShapeDrawer.end(), [](const auto& lhs, const auto& rhs) {
+        return lhs.first.ShapeType() < rhs.first.ShapeType();
+    });
+
+    TopTools_DataMapOfShapeInteger mapFaceDrawerId; // Index in 'vecShapeDrawer'
+    for (int i = 0; i < int(vecShapeDrawer.size()); ++i) {
+        for (TopExp_Explorer expl(vecShapeDrawer.at(i).first, TopAbs_FACE); expl.More(); expl.Next())
+            mapFaceDrawerId.Bind(expl.Current(), i);
+    }
+
+    // Group faces by shading aspect, one vertex array is created per aspect
+    std::unordered_map<const Prs3d_ShadingAspect*, std::vector<TopoDS_Face>> mapAspectFaces;
+    std::vector<Handle_Prs3d_ShadingAspect> vecAspect;
+    for (TopExp_Explorer expl(myshape, TopAbs_FACE); expl.More(); expl.Next()) {
+        Handle_Prs3d_ShadingAspect aspect = myDrawer->ShadingAspect();
+        const int* ptrDrawerId = mapFaceDrawerId.Seek(expl.Current());
+        if (ptrDrawerId) {
+            const Handle_AIS_ColoredDrawer& drawer = vecShapeDrawer.at(*ptrDrawerId).second;
+            if (drawer->IsHidden())
+                continue;
+
+            if (drawer->HasOwnShadingAspect())
+                aspect = drawer->ShadingAspect();
+        }
+
+        std::vector<TopoDS_Face>& vecFace = mapAspectFaces[aspect.get()];
+        if (vecFace.empty())
+            vecAspect.push_back(aspect);
+
+        vecFace.push_back(TopoDS::Face(expl.Current()));
+    }
+
+    for (const Handle_Prs3d_ShadingAspect& aspect : vecAspect) {
+        const std::vector<TopoDS_Face>& vecFace = mapAspectFaces.at(aspect.get());
+        int nodeCount = 0;
+        int triangleCount = 0;
+        for (const TopoDS_Face& face : vecFace) {
+            TopLoc_Location loc;
+            const Handle_Poly_Triangulation triangulation = faceLodTriangulation(face, lod, loc);
+            if (triangulation) {
+                nodeCount += triangulation->NbNodes();
+                triangleCount += triangulation->NbTriangles();
+            }
+        }
+
+        if (triangleCount == 0)
+            continue;
+
+        Handle_Graphic3d_ArrayOfTriangles array = new Graphic3d_ArrayOfTriangles(
+                    nodeCount, 3 * triangleCount, Graphic3d_ArrayFlags_VertexNormal
+        );
+        for (const TopoDS_Face& face : vecFace) {
+            TopLoc_Location loc;
+            const Handle_Poly_Triangulation triangulation = faceLodTriangulation(face, lod, loc);
+            if (!triangulation)
+                continue;
+
+            const gp_Trsf& trsf = loc.Transformation();
+            const bool isReversed = face.Orientation() == TopAbs_REVERSED;
+            const std::vector<gp_Vec> vecNormal = nodeNormals(triangulation);
+            const int nodeOffset = array->VertexNumber();
+            for (int i = 1; i <= triangulation->NbNodes(); ++i) {
+                gp_Vec normal = vecNormal.at(i - 1).Transformed(trsf);
+                if (isReversed)
+                    normal.Reverse();
+
+                const gp_Dir dir = normal.SquareMagnitude() > gp::Resolution() ? gp_Dir(normal) : gp::DZ();
+                array->AddVertex(triangulation->Node(i).Transformed(trsf), dir);
+            }
+
+            for (int i = 1; i <= triangulation->NbTriangles(); ++i) {
+                int n1, n2, n3;
+                triangulation->Triangle(i).Get(n1, n2, n3);
+                if (isReversed)
+                    std::swap(n2, n3);
+
+                array->AddEdges(nodeOffset + n1, nodeOffset + n2, nodeOffset + n3);
+            }
+        }
+
+        data.vecGroup.push_back({ aspect, array, false/*isClosed*/ });
+    }
+
+    // Face boundaries are the polygons on the active(finest) triangulations, fine enough for the
+    // small size on screen coarser LODs are used for
+    data.faceBoundaryDraw = myDrawer->FaceBoundaryDraw();
+    if (data.faceBoundaryDraw)
+        data.faceBoundaries = StdPrs_ShadedShape::FillFaceBoundaries(myshape, myDrawer->FaceBoundaryUpperContinuity());
+#else
+    MAYO_UNUSED(lod);
+#endif
+    return data;
+}
+
+void GraphicsShapeLodObject::addShadedData(const Handle(Prs3d_Presentation)& prs, const ShadedData& data) const
+{
+    for (const ShadedGroup& shadedGroup : data.vecGroup) {
+        const Handle_Prs3d_ShadingAspect& aspect = shadedGroup.aspect ? shadedGroup.aspect : myDrawer->ShadingAspect();
+        Handle_Graphic3d_Group group = prs->NewGroup();
+        group->SetClosed(shadedGroup.isClosed);
+        group->SetGroupPrimitivesAspect(aspect->Aspect());
+        group->AddPrimitiveArray(shadedGroup.triangles);
+    }
+
+    if (data.faceBoundaries) {
+        Handle_Graphic3d_Group group = prs->NewGroup();
+        group->SetGroupPrimitivesAspect(myDrawer->FaceBoundaryAspect()->Aspect());
+        group->AddPrimitiveArray(data.faceBoundaries);
+    }
+}
+
+} // namespace Mayo
@@ -0,0 +1,86 @@
+/****************************************************************************
+** Copyright (c) 2023, Fougue Ltd. <http://www.fougue.pro>
+** All rights reserved.
+** See license at https://github.com/fougue/mayo/blob/master/LICENSE.txt
+****************************************************************************/
+
+#pragma once
+
+#include "../base/tkernel_utils.h"
+
+#include <Graphic3d_ArrayOfSegments.hxx>
+#include <Graphic3d_ArrayOfTriangles.hxx>
+#include <Prs3d_Presentation.hxx>
+#include <Prs3d_ShadingAspect.hxx>
+#include <PrsMgr_PresentationManager.hxx>
+#include <XCAFPrs_AISObject.hxx>
+#include <unordered_map>
+#include <vector>
+
+namespace Mayo {
+
+// Graphics object of a BRep shape providing its coarser levels of detail(LOD) as extra shaded
+// display modes. LOD presentations are built from the triangulations stored per face(see
+// BRepUtils::computeMeshLods()) without making them active, so the BRep model is left untouched
+// Display modes:
+//     AIS_WireFrame, AIS_Shaded -> same as XCAFPrs_AISObject, AIS_Shaded being LOD 0
+//     shadedDisplayMode(lod) -> shaded LOD 'lod'
+// Shaded presentations can be prepared out of Compute()(see prepareShadedPresentation())
+// Requires OpenCascade >= 7.6, otherwise LOD display modes show the active triangulations and
+// shaded presentations can't be prepared
+class GraphicsShapeLodObject : public XCAFPrs_AISObject {
+public:
+    GraphicsShapeLodObject(const TDF_Label& label);
+
+    // Display mode of the shaded presentation of LOD 'lod'
+    static int shadedDisplayMode(int lod);
+    // LOD of shaded display mode 'mode'
+    static int levelOfDetail(int shadedMode);
+    static bool isShadedDisplayMode(int mode);
+
+    // Whether styles of the label were dispatched to the sub-shapes, otherwise this is done by first
+    // Compute()(see XCAFPrs_AISObject::DispatchStyles())
+    bool areStylesDispatched() const { return !myToUpdateStyles; }
+
+    // Builds the primitive arrays of shaded display mode 'mode', so next computation of that mode
+    // only attaches them to the presentation and doesn't read the face triangulations anymore
+    // AIS_Shaded can be prepared only once styles are dispatched, if all faces are triangulated and
+    // share the style of the object. Returns false if 'mode' can't be prepared
+    // Can be called from worker threads for distinct objects, while they aren't being computed
+    bool prepareShadedPresentation(int mode);
+
+    // Prepares all the presentations computed so far for the object, typically before they are
+    // recomputed. Returns false if any of them can't be prepared
+    bool preparePresentations();
+
+    bool AcceptDisplayMode(const int mode) const override;
+
+    DEFINE_STANDARD_RTTI_INLINE(GraphicsShapeLodObject, XCAFPrs_AISObject)
+
+protected:
+    void Compute(
+            const Handle(PrsMgr_PresentationManager)& pm,
+            const Handle(Prs3d_Presentation)& prs,
+            const int mode) override;
+
+private:
+    struct ShadedGroup {
+        Handle_Prs3d_ShadingAspect aspect; // Null for the one of the object
+        Handle_Graphic3d_ArrayOfTriangles triangles;
+        bool isClosed = false;
+    };
+
+    struct ShadedData {
+        std::vector<ShadedGroup> vecGroup;
+        bool faceBoundaryDraw = false; // Value of Prs3d_Drawer::FaceBoundaryDraw() when built
+        Handle_Graphic3d_ArrayOfSegments faceBoundaries;
+    };
+
+    bool computeShadedData(ShadedData* data) const;
+    ShadedData computeShadedLodData(int lod) const;
+    void addShadedData(const Handle(Prs3d_Presentation)& prs, const ShadedData& data) const;
+
+    std::unordered_map<int, ShadedData> m_mapPreparedShadedData; // Key is display mode
+};
+
+} // namespace Mayo
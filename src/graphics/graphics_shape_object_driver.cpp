@@ -8,14 +8,26 @@
 
 #include "../base/brep_utils.h"
 #include "../base/caf_utils.h"
+#include "../base/global.h"
 #include "../base/triangulation_annex_data.h"
 #include "../base/label_data.h"
+#include "../base/tkernel_utils.h"
 #include "../base/xcaf.h"
+#include "graphics_shape_lod_object.h"
 #include "graphics_utils.h"
 
 #include <AIS_ConnectedInteractive.hxx>
 #include <AIS_DisplayMode.hxx>
-#include <XCAFPrs_AISObject.hxx>
+#include <BRep_Tool.hxx>
+#include <OSD_Parallel.hxx>
+#include <TopTools_MapOfShape.hxx>
+#if OCC_VERSION_HEX >= OCC_VERSION_CHECK(7, 6, 0)
+#  include <BRepLib_ToolTriangulatedShape.hxx>
+#endif
+
+#include <algorithm>
+#include <unordered_set>
+#include <vector>
 
 namespace Mayo {
 
@@ -42,7 +54,7 @@ GraphicsObjectDriver::Support GraphicsShapeObjectDriver::supportStatus(const TDF
 GraphicsObjectPtr GraphicsShapeObjectDriver::createObject(const TDF_Label& label) const
 {
     if (XCaf::isShape(label)) {
-        auto object = new XCAFPrs_AISObject(label);
+        auto object = new GraphicsShapeLodObject(label);
         object->SetDisplayMode(AIS_Shaded);
         object->SetMaterial(Graphic3d_NOM_PLASTER);
         object->Attributes()->SetFaceBoundaryDraw(true);
@@ -75,18 +87,26 @@ void GraphicsShapeObjectDriver::applyDisplayMode(GraphicsObjectPtr object, Enume
             it.Value()->SetComputedMode(on);
     };
 
+    // HLR projections aren't computed by the views(computed mode) as it's synchronous on each camera
+    // change. Instead GuiDocument computes them asynchronously(see GraphicsHlrObject) and objects
+    // are kept shaded until the projection is ready
+    context->DefaultDrawer()->SetTypeOfHLR(Prs3d_TOH_NotSet);
+    fnSetViewComputedMode(false);
     if (mode == DisplayMode_HiddenLineRemoval) {
-        context->DefaultDrawer()->SetTypeOfHLR(Prs3d_TOH_PolyAlgo);
         context->DefaultDrawer()->EnableDrawHiddenLine();
-        fnSetViewComputedMode(true);
+        if (!GraphicsShapeLodObject::isShadedDisplayMode(object->DisplayMode()))
+            context->SetDisplayMode(object, AIS_Shaded, false);
     }
     else {
-        context->DefaultDrawer()->SetTypeOfHLR(Prs3d_TOH_NotSet);
         context->DefaultDrawer()->DisableDrawHiddenLine();
-        fnSetViewComputedMode(false);
         const AIS_DisplayMode aisDispMode = mode == DisplayMode_Wireframe ? AIS_WireFrame : AIS_Shaded;
         const bool showFaceBounds = mode == DisplayMode_ShadedWithFaceBoundary;
-        if (object->DisplayMode() != aisDispMode)
+        // Shaded LOD display mode is kept(see setLevelOfDetail())
+        const bool isAisDispModeActive =
+                aisDispMode == AIS_Shaded ?
+                    GraphicsShapeLodObject::isShadedDisplayMode(object->DisplayMode()) :
+                    object->DisplayMode() == aisDispMode;
+        if (!isAisDispModeActive)
             context->SetDisplayMode(object, aisDispMode, false);
 
         if (object->Attributes()->FaceBoundaryDraw() != showFaceBounds) {
@@ -113,7 +133,7 @@ Enumeration::Value GraphicsShapeObjectDriver::currentDisplayMode(const GraphicsO
     if (displayMode == AIS_WireFrame)
         return DisplayMode_Wireframe;
 
-    if (displayMode == AIS_Shaded) {
+    if (GraphicsShapeLodObject::isShadedDisplayMode(displayMode)) {
         return object->Attributes()->FaceBoundaryDraw() ?
                     DisplayMode_ShadedWithFaceBoundary :
                     DisplayMode_Shaded;
@@ -130,6 +150,104 @@ GraphicsShapeObjectDriver::properties(Span<const GraphicsObjectPtr> spanObject)
     return {};
 }
 
+namespace {
+
+TopoDS_Shape shapeOf(const GraphicsObjectPtr& object)
+{
+    auto aisLink = Handle_AIS_ConnectedInteractive::DownCast(object);
+    auto aisObject = Handle_XCAFPrs_AISObject::DownCast(aisLink ? aisLink->ConnectedTo() : object);
+    return aisObject ? XCaf::shape(aisObject->GetLabel()) : TopoDS_Shape{};
+}
+
+} // namespace
+
+int GraphicsShapeObjectDriver::levelOfDetailCount(const GraphicsObjectPtr& object) const
+{
+    this->throwIf_differentDriver(object);
+#if OCC_VERSION_HEX >= OCC_VERSION_CHECK(7, 6, 0)
+    // All faces hold the same count of LODs, so inspecting the first meshed face is enough
+    int lodCount = 1;
+    BRepUtils::forEachSubFace(shapeOf(object), [&](const TopoDS_Face& face) {
+        if (lodCount == 1) {
+            TopLoc_Location loc;
+            lodCount = std::max(BRep_Tool::Triangulations(face, loc).Size(), 1);
+        }
+    });
+    return lodCount;
+#else
+    return 1;
+#endif
+}
+
+bool GraphicsShapeObjectDriver::isLevelOfDetailComputed(const GraphicsObjectPtr& object, int lod) const
+{
+    this->throwIf_differentDriver(object);
+    const int mode = GraphicsShapeLodObject::shadedDisplayMode(std::clamp(lod, 0, this->levelOfDetailCount(object) - 1));
+    AIS_InteractiveContext* context = GraphicsUtils::AisObject_contextPtr(object);
+    return object->DisplayMode() == mode || (context && context->MainPrsMgr()->HasPresentation(object, mode));
+}
+
+bool GraphicsShapeObjectDriver::setLevelOfDetail(const GraphicsObjectPtr& object, int lod) const
+{
+    this->throwIf_differentDriver(object);
+    // LODs are shaded display modes of GraphicsShapeLodObject, presentation of each LOD is computed
+    // once and kept by the presentation manager. Instances(AIS_ConnectedInteractive) share the LOD
+    // presentations of their product but activate them independently
+    AIS_InteractiveContext* context = GraphicsUtils::AisObject_contextPtr(object);
+    if (!context || !GraphicsShapeLodObject::isShadedDisplayMode(object->DisplayMode()))
+        return false;
+
+    const int mode = GraphicsShapeLodObject::shadedDisplayMode(std::clamp(lod, 0, this->levelOfDetailCount(object) - 1));
+    if (object->DisplayMode() == mode)
+        return false;
+
+    context->SetDisplayMode(object, mode, false);
+    return true;
+}
+
+void GraphicsShapeObjectDriver::prepareObjects(Span<const GraphicsObjectPtr> spanObject) const
+{
+    this->throwIf_differentDriver(spanObject);
+#if OCC_VERSION_HEX >= OCC_VERSION_CHECK(7, 6, 0)
+    // Shaded presentation computes and stores normals of face triangulations lacking them, this is
+    // done here in parallel over the faces. Faces are deduplicated as products might share faces
+    TopTools_MapOfShape mapFace;
+    std::vector<TopoDS_Face> vecFace;
+    for (const GraphicsObjectPtr& object : spanObject) {
+        BRepUtils::forEachSubFace(shapeOf(object), [&](const TopoDS_Face& face) {
+            if (mapFace.Add(face.Located(TopLoc_Location())))
+                vecFace.push_back(face);
+        });
+    }
+
+    OSD_Parallel::ForEach(vecFace.cbegin(), vecFace.cend(), [](const TopoDS_Face& face) {
+        TopLoc_Location loc;
+        const Handle_Poly_Triangulation& triangulation = BRep_Tool::Triangulation(face, loc);
+        if (triangulation && !triangulation->HasNormals())
+            BRepLib_ToolTriangulatedShape::ComputeNormals(face, triangulation);
+    });
+
+    // Then shaded presentations of the products are built in parallel, so displaying the objects
+    // only attaches the primitive arrays. Styles are dispatched beforehand as that reads the document
+    std::vector<Handle(GraphicsShapeLodObject)> vecLodObject;
+    std::unordered_set<const GraphicsShapeLodObject*> setLodObject;
+    for (const GraphicsObjectPtr& object : spanObject) {
+        auto aisLink = Handle_AIS_ConnectedInteractive::DownCast(object);
+        auto lodObject = Handle(GraphicsShapeLodObject)::DownCast(aisLink ? aisLink->ConnectedTo() : object);
+        if (lodObject && setLodObject.insert(lodObject.get()).second) {
+            if (!lodObject->areStylesDispatched())
+                lodObject->DispatchStyles();
+
+            vecLodObject.push_back(lodObject);
+        }
+    }
+
+    OSD_Parallel::ForEach(vecLodObject.cbegin(), vecLodObject.cend(), [](const Handle(GraphicsShapeLodObject)& object) {
+        object->prepareShadedPresentation(AIS_Shaded);
+    });
+#endif
+}
+
 GraphicsObjectDriver::Support GraphicsShapeObjectDriver::shapeSupportStatus(const TDF_Label& label)
 {
     const LabelDataFlags flags = findLabelDataFlags(label);
@@ -25,6 +25,17 @@ public:
     Enumeration::Value currentDisplayMode(const GraphicsObjectPtr& object) const override;
     std::unique_ptr<PropertyGroupSignals> properties(Span<const GraphicsObjectPtr> spanObject) const override;
 
+    // LODs are the triangulations stored per face of the BRep shape(see BRepUtils::computeMeshLods())
+    // and are displayed as shaded display modes(see GraphicsShapeLodObject)
+    // Requires OpenCascade >= 7.6
+    int levelOfDetailCount(const GraphicsObjectPtr& object) const override;
+    bool isLevelOfDetailComputed(const GraphicsObjectPtr& object, int lod) const override;
+    bool setLevelOfDetail(const GraphicsObjectPtr& object, int lod) const override;
+    // Computes the normals of face triangulations lacking them, then the primitive arrays of the
+    // shaded presentations(see GraphicsShapeLodObject::prepareShadedPresentation())
+    // Requires OpenCascade >= 7.6
+    void prepareObjects(Span<const GraphicsObjectPtr> spanObject) const override;
+
     static Support shapeSupportStatus(const TDF_Label& label);
 
     enum DisplayMode {
@@ -45,6 +45,7 @@ struct GuiApplication::Private {
     SignalConnectionHandle m_connApplicationItemSelectionChanged;
     ApplicationItemSelectionModel m_selectionModel;
     bool m_automaticDocumentMapping = true;
+    std::mutex* m_brepMeshMutex = nullptr;
 };
 
 GuiApplication::GuiApplication(const ApplicationPtr& app)
@@ -139,6 +140,16 @@ void GuiApplication::setAutomaticDocumentMapping(bool on)
     d->m_automaticDocumentMapping = on;
 }
 
+std::mutex* GuiApplication::brepMeshMutex() const
+{
+    return d->m_brepMeshMutex;
+}
+
+void GuiApplication::setBRepMeshMutex(std::mutex* mutex)
+{
+    d->m_brepMeshMutex = mutex;
+}
+
 void GuiApplication::onDocumentAdded(const DocumentPtr& doc)
 {
     if (d->m_automaticDocumentMapping) {
@@ -13,6 +13,7 @@
 #include "gui_document.h"
 
 #include <memory>
+#include <mutex>
 
 namespace Mayo {
 
@@ -57,6 +58,12 @@ public:
     bool automaticDocumentMapping() const;
     void setAutomaticDocumentMapping(bool on);
 
+    // Mutex held by any code changing the triangulations of BRep shapes concurrently with the
+    // graphics(eg background meshing). GuiDocument locks it whenever face triangulations are read
+    // Null by default, meaning triangulations are never changed by another thread
+    std::mutex* brepMeshMutex() const;
+    void setBRepMeshMutex(std::mutex* mutex);
+
     // Signals
     mutable Signal<GuiDocument*> signalGuiDocumentAdded;
     mutable Signal<GuiDocument*> signalGuiDocumentErased;
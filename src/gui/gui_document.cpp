@@ -14,6 +14,12 @@
 #include "../base/document.h"
 #include "../base/math_utils.h"
 #include "../base/tkernel_utils.h"
+#include "../base/xcaf.h"
+#include "../graphics/graphics_mesh_array_object.h"
+#include "../graphics/graphics_mesh_lods.h"
+#include "../graphics/graphics_point_cloud_object.h"
+#include "../graphics/graphics_shape_lod_object.h"
+#include "../graphics/graphics_shape_object_driver.h"
 #include "../graphics/graphics_utils.h"
 #include "../gui/gui_application.h"
 
@@ -21,17 +27,33 @@
 #  include <AIS_ViewCube.hxx>
 #endif
 #include <AIS_ConnectedInteractive.hxx>
+#include <AIS_Shape.hxx>
 #include <AIS_Trihedron.hxx>
+#include <BRep_Builder.hxx>
+#include <Bnd_Box2d.hxx>
 #include <Geom_Axis2Placement.hxx>
 #include <Graphic3d_GraphicDriver.hxx>
+#include <OSD_Parallel.hxx>
+#include <TopExp_Explorer.hxx>
+#include <TopoDS_Compound.hxx>
 #include <V3d_TypeOfOrientation.hxx>
+#include <XCAFPrs.hxx>
+#include <XCAFPrs_IndexedDataMapOfShapeStyle.hxx>
 
+#include <algorithm>
 #include <cmath>
+#include <unordered_set>
 
 namespace Mayo {
 
 namespace Internal {
 
+static int& guiDocumentMinimumInstanceCount()
+{
+    static int count = 16;
+    return count;
+}
+
 static Handle_AIS_Trihedron createOriginTrihedron()
 {
     Handle_Geom_Axis2Placement axis = new Geom_Axis2Placement(gp::XOY());
@@ -65,6 +87,24 @@ static GuiDocument::GradientBackground& defaultGradientBackground()
     return defaultGradientBackground;
 }
 
+// Stops background work of 'object'(node streaming of point clouds, computation of mesh LODs), its
+// queued slots are no-op from now on
+static void cancelGraphicsObject(const GraphicsObjectPtr& object)
+{
+    auto pntCloudObject = Handle(GraphicsPointCloudObject)::DownCast(object);
+    if (pntCloudObject) {
+        pntCloudObject->cancel();
+        pntCloudObject->signalNodesLoaded.disconnectAll(); // Slot holds a handle to the object
+    }
+
+    auto driver = GraphicsObjectDriver::get(object);
+    GraphicsMeshLodsBase* meshLods = driver ? driver->meshLevelsOfDetail(object) : nullptr;
+    if (meshLods) {
+        meshLods->cancel();
+        meshLods->signalLevelOfDetailAdded.disconnectAll(); // Slot holds a handle to the object
+    }
+}
+
 } // namespace Internal
 
 GuiDocument::GuiDocument(const DocumentPtr& doc, GuiApplication* guiApp)
@@ -102,8 +142,11 @@ GuiDocument::GuiDocument(const DocumentPtr& doc, GuiApplication* guiApp)
 
     m_cameraAnimation->setView(m_v3dView);
 
+    std::vector<TreeNodeId> vecEntityTreeNodeId;
     for (int i = 0; i < doc->entityCount(); ++i)
-        this->mapEntity(doc->entityTreeNodeId(i));
+        vecEntityTreeNodeId.push_back(doc->entityTreeNodeId(i));
+
+    this->mapEntities(vecEntityTreeNodeId);
 
     doc->signalEntityAdded.connectSlot(&GuiDocument::onDocumentEntityAdded, this);
     doc->signalEntityAboutToBeDestroyed.connectSlot(&GuiDocument::onDocumentEntityAboutToBeDestroyed, this);
@@ -149,6 +192,16 @@ void GuiDocument::setDevicePixelRatio(double ratio)
 
 GuiDocument::~GuiDocument()
 {
+    if (m_hlrObject) {
+        m_hlrObject->cancel();
+        m_hlrObject->signalProjectionReady.disconnectAll(); // Slot holds a handle to the HLR object
+    }
+
+    for (const GraphicsEntity& gfxEntity : m_vecGraphicsEntity) {
+        for (const GraphicsEntity::Object& object : gfxEntity.vecObject)
+            Internal::cancelGraphicsObject(object.ptr);
+    }
+
     delete m_cameraAnimation;
 }
 
@@ -163,27 +216,254 @@ void GuiDocument::foreachGraphicsObject(
     if (!ptrItem)
         return;
 
+    std::unordered_set<GraphicsObjectPtr> setInstancedObject;
     traverseTree(nodeId, docModelTree, [&](TreeNodeId id) {
         GraphicsObjectPtr gfxObject = CppUtils::findValue(id, ptrItem->mapTreeNodeGfxObject);
         if (gfxObject)
             fn(gfxObject);
+
+        auto itInstance = ptrItem->mapTreeNodeInstance.find(id);
+        if (itInstance != ptrItem->mapTreeNodeInstance.cend()) {
+            const GraphicsObjectPtr gfxInstanced = itInstance->second.ptr;
+            if (setInstancedObject.insert(gfxInstanced).second)
+                fn(gfxInstanced);
+        }
     });
 }
 
+void GuiDocument::recomputeGraphics(TreeNodeId nodeId)
+{
+    auto brepMeshLock = this->lockBRepMesh();
+    // Instances(AIS_ConnectedInteractive) share the presentation of their product, so recompute the
+    // connected object once instead of each instance
+    std::unordered_set<GraphicsObjectPtr> setRecomputedObject;
+    this->foreachGraphicsObject(nodeId, [&](GraphicsObjectPtr object) {
+        // Instanced objects hold the triangulations they were created with
+        auto gfxInstanced = Handle(GraphicsInstancedMeshObject)::DownCast(object);
+        if (gfxInstanced) {
+            gfxInstanced->updateTriangulations();
+            this->recomputeInstancedObject(gfxInstanced);
+            return;
+        }
+
+        auto aisLink = Handle_AIS_ConnectedInteractive::DownCast(object);
+        const GraphicsObjectPtr objectToRecompute =
+                aisLink && aisLink->HasConnection() ? aisLink->ConnectedTo() : object;
+        if (setRecomputedObject.insert(objectToRecompute).second)
+            m_gfxScene.recomputeObjectPresentation(objectToRecompute);
+    });
+    this->invalidateHiddenLineRemoval(true); // Triangulations might have changed
+    m_gfxScene.redraw();
+}
+
+void GuiDocument::recomputeBRepMeshGraphics(TreeNodeId entityTreeNodeId, Span<const TopoDS_Face> spanFace)
+{
+    std::unordered_set<const TopoDS_TShape*> setFaceChanged;
+    for (const TopoDS_Face& face : spanFace)
+        setFaceChanged.insert(face.TShape().get());
+
+    // Topology isn't changed by meshing, so shapes can be explored without locking BRep meshes
+    auto fnHasFaceChanged = [&](const TopoDS_Shape& shape) {
+        for (TopExp_Explorer expl(shape, TopAbs_FACE); expl.More(); expl.Next()) {
+            if (setFaceChanged.find(expl.Current().TShape().get()) != setFaceChanged.cend())
+                return true;
+        }
+
+        return false;
+    };
+
+    std::vector<Handle(GraphicsInstancedMeshObject)> vecInstanced;
+    std::vector<GraphicsObjectPtr> vecPrepared;
+    bool isRecomputed = false;
+    {
+        auto brepMeshLock = this->lockBRepMesh();
+        std::unordered_set<GraphicsObjectPtr> setVisitedObject;
+        this->foreachGraphicsObject(entityTreeNodeId, [&](GraphicsObjectPtr object) {
+            // Instanced objects hold the triangulations they were created with
+            auto gfxInstanced = Handle(GraphicsInstancedMeshObject)::DownCast(object);
+            if (gfxInstanced) {
+                if (fnHasFaceChanged(gfxInstanced->shape())) {
+                    gfxInstanced->updateTriangulations();
+                    vecInstanced.push_back(gfxInstanced);
+                }
+
+                return;
+            }
+
+            // Instances(AIS_ConnectedInteractive) share the presentation of their product
+            auto aisLink = Handle_AIS_ConnectedInteractive::DownCast(object);
+            const GraphicsObjectPtr product = aisLink && aisLink->HasConnection() ? aisLink->ConnectedTo() : object;
+            if (!setVisitedObject.insert(product).second)
+                return;
+
+            auto lodObject = Handle(GraphicsShapeLodObject)::DownCast(product);
+            if (lodObject && !fnHasFaceChanged(XCaf::shape(lodObject->GetLabel())))
+                return;
+
+            if (lodObject && lodObject->preparePresentations()) {
+                // Sensitive entities hold the triangulations they are built from
+                m_gfxScene.recomputeObjectSelection(product);
+                vecPrepared.push_back(product);
+            }
+            else {
+                m_gfxScene.recomputeObjectPresentation(product);
+                isRecomputed = true;
+            }
+        });
+    }
+
+    for (const Handle(GraphicsInstancedMeshObject)& gfxInstanced : vecInstanced)
+        this->recomputeInstancedObject(gfxInstanced);
+
+    for (const GraphicsObjectPtr& object : vecPrepared)
+        m_gfxScene.recomputeObjectPresentationOnly(object);
+
+    if (isRecomputed || !vecInstanced.empty() || !vecPrepared.empty()) {
+        this->invalidateHiddenLineRemoval(true); // Triangulations have changed
+        m_gfxScene.redraw();
+    }
+}
+
+void GuiDocument::updateLevelOfDetail()
+{
+    // Ratio between two subsequent LODs of the size on screen they are suited for
+    constexpr double lodScreenSizeRatio = 4.;
+    // Interactive rendering quality favors the next coarser LOD
+    const bool isInteractive = m_renderingQuality == RenderingQuality::Interactive;
+    const int lodBias = isInteractive ? 1 : 0;
+
+    // LODs might be computed in background before the view is attached to a window
+    if (!m_v3dView->Window())
+        return;
+
+    Standard_Integer viewWidth = 0;
+    Standard_Integer viewHeight = 0;
+    m_v3dView->Window()->Size(viewWidth, viewHeight);
+    const double viewSize = std::max(viewWidth, viewHeight);
+    if (viewSize <= 0)
+        return;
+
+    // Projected size of a bounding box in the view, in pixels
+    // Returns zero if the box is completely outside of the view
+    auto fnScreenSize = [=](const Bnd_Box& box) -> double {
+        if (box.IsVoid())
+            return 0.;
+
+        const auto coords = BndBoxCoords::get(box);
+        Bnd_Box2d screenBox;
+        for (const gp_Pnt& pnt : coords.vertices()) {
+            Standard_Integer xp, yp;
+            m_v3dView->Convert(pnt.X(), pnt.Y(), pnt.Z(), xp, yp);
+            screenBox.Add(gp_Pnt2d(xp, yp));
+        }
+
+        double xMin, yMin, xMax, yMax;
+        screenBox.Get(xMin, yMin, xMax, yMax);
+        if (xMax < 0 || yMax < 0 || xMin > viewWidth || yMin > viewHeight)
+            return 0.;
+
+        return std::max(xMax - xMin, yMax - yMin);
+    };
+
+    // Instances(AIS_ConnectedInteractive) share the LOD presentations of their product, but each
+    // one activates the LOD corresponding to its own size on screen
+    std::vector<std::pair<GraphicsObjectPtr, double>> vecObjectScreenSize;
+    for (const GraphicsEntity& gfxEntity : m_vecGraphicsEntity) {
+        for (const GraphicsEntity::Object& object : gfxEntity.vecObject) {
+            const double screenSize = object.ptr->IsInfinite() ? viewSize : fnScreenSize(object.bndBox);
+            vecObjectScreenSize.push_back({ object.ptr, screenSize });
+        }
+    }
+
+    // Presentations of LODs are computed from face triangulations on first activation
+    auto brepMeshLock = this->lockBRepMesh();
+    bool lodChanged = false;
+    for (const auto& [object, screenSize] : vecObjectScreenSize) {
+        auto driver = GraphicsObjectDriver::get(object);
+        const int lodCount = driver ? driver->levelOfDetailCount(object) : 1;
+        if (lodCount < 2)
+            continue;
+
+        int lod = lodCount - 1;
+        if (screenSize > 0) {
+            const double sizeRatio = viewSize / screenSize;
+            const double lodReal = sizeRatio > 1 ? std::log(sizeRatio) / std::log(lodScreenSizeRatio) : 0.;
+            lod = std::min(static_cast<int>(lodReal) + lodBias, lodCount - 1);
+        }
+
+        // No presentation is computed while the camera is manipulated, the nearest coarser LOD
+        // already computed is activated instead. Active LOD is kept if there's none
+        if (isInteractive) {
+            while (lod < lodCount && !driver->isLevelOfDetailComputed(object, lod))
+                ++lod;
+
+            if (lod == lodCount)
+                continue;
+        }
+
+        if (driver->setLevelOfDetail(object, lod))
+            lodChanged = true;
+    }
+
+    // Point clouds select their octree nodes by size on screen, within a point budget. The selection
+    // isn't updated while the camera is manipulated, so nodes outside the view are kept meanwhile
+    const int pointBudget =
+            isInteractive ? GraphicsPointCloudObject::interactivePointBudget() : GraphicsPointCloudObject::pointBudget();
+    for (const auto& [object, screenSize] : vecObjectScreenSize) {
+        auto pntCloudObject = Handle(GraphicsPointCloudObject)::DownCast(object);
+        if (pntCloudObject && pntCloudObject->updateVisibleNodes(m_v3dView, pointBudget, !isInteractive)) {
+            m_gfxScene.recomputeObjectPresentation(object);
+            m_gfxScene.invalidateObjectSelection(object);
+            lodChanged = true;
+        }
+    }
+
+    if (lodChanged)
+        m_gfxScene.redraw();
+}
+
 TreeNodeId GuiDocument::nodeFromGraphicsObject(const GraphicsObjectPtr& gfxObject) const
 {
     if (!gfxObject)
         return 0;
 
-    for (const GraphicsEntity& gfxEntity: m_vecGraphicsEntity) {
-        auto it = gfxEntity.mapGfxObjectTreeNode.find(gfxObject);
-        if (it != gfxEntity.mapGfxObjectTreeNode.cend())
-            return it->second;
-    }
+    const TreeNodeId entityTreeNodeId = CppUtils::findValue(gfxObject, m_mapGfxObjectEntityTreeNode);
+    const GraphicsEntity* gfxEntity = this->findGraphicsEntity(entityTreeNodeId);
+    return gfxEntity ? CppUtils::findValue(gfxObject, gfxEntity->mapGfxObjectTreeNode) : 0;
+}
+
+TreeNodeId GuiDocument::nodeFromGraphicsOwner(const GraphicsOwnerPtr& gfxOwner) const
+{
+    if (!gfxOwner)
+        return 0;
+
+    auto gfxObject = GraphicsObjectPtr::DownCast(gfxOwner->Selectable());
+    auto instanceOwner = Handle(GraphicsInstanceOwner)::DownCast(gfxOwner);
+    if (!instanceOwner)
+        return this->nodeFromGraphicsObject(gfxObject);
+
+    const TreeNodeId entityTreeNodeId = CppUtils::findValue(gfxObject, m_mapGfxObjectEntityTreeNode);
+    const GraphicsEntity* gfxEntity = this->findGraphicsEntity(entityTreeNodeId);
+    if (!gfxEntity)
+        return 0;
+
+    auto it = gfxEntity->mapInstancedObjectTreeNodes.find(gfxObject);
+    if (it != gfxEntity->mapInstancedObjectTreeNodes.cend())
+        return it->second.at(instanceOwner->instanceIndex());
 
     return 0;
 }
 
+int GuiDocument::minimumInstanceCount()
+{
+    return Internal::guiDocumentMinimumInstanceCount();
+}
+
+void GuiDocument::setMinimumInstanceCount(int count)
+{
+    Internal::guiDocumentMinimumInstanceCount() = count;
+}
+
 void GuiDocument::toggleItemSelected(const ApplicationItem& appItem)
 {
     const DocumentPtr doc = appItem.document();
@@ -201,6 +481,13 @@ void GuiDocument::toggleItemSelected(const ApplicationItem& appItem)
             GraphicsObjectPtr gfxObject = CppUtils::findValue(id, gfxEntity->mapTreeNodeGfxObject);
             if (gfxObject)
                 m_gfxScene.toggleOwnerSelection(gfxObject->GlobalSelOwner());
+
+            auto itInstance = gfxEntity->mapTreeNodeInstance.find(id);
+            if (itInstance != gfxEntity->mapTreeNodeInstance.cend()) {
+                const GraphicsEntity::Instance& instance = itInstance->second;
+                if (instance.ptr->isInstanceVisible(instance.index))
+                    m_gfxScene.toggleOwnerSelection(instance.ptr->instanceOwner(instance.index));
+            }
         });
     }
 }
@@ -226,12 +513,18 @@ void GuiDocument::setActiveDisplayMode(const GraphicsObjectDriverPtr& driver, in
         return;
 
     m_mapGfxDriverDisplayMode.insert_or_assign(driver, mode);
-    for (const TreeNodeId entityNodeId : m_document->modelTree().roots()) {
-        this->foreachGraphicsObject(entityNodeId, [&](GraphicsObjectPtr object) {
-            if (GraphicsObjectDriver::get(object) == driver)
-                driver->applyDisplayMode(object, mode);
-        });
+    {
+        auto brepMeshLock = this->lockBRepMesh();
+        for (const TreeNodeId entityNodeId : m_document->modelTree().roots()) {
+            this->foreachGraphicsObject(entityNodeId, [&](GraphicsObjectPtr object) {
+                if (GraphicsObjectDriver::get(object) == driver)
+                    driver->applyDisplayMode(object, mode);
+            });
+        }
     }
+
+    if (GraphicsShapeObjectDriverPtr::DownCast(driver))
+        this->setHiddenLineRemovalOn(mode == GraphicsShapeObjectDriver::DisplayMode_HiddenLineRemoval);
 }
 
 CheckState GuiDocument::nodeVisibleState(TreeNodeId nodeId) const
@@ -242,13 +535,36 @@ CheckState GuiDocument::nodeVisibleState(TreeNodeId nodeId) const
 
 void GuiDocument::setNodeVisible(TreeNodeId nodeId, bool on)
 {
-    auto itNode = m_mapTreeNodeCheckState.find(nodeId);
-    if (itNode == m_mapTreeNodeCheckState.end())
-        return; // Error: unknown tree node
+    this->setNodesVisible({ { nodeId, on } });
+}
 
-    const CheckState nodeVisibleState = on ? CheckState::On : CheckState::Off;
-    if (itNode->second == nodeVisibleState)
-        return; // Same visible state
+void GuiDocument::setNodesVisible(const std::unordered_map<TreeNodeId, bool>& mapNodeVisible)
+{
+    const Tree<TDF_Label>& docModelTree = m_document->modelTree();
+    auto fnNodeDepth = [&](TreeNodeId id) {
+        int depth = 0;
+        while ((id = docModelTree.nodeParent(id)) != 0)
+            ++depth;
+
+        return depth;
+    };
+
+    // Input nodes, ancestors first
+    struct NodeVisible {
+        TreeNodeId id;
+        bool on;
+        int depth;
+    };
+    std::vector<NodeVisible> vecInputNode;
+    for (const auto& [nodeId, on] : mapNodeVisible) {
+        if (m_mapTreeNodeCheckState.find(nodeId) != m_mapTreeNodeCheckState.cend())
+            vecInputNode.push_back({ nodeId, on, fnNodeDepth(nodeId) });
+        // else -> Error: unknown tree node
+    }
+
+    std::sort(vecInputNode.begin(), vecInputNode.end(), [](const NodeVisible& lhs, const NodeVisible& rhs) {
+        return lhs.depth < rhs.depth;
+    });
 
     // Helper data/function to keep track of all the nodes whose visibility state are altered
     std::unordered_map<TreeNodeId, CheckState> mapNodeIdVisibleState;
@@ -264,43 +580,110 @@ void GuiDocument::setNodeVisible(TreeNodeId nodeId, bool on)
         }
     };
 
-    // Recursive show/hide of the input node graphics
-    const Tree<TDF_Label>& docModelTree = m_document->modelTree();
-    traverseTree(nodeId, docModelTree , [=](TreeNodeId id) {
-        fnSetNodeVisibleState(id, nodeVisibleState);
-    });
-    this->foreachGraphicsObject(nodeId, [=](GraphicsObjectPtr gfxObject) {
+    // Recursive show/hide of the input nodes, graphics visible states are collected first so each
+    // graphics object is toggled once even if it's below several input nodes
+    std::vector<NodeVisible> vecNodeVisible; // Input nodes whose visible state actually changed
+    std::unordered_map<GraphicsObjectPtr, bool> mapGfxObjectVisible;
+    std::unordered_map<const GraphicsEntity::Instance*, bool> mapInstanceVisible;
+    for (const NodeVisible& node : vecInputNode) {
+        const CheckState nodeVisibleState = node.on ? CheckState::On : CheckState::Off;
+        if (this->nodeVisibleState(node.id) == nodeVisibleState)
+            continue; // Same visible state(possibly set by an ancestor input node)
+
+        vecNodeVisible.push_back(node);
+        traverseTree(node.id, docModelTree, [&](TreeNodeId id) {
+            fnSetNodeVisibleState(id, nodeVisibleState);
+        });
+        this->foreachGraphicsObject(node.id, [&](GraphicsObjectPtr gfxObject) {
+            // Visible state of instances is handled below
+            if (!Handle(GraphicsInstancedMeshObject)::DownCast(gfxObject))
+                mapGfxObjectVisible.insert_or_assign(gfxObject, node.on);
+        });
+
+        const GraphicsEntity* gfxEntity = this->findGraphicsEntity(docModelTree.nodeRoot(node.id));
+        if (gfxEntity && !gfxEntity->mapTreeNodeInstance.empty()) {
+            traverseTree(node.id, docModelTree, [&](TreeNodeId id) {
+                auto itInstance = gfxEntity->mapTreeNodeInstance.find(id);
+                if (itInstance != gfxEntity->mapTreeNodeInstance.cend())
+                    mapInstanceVisible.insert_or_assign(&itInstance->second, node.on);
+            });
+        }
+    }
+
+    if (vecNodeVisible.empty())
+        return;
+
+    for (const auto& [gfxObject, on] : mapGfxObjectVisible)
         GraphicsUtils::AisObject_setVisible(gfxObject, on);
-    });
 
-    // Keep selection state of the input node: in case the node graphics are "shown" back again then
-    // AIS object selection status is lost
-    const ApplicationItem appItem({ m_document, nodeId });
-    bool isAppItemSelected = m_guiApp->selectionModel()->isSelected(appItem);
-    if (!isAppItemSelected) { // Check if a parent is selected
-        TreeNodeId parentId = docModelTree.nodeParent(nodeId);
-        while (parentId != 0 && !isAppItemSelected) {
-            const ApplicationItem parentAppItem({ m_document, parentId });
-            isAppItemSelected = m_guiApp->selectionModel()->isSelected(parentAppItem);
-            parentId = docModelTree.nodeParent(parentId);
+    // Instances drawn by GraphicsInstancedMeshObject objects
+    std::unordered_set<GraphicsObjectPtr> setInstancedObject;
+    for (const auto& [ptrInstance, on] : mapInstanceVisible) {
+        const GraphicsEntity::Instance& instance = *ptrInstance;
+        const Handle(GraphicsInstanceOwner)& owner = instance.ptr->instanceOwner(instance.index);
+        // Same as for AIS objects: selection status of an instance is lost when hidden
+        if (!on && owner->IsSelected())
+            m_gfxScene.toggleOwnerSelection(owner);
+
+        if (instance.ptr->isInstanceVisible(instance.index) != on) {
+            instance.ptr->setInstanceVisible(instance.index, on);
+            setInstancedObject.insert(instance.ptr);
         }
     }
 
-    if (on && isAppItemSelected)
-        this->toggleItemSelected(appItem);
+    // Only the arrays of changed instances are rebuilt
+    for (const GraphicsObjectPtr& gfxObject : setInstancedObject) {
+        Handle(GraphicsInstancedMeshObject)::DownCast(gfxObject)->updatePresentation();
+        m_gfxScene.invalidateObjectSelection(gfxObject);
+    }
 
-    // Keep selection state of input node children
-    traverseTree(nodeId, docModelTree, [=](TreeNodeId id) {
-        if (id != nodeId) {
-            const ApplicationItem childAppItem({ m_document, id });
-            if (on && m_guiApp->selectionModel()->isSelected(childAppItem))
-                this->toggleItemSelected(childAppItem);
+    // Keep selection state of the shown nodes: in case the node graphics are "shown" back again then
+    // AIS object selection status is lost
+    ApplicationItemSelectionModel* appSelectionModel = m_guiApp->selectionModel();
+    for (const NodeVisible& node : vecNodeVisible) {
+        if (!node.on)
+            continue;
+
+        const ApplicationItem appItem({ m_document, node.id });
+        bool isAppItemSelected = appSelectionModel->isSelected(appItem);
+        if (!isAppItemSelected) { // Check if a parent is selected
+            TreeNodeId parentId = docModelTree.nodeParent(node.id);
+            while (parentId != 0 && !isAppItemSelected) {
+                const ApplicationItem parentAppItem({ m_document, parentId });
+                isAppItemSelected = appSelectionModel->isSelected(parentAppItem);
+                parentId = docModelTree.nodeParent(parentId);
+            }
         }
-    });
 
-    // Parent nodes check state
-    TreeNodeId parentId = docModelTree.nodeParent(nodeId);
-    while (parentId != 0) {
+        if (isAppItemSelected)
+            this->toggleItemSelected(appItem);
+
+        // Keep selection state of input node children
+        traverseTree(node.id, docModelTree, [&](TreeNodeId id) {
+            if (id != node.id) {
+                const ApplicationItem childAppItem({ m_document, id });
+                if (appSelectionModel->isSelected(childAppItem))
+                    this->toggleItemSelected(childAppItem);
+            }
+        });
+    }
+
+    // Parent nodes check state, computed once for each parent from the deepest to the upmost
+    std::unordered_map<TreeNodeId, int> mapParentDepth;
+    for (const NodeVisible& node : vecNodeVisible) {
+        TreeNodeId parentId = docModelTree.nodeParent(node.id);
+        int parentDepth = node.depth - 1;
+        while (parentId != 0 && mapParentDepth.insert({ parentId, parentDepth }).second) {
+            parentId = docModelTree.nodeParent(parentId);
+            --parentDepth;
+        }
+    }
+
+    std::vector<std::pair<TreeNodeId, int>> vecParentDepth(mapParentDepth.cbegin(), mapParentDepth.cend());
+    std::sort(vecParentDepth.begin(), vecParentDepth.end(), [](const auto& lhs, const auto& rhs) {
+        return lhs.second > rhs.second;
+    });
+    for (const auto& [parentId, parentDepth] : vecParentDepth) {
         int childCount = 0;
         int checkedCount = 0;
         int uncheckedCount = 0;
@@ -319,25 +702,255 @@ void GuiDocument::setNodeVisible(TreeNodeId nodeId, bool on)
             parentVisibleState = CheckState::Off;
 
         fnSetNodeVisibleState(parentId, parentVisibleState);
-        parentId = docModelTree.nodeParent(parentId);
     }
 
     // Notify all node visibility changes
-    if (!mapNodeIdVisibleState.empty())
+    if (!mapNodeIdVisibleState.empty()) {
+        this->deferHiddenLineRemovalInvalidation(); // Nodes are often toggled in quick succession
         this->signalNodesVisibilityChanged.send(mapNodeIdVisibleState);
+    }
+}
+
+void GuiDocument::setExplodingMode(ExplodingMode mode)
+{
+    if (mode == m_explodingMode)
+        return;
+
+    m_explodingMode = mode;
+    for (GraphicsEntity& entity : m_vecGraphicsEntity)
+        this->computeExplodeVectors(&entity);
+
+    const double t = m_explodingFactor;
+    m_explodingFactor = -1.; // Force update of objects transformation
+    this->setExplodingFactor(t);
 }
 
 void GuiDocument::setExplodingFactor(double t)
 {
+    if (t == m_explodingFactor)
+        return;
+
+    // Explode vectors are precomputed, only object locations have to be updated here
+    // Instanced objects just move the structures of their instances while exploding is interactive
+    // (eg slider dragged), arrays are rebuilt once full rendering quality is back
     m_explodingFactor = t;
+    const bool isMotionModeOn = m_renderingQuality == RenderingQuality::Interactive;
     for (const GraphicsEntity& entity : m_vecGraphicsEntity) {
-        const gp_Pnt entityCenter = BndBoxCoords::get(entity.bndBox).center();
+        for (const auto& [gfxObject, vecNodeId] : entity.mapInstancedObjectTreeNodes)
+            Handle(GraphicsInstancedMeshObject)::DownCast(gfxObject)->setMotionModeOn(isMotionModeOn);
+
         for (const GraphicsEntity::Object& object : entity.vecObject) {
-            const gp_Vec vecDirection(entityCenter, BndBoxCoords::get(object.bndBox).center());
             gp_Trsf trsfMove;
-            trsfMove.SetTranslation(2 * t * vecDirection);
+            trsfMove.SetTranslation(t * object.explodeVector);
             m_gfxScene.setObjectTransformation(object.ptr, trsfMove * object.trsfOriginal);
         }
+
+        for (const auto& [nodeId, instance] : entity.mapTreeNodeInstance) {
+            gp_Trsf trsfMove;
+            trsfMove.SetTranslation(t * instance.explodeVector);
+            instance.ptr->setInstanceTransformation(instance.index, trsfMove * instance.trsfOriginal);
+        }
+
+        // Selection is recomputed once exploding is over(ie on next picking), not at each step
+        for (const auto& [gfxObject, vecNodeId] : entity.mapInstancedObjectTreeNodes) {
+            Handle(GraphicsInstancedMeshObject)::DownCast(gfxObject)->updatePresentation();
+            m_gfxScene.invalidateObjectSelection(gfxObject);
+        }
+    }
+
+    this->deferHiddenLineRemovalInvalidation(); // Exploding factor is typically changed by a slider
+    m_gfxScene.redraw();
+}
+
+void GuiDocument::setRenderingQuality(RenderingQuality quality)
+{
+    if (quality == m_renderingQuality)
+        return;
+
+    m_renderingQuality = quality;
+    Graphic3d_RenderingParams& renderingParams = m_v3dView->ChangeRenderingParams();
+    if (quality == RenderingQuality::Interactive) {
+        m_fullQualityRenderingParams = renderingParams;
+        renderingParams.IsAntialiasingEnabled = false;
+        renderingParams.NbMsaaSamples = 0;
+    }
+    else {
+        renderingParams.IsAntialiasingEnabled = m_fullQualityRenderingParams.IsAntialiasingEnabled;
+        renderingParams.NbMsaaSamples = m_fullQualityRenderingParams.NbMsaaSamples;
+    }
+
+#if OCC_VERSION_HEX >= OCC_VERSION_CHECK(7, 4, 0)
+    // Face boundaries are hidden with an empty line type, this just needs graphics aspects to be
+    // synchronized whereas toggling Prs3d_Drawer::FaceBoundaryDraw() would recompute presentations
+    if (quality == RenderingQuality::Interactive) {
+        std::unordered_set<GraphicsObjectPtr> setObject;
+        for (const GraphicsEntity& gfxEntity : m_vecGraphicsEntity) {
+            for (const GraphicsEntity::Object& object : gfxEntity.vecObject) {
+                // Instances(AIS_ConnectedInteractive) share the presentation of their product
+                auto aisLink = Handle_AIS_ConnectedInteractive::DownCast(object.ptr);
+                const GraphicsObjectPtr gfxObject =
+                        aisLink && aisLink->HasConnection() ? aisLink->ConnectedTo() : object.ptr;
+                if (!setObject.insert(gfxObject).second)
+                    continue;
+
+                const Handle_Prs3d_Drawer& drawer = gfxObject->Attributes();
+                if (!drawer->FaceBoundaryDraw() || !drawer->HasOwnFaceBoundaryAspect())
+                    continue;
+
+                const Handle_Graphic3d_AspectLine3d& aspect = drawer->FaceBoundaryAspect()->Aspect();
+                m_vecHiddenFaceBoundary.push_back({ gfxObject, aspect->Type() });
+                aspect->SetType(Aspect_TOL_EMPTY);
+                gfxObject->SynchronizeAspects();
+            }
+        }
+    }
+    else {
+        for (const auto& [gfxObject, lineType] : m_vecHiddenFaceBoundary) {
+            gfxObject->Attributes()->FaceBoundaryAspect()->Aspect()->SetType(lineType);
+            gfxObject->SynchronizeAspects();
+        }
+
+        m_vecHiddenFaceBoundary.clear();
+    }
+#endif
+
+    if (quality == RenderingQuality::Full) {
+        for (const GraphicsEntity& gfxEntity : m_vecGraphicsEntity) {
+            for (const auto& [gfxObject, vecNodeId] : gfxEntity.mapInstancedObjectTreeNodes) {
+                auto gfxInstanced = Handle(GraphicsInstancedMeshObject)::DownCast(gfxObject);
+                if (gfxInstanced->isMotionModeOn()) {
+                    gfxInstanced->setMotionModeOn(false);
+                    gfxInstanced->updatePresentation();
+                    m_gfxScene.invalidateObjectSelection(gfxObject);
+                }
+            }
+        }
+    }
+
+    this->updateLevelOfDetail();
+    if (quality == RenderingQuality::Interactive && m_hlrObject)
+        this->showHiddenLineRemoval(false);
+    else
+        this->updateHiddenLineRemoval();
+
+    m_gfxScene.redraw();
+}
+
+void GuiDocument::setHiddenLineRemovalOn(bool on)
+{
+    if (on == m_isHiddenLineRemovalOn)
+        return;
+
+    m_isHiddenLineRemovalOn = on;
+    if (on)
+        this->updateHiddenLineRemoval();
+    else if (m_hlrObject)
+        this->showHiddenLineRemoval(false); // Cached projections are kept for when it's back on
+
+    m_gfxScene.redraw();
+}
+
+void GuiDocument::updateHiddenLineRemoval()
+{
+    // Projection would be outdated right away while the camera is manipulated
+    if (!m_isHiddenLineRemovalOn || m_renderingQuality == RenderingQuality::Interactive)
+        return;
+
+    if (m_isHiddenLineRemovalDeferred) {
+        this->invalidateHiddenLineRemoval(); // Calls back this function
+        return;
+    }
+
+    if (!m_hlrObject) {
+        // Triangulations are copied by the worker thread of the HLR object
+        std::mutex* brepMeshMutex = m_guiApp ? m_guiApp->brepMeshMutex() : nullptr;
+        m_hlrObject = new GraphicsHlrObject(this->hiddenLineRemovalShape(), brepMeshMutex);
+        m_hlrObject->setHiddenLinesVisible(m_gfxScene.hiddenLineDrawingOn());
+        const Handle(GraphicsHlrObject) hlrObject = m_hlrObject;
+        m_hlrObject->signalProjectionReady.connectSlot([=]{
+            // Slot is queued, meanwhile the HLR object might have been dropped
+            if (!hlrObject->isCancelled() && hlrObject == m_hlrObject)
+                this->updateHiddenLineRemoval();
+        });
+    }
+
+    const gp_Dir eyeDir = m_v3dView->Camera()->Direction().Reversed();
+    this->showHiddenLineRemoval(m_hlrObject->requestProjection(eyeDir));
+}
+
+TopoDS_Shape GuiDocument::hiddenLineRemovalShape() const
+{
+    // Projected shapes are the ones visible, with their current location(eg exploded)
+    TopoDS_Compound compound;
+    BRep_Builder builder;
+    builder.MakeCompound(compound);
+    for (const GraphicsEntity& gfxEntity : m_vecGraphicsEntity) {
+        for (const GraphicsEntity::Object& object : gfxEntity.vecObject) {
+            if (!GraphicsShapeObjectDriverPtr::DownCast(GraphicsObjectDriver::get(object.ptr)))
+                continue;
+
+            if (!m_gfxScene.isObjectVisible(object.ptr))
+                continue;
+
+            auto aisLink = Handle_AIS_ConnectedInteractive::DownCast(object.ptr);
+            auto aisShape = Handle_AIS_Shape::DownCast(aisLink ? aisLink->ConnectedTo() : object.ptr);
+            if (aisShape && !aisShape->Shape().IsNull())
+                builder.Add(compound, aisShape->Shape().Moved(TopLoc_Location(object.ptr->Transformation())));
+        }
+    }
+
+    return compound;
+}
+
+void GuiDocument::invalidateHiddenLineRemoval(bool meshChanged)
+{
+    const bool wasDeferred = m_isHiddenLineRemovalDeferred;
+    m_isHiddenLineRemovalDeferred = false;
+    if (!m_hlrObject)
+        return;
+
+    // Cached projections still apply if the same shapes are projected(eg visibility toggled back)
+    const TopoDS_Shape shape = this->hiddenLineRemovalShape();
+    if (!meshChanged && m_hlrObject->isSameShape(shape)) {
+        if (wasDeferred)
+            this->updateHiddenLineRemoval(); // Projection was hidden meanwhile
+
+        return;
+    }
+
+    this->showHiddenLineRemoval(false);
+    m_hlrObject->setShape(shape);
+    this->updateHiddenLineRemoval();
+}
+
+void GuiDocument::deferHiddenLineRemovalInvalidation()
+{
+    if (!m_hlrObject)
+        return;
+
+    // Outdated projection is replaced by the shaded shapes until updateHiddenLineRemoval()
+    if (!m_isHiddenLineRemovalDeferred) {
+        m_isHiddenLineRemovalDeferred = true;
+        if (m_isHiddenLineRemovalOn)
+            this->showHiddenLineRemoval(false);
+    }
+
+    this->signalHiddenLineRemovalDeferred.send();
+}
+
+void GuiDocument::showHiddenLineRemoval(bool on)
+{
+    // Full remove, so the presentation gets recomputed from the current projection
+    m_gfxScene.eraseObject(m_hlrObject);
+    if (on)
+        m_gfxScene.addObject(m_hlrObject);
+
+    // Shaded shapes are hidden in the view but remain displayed, so their visible state is untouched
+    for (const GraphicsEntity& gfxEntity : m_vecGraphicsEntity) {
+        for (const GraphicsEntity::Object& object : gfxEntity.vecObject) {
+            if (GraphicsShapeObjectDriverPtr::DownCast(GraphicsObjectDriver::get(object.ptr)))
+                m_gfxScene.setObjectVisibleInView(object.ptr, m_v3dView, !on);
+        }
     }
 
     m_gfxScene.redraw();
@@ -510,9 +1123,10 @@ void GuiDocument::setDefaultGradientBackground(const GradientBackground& gradien
 
 void GuiDocument::onDocumentEntityAdded(TreeNodeId entityTreeNodeId)
 {
-    this->mapEntity(entityTreeNodeId);
-    BndUtils::add(&m_gfxBoundingBox, m_vecGraphicsEntity.back().bndBox);
-    this->signalGraphicsBoundingBoxChanged.send(m_gfxBoundingBox);
+    if (m_entityMappingBatchDepth > 0)
+        m_vecEntityPendingMapping.push_back(entityTreeNodeId);
+    else
+        this->mapEntities(Span<const TreeNodeId>(&entityTreeNodeId, 1));
 }
 
 void GuiDocument::onDocumentEntityAboutToBeDestroyed(TreeNodeId entityTreeNodeId)
@@ -537,15 +1151,15 @@ void GuiDocument::onGraphicsSelectionChanged()
         return;
     }
 
+    // Set-based diff between the graphics selection and the application selection
     std::vector<ApplicationItem> vecSelected;
+    std::unordered_set<ApplicationItem> setSelected;
     m_gfxScene.foreachSelectedOwner([&](const GraphicsOwnerPtr& gfxOwner) {
-        auto gfxObject = GraphicsObjectPtr::DownCast(
-                    gfxOwner ? gfxOwner->Selectable() : Handle_SelectMgr_SelectableObject()
-        );
-        const TreeNodeId nodeId = this->nodeFromGraphicsObject(gfxObject);
+        const TreeNodeId nodeId = this->nodeFromGraphicsOwner(gfxOwner);
         if (nodeId != 0) {
             const ApplicationItem appItem({ m_document, nodeId });
-            vecSelected.push_back(std::move(appItem));
+            if (setSelected.insert(appItem).second)
+                vecSelected.push_back(std::move(appItem));
         }
     });
 
@@ -554,8 +1168,7 @@ void GuiDocument::onGraphicsSelectionChanged()
         if (appItem.document() != m_document)
             continue;
 
-        auto it = std::find(vecSelected.cbegin(), vecSelected.cend(), appItem);
-        if (it == vecSelected.cend())
+        if (setSelected.find(appItem) == setSelected.cend())
             vecRemoved.push_back(appItem);
     }
 
@@ -566,12 +1179,161 @@ void GuiDocument::onGraphicsSelectionChanged()
         appSelectionModel->remove(vecRemoved);
 }
 
-void GuiDocument::mapEntity(TreeNodeId entityTreeNodeId)
+void GuiDocument::mapEntities(Span<const TreeNodeId> spanEntityTreeNodeId)
+{
+    if (spanEntityTreeNodeId.empty())
+        return;
+
+    // Face triangulations are read until bounding boxes are computed: by the instanced objects, the
+    // drivers preparing objects and the presentations
+    auto brepMeshLock = this->lockBRepMesh();
+    std::vector<GraphicsEntity> vecGfxEntity;
+    MapDriverGraphicsObjects mapDriverGfxObjects;
+    for (TreeNodeId entityTreeNodeId : spanEntityTreeNodeId)
+        vecGfxEntity.push_back(this->createGraphicsEntity(entityTreeNodeId, &mapDriverGfxObjects));
+
+    // Products are independent until displayed, so let drivers prepare the data of their presentations
+    // concurrently(eg triangulation normals, shaded primitive arrays, mesh vertex arrays). Presentations
+    // are then computed when all graphics objects are displayed in a single batch
+    // Coarser LODs of meshes are computed in background afterwards, each one being activated as soon
+    // as it's available
+    for (const auto& [driver, vecGfxObject] : mapDriverGfxObjects) {
+        const GraphicsObjectDriverPtr gfxDriver = driver;
+        for (const GraphicsObjectPtr& gfxObject : vecGfxObject) {
+            GraphicsMeshLodsBase* meshLods = gfxDriver->meshLevelsOfDetail(gfxObject);
+            if (meshLods) {
+                meshLods->signalLevelOfDetailAdded.connectSlot([=]{
+                    // Slot is queued, meanwhile the object might have been unmapped
+                    if (!gfxDriver->meshLevelsOfDetail(gfxObject)->isCancelled())
+                        this->updateLevelOfDetail();
+                });
+            }
+        }
+
+        gfxDriver->prepareObjects(vecGfxObject);
+    }
+
+    std::vector<GraphicsObjectPtr> vecGfxObjectAdded;
+    {
+        GraphicsSceneRedrawBlocker redrawBlocker(&m_gfxScene);
+        for (const GraphicsEntity& gfxEntity : vecGfxEntity) {
+            for (const GraphicsEntity::Object& object : gfxEntity.vecObject) {
+                m_gfxScene.addObject(object.ptr);
+                auto driver = GraphicsObjectDriver::get(object.ptr);
+                if (driver)
+                    driver->applyDisplayMode(object.ptr, this->activeDisplayMode(driver));
+
+                const Handle(GraphicsPointCloudObject) pntCloudObject =
+                        Handle(GraphicsPointCloudObject)::DownCast(object.ptr);
+                if (pntCloudObject) {
+                    // Finer octree nodes are progressively displayed as they get loaded
+                    pntCloudObject->signalNodesLoaded.connectSlot([=]{
+                        // Slot is queued, meanwhile the object might have been unmapped
+                        if (!pntCloudObject->isCancelled()) {
+                            m_gfxScene.recomputeObjectPresentation(pntCloudObject);
+                            m_gfxScene.invalidateObjectSelection(pntCloudObject);
+                            m_gfxScene.redraw();
+                        }
+                    });
+                }
+
+                vecGfxObjectAdded.push_back(object.ptr);
+            }
+
+            for (const auto& [gfxObject, vecNodeId] : gfxEntity.mapInstancedObjectTreeNodes) {
+                m_gfxScene.addObject(gfxObject);
+                vecGfxObjectAdded.push_back(gfxObject);
+            }
+        }
+    }
+
+    // Avoid the view freezing on first mouse hover because of selection structures built on demand
+    m_gfxScene.precomputeObjectSelection(vecGfxObjectAdded);
+
+    // Compute bounding boxes in parallel. Instances(AIS_ConnectedInteractive) read the presentation
+    // of their product, so bounding boxes of objects owning a presentation are computed first
+    std::vector<GraphicsEntity::Object*> vecObject;
+    std::vector<GraphicsEntity::Object*> vecObjectInstance;
+    for (GraphicsEntity& gfxEntity : vecGfxEntity) {
+        for (GraphicsEntity::Object& object : gfxEntity.vecObject) {
+            if (Handle_AIS_ConnectedInteractive::DownCast(object.ptr))
+                vecObjectInstance.push_back(&object);
+            else
+                vecObject.push_back(&object);
+        }
+    }
+
+    auto fnComputeBoundingBox = [](GraphicsEntity::Object* object) {
+        object->bndBox = GraphicsUtils::AisObject_boundingBox(object->ptr);
+    };
+    OSD_Parallel::ForEach(vecObject.begin(), vecObject.end(), fnComputeBoundingBox);
+    OSD_Parallel::ForEach(vecObjectInstance.begin(), vecObjectInstance.end(), fnComputeBoundingBox);
+    if (brepMeshLock.owns_lock())
+        brepMeshLock.unlock();
+
+    const Tree<TDF_Label>& docModelTree = m_document->modelTree();
+    for (GraphicsEntity& gfxEntity : vecGfxEntity) {
+        for (GraphicsEntity::Object& object : gfxEntity.vecObject) {
+            object.trsfOriginal = m_gfxScene.objectTransformation(object.ptr);
+            BndUtils::add(&gfxEntity.bndBox, object.bndBox);
+        }
+
+        for (auto& [nodeId, instance] : gfxEntity.mapTreeNodeInstance) {
+            instance.bndBox = instance.ptr->instanceBoundingBox(instance.index);
+            BndUtils::add(&gfxEntity.bndBox, instance.bndBox);
+        }
+
+        this->computeExplodeVectors(&gfxEntity);
+        traverseTree(gfxEntity.treeNodeId, docModelTree, [=](TreeNodeId id) {
+            m_mapTreeNodeCheckState.insert({ id, CheckState::On });
+        });
+        BndUtils::add(&m_gfxBoundingBox, gfxEntity.bndBox);
+        for (const auto& [gfxObject, nodeId] : gfxEntity.mapGfxObjectTreeNode)
+            m_mapGfxObjectEntityTreeNode.insert({ gfxObject, gfxEntity.treeNodeId });
+
+        for (const auto& [gfxObject, vecNodeId] : gfxEntity.mapInstancedObjectTreeNodes)
+            m_mapGfxObjectEntityTreeNode.insert({ gfxObject, gfxEntity.treeNodeId });
+
+        m_mapEntityTreeNodeIndex.insert({ gfxEntity.treeNodeId, m_vecGraphicsEntity.size() });
+        m_vecGraphicsEntity.push_back(std::move(gfxEntity));
+    }
+
+    this->invalidateHiddenLineRemoval();
+    GraphicsUtils::V3dView_fitAll(m_v3dView);
+    m_gfxScene.redraw();
+    this->signalGraphicsBoundingBoxChanged.send(m_gfxBoundingBox);
+}
+
+void GuiDocument::beginEntityMappingBatch()
+{
+    ++m_entityMappingBatchDepth;
+}
+
+void GuiDocument::endEntityMappingBatch()
+{
+    if (m_entityMappingBatchDepth <= 0)
+        return;
+
+    if (--m_entityMappingBatchDepth == 0) {
+        const std::vector<TreeNodeId> vecEntityTreeNodeId = std::move(m_vecEntityPendingMapping);
+        m_vecEntityPendingMapping.clear();
+        this->mapEntities(vecEntityTreeNodeId);
+    }
+}
+
+GuiDocument::GraphicsEntity GuiDocument::createGraphicsEntity(
+        TreeNodeId entityTreeNodeId, MapDriverGraphicsObjects* ptrMapDriverGfxObjects)
 {
     const Tree<TDF_Label>& docModelTree = m_document->modelTree();
     GraphicsEntity gfxEntity;
     gfxEntity.treeNodeId = entityTreeNodeId;
     std::unordered_map<TDF_Label, GraphicsObjectPtr> mapLabelGfxProduct;
+    // Graphics objects owning a presentation(ie not AIS_ConnectedInteractive instances)
+    auto fnAddObjectToPrepare = [=](const GraphicsObjectPtr& gfxObject) {
+        auto driver = GraphicsObjectDriver::get(gfxObject);
+        if (driver)
+            (*ptrMapDriverGfxObjects)[driver.get()].push_back(gfxObject);
+    };
 
     traverseTree(entityTreeNodeId, docModelTree, [&](TreeNodeId id) {
         const TDF_Label nodeLabel = docModelTree.nodeData(id);
@@ -583,6 +1345,7 @@ void GuiDocument::mapEntity(TreeNodeId entityTreeNodeId)
                     return;
 
                 mapLabelGfxProduct.insert({ nodeLabel, gfxProduct });
+                fnAddObjectToPrepare(gfxProduct);
             }
 
             if (!docModelTree.nodeIsRoot(id)) {
@@ -592,6 +1355,7 @@ void GuiDocument::mapEntity(TreeNodeId entityTreeNodeId)
                     // can't be shared with the product
                     auto gfxObject = m_guiApp->createGraphicsObject(parentNodeLabel);
                     gfxEntity.vecObject.push_back(gfxObject);
+                    fnAddObjectToPrepare(gfxObject);
                 }
                 else {
                     auto gfxInstance = new AIS_ConnectedInteractive;
@@ -615,27 +1379,154 @@ void GuiDocument::mapEntity(TreeNodeId entityTreeNodeId)
         }
     });
 
-    for (const GraphicsEntity::Object& object : gfxEntity.vecObject) {
-        m_gfxScene.addObject(object.ptr);
-        auto driver = GraphicsObjectDriver::get(object.ptr);
-        if (driver)
-            driver->applyDisplayMode(object.ptr, this->activeDisplayMode(driver));
+    // Occurrences(AIS_ConnectedInteractive) of products repeated many times are replaced by a single
+    // GraphicsInstancedMeshObject for each product
+    std::unordered_map<GraphicsObjectPtr, std::vector<size_t>> mapProductOccurrences;
+    for (size_t i = 0; i < gfxEntity.vecObject.size(); ++i) {
+        auto aisLink = Handle_AIS_ConnectedInteractive::DownCast(gfxEntity.vecObject.at(i).ptr);
+        if (aisLink && aisLink->HasConnection())
+            mapProductOccurrences[aisLink->ConnectedTo()].push_back(i);
+    }
+
+    std::vector<bool> vecObjectInstanced(gfxEntity.vecObject.size(), false);
+    for (const auto& [productLabel, gfxProduct] : mapLabelGfxProduct) {
+        auto itOccurrences = mapProductOccurrences.find(gfxProduct);
+        if (itOccurrences == mapProductOccurrences.cend())
+            continue;
+
+        const std::vector<size_t>& vecOccurrenceIndex = itOccurrences->second;
+        if (CppUtils::cmpLess(vecOccurrenceIndex.size(), GuiDocument::minimumInstanceCount()))
+            continue;
+
+        const TopoDS_Shape shape = XCaf::shape(productLabel);
+        if (!GraphicsInstancedMeshObject::isShapeSupported(shape))
+            continue;
+
+        // Colors of sub-shapes can't be rendered
+        XCAFPrs_IndexedDataMapOfShapeStyle mapShapeStyle;
+        XCAFPrs::CollectStyleSettings(productLabel, TopLoc_Location(), mapShapeStyle);
+        if (mapShapeStyle.Extent() > 1)
+            continue;
+
+        // Instance geometry is duplicated in vertex buffers, limit it to a single array
+        Handle(GraphicsInstancedMeshObject) gfxInstanced = new GraphicsInstancedMeshObject(shape);
+        const double instancedTriangleCount = double(gfxInstanced->triangleCount()) * vecOccurrenceIndex.size();
+        if (instancedTriangleCount > GraphicsMeshArrayObject::maxArrayTriangleCount())
+            continue;
+
+        Quantity_Color color = gfxProduct->Attributes()->ShadingAspect()->Color();
+        if (mapShapeStyle.Extent() == 1 && mapShapeStyle.FindFromIndex(1).IsSetColorSurf())
+            color = mapShapeStyle.FindFromIndex(1).GetColorSurf();
+
+        gfxInstanced->setColor(color);
+        gfxInstanced->setMaterial(gfxProduct->Attributes()->ShadingAspect()->Material());
+        std::vector<TreeNodeId> vecInstanceNodeId;
+        for (size_t i : vecOccurrenceIndex) {
+            const GraphicsObjectPtr gfxOccurrence = gfxEntity.vecObject.at(i).ptr;
+            const TreeNodeId nodeId = CppUtils::findValue(gfxOccurrence, gfxEntity.mapGfxObjectTreeNode);
+            GraphicsEntity::Instance instance;
+            instance.ptr = gfxInstanced;
+            instance.trsfOriginal = gfxOccurrence->LocalTransformation();
+            instance.index = gfxInstanced->addInstance(instance.trsfOriginal);
+            gfxEntity.mapTreeNodeInstance.insert({ nodeId, instance });
+            gfxEntity.mapTreeNodeGfxObject.erase(nodeId);
+            gfxEntity.mapGfxObjectTreeNode.erase(gfxOccurrence);
+            vecInstanceNodeId.push_back(nodeId);
+            vecObjectInstanced.at(i) = true;
+        }
+
+        gfxEntity.mapInstancedObjectTreeNodes.insert({ gfxInstanced, std::move(vecInstanceNodeId) });
+        // Product isn't displayed anymore unless it's an entity itself, no need to prepare it
+        if (!CppUtils::findValue(gfxProduct, gfxEntity.mapGfxObjectTreeNode)) {
+            auto driver = GraphicsObjectDriver::get(gfxProduct);
+            if (driver) {
+                std::vector<GraphicsObjectPtr>& vecGfxObject = (*ptrMapDriverGfxObjects)[driver.get()];
+                vecGfxObject.erase(std::remove(vecGfxObject.begin(), vecGfxObject.end(), gfxProduct), vecGfxObject.end());
+            }
+        }
+    }
+
+    if (!gfxEntity.mapInstancedObjectTreeNodes.empty()) {
+        std::vector<GraphicsEntity::Object> vecObject;
+        for (size_t i = 0; i < gfxEntity.vecObject.size(); ++i) {
+            if (!vecObjectInstanced.at(i))
+                vecObject.push_back(gfxEntity.vecObject.at(i));
+        }
+
+        gfxEntity.vecObject = std::move(vecObject);
     }
 
+    return gfxEntity;
+}
+
+void GuiDocument::computeExplodeVectors(GraphicsEntity* ptrGfxEntity) const
+{
+    GraphicsEntity& gfxEntity = *ptrGfxEntity;
+    // Items to be exploded: graphics objects and instances within instanced objects
+    struct ExplodeItem {
+        TreeNodeId treeNodeId;
+        const Bnd_Box* ptrBndBox;
+        gp_Vec* ptrExplodeVector;
+    };
+    std::vector<ExplodeItem> vecItem;
     for (GraphicsEntity::Object& object : gfxEntity.vecObject) {
-        object.bndBox = GraphicsUtils::AisObject_boundingBox(object.ptr);
-        object.trsfOriginal = m_gfxScene.objectTransformation(object.ptr);
-        BndUtils::add(&gfxEntity.bndBox, object.bndBox);
+        const TreeNodeId nodeId = CppUtils::findValue(object.ptr, gfxEntity.mapGfxObjectTreeNode);
+        vecItem.push_back({ nodeId, &object.bndBox, &object.explodeVector });
     }
 
-    m_gfxScene.redraw();
+    for (auto& [nodeId, instance] : gfxEntity.mapTreeNodeInstance)
+        vecItem.push_back({ nodeId, &instance.bndBox, &instance.explodeVector });
 
-    traverseTree(entityTreeNodeId, docModelTree, [=](TreeNodeId id) {
-        m_mapTreeNodeCheckState.insert({ id, CheckState::On });
-    });
+    auto fnCenter = [](const Bnd_Box& box) { return BndBoxCoords::get(box).center(); };
+    if (m_explodingMode == ExplodingMode::Flat) {
+        const gp_Pnt entityCenter = fnCenter(gfxEntity.bndBox);
+        for (const ExplodeItem& item : vecItem)
+            *item.ptrExplodeVector = 2 * gp_Vec(entityCenter, fnCenter(*item.ptrBndBox));
 
-    GraphicsUtils::V3dView_fitAll(m_v3dView);
-    m_vecGraphicsEntity.push_back(std::move(gfxEntity));
+        return;
+    }
+
+    // Hierarchical mode: bounding box of each assembly node is the union of the boxes of the
+    // items below it, then explode vector of an item is the sum of the offsets of each assembly
+    // level(node center relative to parent node center) along its path to the entity root
+    const Tree<TDF_Label>& docModelTree = m_document->modelTree();
+    std::unordered_map<TreeNodeId, Bnd_Box> mapTreeNodeBndBox;
+    for (const ExplodeItem& item : vecItem) {
+        TreeNodeId nodeId = item.treeNodeId;
+        while (nodeId != 0) {
+            BndUtils::add(&mapTreeNodeBndBox[nodeId], *item.ptrBndBox);
+            if (nodeId == gfxEntity.treeNodeId)
+                break;
+
+            nodeId = docModelTree.nodeParent(nodeId);
+        }
+    }
+
+    for (const ExplodeItem& item : vecItem) {
+        gp_Vec explodeVector;
+        TreeNodeId nodeId = item.treeNodeId;
+        while (nodeId != 0 && nodeId != gfxEntity.treeNodeId) {
+            const TreeNodeId parentNodeId = docModelTree.nodeParent(nodeId);
+            const gp_Pnt nodeCenter = fnCenter(mapTreeNodeBndBox[nodeId]);
+            const gp_Pnt parentNodeCenter = fnCenter(mapTreeNodeBndBox[parentNodeId]);
+            explodeVector += 2 * gp_Vec(parentNodeCenter, nodeCenter);
+            nodeId = parentNodeId;
+        }
+
+        *item.ptrExplodeVector = explodeVector;
+    }
+}
+
+void GuiDocument::recomputeInstancedObject(const GraphicsObjectPtr& gfxObject)
+{
+    m_gfxScene.recomputeObjectPresentation(gfxObject);
+    m_gfxScene.recomputeObjectSelection(gfxObject);
+}
+
+std::unique_lock<std::mutex> GuiDocument::lockBRepMesh() const
+{
+    std::mutex* mutex = m_guiApp ? m_guiApp->brepMeshMutex() : nullptr;
+    return mutex ? std::unique_lock<std::mutex>(*mutex) : std::unique_lock<std::mutex>();
 }
 
 void GuiDocument::unmapEntity(TreeNodeId entityTreeNodeId)
@@ -645,11 +1536,25 @@ void GuiDocument::unmapEntity(TreeNodeId entityTreeNodeId)
         if (!ptrItem)
             return;
 
-        for (const GraphicsEntity::Object& object : ptrItem->vecObject)
+        for (const GraphicsEntity::Object& object : ptrItem->vecObject) {
+            Internal::cancelGraphicsObject(object.ptr);
             m_gfxScene.eraseObject(object.ptr);
+            m_mapGfxObjectEntityTreeNode.erase(object.ptr);
+        }
+
+        for (const auto& [gfxObject, vecNodeId] : ptrItem->mapInstancedObjectTreeNodes) {
+            Handle(GraphicsInstancedMeshObject)::DownCast(gfxObject)->setMotionModeOn(false); // Erase shadows
+            m_gfxScene.eraseObject(gfxObject);
+            m_mapGfxObjectEntityTreeNode.erase(gfxObject);
+        }
 
         const auto indexItem = ptrItem - &m_vecGraphicsEntity.front();
         m_vecGraphicsEntity.erase(m_vecGraphicsEntity.begin() + indexItem);
+        m_mapEntityTreeNodeIndex.erase(entityTreeNodeId);
+        for (size_t i = indexItem; i < m_vecGraphicsEntity.size(); ++i)
+            m_mapEntityTreeNodeIndex.at(m_vecGraphicsEntity.at(i).treeNodeId) = i;
+
+        this->invalidateHiddenLineRemoval();
         m_gfxScene.redraw();
     }
 
@@ -660,12 +1565,8 @@ void GuiDocument::unmapEntity(TreeNodeId entityTreeNodeId)
 
 const GuiDocument::GraphicsEntity* GuiDocument::findGraphicsEntity(TreeNodeId entityTreeNodeId) const
 {
-    auto itFound = std::find_if(
-                m_vecGraphicsEntity.cbegin(),
-                m_vecGraphicsEntity.cend(),
-                [=](const GraphicsEntity& item) { return item.treeNodeId == entityTreeNodeId; }
-    );
-    return itFound != m_vecGraphicsEntity.cend() ? &(*itFound) : nullptr;
+    auto itFound = m_mapEntityTreeNodeIndex.find(entityTreeNodeId);
+    return itFound != m_mapEntityTreeNodeIndex.cend() ? &m_vecGraphicsEntity.at(itFound->second) : nullptr;
 }
 
 void GuiDocument::v3dViewTrihedronDisplay(Aspect_TypeOfTriedronPosition corner)
@@ -10,17 +10,24 @@
 #include "../base/global.h"
 #include "../base/signal.h"
 #include "../base/tkernel_utils.h"
+#include "../graphics/graphics_hlr_object.h"
+#include "../graphics/graphics_instanced_mesh_object.h"
 #include "../graphics/graphics_object_driver.h"
 #include "../graphics/graphics_scene.h"
 #include "../graphics/graphics_view_ptr.h"
 #include "v3d_view_camera_animation.h"
 
+#include <Aspect_TypeOfLine.hxx>
 #include <Aspect_TypeOfTriedronPosition.hxx>
 #include <Bnd_Box.hxx>
+#include <Graphic3d_RenderingParams.hxx>
+#include <TopoDS_Face.hxx>
 #include <V3d_View.hxx>
 #include <functional>
 #include <memory>
+#include <mutex>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
 namespace Mayo {
@@ -57,11 +64,46 @@ public:
 
     // Executes callback 'fn' on all graphics objects associated to tree node 'nodeId'
     // This also includes all children(deep node traversal)
+    // Objects drawing several instances(GraphicsInstancedMeshObject) are visited once, note they
+    // might also draw instances of nodes outside of 'nodeId'
     void foreachGraphicsObject(TreeNodeId nodeId, const std::function<void(GraphicsObjectPtr)>& fn) const;
 
+    // Recomputes presentation of all graphics objects associated to tree node 'nodeId'(deep node traversal)
+    // To be called when the data displayed by the graphics objects has changed(eg BRep mesh refined)
+    void recomputeGraphics(TreeNodeId nodeId);
+
+    // Recomputes presentation of the graphics objects of entity 'entityTreeNodeId' showing any of the
+    // faces 'spanFace', to be called when the triangulations of these faces were replaced in background
+    // Objects take a snapshot of the triangulations while BRep meshes are locked, presentations are
+    // then computed from that snapshot once the lock is released
+    void recomputeBRepMeshGraphics(TreeNodeId entityTreeNodeId, Span<const TopoDS_Face> spanFace);
+
+    // Selects the level of detail(LOD) of each graphics object from its projected size in the 3D view
+    // To be called once the view camera has changed
+    void updateLevelOfDetail();
+
+    // Maps to graphics several document entities at once: graphics objects are added while scene redraw
+    // is blocked, their bounding boxes are computed in parallel, then view is fitted and redrawn once
+    void mapEntities(Span<const TreeNodeId> spanEntityTreeNodeId);
+
+    // Between beginEntityMappingBatch() and endEntityMappingBatch() the entities added to the document
+    // aren't mapped right away, they are all mapped by endEntityMappingBatch() with mapEntities()
+    // Useful when many entities are added in a row(eg import of multiple files)
+    void beginEntityMappingBatch();
+    void endEntityMappingBatch();
+
     // Finds the tree node id associated to graphics object
     TreeNodeId nodeFromGraphicsObject(const GraphicsObjectPtr& gfxObject) const;
 
+    // Finds the tree node id associated to graphics owner, owner of an instance within a
+    // GraphicsInstancedMeshObject is mapped to the tree node of that instance
+    TreeNodeId nodeFromGraphicsOwner(const GraphicsOwnerPtr& gfxOwner) const;
+
+    // Products having at least minimumInstanceCount() occurrences within an entity are drawn by a
+    // single GraphicsInstancedMeshObject instead of one graphics object per occurrence
+    static int minimumInstanceCount();
+    static void setMinimumInstanceCount(int count);
+
     // Toggles selected status of an application item(doesn't affect Application's selection model)
     void toggleItemSelected(const ApplicationItem& appItem);
 
@@ -75,11 +117,45 @@ public:
     // -- Visible state of document's tree nodes
     CheckState nodeVisibleState(TreeNodeId nodeId) const;
     void setNodeVisible(TreeNodeId nodeId, bool on);
+    // Sets visible state of several nodes at once(deep node traversal for each). When a node and one
+    // of its ancestors are both specified then the node(deeper) wins
+    // Check states of parent nodes are updated once bottom-up, graphics visibility is toggled in a
+    // single pass and signalNodesVisibilityChanged is sent once
+    void setNodesVisible(const std::unordered_map<TreeNodeId, bool>& mapNodeVisible);
 
     // -- Exploding
+    enum class ExplodingMode {
+        Flat, // Objects move away from the center of their entity
+        Hierarchical // Each assembly level moves away from the center of its parent assembly
+    };
+    ExplodingMode explodingMode() const { return m_explodingMode; }
+    void setExplodingMode(ExplodingMode mode);
+
     double explodingFactor() const { return m_explodingFactor; }
     void setExplodingFactor(double t); // Must be in [0,1]
 
+    // -- Rendering quality
+    enum class RenderingQuality {
+        Full,
+        // Meant to keep camera manipulation fluid: anti-aliasing(MSAA) is disabled, face boundaries
+        // are hidden(requires OpenCascade >= v7.4.0) and the next coarser levels of detail are used
+        Interactive
+    };
+    RenderingQuality renderingQuality() const { return m_renderingQuality; }
+    void setRenderingQuality(RenderingQuality quality);
+
+    // -- Hidden line removal(HLR)
+    // Shapes are drawn with their HLR projection along the view direction(see GraphicsHlrObject)
+    // Projections are computed in background and cached per view direction, shapes stay shaded until
+    // the projection for the current camera is ready. Turned on/off by the HLR display mode of
+    // GraphicsShapeObjectDriver(see setActiveDisplayMode())
+    bool isHiddenLineRemovalOn() const { return m_isHiddenLineRemovalOn; }
+    void setHiddenLineRemovalOn(bool on);
+    // Requests HLR projection for the current camera, to be called once the view camera has changed
+    // Also applies the changes of projected shapes deferred by exploding and visibility toggling(see
+    // signalHiddenLineRemovalDeferred)
+    void updateHiddenLineRemoval();
+
     // -- Visibility of trihedron at world origin
     bool isOriginTrihedronVisible() const;
     void toggleOriginTrihedronVisibility();
@@ -120,6 +196,9 @@ public:
     mutable Signal<const Bnd_Box&> signalGraphicsBoundingBoxChanged;
     mutable Signal<ViewTrihedronMode> signalViewTrihedronModeChanged;
     mutable Signal<Aspect_TypeOfTriedronPosition> signalViewTrihedronCornerChanged;
+    // Sent each time a change of the HLR projected shapes is deferred, projection stays hidden until
+    // updateHiddenLineRemoval() is called(eg once changes have settled)
+    mutable Signal<> signalHiddenLineRemovalDeferred;
 
     // -- Implementation
 private:
@@ -127,7 +206,6 @@ private:
     void onDocumentEntityAboutToBeDestroyed(TreeNodeId entityTreeNodeId);
     void onGraphicsSelectionChanged();
 
-    void mapEntity(TreeNodeId entityTreeNodeId);
     void unmapEntity(TreeNodeId entityTreeNodeId);
 
     struct GraphicsEntity {
@@ -136,17 +214,45 @@ private:
             GraphicsObjectPtr ptr;
             gp_Trsf trsfOriginal;
             Bnd_Box bndBox;
+            gp_Vec explodeVector; // Translation applied when exploding factor is 1
+        };
+
+        // Occurrence of a product drawn by a GraphicsInstancedMeshObject
+        struct Instance {
+            Handle(GraphicsInstancedMeshObject) ptr;
+            int index = -1;
+            gp_Trsf trsfOriginal;
+            Bnd_Box bndBox;
+            gp_Vec explodeVector; // Translation applied when exploding factor is 1
         };
 
         TreeNodeId treeNodeId;
         std::vector<Object> vecObject;
         std::unordered_map<TreeNodeId, GraphicsObjectPtr> mapTreeNodeGfxObject;
         std::unordered_map<GraphicsObjectPtr, TreeNodeId> mapGfxObjectTreeNode;
+        std::unordered_map<TreeNodeId, Instance> mapTreeNodeInstance;
+        // Instanced graphics objects along with the tree node of each of their instances
+        std::unordered_map<GraphicsObjectPtr, std::vector<TreeNodeId>> mapInstancedObjectTreeNodes;
         Bnd_Box bndBox;
     };
 
     const GraphicsEntity* findGraphicsEntity(TreeNodeId entityTreeNodeId) const;
 
+    using MapDriverGraphicsObjects = std::unordered_map<GraphicsObjectDriver*, std::vector<GraphicsObjectPtr>>;
+    // Creates the graphics objects of an entity, objects owning a presentation are added to 'ptrMapDriverGfxObjects'
+    GraphicsEntity createGraphicsEntity(TreeNodeId entityTreeNodeId, MapDriverGraphicsObjects* ptrMapDriverGfxObjects);
+    void computeExplodeVectors(GraphicsEntity* ptrGfxEntity) const;
+    void recomputeInstancedObject(const GraphicsObjectPtr& gfxObject);
+    // Locks GuiApplication::brepMeshMutex(), the returned lock owns no mutex if there is none
+    std::unique_lock<std::mutex> lockBRepMesh() const;
+    // Compound of the visible shapes in world coordinates, projected by the HLR object
+    TopoDS_Shape hiddenLineRemovalShape() const;
+    // To be called when the shapes to project, their location or their triangulations changed
+    void invalidateHiddenLineRemoval(bool meshChanged = false);
+    // Same as invalidateHiddenLineRemoval() but postponed to next updateHiddenLineRemoval()
+    void deferHiddenLineRemovalInvalidation();
+    void showHiddenLineRemoval(bool on);
+
     void v3dViewTrihedronDisplay(Aspect_TypeOfTriedronPosition corner);
 
     GuiApplication* m_guiApp = nullptr;
@@ -162,12 +268,27 @@ private:
     Handle_AIS_InteractiveObject m_aisViewCube;
 
     std::vector<GraphicsEntity> m_vecGraphicsEntity;
+    // Document-wide index of the graphics, for constant time lookups
+    std::unordered_map<TreeNodeId, size_t> m_mapEntityTreeNodeIndex; // Entity -> index in m_vecGraphicsEntity
+    std::unordered_map<GraphicsObjectPtr, TreeNodeId> m_mapGfxObjectEntityTreeNode; // Graphics object -> entity
     Bnd_Box m_gfxBoundingBox;
+    int m_entityMappingBatchDepth = 0;
+    std::vector<TreeNodeId> m_vecEntityPendingMapping;
 
     std::unordered_map<GraphicsObjectDriverPtr, int> m_mapGfxDriverDisplayMode;
     std::unordered_map<TreeNodeId, CheckState> m_mapTreeNodeCheckState;
 
     double m_explodingFactor = 0.;
+    ExplodingMode m_explodingMode = ExplodingMode::Flat;
+
+    bool m_isHiddenLineRemovalOn = false;
+    bool m_isHiddenLineRemovalDeferred = false;
+    Handle(GraphicsHlrObject) m_hlrObject;
+
+    RenderingQuality m_renderingQuality = RenderingQuality::Full;
+    Graphic3d_RenderingParams m_fullQualityRenderingParams;
+    // Objects whose face boundaries were hidden by interactive quality, along with the line type to restore
+    std::vector<std::pair<GraphicsObjectPtr, Aspect_TypeOfLine>> m_vecHiddenFaceBoundary;
 };
 
 } // namespace Mayo
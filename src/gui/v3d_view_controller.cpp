@@ -20,6 +20,7 @@ V3dViewController::V3dViewController(const Handle_V3d_View& view)
 
 void V3dViewController::zoomIn()
 {
+    this->notifyCameraInteraction();
     m_view->SetScale(m_view->Scale() * 1.1); // +10%
     this->redrawView();
     this->signalViewScaled.send();
@@ -27,6 +28,7 @@ void V3dViewController::zoomIn()
 
 void V3dViewController::zoomOut()
 {
+    this->notifyCameraInteraction();
     m_view->SetScale(m_view->Scale() / 1.1); // -10%
     this->redrawView();
     this->signalViewScaled.send();
@@ -34,10 +36,31 @@ void V3dViewController::zoomOut()
 
 void V3dViewController::turn(V3d_TypeOfAxe axis, QuantityAngle angle)
 {
+    this->notifyCameraInteraction();
     m_view->Turn(axis, UnitSystem::radians(angle), true/*start*/);
     this->redrawView();
 }
 
+void V3dViewController::notifyCameraInteraction()
+{
+    if (!m_isInteractionModeOn) {
+        m_isInteractionModeOn = true;
+        this->signalInteractionModeChanged.send(true);
+    }
+
+    this->startInteractionIdleTimer(m_interactionIdleTime);
+}
+
+void V3dViewController::endInteractionMode()
+{
+    // Camera is still held by a dynamic action, interaction mode will end after it's stopped
+    if (!m_isInteractionModeOn || this->hasCurrentDynamicAction())
+        return;
+
+    m_isInteractionModeOn = false;
+    this->signalInteractionModeChanged.send(false);
+}
+
 void V3dViewController::startDynamicAction(DynamicAction dynAction)
 {
     if (dynAction == DynamicAction::None)
@@ -47,6 +70,9 @@ void V3dViewController::startDynamicAction(DynamicAction dynAction)
         return;
 
     m_dynamicAction = dynAction;
+    if (dynAction != DynamicAction::WindowZoom) // Rubber band drawing doesn't change camera
+        this->notifyCameraInteraction();
+
     this->signalDynamicActionStarted.send(dynAction);
 }
 
@@ -55,6 +81,8 @@ void V3dViewController::stopDynamicAction()
     if (m_dynamicAction != DynamicAction::None) {
         this->signalDynamicActionEnded.send(m_dynamicAction);
         m_dynamicAction = DynamicAction::None;
+        if (m_isInteractionModeOn)
+            this->startInteractionIdleTimer(m_interactionIdleTime);
     }
 }
 
@@ -49,6 +49,16 @@ public:
     double instantZoomFactor() const { return m_instantZoomFactor; }
     void setInstantZoomFactor(double factor) { m_instantZoomFactor = factor; }
 
+    // Interaction mode is on while the camera is being manipulated(rotation, panning, zoom, camera
+    // animation, ...) and switched off when there was no camera change for interactionIdleTime()
+    // Clients can rely on it to trade rendering quality for speed(see signalInteractionModeChanged)
+    bool isInteractionModeOn() const { return m_isInteractionModeOn; }
+    // Notifies the camera is being changed, also to be called by any external camera manipulator
+    void notifyCameraInteraction();
+
+    QuantityTime interactionIdleTime() const { return m_interactionIdleTime; }
+    void setInteractionIdleTime(QuantityTime t) { m_interactionIdleTime = t; }
+
     // Signals
     Signal<DynamicAction> signalDynamicActionStarted;
     Signal<DynamicAction> signalDynamicActionEnded;
@@ -56,6 +66,7 @@ public:
     Signal<int, int> signalMouseMoved; // x,y: mouse position in view
     Signal<Aspect_VKeyMouse> signalMouseButtonClicked;
     Signal<bool> signalMultiSelectionToggled;
+    Signal<bool> signalInteractionModeChanged;
 
 protected:
     struct Position { int x; int y; };
@@ -84,6 +95,10 @@ protected:
     void drawRubberBand(const Position& posMin, const Position& posMax);
     void hideRubberBand();
 
+    // Starts(or restarts) the timer after which endInteractionMode() has to be called
+    virtual void startInteractionIdleTimer(QuantityTime idleTime) = 0;
+    void endInteractionMode();
+
     void backupCamera();
     void restoreCamera();
 
@@ -96,6 +111,8 @@ private:
     double m_instantZoomFactor = 5.;
     Handle_Graphic3d_Camera m_cameraBackup;
     Position m_posRubberBandStart = {};
+    bool m_isInteractionModeOn = false;
+    QuantityTime m_interactionIdleTime = 250 * Quantity_Millisecond;
 };
 
 } // namespace Mayo
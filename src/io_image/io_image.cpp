@@ -5,6 +5,7 @@
 ****************************************************************************/
 
 #include "io_image.h"
+#include "io_image_software_renderer.h"
 
 #include "../base/application_item.h"
 #include "../base/caf_utils.h"
@@ -19,6 +20,7 @@
 #include "../base/property_enumeration.h"
 #include "../base/task_progress.h"
 #include "../base/tkernel_utils.h"
+#include "../base/unit_system.h"
 #include "../graphics/graphics_scene.h"
 #include "../graphics/graphics_utils.h"
 #include "../gui/gui_application.h"
@@ -26,7 +28,9 @@
 #include <Aspect_Window.hxx>
 #include <Graphic3d_GraphicDriver.hxx>
 #include <Image_AlienPixMap.hxx>
+#include <Standard_Failure.hxx>
 #include <V3d_View.hxx>
+#include <gp.hxx>
 
 #include <gsl/util>
 #include <limits>
@@ -105,33 +109,9 @@ bool ImageWriter::writeFile(const FilePath& filepath, TaskProgress* progress)
     if (isVectorNull(m_params.cameraOrientation))
         this->messenger()->emitError(ImageWriterI18N::textIdTr("Camera orientation vector must not be null"));
 
-    // Create 3D view
-    GraphicsScene gfxScene;
-    Handle_V3d_View view = ImageWriter::createV3dView(&gfxScene, m_params);
-
-    const int itemCount = CppUtils::safeStaticCast<int>(m_vecAppItem.size());
-    // Render application items
-    for (const ApplicationItem& appItem : m_vecAppItem) {
-        if (appItem.isDocument()) {
-            // Iterate other root entities
-            const DocumentPtr doc = appItem.document();
-            for (int i = 0; i < doc->entityCount(); ++i) {
-                const TDF_Label labelEntity = doc->entityLabel(i);
-                gfxScene.addObject(m_guiApp->createGraphicsObject(labelEntity));
-            }
-        }
-        else if (appItem.isDocumentTreeNode()) {
-            const TDF_Label labelNode = appItem.documentTreeNode().label();
-            gfxScene.addObject(m_guiApp->createGraphicsObject(labelNode));
-        }
-
-        const auto itemProgress = &appItem - &m_vecAppItem.front();
-        progress->setValue(MathUtils::toPercent(itemProgress, 0, itemCount));
-    }
-
-    view->Redraw();
-    GraphicsUtils::V3dView_fitAll(view);
-    Handle_Image_AlienPixMap pixmap = ImageWriter::createImage(view);
+    ImageBatchRenderer renderer(m_guiApp, m_params);
+    renderer.setItems(m_vecAppItem, progress);
+    Handle_Image_AlienPixMap pixmap = renderer.renderImage(m_params.width, m_params.height, m_params.cameraOrientation);
     if (!pixmap)
         return false;
 
@@ -183,10 +163,22 @@ Handle_Image_AlienPixMap ImageWriter::createImage(GuiDocument* guiDoc, const Par
 
 Handle_Image_AlienPixMap ImageWriter::createImage(Handle_V3d_View view)
 {
+    Standard_Integer width = 0;
+    Standard_Integer height = 0;
+    view->Window()->Size(width, height);
+    return ImageWriter::createImage(view, width, height);
+}
+
+Handle_Image_AlienPixMap ImageWriter::createImage(Handle_V3d_View view, int width, int height)
+{
+    if (width <= 0 || height <= 0)
+        return {};
+
     Handle_Image_AlienPixMap pixmap = new Image_AlienPixMap;
     V3d_ImageDumpOptions dumpOptions;
     dumpOptions.BufferType = Graphic3d_BT_RGB;
-    view->Window()->Size(dumpOptions.Width, dumpOptions.Height);
+    dumpOptions.Width = width;
+    dumpOptions.Height = height;
     const bool okPixmap = view->ToPixMap(*pixmap.get(), dumpOptions);
     if (!okPixmap)
         return {};
@@ -223,6 +215,128 @@ Handle_V3d_View ImageWriter::createV3dView(GraphicsScene* gfxScene, const Parame
     return view;
 }
 
+ImageBatchRenderer::ImageBatchRenderer(GuiApplication* guiApp, const ImageWriter::Parameters& params)
+    : m_guiApp(guiApp),
+      m_params(params)
+{
+    try {
+        m_gfxScene.reset(new GraphicsScene);
+        m_view = ImageWriter::createV3dView(m_gfxScene.get(), params);
+    } catch (const Standard_Failure&) {
+        // No graphics driver available(eg no display connection or no OpenGL implementation)
+        this->switchToSoftwareRendering();
+    }
+}
+
+ImageBatchRenderer::~ImageBatchRenderer()
+{
+    this->clearItems();
+}
+
+void ImageBatchRenderer::setItems(Span<const ApplicationItem> appItems, TaskProgress* progress)
+{
+    this->clearItems();
+    m_vecAppItem.assign(appItems.begin(), appItems.end());
+    if (m_softRenderer) {
+        m_softRenderer->addItems(appItems, progress);
+        return;
+    }
+
+    auto fnAddObject = [=](const TDF_Label& label) {
+        GraphicsObjectPtr gfxObject = m_guiApp->createGraphicsObject(label);
+        if (gfxObject) {
+            m_gfxScene->addObject(gfxObject, GraphicsScene::AddObjectDisableSelectionMode);
+            m_vecGfxObject.push_back(gfxObject);
+        }
+    };
+
+    const int itemCount = CppUtils::safeStaticCast<int>(appItems.size());
+    for (int i = 0; i < itemCount; ++i) {
+        const ApplicationItem& appItem = appItems[i];
+        if (appItem.isDocument()) {
+            // Iterate other root entities
+            const DocumentPtr doc = appItem.document();
+            for (int j = 0; j < doc->entityCount(); ++j)
+                fnAddObject(doc->entityLabel(j));
+        }
+        else if (appItem.isDocumentTreeNode()) {
+            fnAddObject(appItem.documentTreeNode().label());
+        }
+
+        if (progress)
+            progress->setValue(MathUtils::toPercent(i, 0, itemCount));
+    }
+
+    m_view->Redraw();
+}
+
+void ImageBatchRenderer::clearItems()
+{
+    for (const GraphicsObjectPtr& gfxObject : m_vecGfxObject)
+        m_gfxScene->eraseObject(gfxObject);
+
+    m_vecGfxObject.clear();
+    m_vecAppItem.clear();
+    if (m_softRenderer)
+        m_softRenderer->clear();
+}
+
+Handle_Image_AlienPixMap ImageBatchRenderer::renderImage(int width, int height, const gp_Vec& cameraOrientation)
+{
+    if (width <= 0 || height <= 0)
+        return {};
+
+    if (m_softRenderer)
+        return m_softRenderer->renderImage(width, height, cameraOrientation);
+
+    if (!isVectorNull(cameraOrientation))
+        m_view->SetProj(cameraOrientation.X(), cameraOrientation.Y(), cameraOrientation.Z());
+    else
+        m_view->SetProj(1, -1, 1);
+
+    // Fit with the aspect ratio of the image, not the one of the virtual window
+    m_view->Camera()->SetAspect(double(width) / double(height));
+    GraphicsUtils::V3dView_fitAll(m_view);
+    Handle_Image_AlienPixMap pixmap = ImageWriter::createImage(m_view, width, height);
+    if (!pixmap) {
+        // Offscreen rendering isn't supported by the OpenGL context
+        this->switchToSoftwareRendering();
+        return m_softRenderer->renderImage(width, height, cameraOrientation);
+    }
+
+    return pixmap;
+}
+
+void ImageBatchRenderer::switchToSoftwareRendering()
+{
+    if (m_gfxScene) {
+        for (const GraphicsObjectPtr& gfxObject : m_vecGfxObject)
+            m_gfxScene->eraseObject(gfxObject);
+    }
+
+    m_vecGfxObject.clear();
+    m_view.Nullify();
+    m_gfxScene.reset();
+
+    ImageSoftwareRenderer::Parameters params;
+    params.backgroundColor = m_params.backgroundColor;
+    params.cameraProjection = m_params.cameraProjection;
+    m_softRenderer = std::make_unique<ImageSoftwareRenderer>(params);
+    m_softRenderer->addItems(m_vecAppItem);
+}
+
+std::vector<gp_Vec> ImageBatchRenderer::turntableOrientations(const gp_Vec& start, int count)
+{
+    std::vector<gp_Vec> vecOrientation;
+    const gp_Vec startOrientation = !isVectorNull(start) ? start : gp_Vec(1, -1, 1);
+    for (int i = 0; i < count; ++i) {
+        const QuantityAngle angle = (360. * i / count) * Quantity_Degree;
+        vecOrientation.push_back(startOrientation.Rotated(gp::OZ(), UnitSystem::radians(angle).value));
+    }
+
+    return vecOrientation;
+}
+
 ImageFactoryWriter::ImageFactoryWriter(GuiApplication* guiApp)
     : m_guiApp(guiApp)
 {
@@ -10,6 +10,7 @@
 #include "../base/application_item.h"
 #include "../base/caf_utils.h"
 #include "../base/tkernel_utils.h"
+#include "../graphics/graphics_object_ptr.h"
 
 #include <gp_Dir.hxx>
 #include <Image_AlienPixMap.hxx>
@@ -17,6 +18,7 @@
 #include <TDF_Label.hxx>
 #include <V3d_View.hxx>
 
+#include <memory>
 #include <vector>
 
 // Pre-decls
@@ -29,6 +31,8 @@ class GuiDocument;
 namespace Mayo {
 namespace IO {
 
+class ImageSoftwareRenderer;
+
 // Provides a writer for image creation
 // Formats are those supported by OpenCascade with Image_AlienPixMap, see:
 //     https://dev.opencascade.org/doc/refman/html/class_image___alien_pix_map.html#details
@@ -61,6 +65,8 @@ public:
     // Helper
     static Handle_Image_AlienPixMap createImage(GuiDocument* guiDoc, const Parameters& params);
     static Handle_Image_AlienPixMap createImage(Handle_V3d_View view);
+    // Image dimensions might differ from the view window, camera aspect ratio is then adjusted
+    static Handle_Image_AlienPixMap createImage(Handle_V3d_View view, int width, int height);
     static Handle_V3d_View createV3dView(GraphicsScene* gfxScene, const Parameters& params);
 
 private:
@@ -70,6 +76,47 @@ private:
     std::vector<ApplicationItem> m_vecAppItem;
 };
 
+// Renders images of application items with a single offscreen 3D view kept alive
+// Scene, view and virtual window are created once, and graphics objects once per setItems() call.
+// So rendering many images(eg camera orientations of a turntable, image sizes) only costs the
+// rendering itself
+// If no OpenGL context is available then images are rendered on the CPU(see ImageSoftwareRenderer)
+class ImageBatchRenderer {
+public:
+    // 'params' provides background color, camera projection and size of the virtual window
+    ImageBatchRenderer(GuiApplication* guiApp, const ImageWriter::Parameters& params);
+    ~ImageBatchRenderer();
+
+    // Not copyable
+    ImageBatchRenderer(const ImageBatchRenderer&) = delete;
+    ImageBatchRenderer& operator=(const ImageBatchRenderer&) = delete;
+
+    // Replaces the rendered items, graphics objects are created for them
+    void setItems(Span<const ApplicationItem> appItems, TaskProgress* progress = nullptr);
+    void clearItems();
+
+    // Renders current items, camera looks along 'cameraOrientation'(Z-up convention) and fits all
+    Handle_Image_AlienPixMap renderImage(int width, int height, const gp_Vec& cameraOrientation);
+
+    // Returns 'count' camera orientations evenly spaced around Z axis, the first one being 'start'
+    static std::vector<gp_Vec> turntableOrientations(const gp_Vec& start, int count);
+
+    // Whether images are rendered on the CPU, which is the case when creation of the OpenGL view
+    // or offscreen rendering failed
+    bool isSoftwareRendering() const { return m_softRenderer != nullptr; }
+
+private:
+    void switchToSoftwareRendering();
+
+    GuiApplication* m_guiApp = nullptr;
+    ImageWriter::Parameters m_params;
+    std::unique_ptr<GraphicsScene> m_gfxScene;
+    Handle_V3d_View m_view;
+    std::vector<GraphicsObjectPtr> m_vecGfxObject;
+    std::vector<ApplicationItem> m_vecAppItem;
+    std::unique_ptr<ImageSoftwareRenderer> m_softRenderer;
+};
+
 class ImageFactoryWriter : public FactoryWriter {
 public:
     ImageFactoryWriter(GuiApplication* guiApp);
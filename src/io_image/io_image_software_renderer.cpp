@@ -0,0 +1,370 @@
+/****************************************************************************
+** Copyright (c) 2023, Fougue Ltd. <http://www.fougue.pro>
+** All rights reserved.
+** See license at https://github.com/fougue/mayo/blob/master/LICENSE.txt
+****************************************************************************/
+
+#include "io_image_software_renderer.h"
+
+#include "../base/bnd_utils.h"
+#include "../base/document_tree_node.h"
+#include "../base/io_system.h"
+#include "../base/math_utils.h"
+#include "../base/mesh_access.h"
+#include "../base/task_progress.h"
+#include "../base/tkernel_utils.h"
+#include "../base/unit_system.h"
+
+#include <OSD_Parallel.hxx>
+#include <Precision.hxx>
+#include <TopLoc_Location.hxx>
+#include <gp.hxx>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace Mayo {
+namespace IO {
+
+namespace {
+
+// Vertex projected in the image
+// Depth is affine in image space so it can be linearly interpolated over triangles, lower is nearer
+struct ScreenVertex {
+    double x;
+    double y;
+    double depth;
+};
+
+// Twice the signed area of triangle(a, b, c) where c is (cx, cy)
+double edgeFunction(const ScreenVertex& a, const ScreenVertex& b, double cx, double cy)
+{
+    return (b.x - a.x) * (cy - a.y) - (b.y - a.y) * (cx - a.x);
+}
+
+} // namespace
+
+ImageSoftwareRenderer::ImageSoftwareRenderer(const Parameters& params)
+    : m_params(params)
+{
+}
+
+void ImageSoftwareRenderer::addItems(Span<const ApplicationItem> appItems, TaskProgress* progress)
+{
+    progress = progress ? progress : &TaskProgress::null();
+    int count = 0;
+    System::traverseUniqueItems(appItems, [&](const DocumentTreeNode& treeNode) {
+        if (treeNode.isLeaf())
+            ++count;
+    });
+
+    int iCount = 0;
+    System::traverseUniqueItems(appItems, [&](const DocumentTreeNode& treeNode) {
+        if (treeNode.isLeaf() && !progress->isAbortRequested()) {
+            IMeshAccess_visitMeshes(treeNode, [&](const IMeshAccess& mesh) { this->addMesh(mesh); });
+            progress->setValue(MathUtils::toPercent(++iCount, 0, count));
+        }
+    });
+}
+
+void ImageSoftwareRenderer::addMesh(
+        const Handle(Poly_Triangulation)& triangulation, const gp_Trsf& trsf, const Quantity_Color& color)
+{
+    this->addMesh(triangulation, trsf, [&](int) { return color; });
+}
+
+void ImageSoftwareRenderer::addMesh(const IMeshAccess& mesh)
+{
+    const Quantity_Color defaultColor = m_params.defaultColor;
+    this->addMesh(mesh.triangulation(), mesh.location().Transformation(), [&](int i) {
+        const std::optional<Quantity_Color> nodeColor = mesh.nodeColor(i);
+        return nodeColor ? nodeColor.value() : defaultColor;
+    });
+}
+
+void ImageSoftwareRenderer::addMesh(
+        const Handle(Poly_Triangulation)& triangulation, const gp_Trsf& trsf, const FunctionNodeColor& fnNodeColor)
+{
+    if (!triangulation || triangulation->NbTriangles() <= 0)
+        return;
+
+    const int offset = int(m_vecVertex.size());
+    for (int i = 1; i <= triangulation->NbNodes(); ++i) {
+        const gp_Pnt pnt = triangulation->Node(i).Transformed(trsf);
+        const Quantity_Color color = fnNodeColor(i - 1);
+        m_vecVertex.push_back({ pnt.XYZ(), Vec3f(float(color.Red()), float(color.Green()), float(color.Blue())) });
+        m_bndBox.Add(pnt);
+    }
+
+    for (int i = 1; i <= triangulation->NbTriangles(); ++i) {
+        int n1, n2, n3;
+        triangulation->Triangle(i).Get(n1, n2, n3);
+        m_vecTriangle.push_back({ { offset + n1 - 1, offset + n2 - 1, offset + n3 - 1 }, m_meshCount });
+    }
+
+    ++m_meshCount;
+}
+
+void ImageSoftwareRenderer::clear()
+{
+    m_vecVertex.clear();
+    m_vecTriangle.clear();
+    m_meshCount = 0;
+    m_bndBox.SetVoid();
+}
+
+Handle_Image_AlienPixMap ImageSoftwareRenderer::renderImage(int width, int height, const gp_Vec& cameraOrientation) const
+{
+    if (width <= 0 || height <= 0)
+        return {};
+
+    // Camera frame, eye is located along 'cameraOrientation' and Z axis is pointing up
+    const bool isOrientationNull = cameraOrientation.Magnitude() <= Precision::Confusion();
+    const gp_Dir dirView = gp_Dir(!isOrientationNull ? cameraOrientation : gp_Vec(1, -1, 1)).Reversed();
+    gp_Vec vecUp = gp_Vec(gp::DZ()) - gp_Vec(dirView) * gp::DZ().Dot(dirView);
+    if (vecUp.Magnitude() <= Precision::Confusion())
+        vecUp = gp_Vec(gp::DY());
+
+    const gp_XYZ up = gp_Dir(vecUp).XYZ();
+    const gp_XYZ right = dirView.Crossed(gp_Dir(vecUp)).XYZ();
+    const gp_XYZ view = dirView.XYZ();
+
+    // Project vertices
+    const bool isPerspective = m_params.cameraProjection == ImageWriter::CameraProjection::Perspective;
+    const BndBoxCoords bndCoords = !m_bndBox.IsVoid() ? BndBoxCoords::get(m_bndBox) : BndBoxCoords{};
+    const gp_XYZ center = bndCoords.center().XYZ();
+    const double halfWidth = width / 2.;
+    const double halfHeight = height / 2.;
+    std::vector<ScreenVertex> vecScreenVertex(m_vecVertex.size());
+    gp_XYZ eye = center;
+    if (isPerspective) {
+        // Fit the bounding sphere in the field of view
+        const double radius = std::max(0.5 * (bndCoords.maxVertex().XYZ() - bndCoords.minVertex().XYZ()).Modulus(),
+                                       Precision::Confusion());
+        const double tanHalfFovy = std::tan(UnitSystem::radians(22.5 * Quantity_Degree).value);
+        const double tanHalfFovMin = std::min(tanHalfFovy, tanHalfFovy * width / double(height));
+        const double distance = radius * std::sqrt(1 + tanHalfFovMin * tanHalfFovMin) / tanHalfFovMin;
+        const double focal = halfHeight / tanHalfFovy;
+        eye = center - distance * view;
+        OSD_Parallel::For(0, int(m_vecVertex.size()), [&](int i) {
+            const gp_XYZ vec = m_vecVertex[i].pnt - eye;
+            const double z = std::max(vec.Dot(view), Precision::Confusion());
+            vecScreenVertex[i] = {
+                halfWidth + focal * vec.Dot(right) / z, halfHeight - focal * vec.Dot(up) / z, -1. / z
+            };
+        });
+    }
+    else {
+        double xMin = std::numeric_limits<double>::max();
+        double xMax = std::numeric_limits<double>::lowest();
+        double yMin = xMin;
+        double yMax = xMax;
+        for (const Vertex& vertex : m_vecVertex) {
+            const gp_XYZ vec = vertex.pnt - center;
+            xMin = std::min(xMin, vec.Dot(right));
+            xMax = std::max(xMax, vec.Dot(right));
+            yMin = std::min(yMin, vec.Dot(up));
+            yMax = std::max(yMax, vec.Dot(up));
+        }
+
+        constexpr double fitMargin = 0.9;
+        const double xMid = (xMin + xMax) / 2.;
+        const double yMid = (yMin + yMax) / 2.;
+        const double scale = fitMargin * std::min(
+                width / std::max(xMax - xMin, Precision::Confusion()),
+                height / std::max(yMax - yMin, Precision::Confusion())
+        );
+        OSD_Parallel::For(0, int(m_vecVertex.size()), [&](int i) {
+            const gp_XYZ vec = m_vecVertex[i].pnt - center;
+            vecScreenVertex[i] = {
+                halfWidth + (vec.Dot(right) - xMid) * scale, halfHeight - (vec.Dot(up) - yMid) * scale, vec.Dot(view)
+            };
+        });
+    }
+
+    // Flat shading with a directional headlight(along the view direction, also for perspective
+    // projection so faces orthogonal to the view are evenly lit), both sides of triangles are lit
+    constexpr float ambient = 0.3f;
+    constexpr float diffuse = 0.7f;
+    std::vector<float> vecTriangleIntensity(m_vecTriangle.size(), 1.f);
+    OSD_Parallel::For(0, int(m_vecTriangle.size()), [&](int i) {
+        const Triangle& tri = m_vecTriangle[i];
+        const gp_XYZ& p0 = m_vecVertex[tri.vertices[0]].pnt;
+        const gp_XYZ& p1 = m_vecVertex[tri.vertices[1]].pnt;
+        const gp_XYZ& p2 = m_vecVertex[tri.vertices[2]].pnt;
+        const gp_XYZ normal = (p1 - p0).Crossed(p2 - p0);
+        const gp_XYZ vecToEye = view.Reversed();
+        const double lengths = normal.Modulus() * vecToEye.Modulus();
+        if (lengths > std::numeric_limits<double>::min())
+            vecTriangleIntensity[i] = ambient + diffuse * float(std::abs(normal.Dot(vecToEye)) / lengths);
+    });
+
+    // Bin triangles into image tiles
+    const int tileSize = std::max(m_params.tileSize, 8);
+    const int tileCountX = (width + tileSize - 1) / tileSize;
+    const int tileCountY = (height + tileSize - 1) / tileSize;
+    std::vector<std::vector<int>> vecTileTriangles(tileCountX * tileCountY);
+    for (int i = 0; i < int(m_vecTriangle.size()); ++i) {
+        const Triangle& tri = m_vecTriangle[i];
+        const ScreenVertex& a = vecScreenVertex[tri.vertices[0]];
+        const ScreenVertex& b = vecScreenVertex[tri.vertices[1]];
+        const ScreenVertex& c = vecScreenVertex[tri.vertices[2]];
+        // Pixel 'x' is covered when its center 'x + 0.5' is inside the triangle
+        const int xMin = std::max(int(std::ceil(std::min({ a.x, b.x, c.x }) - 0.5)), 0);
+        const int xMax = std::min(int(std::floor(std::max({ a.x, b.x, c.x }) - 0.5)), width - 1);
+        const int yMin = std::max(int(std::ceil(std::min({ a.y, b.y, c.y }) - 0.5)), 0);
+        const int yMax = std::min(int(std::floor(std::max({ a.y, b.y, c.y }) - 0.5)), height - 1);
+        if (xMin > xMax || yMin > yMax)
+            continue;
+
+        for (int ty = yMin / tileSize; ty <= yMax / tileSize; ++ty) {
+            for (int tx = xMin / tileSize; tx <= xMax / tileSize; ++tx)
+                vecTileTriangles[ty * tileCountX + tx].push_back(i);
+        }
+    }
+
+    // Rasterize tiles concurrently, each one writes to its own pixels of the buffers
+    const int pixelCount = width * height;
+    const Vec3f bkgColor(
+        float(m_params.backgroundColor.Red()),
+        float(m_params.backgroundColor.Green()),
+        float(m_params.backgroundColor.Blue())
+    );
+    std::vector<double> vecDepth(pixelCount, std::numeric_limits<double>::max());
+    std::vector<int> vecMeshId(pixelCount, -1);
+    std::vector<Vec3f> vecColor(pixelCount, bkgColor);
+    OSD_Parallel::For(0, int(vecTileTriangles.size()), [&](int tileIndex) {
+        const int tileX = (tileIndex % tileCountX) * tileSize;
+        const int tileY = (tileIndex / tileCountX) * tileSize;
+        for (int triIndex : vecTileTriangles[tileIndex]) {
+            const Triangle& tri = m_vecTriangle[triIndex];
+            const ScreenVertex& a = vecScreenVertex[tri.vertices[0]];
+            const ScreenVertex& b = vecScreenVertex[tri.vertices[1]];
+            const ScreenVertex& c = vecScreenVertex[tri.vertices[2]];
+            const double area = edgeFunction(a, b, c.x, c.y);
+            if (std::abs(area) <= std::numeric_limits<double>::epsilon())
+                continue;
+
+            const double invArea = 1. / area; // Sign of 'area' makes weights positive inside the triangle
+            const int xMin = std::max(int(std::ceil(std::min({ a.x, b.x, c.x }) - 0.5)), tileX);
+            const int xMax = std::min({ int(std::floor(std::max({ a.x, b.x, c.x }) - 0.5)), tileX + tileSize - 1, width - 1 });
+            const int yMin = std::max(int(std::ceil(std::min({ a.y, b.y, c.y }) - 0.5)), tileY);
+            const int yMax = std::min({ int(std::floor(std::max({ a.y, b.y, c.y }) - 0.5)), tileY + tileSize - 1, height - 1 });
+            const Vec3f& colorA = m_vecVertex[tri.vertices[0]].color;
+            const Vec3f& colorB = m_vecVertex[tri.vertices[1]].color;
+            const Vec3f& colorC = m_vecVertex[tri.vertices[2]].color;
+            const float intensity = vecTriangleIntensity[triIndex];
+            for (int y = yMin; y <= yMax; ++y) {
+                const double cy = y + 0.5;
+                for (int x = xMin; x <= xMax; ++x) {
+                    const double cx = x + 0.5;
+                    const double wa = edgeFunction(b, c, cx, cy) * invArea;
+                    const double wb = edgeFunction(c, a, cx, cy) * invArea;
+                    const double wc = edgeFunction(a, b, cx, cy) * invArea;
+                    if (wa < 0 || wb < 0 || wc < 0)
+                        continue;
+
+                    const int pixelIndex = y * width + x;
+                    const double depth = wa * a.depth + wb * b.depth + wc * c.depth;
+                    if (depth >= vecDepth[pixelIndex])
+                        continue;
+
+                    vecDepth[pixelIndex] = depth;
+                    vecMeshId[pixelIndex] = tri.meshId;
+                    vecColor[pixelIndex] = (colorA * float(wa) + colorB * float(wb) + colorC * float(wc)) * intensity;
+                }
+            }
+        }
+    });
+
+    // Detect edges: boundaries between meshes and depth discontinuities
+    std::vector<char> vecEdgeFlag;
+    if (m_params.showEdges && !vecScreenVertex.empty()) {
+        auto itDepthMinMax = std::minmax_element(
+                    vecScreenVertex.cbegin(), vecScreenVertex.cend(), [](const ScreenVertex& lhs, const ScreenVertex& rhs) {
+            return lhs.depth < rhs.depth;
+        });
+        // Depth is affine over planar surfaces, so its second derivative is null except at creases
+        const double depthCurvatureTol = 0.01 * (itDepthMinMax.second->depth - itDepthMinMax.first->depth);
+        vecEdgeFlag.resize(pixelCount, 0);
+        OSD_Parallel::For(0, height, [&](int y) {
+            for (int x = 0; x < width; ++x) {
+                const int pixelIndex = y * width + x;
+                const int meshId = vecMeshId[pixelIndex];
+                if (meshId < 0)
+                    continue;
+
+                const double depth = vecDepth[pixelIndex];
+                auto fnIsEdgeWith = [&](int otherPixelIndex) {
+                    const int otherMeshId = vecMeshId[otherPixelIndex];
+                    if (otherMeshId == meshId)
+                        return false;
+
+                    // Only the nearest side of the boundary is marked, so edges are one pixel wide
+                    const double otherDepth = vecDepth[otherPixelIndex];
+                    return otherMeshId < 0 || depth < otherDepth || (depth == otherDepth && meshId > otherMeshId);
+                };
+                auto fnIsCrease = [&](int prevPixelIndex, int nextPixelIndex) {
+                    if (vecMeshId[prevPixelIndex] < 0 || vecMeshId[nextPixelIndex] < 0)
+                        return false;
+
+                    const double curvature = vecDepth[prevPixelIndex] + vecDepth[nextPixelIndex] - 2 * depth;
+                    return std::abs(curvature) > depthCurvatureTol;
+                };
+                bool isEdge = false;
+                if (x > 0)
+                    isEdge = isEdge || fnIsEdgeWith(pixelIndex - 1);
+
+                if (x < width - 1)
+                    isEdge = isEdge || fnIsEdgeWith(pixelIndex + 1);
+
+                if (y > 0)
+                    isEdge = isEdge || fnIsEdgeWith(pixelIndex - width);
+
+                if (y < height - 1)
+                    isEdge = isEdge || fnIsEdgeWith(pixelIndex + width);
+
+                if (x > 0 && x < width - 1)
+                    isEdge = isEdge || fnIsCrease(pixelIndex - 1, pixelIndex + 1);
+
+                if (y > 0 && y < height - 1)
+                    isEdge = isEdge || fnIsCrease(pixelIndex - width, pixelIndex + width);
+
+                vecEdgeFlag[pixelIndex] = isEdge ? 1 : 0;
+            }
+        });
+    }
+
+    // Write image, colors are converted from linear RGB
+    Handle_Image_AlienPixMap pixmap = new Image_AlienPixMap;
+    if (!pixmap->InitZero(Image_Format_RGB, width, height))
+        return {};
+
+    const Quantity_TypeOfColor colorType = TKernelUtils::preferredRgbColorType();
+    OSD_Parallel::For(0, height, [&](int y) {
+        Standard_Byte* row = pixmap->ChangeRow(y);
+        for (int x = 0; x < width; ++x) {
+            const int pixelIndex = y * width + x;
+            Quantity_Color color = m_params.edgeColor;
+            if (vecEdgeFlag.empty() || !vecEdgeFlag[pixelIndex]) {
+                const Vec3f& c = vecColor[pixelIndex];
+                color.SetValues(
+                        std::clamp(c.r(), 0.f, 1.f), std::clamp(c.g(), 0.f, 1.f), std::clamp(c.b(), 0.f, 1.f),
+                        Quantity_TOC_RGB
+                );
+            }
+
+            double r, g, b;
+            color.Values(r, g, b, colorType);
+            row[3 * x] = Standard_Byte(std::lround(r * 255));
+            row[3 * x + 1] = Standard_Byte(std::lround(g * 255));
+            row[3 * x + 2] = Standard_Byte(std::lround(b * 255));
+        }
+    });
+
+    return pixmap;
+}
+
+} // namespace IO
+} // namespace Mayo
@@ -0,0 +1,89 @@
+/****************************************************************************
+** Copyright (c) 2023, Fougue Ltd. <http://www.fougue.pro>
+** All rights reserved.
+** See license at https://github.com/fougue/mayo/blob/master/LICENSE.txt
+****************************************************************************/
+
+#pragma once
+
+#include "io_image.h"
+
+#include <Bnd_Box.hxx>
+#include <Image_AlienPixMap.hxx>
+#include <NCollection_Vec3.hxx>
+#include <Poly_Triangulation.hxx>
+#include <Quantity_Color.hxx>
+#include <gp_Trsf.hxx>
+#include <gp_Vec.hxx>
+
+#include <array>
+#include <functional>
+#include <vector>
+
+namespace Mayo {
+
+class IMeshAccess;
+class TaskProgress;
+
+namespace IO {
+
+// Renders triangulations of application items on the CPU, without any OpenGL context
+// Used by ImageBatchRenderer when no graphics driver is available(eg headless hosts without GPU)
+// The image is split into tiles rasterized concurrently, each pixel being depth-tested. Triangles are
+// flat shaded with a headlight, and colors of the parts are interpolated over the triangles.
+// Boundaries of the meshes(ie BRep faces) and depth discontinuities are drawn as edges
+class ImageSoftwareRenderer {
+public:
+    struct Parameters {
+        Quantity_Color backgroundColor = Quantity_NOC_BLACK;
+        ImageWriter::CameraProjection cameraProjection = ImageWriter::CameraProjection::Orthographic;
+        Quantity_Color defaultColor = Quantity_NOC_GRAY70; // Color of meshes not having any color
+        Quantity_Color edgeColor = Quantity_NOC_BLACK;
+        bool showEdges = true;
+        int tileSize = 64; // Width and height in pixels of the image tiles
+    };
+
+    ImageSoftwareRenderer() = default;
+    ImageSoftwareRenderer(const Parameters& params);
+
+    Parameters& parameters() { return m_params; }
+    const Parameters& constParameters() const { return m_params; }
+
+    // Adds meshes(ie BRep face triangulations) found in the tree of application items
+    void addItems(Span<const ApplicationItem> appItems, TaskProgress* progress = nullptr);
+    void addMesh(const Handle(Poly_Triangulation)& triangulation, const gp_Trsf& trsf, const Quantity_Color& color);
+    void clear();
+
+    bool isEmpty() const { return m_vecTriangle.empty(); }
+    int meshCount() const { return m_meshCount; }
+    const Bnd_Box& boundingBox() const { return m_bndBox; }
+
+    // Renders current meshes, camera looks along 'cameraOrientation'(Z-up convention) and fits all
+    Handle_Image_AlienPixMap renderImage(int width, int height, const gp_Vec& cameraOrientation) const;
+
+private:
+    using Vec3f = NCollection_Vec3<float>;
+    using FunctionNodeColor = std::function<Quantity_Color(int)>;
+
+    void addMesh(const IMeshAccess& mesh);
+    void addMesh(const Handle(Poly_Triangulation)& triangulation, const gp_Trsf& trsf, const FunctionNodeColor& fnNodeColor);
+
+    struct Vertex {
+        gp_XYZ pnt;
+        Vec3f color; // Linear RGB
+    };
+
+    struct Triangle {
+        std::array<int, 3> vertices;
+        int meshId;
+    };
+
+    Parameters m_params;
+    std::vector<Vertex> m_vecVertex;
+    std::vector<Triangle> m_vecTriangle;
+    int m_meshCount = 0;
+    Bnd_Box m_bndBox;
+};
+
+} // namespace IO
+} // namespace Mayo
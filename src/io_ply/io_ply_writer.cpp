@@ -13,6 +13,7 @@
 #include "../base/io_system.h"
 #include "../base/math_utils.h"
 #include "../base/mesh_access.h"
+#include "../base/mesh_utils.h"
 #include "../base/messenger.h"
 #include "../base/property_builtins.h"
 #include "../base/property_enumeration.h"
@@ -20,6 +21,7 @@
 #include "../base/tkernel_utils.h"
 
 #include <Poly_Triangulation.hxx>
+#include <TopLoc_Location.hxx>
 
 #include <gsl/util>
 #include <fmt/format.h>
@@ -66,6 +68,9 @@ public:
     {
         this->targetFormat.mutableEnumeration().changeTrContext(PlyWriterI18N::textIdContext());
         this->comment.setDescription(PlyWriterI18N::textIdTr("Line that will appear in header"));
+        this->writeNormals.setDescription(
+                    PlyWriterI18N::textIdTr("Write normals at the mesh nodes. Normals computed at import are "
+                                            "used, otherwise they are computed from the triangles"));
     }
 
     void restoreDefaults() override {
@@ -74,18 +79,21 @@ public:
         this->writeColors.setValue(defaultParams.writeColors);
         this->defaultColor.setValue(defaultParams.defaultColor.GetRGB());
         this->comment.setValue(defaultParams.comment);
+        this->writeNormals.setValue(defaultParams.writeNormals);
     }
 
     PropertyEnum<PlyWriter::Format> targetFormat{ this, PlyWriterI18N::textId("targetFormat") };
     PropertyBool writeColors{ this, PlyWriterI18N::textId("writeColors") };
     PropertyOccColor defaultColor{ this, PlyWriterI18N::textId("defaultColor") };
     PropertyString comment{ this, PlyWriterI18N::textId("comment") };
+    PropertyBool writeNormals{ this, PlyWriterI18N::textId("writeNormals") };
 };
 
 bool PlyWriter::transfer(Span<const ApplicationItem> appItems, TaskProgress* progress)
 {
     progress = progress ? progress : &TaskProgress::null();
     m_vecNode.clear();
+    m_vecNodeNormal.clear();
     m_vecNodeColor.clear();
     m_vecFace.clear();
 
@@ -176,6 +184,12 @@ bool PlyWriter::writeFile(const FilePath& filepath, TaskProgress* progress)
          << "property float y\n"
          << "property float z\n";
 
+    if (m_params.writeNormals) {
+        fstr << "property float nx\n"
+             << "property float ny\n"
+             << "property float nz\n";
+    }
+
     if (m_params.writeColors) {
         fstr << "property uchar red\n"
              << "property uchar green\n"
@@ -205,11 +219,19 @@ bool PlyWriter::writeFile(const FilePath& filepath, TaskProgress* progress)
         const auto inode = &node - &m_vecNode.front();
         if (isBinary) {
             fstr.write(reinterpret_cast<const char*>(&node.x), 12);
+            if (m_params.writeNormals)
+                fstr.write(reinterpret_cast<const char*>(&m_vecNodeNormal.at(inode).nx), 12);
+
             if (m_params.writeColors)
                 fstr.write(reinterpret_cast<const char*>(&m_vecNodeColor.at(inode).red), 3);
         }
         else {
             fstr << node.x << " " << node.y << " " << node.z;
+            if (m_params.writeNormals) {
+                const Normal& n = m_vecNodeNormal.at(inode);
+                fstr << " " << n.nx << " " << n.ny << " " << n.nz;
+            }
+
             if (m_params.writeColors) {
                 const Color& c = m_vecNodeColor.at(inode);
                 fstr << " " << int(c.red) << " " << int(c.green) << " " << int(c.blue);
@@ -255,6 +277,7 @@ void PlyWriter::applyProperties(const PropertyGroup* params)
         m_params.writeColors = ptr->writeColors;
         m_params.defaultColor = Quantity_ColorRGBA(ptr->defaultColor);
         m_params.comment = ptr->comment;
+        m_params.writeNormals = ptr->writeNormals;
     }
 }
 
@@ -275,6 +298,24 @@ void PlyWriter::addMesh(const IMeshAccess& mesh)
         m_vecNode.push_back(std::move(vertex));
     }
 
+    if (m_params.writeNormals) {
+        Handle(Poly_Triangulation) triangulationNormals = triangulation;
+        if (!triangulation->HasNormals()) {
+            // Compute on a copy, so the triangulation in the document isn't modified
+            triangulationNormals = triangulation->Copy();
+            MeshUtils::computeSmoothNormals(triangulationNormals, MathUtils::pi);
+        }
+
+        const gp_Trsf& trsf = mesh.location().Transformation();
+        for (int i = 1; i <= triangulationNormals->NbNodes(); ++i) {
+            gp_Vec n = MeshUtils::toGpVec(MeshUtils::normal(triangulationNormals, i)).Transformed(trsf);
+            if (n.SquareMagnitude() > 0.)
+                n.Normalize();
+
+            m_vecNodeNormal.push_back(Normal{ float(n.X()), float(n.Y()), float(n.Z()) });
+        }
+    }
+
     if (m_params.writeColors) {
         for (int i = 0; i < triangulation->NbNodes(); ++i) {
             const std::optional<Quantity_Color> nodeColor = mesh.nodeColor(i);
@@ -293,6 +334,14 @@ void PlyWriter::addPointCloud(const PointCloudDataPtr& pntCloud)
         m_vecNode.push_back(std::move(vertex));
     }
 
+    if (m_params.writeNormals) {
+        const bool hasNormals = points->HasVertexNormals();
+        for (int i = 1; i <= pntCount; ++i) {
+            const Graphic3d_Vec3 n = hasNormals ? points->VertexNormal(i) : Graphic3d_Vec3(0.f, 0.f, 0.f);
+            m_vecNodeNormal.push_back(Normal{ n.x(), n.y(), n.z() });
+        }
+    }
+
     if (m_params.writeColors) {
         const bool hasColors = points->HasVertexColors();
         for (int i = 1; i <= pntCount; ++i) {
@@ -36,7 +36,7 @@ public:
         bool writeColors = true;
         Quantity_ColorRGBA defaultColor{ Quantity_Color(Quantity_NOC_GRAY) };
         std::string comment;
-        // TODO bool writeNormals = false;
+        bool writeNormals = false;
         // TODO bool writeEdges = true;
     };
     Parameters& parameters() { return m_params; }
@@ -44,6 +44,7 @@ public:
 
 private:
     struct Vertex { float x; float y; float z; };
+    struct Normal { float nx; float ny; float nz; };
     struct Color { uint8_t red; uint8_t green; uint8_t blue; };
     struct Face { int32_t v1; int32_t v2; int32_t v3; };
 
@@ -56,6 +57,7 @@ private:
     class Properties;
     Parameters m_params;
     std::vector<Vertex> m_vecNode;
+    std::vector<Normal> m_vecNodeNormal;
     std::vector<Color> m_vecNodeColor;
     std::vector<Face> m_vecFace;
 };
@@ -21,11 +21,13 @@
 
 #include <QtCore/QtDebug>
 #include <QtCore/QFile>
+#include <QtCore/QTemporaryDir>
 #include <QtCore/QTemporaryFile>
 #include <QtCore/QVariant>
 #include <QtGui/QPainter>
 #include <QtGui/QPixmap>
 #include <QtTest/QSignalSpy>
+#include <memory>
 
 namespace Mayo {
 
@@ -121,27 +123,35 @@ void TestApp::QStringUtils_text_test_data()
 
 void TestApp::RecentFiles_test()
 {
-    auto fnColorPixmap = [](const QColor& color) {
-        QPixmap pix(64, 64);
-        QPainter painter(&pix);
-        painter.fillRect(0, 0, 64, 64, color);
-        return pix;
+    QTemporaryDir cacheDir;
+    QVERIFY(cacheDir.isValid());
+    RecentFile::setThumbnailCacheDirectory(filepathFrom(cacheDir.path()));
+
+    auto fnColorImage = [](const QColor& color) {
+        QImage img(64, 64, QImage::Format_ARGB32);
+        img.fill(color);
+        return img;
     };
 
-    auto fnCreateRecentFile = [](const QPixmap& thumbnail) {
-        QTemporaryFile file;
-        file.open();
+    std::vector<std::unique_ptr<QTemporaryFile>> vecFile;
+    auto fnCreateRecentFile = [&]{
+        vecFile.push_back(std::make_unique<QTemporaryFile>());
+        vecFile.back()->open();
         RecentFile rf;
-        rf.filepath = filepathFrom(QFileInfo(file));
+        rf.filepath = filepathFrom(QFileInfo(*vecFile.back()));
         rf.thumbnailTimestamp = RecentFile::timestampLastModified(rf.filepath);
-        rf.thumbnail = thumbnail;
         return rf;
     };
 
     RecentFiles recentFiles;
-    recentFiles.push_back(fnCreateRecentFile(fnColorPixmap(Qt::blue)));
-    recentFiles.push_back(fnCreateRecentFile(fnColorPixmap(Qt::white)));
-    recentFiles.push_back(fnCreateRecentFile(fnColorPixmap(Qt::red)));
+    const QColor colors[] = { Qt::blue, Qt::white, Qt::red };
+    for (const QColor& color : colors) {
+        RecentFile rf = fnCreateRecentFile();
+        QVERIFY(rf.isThumbnailOutOfSync());
+        QVERIFY(fnColorImage(color).save(filepathTo<QString>(rf.thumbnailFilepath()), "PNG"));
+        QVERIFY(!rf.isThumbnailOutOfSync());
+        recentFiles.push_back(rf);
+    }
 
     RecentFiles recentFiles_read;
     {
@@ -159,15 +169,36 @@ void TestApp::RecentFiles_test()
         QCOMPARE(lhs.filepath, rhs.filepath);
         QVERIFY(lhs.thumbnailTimestamp != -1);
         QCOMPARE(lhs.thumbnailTimestamp, rhs.thumbnailTimestamp);
-        QCOMPARE(lhs.thumbnail.size(), rhs.thumbnail.size());
-        const QImage lhsImg = lhs.thumbnail.toImage();
-        const QImage rhsImg = rhs.thumbnail.toImage();
-        for (int i = 0; i < lhs.thumbnail.width(); ++i) {
-            for (int j = 0; j < lhs.thumbnail.height(); ++j) {
-                QCOMPARE(lhsImg.pixel(i, j), rhsImg.pixel(i, j));
-            }
-        } // endfor
+        QCOMPARE(rhs.thumbnailFilepath(), lhs.thumbnailFilepath());
+        const QImage img = rhs.loadThumbnail();
+        QCOMPARE(img.size(), QSize(64, 64));
+        QCOMPARE(img.pixelColor(32, 32), colors[i]);
     }
+
+    // Thumbnail stored in settings by older versions is moved to the cache directory
+    {
+        RecentFile rf = fnCreateRecentFile();
+        QByteArray data;
+        QDataStream wstream(&data, QIODevice::WriteOnly);
+        wstream << uint32_t(1) << filepathTo<QString>(rf.filepath) << fnColorImage(Qt::green) << qint64(rf.thumbnailTimestamp);
+        RecentFiles legacyRecentFiles;
+        QDataStream rstream(&data, QIODevice::ReadOnly);
+        rstream >> legacyRecentFiles;
+        QCOMPARE(int(legacyRecentFiles.size()), 1);
+        QCOMPARE(legacyRecentFiles.front().filepath, rf.filepath);
+        QVERIFY(!legacyRecentFiles.front().isThumbnailOutOfSync());
+        QCOMPARE(legacyRecentFiles.front().loadThumbnail().pixelColor(0, 0), QColor(Qt::green));
+    }
+
+    // Unreferenced thumbnails are deleted
+    const FilePath fpThumbnailRemoved = recentFiles.back().thumbnailFilepath();
+    recentFiles.pop_back();
+    pruneRecentFileThumbnails(recentFiles);
+    QVERIFY(!filepathExists(fpThumbnailRemoved));
+    for (const RecentFile& rf : recentFiles)
+        QVERIFY(filepathExists(rf.thumbnailFilepath()));
+
+    RecentFile::setThumbnailCacheDirectory({});
 }
 
 void TestApp::StringConv_test()
@@ -12,6 +12,7 @@
 #include "test_base.h"
 
 #include "../src/base/application.h"
+#include "../src/base/application_item_selection_model.h"
 #include "../src/base/brep_utils.h"
 #include "../src/base/caf_utils.h"
 #include "../src/base/cpp_utils.h"
@@ -23,8 +24,11 @@
 #include "../src/base/io_system.h"
 #include "../src/base/occ_static_variables_rollback.h"
 #include "../src/base/libtree.h"
+#include "../src/base/math_utils.h"
+#include "../src/base/mesh_decimation.h"
 #include "../src/base/mesh_utils.h"
 #include "../src/base/meta_enum.h"
+#include "../src/base/point_cloud_octree.h"
 #include "../src/base/property_builtins.h"
 #include "../src/base/property_enumeration.h"
 #include "../src/base/property_value_conversion.h"
@@ -34,6 +38,7 @@
 #include "../src/base/unit.h"
 #include "../src/base/unit_system.h"
 #include "../src/io_dxf/io_dxf.h"
+#include "../src/io_image/io_image_software_renderer.h"
 #include "../src/io_occ/io_occ.h"
 #include "../src/io_ply/io_ply_reader.h"
 #include "../src/io_ply/io_ply_writer.h"
@@ -42,10 +47,13 @@
 #include <BRepAdaptor_Curve.hxx>
 #include <BRepMesh_IncrementalMesh.hxx>
 #include <BRepPrimAPI_MakeBox.hxx>
+#include <BRepPrimAPI_MakeSphere.hxx>
 #include <GCPnts_TangentialDeflection.hxx>
 #include <Interface_ParamType.hxx>
 #include <Interface_Static.hxx>
+#include <Precision.hxx>
 #include <TopAbs_ShapeEnum.hxx>
+#include <gp_Trsf.hxx>
 
 #include <QtCore/QtDebug>
 #include <QtCore/QFile>
@@ -53,6 +61,7 @@
 
 #include <gsl/util>
 #include <algorithm>
+#include <array>
 #include <clocale>
 #include <cmath>
 #include <climits>
@@ -60,6 +69,8 @@
 #include <fstream>
 #include <iostream>
 #include <memory>
+#include <numeric>
+#include <random>
 #include <sstream>
 #include <type_traits>
 #include <utility>
@@ -209,6 +220,44 @@ void TestBase::DocumentRefCount_test()
     QCOMPARE(doc->GetRefCount(), 1);
 }
 
+void TestBase::ApplicationItemSelectionModel_test()
+{
+    DocumentPtr doc = Application::instance()->newDocument();
+    auto _ = gsl::finally([=]{ Application::instance()->closeDocument(doc); });
+    std::vector<ApplicationItem> vecItem;
+    for (TreeNodeId id = 1; id <= 10; ++id)
+        vecItem.push_back(DocumentTreeNode(doc, id));
+
+    ApplicationItemSelectionModel selectionModel;
+    SignalEmitSpy spyChanged(&selectionModel.signalChanged);
+    selectionModel.add(vecItem);
+    selectionModel.add(vecItem.front()); // Already selected
+    QCOMPARE(spyChanged.count, 1);
+    QCOMPARE(selectionModel.selectedItems().size(), vecItem.size());
+    for (const ApplicationItem& item : vecItem)
+        QVERIFY(selectionModel.isSelected(item));
+
+    // Remove items at even positions, selection order must be kept
+    std::vector<ApplicationItem> vecItemToRemove;
+    for (size_t i = 0; i < vecItem.size(); i += 2)
+        vecItemToRemove.push_back(vecItem.at(i));
+
+    selectionModel.remove(vecItemToRemove);
+    QCOMPARE(spyChanged.count, 2);
+    QCOMPARE(selectionModel.selectedItems().size(), vecItem.size() / 2);
+    for (size_t i = 0; i < vecItem.size(); ++i) {
+        QCOMPARE(selectionModel.isSelected(vecItem.at(i)), i % 2 != 0);
+        if (i % 2 != 0)
+            QVERIFY(selectionModel.selectedItems()[i / 2] == vecItem.at(i));
+    }
+
+    selectionModel.remove(vecItem.at(1));
+    QVERIFY(!selectionModel.isSelected(vecItem.at(1)));
+    selectionModel.clear();
+    QVERIFY(selectionModel.selectedItems().empty());
+    QVERIFY(!selectionModel.isSelected(vecItem.at(3)));
+}
+
 void TestBase::CppUtils_toggle_test()
 {
     bool v = false;
@@ -597,6 +646,37 @@ void TestBase::BRepUtils_test()
     }
 }
 
+void TestBase::BRepUtils_computeMeshLods_test()
+{
+    const TopoDS_Shape shape = BRepPrimAPI_MakeSphere(25.);
+    std::vector<OccBRepMeshParameters> vecParams;
+    for (double deflection : { 0.05, 0.2, 0.8 }) {
+        OccBRepMeshParameters params;
+        params.Deflection = deflection;
+        params.Angle = 0.5;
+        vecParams.push_back(params);
+    }
+
+    BRepUtils::computeMeshLods(shape, vecParams);
+    BRepUtils::forEachSubFace(shape, [](const TopoDS_Face& face) {
+        TopLoc_Location loc;
+        const Handle_Poly_Triangulation& activeTriangulation = BRep_Tool::Triangulation(face, loc);
+        QVERIFY(!activeTriangulation.IsNull());
+#if OCC_VERSION_HEX >= OCC_VERSION_CHECK(7, 6, 0)
+        const Poly_ListOfTriangulation& listTriangulation = BRep_Tool::Triangulations(face, loc);
+        QCOMPARE(listTriangulation.Size(), 3);
+        QVERIFY(activeTriangulation == listTriangulation.First());
+        int prevTriangleCount = INT_MAX;
+        for (const Handle_Poly_Triangulation& triangulation : listTriangulation) {
+            QVERIFY(triangulation->NbTriangles() <= prevTriangleCount);
+            prevTriangleCount = triangulation->NbTriangles();
+        }
+
+        QVERIFY(listTriangulation.First()->NbTriangles() > listTriangulation.Last()->NbTriangles());
+#endif
+    });
+}
+
 void TestBase::CafUtils_test()
 {
     // TODO Add CafUtils::labelTag() test for multi-threaded safety
@@ -679,6 +759,532 @@ void TestBase::MeshUtils_orientation_test_data()
     }
 }
 
+void TestBase::MeshUtils_vertexCacheOrder_test()
+{
+    // Regular grid of nodes, whose nodes and triangles are shuffled
+    constexpr int gridSize = 40;
+    std::vector<int> vecNodeShuffle(gridSize * gridSize);
+    std::iota(vecNodeShuffle.begin(), vecNodeShuffle.end(), 1);
+    std::mt19937 randomEngine(54321);
+    std::shuffle(vecNodeShuffle.begin(), vecNodeShuffle.end(), randomEngine);
+    std::vector<Poly_Triangle> vecTriangle;
+    for (int i = 0; i < gridSize - 1; ++i) {
+        for (int j = 0; j < gridSize - 1; ++j) {
+            const int n1 = vecNodeShuffle.at(i * gridSize + j);
+            const int n2 = vecNodeShuffle.at((i + 1) * gridSize + j);
+            const int n3 = vecNodeShuffle.at((i + 1) * gridSize + j + 1);
+            const int n4 = vecNodeShuffle.at(i * gridSize + j + 1);
+            vecTriangle.emplace_back(n1, n2, n3);
+            vecTriangle.emplace_back(n1, n3, n4);
+        }
+    }
+
+    std::shuffle(vecTriangle.begin(), vecTriangle.end(), randomEngine);
+    Handle_Poly_Triangulation polyTri = new Poly_Triangulation(
+                int(vecNodeShuffle.size()), int(vecTriangle.size()), true/*hasUVNodes*/
+    );
+    for (int i = 0; i < gridSize; ++i) {
+        for (int j = 0; j < gridSize; ++j) {
+            const int n = vecNodeShuffle.at(i * gridSize + j);
+            MeshUtils::setNode(polyTri, n, gp_Pnt(i, j, (i * j) % 3));
+            MeshUtils::setUVNode(polyTri, n, gp_Pnt2d(i, j));
+        }
+    }
+
+    for (int i = 0; CppUtils::cmpLess(i, vecTriangle.size()); ++i)
+        MeshUtils::setTriangle(polyTri, i + 1, vecTriangle.at(i));
+
+    // Copy of the triangles as node coordinates, independent of node/triangle indices
+    auto fnTrianglesAsPoints = [](const Handle_Poly_Triangulation& triangulation) {
+        std::vector<std::array<double, 9>> vecTriPoints;
+        for (const Poly_Triangle& tri : MeshUtils::triangles(triangulation)) {
+            std::array<double, 9> triPoints;
+            for (int k = 0; k < 3; ++k) {
+                const gp_Pnt pnt = triangulation->Node(tri.Value(k + 1));
+                triPoints[3 * k] = pnt.X();
+                triPoints[3 * k + 1] = pnt.Y();
+                triPoints[3 * k + 2] = pnt.Z();
+            }
+
+            vecTriPoints.push_back(triPoints);
+        }
+
+        std::sort(vecTriPoints.begin(), vecTriPoints.end());
+        return vecTriPoints;
+    };
+
+    const auto vecTriPointsBefore = fnTrianglesAsPoints(polyTri);
+    const double areaBefore = MeshUtils::triangulationArea(polyTri);
+    const double acmrBefore = MeshUtils::averageCacheMissRatio(polyTri);
+    QVERIFY(acmrBefore > 2.);
+
+    const std::vector<int> vecTriangleOrder = MeshUtils::vertexCacheTriangleOrder(polyTri);
+    QCOMPARE(int(vecTriangleOrder.size()), polyTri->NbTriangles());
+    {
+        std::vector<int> vecSortedOrder = vecTriangleOrder;
+        std::sort(vecSortedOrder.begin(), vecSortedOrder.end());
+        for (int i = 0; CppUtils::cmpLess(i, vecSortedOrder.size()); ++i)
+            QCOMPARE(vecSortedOrder.at(i), i + 1); // Each triangle appears once
+    }
+
+    std::vector<gp_Pnt> vecNodeBefore;
+    for (int n = 1; n <= polyTri->NbNodes(); ++n)
+        vecNodeBefore.push_back(polyTri->Node(n));
+
+    const std::vector<int> vecNewNodeIndex = MeshUtils::reorderTriangulation(polyTri, vecTriangleOrder);
+    QCOMPARE(int(vecNewNodeIndex.size()), polyTri->NbNodes());
+    for (int n = 0; CppUtils::cmpLess(n, vecNewNodeIndex.size()); ++n) {
+        const int newIndex = vecNewNodeIndex.at(n);
+        QVERIFY(polyTri->Node(newIndex).IsEqual(vecNodeBefore.at(n), Precision::Confusion()));
+        const gp_Pnt2d uv = polyTri->UVNode(newIndex);
+        QCOMPARE(uv.X(), vecNodeBefore.at(n).X());
+        QCOMPARE(uv.Y(), vecNodeBefore.at(n).Y());
+    }
+
+    // Nodes are numbered by first use
+    int n1, n2, n3;
+    polyTri->Triangle(1).Get(n1, n2, n3);
+    QCOMPARE(n1, 1);
+    QCOMPARE(n2, 2);
+    QCOMPARE(n3, 3);
+
+    QVERIFY(fnTrianglesAsPoints(polyTri) == vecTriPointsBefore);
+    QCOMPARE(MeshUtils::triangulationArea(polyTri), areaBefore);
+    const double acmrAfter = MeshUtils::averageCacheMissRatio(polyTri);
+    QVERIFY(acmrAfter < 1.);
+}
+
+void TestBase::MeshUtils_computeSmoothNormals_test()
+{
+    // Cube of 12 triangles sharing 8 nodes
+    Handle_Poly_Triangulation polyTriCube = new Poly_Triangulation(8, 12, false);
+    for (int i = 0; i < 8; ++i)
+        MeshUtils::setNode(polyTriCube, i + 1, gp_Pnt(i & 1, (i >> 1) & 1, (i >> 2) & 1));
+
+    const int cubeTriangles[12][3] = {
+        {1, 3, 4}, {1, 4, 2}, {5, 6, 8}, {5, 8, 7}, {1, 2, 6}, {1, 6, 5},
+        {3, 7, 8}, {3, 8, 4}, {1, 5, 7}, {1, 7, 3}, {2, 4, 8}, {2, 8, 6}
+    };
+    for (int i = 0; i < 12; ++i) {
+        const int* nodes = cubeTriangles[i];
+        MeshUtils::setTriangle(polyTriCube, i + 1, Poly_Triangle(nodes[0], nodes[1], nodes[2]));
+    }
+
+    // No crease, normals at cube corners are the diagonals
+    {
+        const Handle_Poly_Triangulation polyTri = MeshUtils::computeSmoothNormals(polyTriCube, MathUtils::pi);
+        QVERIFY(polyTri == polyTriCube);
+        QVERIFY(polyTri->HasNormals());
+        const gp_Vec n1 = MeshUtils::toGpVec(MeshUtils::normal(polyTri, 1));
+        QVERIFY(n1.IsParallel(gp_Vec(-1, -1, -1), 1e-5));
+        QVERIFY(n1.Dot(gp_Vec(-1, -1, -1)) > 0);
+    }
+
+    // Crease angle of 30°, each cube corner is split into 3 nodes having the normal of the cube faces
+    {
+        std::vector<int> vecSourceNode;
+        const Handle_Poly_Triangulation polyTri = MeshUtils::computeSmoothNormals(
+                    polyTriCube, 30 * MathUtils::pi / 180., MeshUtils::NormalWeighting::Angle, &vecSourceNode
+        );
+        QVERIFY(polyTri != polyTriCube);
+        QCOMPARE(polyTri->NbNodes(), 24);
+        QCOMPARE(polyTri->NbTriangles(), 12);
+        QCOMPARE(int(vecSourceNode.size()), 24);
+        for (int i = 1; i <= polyTri->NbNodes(); ++i)
+            QVERIFY(polyTri->Node(i).IsEqual(polyTriCube->Node(vecSourceNode.at(i - 1)), Precision::Confusion()));
+
+        for (int i = 1; i <= polyTri->NbTriangles(); ++i) {
+            int n1, n2, n3;
+            polyTri->Triangle(i).Get(n1, n2, n3);
+            const gp_Pnt pnt1 = polyTri->Node(n1);
+            const gp_Vec faceNormal = gp_Vec(pnt1, polyTri->Node(n2)).Crossed(gp_Vec(pnt1, polyTri->Node(n3)));
+            for (int n : { n1, n2, n3 }) {
+                const gp_Vec normal = MeshUtils::toGpVec(MeshUtils::normal(polyTri, n));
+                QVERIFY(normal.IsParallel(faceNormal, 1e-5));
+                QVERIFY(normal.Dot(faceNormal) > 0);
+            }
+        }
+    }
+
+    // Sphere, normals at nodes are close to the radial directions
+    const TopoDS_Shape shapeSphere = BRepPrimAPI_MakeSphere(10.);
+    BRepMesh_IncrementalMesh(shapeSphere, 0.01);
+    BRepUtils::forEachSubFace(shapeSphere, [](const TopoDS_Face& face) {
+        TopLoc_Location loc;
+        const Handle_Poly_Triangulation& triangulation = BRep_Tool::Triangulation(face, loc);
+        QVERIFY(!triangulation.IsNull());
+        for (auto weighting : { MeshUtils::NormalWeighting::Area, MeshUtils::NormalWeighting::Angle }) {
+            const Handle_Poly_Triangulation polyTri = MeshUtils::computeSmoothNormals(triangulation, MathUtils::pi, weighting);
+            for (int i = 1; i <= polyTri->NbNodes(); ++i) {
+                const gp_Vec radial(polyTri->Node(i).XYZ());
+                const gp_Vec normal = MeshUtils::toGpVec(MeshUtils::normal(polyTri, i));
+                QVERIFY(std::abs(normal.Normalized().Dot(radial.Normalized())) > 0.95);
+            }
+        }
+    });
+}
+
+void TestBase::MeshUtils_metrics_test()
+{
+    auto fnLocatedTriangulations = [](const TopoDS_Shape& shape) {
+        std::vector<MeshUtils::LocatedTriangulation> vecTriangulation;
+        BRepUtils::forEachSubFace(shape, [&](const TopoDS_Face& face) {
+            TopLoc_Location loc;
+            const Handle_Poly_Triangulation& triangulation = BRep_Tool::Triangulation(face, loc);
+            vecTriangulation.push_back({ triangulation, loc, face.Orientation() == TopAbs_REVERSED });
+        });
+        return vecTriangulation;
+    };
+
+    // Box translated by location
+    {
+        const double dx = 10, dy = 15, dz = 20;
+        const TopoDS_Shape shapeBox = BRepPrimAPI_MakeBox(dx, dy, dz);
+        BRepMesh_IncrementalMesh(shapeBox, 0.1);
+        gp_Trsf trsf;
+        trsf.SetTranslation(gp_Vec(1, 2, 3));
+        const auto vecTriangulation = fnLocatedTriangulations(shapeBox.Moved(TopLoc_Location(trsf)));
+        const MeshUtils::Metrics metrics = MeshUtils::triangulationMetrics(vecTriangulation);
+        const gp_XYZ centroid(1 + dx / 2, 2 + dy / 2, 3 + dz / 2);
+        const double mass = dx * dy * dz;
+        QCOMPARE(metrics.area, 2 * (dx * dy + dy * dz + dx * dz));
+        // Faces of a box are partly reversed, so volume is positive only if their orientation is used
+        QVERIFY(std::abs(metrics.signedVolume - mass) < 1e-9 * mass);
+        QVERIFY(metrics.areaCentroid.IsEqual(centroid, Precision::Confusion()));
+        QVERIFY(metrics.volumeCentroid.IsEqual(centroid, Precision::Confusion()));
+        const double tol = 1e-9 * mass * dz * dz;
+        QVERIFY(std::abs(metrics.inertia(1, 1) - mass * (dy * dy + dz * dz) / 12.) < tol);
+        QVERIFY(std::abs(metrics.inertia(2, 2) - mass * (dx * dx + dz * dz) / 12.) < tol);
+        QVERIFY(std::abs(metrics.inertia(3, 3) - mass * (dx * dx + dy * dy) / 12.) < tol);
+        QVERIFY(std::abs(metrics.inertia(1, 2)) < tol);
+        QVERIFY(std::abs(metrics.inertia(2, 3)) < tol);
+        QVERIFY(std::abs(metrics.inertia(1, 3)) < tol);
+        QVERIFY(metrics.boundingBox.CornerMin().IsEqual(gp_Pnt(1, 2, 3), Precision::Confusion()));
+        QVERIFY(metrics.boundingBox.CornerMax().IsEqual(gp_Pnt(1 + dx, 2 + dy, 3 + dz), Precision::Confusion()));
+    }
+
+    // Sphere, triangles are summed by several blocks
+    {
+        const double radius = 10;
+        const TopoDS_Shape shapeSphere = BRepPrimAPI_MakeSphere(radius);
+        BRepMesh_IncrementalMesh(shapeSphere, 0.001);
+        const auto vecTriangulation = fnLocatedTriangulations(shapeSphere);
+        QCOMPARE(int(vecTriangulation.size()), 1);
+        const Handle_Poly_Triangulation& triangulation = vecTriangulation.front().triangulation;
+        QVERIFY(triangulation->NbTriangles() > 10000);
+        const MeshUtils::Metrics metrics = MeshUtils::triangulationMetrics(triangulation);
+        const double sphereArea = 4 * MathUtils::pi * radius * radius;
+        const double sphereVolume = 4 * MathUtils::pi * radius * radius * radius / 3.;
+        QVERIFY(std::abs(metrics.area - sphereArea) < 1e-3 * sphereArea);
+        QVERIFY(std::abs(metrics.signedVolume - sphereVolume) < 1e-3 * sphereVolume);
+        QVERIFY(metrics.volumeCentroid.Modulus() < 1e-6);
+        for (int i = 1; i <= 3; ++i) {
+            const double sphereInertia = 0.4 * sphereVolume * radius * radius;
+            QVERIFY(std::abs(metrics.inertia(i, i) - sphereInertia) < 1e-2 * sphereInertia);
+        }
+
+        QCOMPARE(MeshUtils::triangulationArea(triangulation), metrics.area);
+        QCOMPARE(MeshUtils::triangulationVolume(triangulation), std::abs(metrics.signedVolume));
+
+        // Results are reproducible
+        const MeshUtils::Metrics metricsAgain = MeshUtils::triangulationMetrics(vecTriangulation);
+        QVERIFY(metricsAgain.area == metrics.area);
+        QVERIFY(metricsAgain.signedVolume == metrics.signedVolume);
+        QVERIFY(metricsAgain.volumeCentroid.IsEqual(metrics.volumeCentroid, 0.));
+        for (int i = 1; i <= 3; ++i) {
+            for (int j = 1; j <= 3; ++j)
+                QVERIFY(metricsAgain.inertia(i, j) == metrics.inertia(i, j));
+        }
+    }
+}
+
+void TestBase::MeshDecimation_test()
+{
+    // Wavy grid of size x size nodes
+    auto fnCreateGrid = [](int size) {
+        const int triangleCount = 2 * (size - 1) * (size - 1);
+        Handle_Poly_Triangulation polyTri = new Poly_Triangulation(size * size, triangleCount, false);
+        for (int i = 0; i < size; ++i) {
+            for (int j = 0; j < size; ++j) {
+                const double x = i / double(size - 1);
+                const double y = j / double(size - 1);
+                MeshUtils::setNode(polyTri, i * size + j + 1, gp_Pnt(x, y, 0.2 * std::sin(3 * x) * std::cos(2 * y)));
+            }
+        }
+
+        int triangleId = 0;
+        for (int i = 0; i < size - 1; ++i) {
+            for (int j = 0; j < size - 1; ++j) {
+                const int n1 = i * size + j + 1;
+                const int n2 = n1 + size;
+                MeshUtils::setTriangle(polyTri, ++triangleId, Poly_Triangle(n1, n2, n2 + 1));
+                MeshUtils::setTriangle(polyTri, ++triangleId, Poly_Triangle(n1, n2 + 1, n1 + 1));
+            }
+        }
+
+        return polyTri;
+    };
+
+    constexpr int gridSize = 50;
+    const int gridTriangleCount = 2 * (gridSize - 1) * (gridSize - 1);
+    const Handle_Poly_Triangulation polyTriGrid = fnCreateGrid(gridSize);
+
+    auto fnIsBorderNode = [=](int node) {
+        const int i = (node - 1) / gridSize;
+        const int j = (node - 1) % gridSize;
+        return i == 0 || j == 0 || i == gridSize - 1 || j == gridSize - 1;
+    };
+
+    auto fnCheckResult = [=](const MeshDecimation::Result& result) {
+        const Handle_Poly_Triangulation& polyTri = result.triangulation;
+        QVERIFY(!polyTri.IsNull());
+        QCOMPARE(int(result.vecSourceNode.size()), polyTri->NbNodes());
+        QVERIFY(std::is_sorted(result.vecSourceNode.begin(), result.vecSourceNode.end()));
+        // Border nodes are all kept, unmoved
+        const int borderNodeCount = 4 * (gridSize - 1);
+        int keptBorderNodeCount = 0;
+        for (int i = 1; i <= polyTri->NbNodes(); ++i) {
+            const int sourceNode = result.vecSourceNode.at(i - 1);
+            QVERIFY(sourceNode >= 1 && sourceNode <= polyTriGrid->NbNodes());
+            if (fnIsBorderNode(sourceNode)) {
+                QVERIFY(polyTri->Node(i).IsEqual(polyTriGrid->Node(sourceNode), Precision::Confusion()));
+                ++keptBorderNodeCount;
+            }
+        }
+
+        QCOMPARE(keptBorderNodeCount, borderNodeCount);
+        // Triangles are valid and not flipped(grid is facing +Z)
+        for (int i = 1; i <= polyTri->NbTriangles(); ++i) {
+            int n1, n2, n3;
+            polyTri->Triangle(i).Get(n1, n2, n3);
+            for (int n : { n1, n2, n3 })
+                QVERIFY(n >= 1 && n <= polyTri->NbNodes());
+
+            QVERIFY(n1 != n2 && n2 != n3 && n3 != n1);
+            const gp_Pnt pnt1 = polyTri->Node(n1);
+            const gp_Vec triNormal = gp_Vec(pnt1, polyTri->Node(n2)).Crossed(gp_Vec(pnt1, polyTri->Node(n3)));
+            QVERIFY(triNormal.Z() > 0);
+        }
+    };
+
+    // Target count of triangles
+    {
+        MeshDecimation::Parameters params;
+        params.targetTriangleCount = 1000;
+        const MeshDecimation::Result result = MeshDecimation::decimate(polyTriGrid, params);
+        fnCheckResult(result);
+        QVERIFY(result.triangulation->NbTriangles() <= params.targetTriangleCount);
+        QVERIFY(result.maxError > 0);
+    }
+
+    // Maximum error
+    {
+        MeshDecimation::Parameters params;
+        params.maxError = 1e-3;
+        const MeshDecimation::Result result = MeshDecimation::decimate(polyTriGrid, params);
+        fnCheckResult(result);
+        QVERIFY(result.triangulation->NbTriangles() < gridTriangleCount);
+        QVERIFY(result.maxError <= params.maxError);
+    }
+
+    // Decimation by chunks is deterministic
+    {
+        MeshDecimation::Parameters params;
+        params.targetTriangleCount = 1000;
+        params.minChunkTriangleCount = gridTriangleCount / 4;
+        const MeshDecimation::Result result1 = MeshDecimation::decimate(polyTriGrid, params);
+        const MeshDecimation::Result result2 = MeshDecimation::decimate(polyTriGrid, params);
+        fnCheckResult(result1);
+        QVERIFY(result1.vecSourceNode == result2.vecSourceNode);
+        QCOMPARE(result1.triangulation->NbTriangles(), result2.triangulation->NbTriangles());
+    }
+
+    // Nothing to do, source triangulation is returned
+    {
+        MeshDecimation::Parameters params;
+        params.targetTriangleCount = gridTriangleCount;
+        const MeshDecimation::Result result = MeshDecimation::decimate(polyTriGrid, params);
+        QVERIFY(result.triangulation == polyTriGrid);
+        QCOMPARE(int(result.vecSourceNode.size()), polyTriGrid->NbNodes());
+        QCOMPARE(result.vecSourceNode.back(), polyTriGrid->NbNodes());
+    }
+
+    // Levels of detail, nodes of each one are mapped to the source triangulation
+    {
+        const Handle_Poly_Triangulation polyTriSource = fnCreateGrid(200);
+        std::vector<int> vecLodTriangleCount;
+        int invalidSourceNodeCount = 0;
+        MeshDecimation::computeLevelsOfDetail(polyTriSource, 4, [&](MeshDecimation::Result&& result) {
+            const Handle_Poly_Triangulation& polyTri = result.triangulation;
+            vecLodTriangleCount.push_back(polyTri->NbTriangles());
+            for (int i = 1; i <= polyTri->NbNodes(); ++i) {
+                // Nodes are moved along the wavy surface, not far from their source node
+                const int sourceNode = result.vecSourceNode.at(i - 1);
+                const bool isValidNode = sourceNode >= 1 && sourceNode <= polyTriSource->NbNodes();
+                if (!isValidNode || polyTri->Node(i).Distance(polyTriSource->Node(sourceNode)) > 0.1)
+                    ++invalidSourceNodeCount;
+            }
+
+            return true;
+        });
+
+        // 79202 triangles, then about 19800 and no more LOD as 19800/4 is below the minimum count
+        QCOMPARE(invalidSourceNodeCount, 0);
+        QCOMPARE(int(vecLodTriangleCount.size()), 1);
+        QVERIFY(vecLodTriangleCount.front() <= polyTriSource->NbTriangles() / 2);
+    }
+}
+
+void TestBase::PointCloudOctree_test()
+{
+    // Regular grid of points, with some duplicates to exercise maximum depth
+    constexpr int gridSize = 20;
+    Handle_Graphic3d_ArrayOfPoints points = new Graphic3d_ArrayOfPoints(gridSize * gridSize * gridSize + 100);
+    for (int i = 0; i < gridSize; ++i) {
+        for (int j = 0; j < gridSize; ++j) {
+            for (int k = 0; k < gridSize; ++k)
+                points->AddVertex(gp_Pnt(i, j, k));
+        }
+    }
+
+    for (int i = 0; i < 100; ++i)
+        points->AddVertex(gp_Pnt(5, 5, 5));
+
+    PointCloudOctree::Parameters params;
+    params.gridResolution = 4;
+    params.maxDepth = 6;
+    PointCloudOctree octree;
+    octree.build(points, params);
+    QVERIFY(!octree.isEmpty());
+    QCOMPARE(octree.pointCount(), points->VertexNumber());
+    QVERIFY(octree.depth() > 0 && octree.depth() <= params.maxDepth);
+    QCOMPARE(octree.node(0).depth, 0);
+    QCOMPARE(octree.node(0).parent, -1);
+
+    // Each point belongs to exactly one node, which cube contains the point
+    const int maxNodePointCount = params.gridResolution * params.gridResolution * params.gridResolution;
+    std::vector<int> vecPointOccurrence(points->VertexNumber() + 1, 0);
+    for (int i = 0; i < octree.nodeCount(); ++i) {
+        const PointCloudOctree::Node& node = octree.node(i);
+        if (node.depth < params.maxDepth)
+            QVERIFY(node.pointCount() <= maxNodePointCount);
+
+        for (int childIndex : node.children) {
+            if (childIndex >= 0) {
+                QCOMPARE(octree.node(childIndex).parent, i);
+                QCOMPARE(octree.node(childIndex).depth, node.depth + 1);
+            }
+        }
+
+        const double tol = 1e-6;
+        for (int pntIndex : node.vecPointIndex) {
+            ++vecPointOccurrence.at(pntIndex);
+            const gp_Pnt pnt = points->Vertice(pntIndex);
+            QVERIFY(std::abs(pnt.X() - node.center.X()) <= node.halfSize + tol);
+            QVERIFY(std::abs(pnt.Y() - node.center.Y()) <= node.halfSize + tol);
+            QVERIFY(std::abs(pnt.Z() - node.center.Z()) <= node.halfSize + tol);
+        }
+    }
+
+    QVERIFY(std::all_of(vecPointOccurrence.cbegin() + 1, vecPointOccurrence.cend(), [](int count) {
+        return count == 1;
+    }));
+
+    // Once sorted, points of each node are contiguous and still within the node cube
+    std::vector<int> vecNodePointCount;
+    for (const PointCloudOctree::Node& node : octree.nodes())
+        vecNodePointCount.push_back(node.pointCount());
+
+    const Handle(Graphic3d_ArrayOfPoints) sortedPoints = octree.sortPointsByNode(points);
+    QVERIFY(!sortedPoints.IsNull());
+    QCOMPARE(sortedPoints->VertexNumber(), points->VertexNumber());
+    int sortedPointFirst = 1;
+    for (int i = 0; i < octree.nodeCount(); ++i) {
+        const PointCloudOctree::Node& node = octree.node(i);
+        QVERIFY(node.vecPointIndex.empty());
+        QCOMPARE(node.pointCount(), vecNodePointCount.at(i));
+        QCOMPARE(node.sortedPointFirst, sortedPointFirst);
+        sortedPointFirst += node.sortedPointCount;
+        const double tol = 1e-6;
+        for (int pntIndex = node.sortedPointFirst; pntIndex < sortedPointFirst; ++pntIndex) {
+            const gp_Pnt pnt = sortedPoints->Vertice(pntIndex);
+            QVERIFY(std::abs(pnt.X() - node.center.X()) <= node.halfSize + tol);
+            QVERIFY(std::abs(pnt.Y() - node.center.Y()) <= node.halfSize + tol);
+            QVERIFY(std::abs(pnt.Z() - node.center.Z()) <= node.halfSize + tol);
+        }
+    }
+
+    QCOMPARE(sortedPointFirst, points->VertexNumber() + 1);
+
+    octree.clear();
+    QVERIFY(octree.isEmpty());
+    QCOMPARE(octree.pointCount(), 0);
+}
+
+void TestBase::IO_ImageSoftwareRenderer_test()
+{
+    // Meshed box where top face is red and the other faces are green
+    const TopoDS_Shape shapeBox = BRepPrimAPI_MakeBox(10, 10, 10);
+    BRepMesh_IncrementalMesh mesher(shapeBox, 0.1);
+    IO::ImageSoftwareRenderer renderer;
+    renderer.parameters().backgroundColor = Quantity_NOC_BLUE1;
+    BRepUtils::forEachSubFace(shapeBox, [&](const TopoDS_Face& face) {
+        TopLoc_Location loc;
+        const Handle_Poly_Triangulation& triangulation = BRep_Tool::Triangulation(face, loc);
+        QVERIFY(!triangulation.IsNull());
+        bool isTopFace = true;
+        for (int i = 1; i <= triangulation->NbNodes(); ++i)
+            isTopFace = isTopFace && std::abs(triangulation->Node(i).Z() - 10) < Precision::Confusion();
+
+        renderer.addMesh(triangulation, loc.Transformation(), isTopFace ? Quantity_NOC_RED : Quantity_NOC_GREEN);
+    });
+    QCOMPARE(renderer.meshCount(), 6);
+
+    // Pixels are 8-bit per channel, so allow a rounding error of one level
+    auto fnIsPixelColor = [](const Handle_Image_AlienPixMap& image, int x, int y, Quantity_NameOfColor color) {
+        const Quantity_Color pixelColor = image->PixelColor(x, y).GetRGB();
+        const Quantity_Color expectedColor(color);
+        constexpr double tol = 1.5 / 255.;
+        return std::abs(pixelColor.Red() - expectedColor.Red()) < tol
+                && std::abs(pixelColor.Green() - expectedColor.Green()) < tol
+                && std::abs(pixelColor.Blue() - expectedColor.Blue()) < tol;
+    };
+
+    // Top view, box is seen as a fully lit red square surrounded by edges
+    for (auto projection : { IO::ImageWriter::CameraProjection::Orthographic, IO::ImageWriter::CameraProjection::Perspective }) {
+        renderer.parameters().cameraProjection = projection;
+        const Handle_Image_AlienPixMap image = renderer.renderImage(64, 48, gp_Vec(0, 0, 1));
+        QVERIFY(!image.IsNull());
+        QCOMPARE(int(image->SizeX()), 64);
+        QCOMPARE(int(image->SizeY()), 48);
+        QVERIFY(fnIsPixelColor(image, 32, 24, Quantity_NOC_RED));
+        QVERIFY(fnIsPixelColor(image, 0, 0, Quantity_NOC_BLUE1));
+        QVERIFY(fnIsPixelColor(image, 63, 47, Quantity_NOC_BLUE1));
+        int x = 0;
+        while (x < 32 && fnIsPixelColor(image, x, 24, Quantity_NOC_BLUE1))
+            ++x;
+
+        QVERIFY(x > 0 && x < 32);
+        QVERIFY(fnIsPixelColor(image, x, 24, Quantity_NOC_BLACK));
+    }
+
+    // No edges
+    renderer.parameters().showEdges = false;
+    renderer.parameters().cameraProjection = IO::ImageWriter::CameraProjection::Orthographic;
+    {
+        const Handle_Image_AlienPixMap image = renderer.renderImage(64, 48, gp_Vec(0, 0, 1));
+        QVERIFY(!image.IsNull());
+        for (int y = 0; y < 48; ++y) {
+            for (int x = 0; x < 64; ++x)
+                QVERIFY(fnIsPixelColor(image, x, y, Quantity_NOC_RED) || fnIsPixelColor(image, x, y, Quantity_NOC_BLUE1));
+        }
+    }
+
+    renderer.clear();
+    QVERIFY(renderer.isEmpty());
+    QCOMPARE(renderer.meshCount(), 0);
+}
+
 void TestBase::Enumeration_test()
 {
     enum class TestBase_Enum1 { Value0, Value1, Value2, Value3, Value4 };
@@ -18,6 +18,7 @@ class TestBase : public QObject {
 private slots:
     void Application_test();
     void DocumentRefCount_test();
+    void ApplicationItemSelectionModel_test();
 
     void CppUtils_toggle_test();
     void CppUtils_safeStaticCast_test();
@@ -42,6 +43,7 @@ private slots:
     void DoubleToString_test();
 
     void BRepUtils_test();
+    void BRepUtils_computeMeshLods_test();
 
     void CafUtils_test();
 
@@ -49,6 +51,15 @@ private slots:
     void MeshUtils_test_data();
     void MeshUtils_orientation_test();
     void MeshUtils_orientation_test_data();
+    void MeshUtils_vertexCacheOrder_test();
+    void MeshUtils_computeSmoothNormals_test();
+    void MeshUtils_metrics_test();
+
+    void MeshDecimation_test();
+
+    void PointCloudOctree_test();
+
+    void IO_ImageSoftwareRenderer_test();
 
     void Enumeration_test();
     void MetaEnum_test();